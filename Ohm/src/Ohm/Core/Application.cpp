@@ -2,7 +2,11 @@
 #include "Ohm/Core/Application.h"
 #include "Ohm/Rendering/RenderCommand.h"
 #include "Ohm/Rendering/Renderer.h"
+#include "Ohm/Rendering/GeometryPool.h"
+#include "Ohm/Rendering/RenderThread.h"
+#include "Ohm/Rendering/TextureLibrary.h"
 #include "Ohm/Core/Time.h"
+#include "Ohm/Core/JobSystem.h"
 
 #include <GLFW/glfw3.h>
 
@@ -10,31 +14,51 @@ namespace Ohm
 {
 	Application* Application::s_Instance = nullptr;
 
-	Application::Application(const std::string& name)
+	Application::Application(const std::string& name, ApplicationRenderMode renderMode)
 		:m_Name(name)
 	{
 		ASSERT(!s_Instance, "An instance of Application already exists!");
 		s_Instance = this;
 		m_Window = CreateScope<Window>(name);
 		m_Window->SetEventCallbackFunction(OHM_BIND_FN(Application::OnEvent));
+		JobSystem::Initialize();
 		RenderCommand::Initialize();
 		RenderCommand::SetViewport(m_Window->GetWidth(), m_Window->GetHeight());
 		Renderer::Initialize();
 
+		if (renderMode == ApplicationRenderMode::MultiThreaded)
+			m_RenderThread = CreateScope<RenderThread>(*m_Window);
+
 		m_ImGuiLayer = new ImGuiLayer();
 		PushOverlay(m_ImGuiLayer);
 	}
 
 	Application::~Application()
 	{
+		// Layers are detached by the layer stack after this, so the window's context has to be back on this thread.
+		if (m_RenderThread)
+			m_RenderThread->Stop();
 		Renderer::Shutdown();
+		JobSystem::Shutdown();
 	}
 
 	void Application::Run()
 	{
+		if (m_RenderThread)
+			m_RenderThread->Start();
+
 		while (m_IsRunning)
 		{
+			// Events are polled inside the frame so anything they enqueue for the render thread has a frame to go to.
+			if (m_RenderThread)
+			{
+				m_RenderThread->BeginFrame();
+				m_Window->PollEvents();
+			}
+
 			Time::Tick();
+			// Uploads go out on this thread's context, ahead of the frame's fence.
+			TextureLibrary::UpdateAsyncLoads();
 			for (auto* layer : m_LayerStack)
 				layer->OnUpdate(Time::DeltaTime());
 
@@ -43,8 +67,15 @@ namespace Ohm
 				layer->OnUIRender();
 			m_ImGuiLayer->End();
 
-			m_Window->Update();
+			if (m_RenderThread)
+				m_RenderThread->EndFrame();
+			else
+				m_Window->Update();
+			GeometryPool::EndFrame();
 		}
+
+		if (m_RenderThread)
+			m_RenderThread->Stop();
 	}
 
 	void Application::Close()
@@ -87,7 +118,13 @@ namespace Ohm
 	
 	bool Application::OnWindowResize(const WindowResizedEvent& windowResizeEvent)
 	{
-		RenderCommand::SetViewport(windowResizeEvent.GetWidth(), windowResizeEvent.GetHeight());
+		const uint32_t Width = windowResizeEvent.GetWidth();
+		const uint32_t Height = windowResizeEvent.GetHeight();
+
+		if (m_RenderThread)
+			m_RenderThread->Enqueue([Width, Height]() { RenderCommand::SetViewport(Width, Height); });
+		else
+			RenderCommand::SetViewport(Width, Height);
 		return true;
 	}
 }
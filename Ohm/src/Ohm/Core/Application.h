@@ -8,10 +8,15 @@
 
 namespace Ohm
 {
+	class RenderThread;
+
+	// MultiThreaded renders on a dedicated thread that owns the window's context, one frame behind the main thread.
+	enum class ApplicationRenderMode { SingleThreaded = 0, MultiThreaded };
+
 	class Application
 	{
 	public:
-		Application(const std::string& name);
+		Application(const std::string& name, ApplicationRenderMode renderMode = ApplicationRenderMode::SingleThreaded);
 		virtual ~Application();
 
 		void Run();
@@ -27,6 +32,9 @@ namespace Ohm
 
 		ImGuiLayer& GetImGuiLayer() const { return *m_ImGuiLayer; }
 
+		bool IsRenderThreadEnabled() const { return m_RenderThread != nullptr; }
+		RenderThread& GetRenderThread() const { return *m_RenderThread; }
+
 	private:
 		bool OnWindowClose(WindowClosedEvent& windowCloseEvent);
 		bool OnWindowResize(const WindowResizedEvent& windowResizeEvent);
@@ -38,9 +46,10 @@ namespace Ohm
 		std::string m_Name;
 		bool m_IsRunning = true;
 		Scope<Window> m_Window;
+		Scope<RenderThread> m_RenderThread;
 		LayerStack m_LayerStack;
 		ImGuiLayer* m_ImGuiLayer;
 	};
 
-	Application* CreateApplication();
+	Application* CreateApplication(int argc, char** argv);
 }
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "ohmpch.h"
+#include "Ohm/Core/AssetCache.h"
+
+#include <filesystem>
+
+namespace Ohm
+{
+	bool AssetCache::GetSourceStamp(const std::string& filePath, SourceStamp& stamp)
+	{
+		std::error_code Error;
+		stamp.Size = std::filesystem::file_size(filePath, Error);
+		if (Error) return false;
+		stamp.WriteTime = static_cast<int64_t>(std::filesystem::last_write_time(filePath, Error).time_since_epoch().count());
+		return !Error;
+	}
+
+	bool AssetCache::Write(const std::string& cachePath, std::initializer_list<AssetCacheSection> sections)
+	{
+		const std::string TemporaryPath = cachePath + ".tmp";
+		{
+			std::ofstream Out(TemporaryPath, std::ios::binary | std::ios::trunc);
+			for (const AssetCacheSection& Section : sections)
+				Out.write(static_cast<const char*>(Section.Data), static_cast<std::streamsize>(Section.Size));
+			if (!Out)
+			{
+				OHM_CORE_WARN("Asset Cache: Couldn't write '{}'.", TemporaryPath);
+				Out.close();
+				std::error_code Error;
+				std::filesystem::remove(TemporaryPath, Error);
+				return false;
+			}
+		}
+
+		std::error_code Error;
+		std::filesystem::rename(TemporaryPath, cachePath, Error);
+		if (Error)
+		{
+			OHM_CORE_WARN("Asset Cache: Couldn't write '{}': {}", cachePath, Error.message());
+			std::filesystem::remove(TemporaryPath, Error);
+			return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+namespace Ohm
+{
+	// Size and modification time of a source file; a cache built from it is stale once either changes.
+	struct SourceStamp
+	{
+		uint64_t Size = 0;
+		int64_t WriteTime = 0;
+	};
+
+	// One run of bytes written to a cache file.
+	struct AssetCacheSection
+	{
+		const void* Data;
+		uint64_t Size;
+	};
+
+	/*
+	 * The file handling shared by the caches the importers keep next to their source files.  What goes in a cache
+	 * and how it is validated on load is up to the importer; this only stamps sources and writes the files.
+	 */
+	class AssetCache
+	{
+	public:
+		// False if the file doesn't exist or can't be queried.
+		static bool GetSourceStamp(const std::string& filePath, SourceStamp& stamp);
+
+		// Writes the sections back to back.  The file is written under another name and renamed, so an interrupted
+		// write can't leave a cache that looks complete.  Failures are logged and leave no file behind.
+		static bool Write(const std::string& cachePath, std::initializer_list<AssetCacheSection> sections);
+	};
+}
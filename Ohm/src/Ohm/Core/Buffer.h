@@ -58,6 +58,12 @@ struct Buffer
 		return (T*)((byte*)Data + offset);
 	}
 
+	template<typename T>
+	const T* Read(size_t offset = 0) const
+	{
+		return (const T*)((const byte*)Data + offset);
+	}
+
 	byte* ReadBytes(uint32_t size, uint32_t offset) const
 	{
 		ASSERT(offset + size <= Size, "Buffer overflow!");
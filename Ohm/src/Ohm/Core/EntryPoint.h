@@ -1,11 +1,11 @@
 #pragma once
 
-extern Ohm::Application* Ohm::CreateApplication();
+extern Ohm::Application* Ohm::CreateApplication(int argc, char** argv);
 
-int main()
+int main(int argc, char** argv)
 {
 	Ohm::Log::Init();
-	auto* app = Ohm::CreateApplication();
+	auto* app = Ohm::CreateApplication(argc, argv);
 	app->Run();
 	delete app;
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Ohm/Core/Assert.h"
+#include "Ohm/Core/Memory.h"
+
+#include <deque>
+
+namespace Ohm
+{
+	// Index of a slot in a HandlePool and the generation the slot had when the handle was made.  A handle whose
+	// slot has been freed and reused resolves to nothing instead of to whatever took its place.
+	template<typename T>
+	struct Handle
+	{
+		uint32_t Index = UINT32_MAX;
+		uint32_t Generation = 0;
+
+		bool IsValid() const { return Index != UINT32_MAX; }
+		bool operator==(const Handle& other) const { return Index == other.Index && Generation == other.Generation; }
+		bool operator!=(const Handle& other) const { return !(*this == other); }
+	};
+
+	/*
+	 * Owns resources in slots addressed by Handle<T>, so a handle resolves with an index and a generation compare
+	 * rather than a string hash.  Names are kept once per slot, for the editor and for the lookup that turns a name
+	 * into a handle; resolve that when the resource is loaded or the scene is set up, not every frame.
+	 *
+	 * Slots never move, so a reference returned by Get stays valid while the handle is.  The pool isn't
+	 * synchronized; libraries used from more than one thread lock around it.
+	 */
+	template<typename T>
+	class HandlePool
+	{
+	public:
+		Handle<T> Add(const Ref<T>& resource, const std::string& name)
+		{
+			uint32_t Index;
+			if (m_FreeSlots.empty())
+			{
+				Index = static_cast<uint32_t>(m_Slots.size());
+				m_Slots.emplace_back();
+			}
+			else
+			{
+				Index = m_FreeSlots.back();
+				m_FreeSlots.pop_back();
+			}
+
+			Slot& Entry = m_Slots[Index];
+			Entry.Resource = resource;
+			Entry.Name = name;
+			const Handle<T> NewHandle{ Index, Entry.Generation };
+			m_NameToHandle[name] = NewHandle;
+			return NewHandle;
+		}
+
+		void Remove(Handle<T> handle)
+		{
+			if (!IsAlive(handle)) return;
+
+			Slot& Entry = m_Slots[handle.Index];
+			const auto It = m_NameToHandle.find(Entry.Name);
+			if (It != m_NameToHandle.end() && It->second == handle)
+				m_NameToHandle.erase(It);
+
+			Entry.Resource = nullptr;
+			Entry.Name.clear();
+			Entry.Generation++;
+			m_FreeSlots.push_back(handle.Index);
+		}
+
+		bool IsAlive(Handle<T> handle) const
+		{
+			return handle.Index < m_Slots.size() && m_Slots[handle.Index].Generation == handle.Generation && m_Slots[handle.Index].Resource;
+		}
+
+		// nullptr if the handle is stale or was never valid.
+		T* Resolve(Handle<T> handle) const { return IsAlive(handle) ? m_Slots[handle.Index].Resource.get() : nullptr; }
+
+		const Ref<T>& Get(Handle<T> handle) const
+		{
+			ASSERT(IsAlive(handle), "HandlePool: Handle {}:{} is stale or invalid.", handle.Index, handle.Generation);
+			return m_Slots[handle.Index].Resource;
+		}
+
+		const std::string& GetName(Handle<T> handle) const
+		{
+			ASSERT(IsAlive(handle), "HandlePool: Handle {}:{} is stale or invalid.", handle.Index, handle.Generation);
+			return m_Slots[handle.Index].Name;
+		}
+
+		// An invalid handle if nothing by that name is alive.
+		Handle<T> Find(const std::string& name) const
+		{
+			const auto It = m_NameToHandle.find(name);
+			return It == m_NameToHandle.end() ? Handle<T>() : It->second;
+		}
+
+		bool Contains(const std::string& name) const { return m_NameToHandle.find(name) != m_NameToHandle.end(); }
+		uint32_t GetCount() const { return static_cast<uint32_t>(m_Slots.size() - m_FreeSlots.size()); }
+
+		// fn(Handle<T>, const Ref<T>&, const std::string& name) for every live resource, in slot order.
+		template<typename Fn>
+		void ForEach(Fn&& fn) const
+		{
+			for (uint32_t i = 0; i < m_Slots.size(); i++)
+			{
+				const Slot& Entry = m_Slots[i];
+				if (Entry.Resource)
+					fn(Handle<T>{ i, Entry.Generation }, Entry.Resource, Entry.Name);
+			}
+		}
+
+	private:
+		struct Slot
+		{
+			Ref<T> Resource;
+			std::string Name;
+			uint32_t Generation = 1;
+		};
+
+		std::deque<Slot> m_Slots;
+		std::vector<uint32_t> m_FreeSlots;
+		std::unordered_map<std::string, Handle<T>> m_NameToHandle;
+	};
+}
@@ -0,0 +1,76 @@
+#include "ohmpch.h"
+#include "Ohm/Core/Hash.h"
+
+#include <cstring>
+
+namespace Ohm
+{
+	static constexpr uint64_t C1 = 0x87c37b91114253d5ull;
+	static constexpr uint64_t C2 = 0x4cf5ad432745937full;
+
+	static uint64_t RotateLeft(uint64_t value, int bits)
+	{
+		return (value << bits) | (value >> (64 - bits));
+	}
+
+	static uint64_t Mix(uint64_t value)
+	{
+		value ^= value >> 33;
+		value *= 0xff51afd7ed558ccdull;
+		value ^= value >> 33;
+		value *= 0xc4ceb9fe1a85ec53ull;
+		value ^= value >> 33;
+		return value;
+	}
+
+	static uint64_t ScrambleLow(uint64_t k) { return RotateLeft(k * C1, 31) * C2; }
+	static uint64_t ScrambleHigh(uint64_t k) { return RotateLeft(k * C2, 33) * C1; }
+
+	Hash128 HashBytes128(const void* data, size_t size, uint64_t seed)
+	{
+		const uint8_t* Bytes = static_cast<const uint8_t*>(data);
+		const size_t BlockCount = size / 16;
+		uint64_t H1 = seed;
+		uint64_t H2 = seed;
+
+		for (size_t i = 0; i < BlockCount; i++)
+		{
+			uint64_t K1, K2;
+			std::memcpy(&K1, Bytes + i * 16, sizeof(K1));
+			std::memcpy(&K2, Bytes + i * 16 + 8, sizeof(K2));
+
+			H1 ^= ScrambleLow(K1);
+			H1 = RotateLeft(H1, 27) + H2;
+			H1 = H1 * 5 + 0x52dce729;
+			H2 ^= ScrambleHigh(K2);
+			H2 = RotateLeft(H2, 31) + H1;
+			H2 = H2 * 5 + 0x38495ab5;
+		}
+
+		// The last 0-15 bytes, little endian, as the reference implementation reads them.
+		const uint8_t* Tail = Bytes + BlockCount * 16;
+		const size_t TailSize = size & 15;
+		uint64_t K1 = 0, K2 = 0;
+		for (size_t i = 0; i < TailSize; i++)
+		{
+			if (i < 8)
+				K1 |= static_cast<uint64_t>(Tail[i]) << (i * 8);
+			else
+				K2 |= static_cast<uint64_t>(Tail[i]) << ((i - 8) * 8);
+		}
+		if (TailSize > 8)
+			H2 ^= ScrambleHigh(K2);
+		if (TailSize > 0)
+			H1 ^= ScrambleLow(K1);
+
+		H1 ^= size;
+		H2 ^= size;
+		H1 += H2;
+		H2 += H1;
+		H1 = Mix(H1);
+		H2 = Mix(H2);
+		H1 += H2;
+		H2 += H1;
+		return { H1, H2 };
+	}
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+namespace Ohm
+{
+	struct Hash128
+	{
+		uint64_t Low = 0;
+		uint64_t High = 0;
+
+		bool operator==(const Hash128& other) const { return Low == other.Low && High == other.High; }
+		bool operator!=(const Hash128& other) const { return !(*this == other); }
+	};
+
+	// MurmurHash3's 128 bit variant.  Wide enough that distinct contents sharing a hash is out of the question in
+	// practice, which content addressed caches rely on; it isn't meant to hold up against deliberately crafted input.
+	Hash128 HashBytes128(const void* data, size_t size, uint64_t seed = 0);
+}
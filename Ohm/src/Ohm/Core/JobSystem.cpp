@@ -0,0 +1,169 @@
+#include "ohmpch.h"
+#include "Ohm/Core/JobSystem.h"
+
+namespace Ohm
+{
+	struct JobSystemData
+	{
+		std::vector<std::thread> Workers;
+
+		std::mutex QueueMutex;
+		std::condition_variable QueueCondition;
+		std::deque<std::function<void()>> Queue;
+		bool StopRequested = false;
+	};
+
+	// One ParallelFor.  Helpers that are dequeued after the range is finished still hold it, so it's shared.
+	struct ParallelForState
+	{
+		ParallelForFn Fn;
+		uint32_t Count = 0;
+		uint32_t ChunkSize = 0;
+		uint32_t ChunkCount = 0;
+
+		std::atomic<uint32_t> NextChunk{ 0 };
+		std::atomic<uint32_t> ChunksDone{ 0 };
+		std::mutex DoneMutex;
+		std::condition_variable DoneCondition;
+
+		// Claims and runs chunks until none are left.
+		void Run(uint32_t threadIndex)
+		{
+			uint32_t Done = 0;
+			for (uint32_t Chunk = NextChunk.fetch_add(1); Chunk < ChunkCount; Chunk = NextChunk.fetch_add(1))
+			{
+				const uint32_t Begin = Chunk * ChunkSize;
+				Fn(Begin, std::min(Begin + ChunkSize, Count), threadIndex);
+				Done++;
+			}
+
+			if (Done == 0) return;
+			if (ChunksDone.fetch_add(Done) + Done == ChunkCount)
+			{
+				std::lock_guard<std::mutex> Lock(DoneMutex);
+				DoneCondition.notify_all();
+			}
+		}
+	};
+
+	static JobSystemData* s_JobData = nullptr;
+	static thread_local uint32_t s_ThreadIndex = 0;
+
+	static void WorkerLoop(uint32_t threadIndex)
+	{
+		s_ThreadIndex = threadIndex;
+
+		while (true)
+		{
+			std::function<void()> Job;
+			{
+				std::unique_lock<std::mutex> Lock(s_JobData->QueueMutex);
+				s_JobData->QueueCondition.wait(Lock, []() { return s_JobData->StopRequested || !s_JobData->Queue.empty(); });
+				if (s_JobData->Queue.empty()) return;
+
+				Job = std::move(s_JobData->Queue.front());
+				s_JobData->Queue.pop_front();
+			}
+
+			Job();
+		}
+	}
+
+	void JobSystem::Initialize(uint32_t workerCount)
+	{
+		ASSERT(s_JobData == nullptr, "Job System: Already initialized.");
+		s_JobData = new JobSystemData();
+
+		if (workerCount == 0)
+		{
+			const uint32_t HardwareThreads = std::thread::hardware_concurrency();
+			workerCount = HardwareThreads > 2 ? HardwareThreads - 2 : 1;
+		}
+
+		s_JobData->Workers.reserve(workerCount);
+		for (uint32_t i = 0; i < workerCount; i++)
+			s_JobData->Workers.emplace_back(WorkerLoop, i + 1);
+
+		OHM_CORE_INFO("Job System: Started {} worker threads.", workerCount);
+	}
+
+	void JobSystem::Shutdown()
+	{
+		if (s_JobData == nullptr) return;
+
+		{
+			std::lock_guard<std::mutex> Lock(s_JobData->QueueMutex);
+			s_JobData->StopRequested = true;
+		}
+		s_JobData->QueueCondition.notify_all();
+
+		for (std::thread& Worker : s_JobData->Workers)
+			Worker.join();
+
+		delete s_JobData;
+		s_JobData = nullptr;
+	}
+
+	void JobSystem::ParallelFor(uint32_t count, uint32_t chunkSize, const ParallelForFn& fn)
+	{
+		if (count == 0) return;
+
+		chunkSize = std::max(chunkSize, 1u);
+		const uint32_t ChunkCount = (count + chunkSize - 1) / chunkSize;
+
+		// Not worth waking anyone for a single chunk.
+		if (ChunkCount == 1 || s_JobData == nullptr || s_JobData->Workers.empty())
+		{
+			fn(0, count, s_ThreadIndex);
+			return;
+		}
+
+		Ref<ParallelForState> State = CreateRef<ParallelForState>();
+		State->Fn = fn;
+		State->Count = count;
+		State->ChunkSize = chunkSize;
+		State->ChunkCount = ChunkCount;
+
+		// The calling thread takes one of the chunks, so one helper fewer than there are chunks is enough.
+		const uint32_t HelperCount = std::min(ChunkCount - 1, static_cast<uint32_t>(s_JobData->Workers.size()));
+		{
+			std::lock_guard<std::mutex> Lock(s_JobData->QueueMutex);
+			for (uint32_t i = 0; i < HelperCount; i++)
+				s_JobData->Queue.emplace_back([State]() { State->Run(s_ThreadIndex); });
+		}
+		if (HelperCount == 1)
+			s_JobData->QueueCondition.notify_one();
+		else
+			s_JobData->QueueCondition.notify_all();
+
+		State->Run(s_ThreadIndex);
+
+		std::unique_lock<std::mutex> Lock(State->DoneMutex);
+		State->DoneCondition.wait(Lock, [&State]() { return State->ChunksDone.load() == State->ChunkCount; });
+	}
+
+	void JobSystem::Submit(const JobFn& fn)
+	{
+		if (s_JobData == nullptr || s_JobData->Workers.empty())
+		{
+			fn();
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> Lock(s_JobData->QueueMutex);
+			s_JobData->Queue.emplace_back(fn);
+		}
+		s_JobData->QueueCondition.notify_one();
+	}
+
+	uint32_t JobSystem::GetWorkerCount()
+	{
+		return s_JobData ? static_cast<uint32_t>(s_JobData->Workers.size()) : 0;
+	}
+
+	uint32_t JobSystem::GetThreadIndex()
+	{
+		return s_ThreadIndex;
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+namespace Ohm
+{
+	// Processes indices [begin, end).  threadIndex is unique among the threads running the same ParallelFor.
+	using ParallelForFn = std::function<void(uint32_t begin, uint32_t end, uint32_t threadIndex)>;
+	using JobFn = std::function<void()>;
+
+	/*
+	 * A fixed pool of worker threads, started with the application.
+	 *
+	 * ParallelFor splits a range into chunks that workers and the calling thread claim from a shared counter until
+	 * none are left, and returns once every chunk has been processed.  The calling thread always takes part, so a
+	 * ParallelFor never waits on a worker that is busy elsewhere.
+	 *
+	 * Submit hands a job to the workers without waiting for it.  A long job holds its worker up; a ParallelFor started
+	 * meanwhile still finishes, with one helper fewer.
+	 *
+	 * Workers have thread indices 1 to GetWorkerCount(); every other thread has index 0.  Per-thread scratch sized
+	 * by GetThreadCount() is therefore only safe to share with one non-worker caller at a time.
+	 */
+	class JobSystem
+	{
+	public:
+		// A worker count of zero leaves one hardware thread for the main thread and one for rendering.
+		static void Initialize(uint32_t workerCount = 0);
+		static void Shutdown();
+
+		static void ParallelFor(uint32_t count, uint32_t chunkSize, const ParallelForFn& fn);
+		// Runs on the calling thread when there are no workers.  Jobs still queued at shutdown are run before it returns.
+		static void Submit(const JobFn& fn);
+
+		static uint32_t GetWorkerCount();
+		static uint32_t GetThreadCount() { return GetWorkerCount() + 1; }
+		static uint32_t GetThreadIndex();
+	};
+}
@@ -0,0 +1,74 @@
+#include "ohmpch.h"
+#include "Ohm/Core/MappedFile.h"
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace Ohm
+{
+#ifdef _WIN32
+	MappedFile::MappedFile(const std::string& filePath)
+	{
+		const HANDLE File = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (File == INVALID_HANDLE_VALUE)
+			return;
+
+		LARGE_INTEGER Size;
+		if (GetFileSizeEx(File, &Size) && Size.QuadPart > 0)
+		{
+			// The view keeps the mapping alive, so both handles can be closed straight away.
+			const HANDLE Mapping = CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (Mapping)
+			{
+				m_Data = static_cast<const uint8_t*>(MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0));
+				m_Size = m_Data ? static_cast<uint64_t>(Size.QuadPart) : 0;
+				CloseHandle(Mapping);
+			}
+		}
+		CloseHandle(File);
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (m_Data)
+			UnmapViewOfFile(m_Data);
+	}
+#else
+	MappedFile::MappedFile(const std::string& filePath)
+	{
+		const int File = open(filePath.c_str(), O_RDONLY);
+		if (File < 0)
+			return;
+
+		struct stat Info;
+		if (fstat(File, &Info) == 0 && Info.st_size > 0)
+		{
+			void* Mapped = mmap(nullptr, static_cast<size_t>(Info.st_size), PROT_READ, MAP_PRIVATE, File, 0);
+			if (Mapped != MAP_FAILED)
+			{
+				// The whole file is about to be uploaded, so let the kernel read ahead.
+				madvise(Mapped, static_cast<size_t>(Info.st_size), MADV_SEQUENTIAL);
+				m_Data = static_cast<const uint8_t*>(Mapped);
+				m_Size = static_cast<uint64_t>(Info.st_size);
+			}
+		}
+		// The mapping holds its own reference to the file.
+		close(File);
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (m_Data)
+			munmap(const_cast<uint8_t*>(m_Data), static_cast<size_t>(m_Size));
+	}
+#endif
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+namespace Ohm
+{
+	/*
+	 * A whole file mapped read-only into memory.  Pages are read in by the OS as they are touched, so nothing is
+	 * copied up front and repeated loads come straight out of the page cache.
+	 */
+	class MappedFile
+	{
+	public:
+		MappedFile(const std::string& filePath);
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		// False if the file couldn't be opened or is empty.
+		bool IsValid() const { return m_Data != nullptr; }
+		const uint8_t* GetData() const { return m_Data; }
+		uint64_t GetSize() const { return m_Size; }
+
+	private:
+		const uint8_t* m_Data = nullptr;
+		uint64_t m_Size = 0;
+	};
+}
@@ -147,8 +147,18 @@ namespace Ohm
 	}
 
 	void Window::Update()
+	{
+		PollEvents();
+		SwapBuffers();
+	}
+
+	void Window::PollEvents()
 	{
 		glfwPollEvents();
+	}
+
+	void Window::SwapBuffers()
+	{
 		glfwSwapBuffers(m_WindowHandle);
 	}
 
@@ -17,6 +17,8 @@ namespace Ohm
 		~Window();
 
 		void Update();
+		void PollEvents();
+		void SwapBuffers();
 		void SetEventCallbackFunction(const EventCallbackFunction& callback) { m_WindowData.Callback = callback; }
 
 		uint32_t GetWidth() const { return m_WindowData.Width; }
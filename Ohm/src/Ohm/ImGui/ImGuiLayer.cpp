@@ -2,6 +2,7 @@
 #include "Ohm/ImGui/ImGuiLayer.h"
 
 #include "Ohm/Core/Application.h"
+#include "Ohm/Rendering/RenderThread.h"
 
 #include <GLFW/glfw3.h>
 #include <glad/glad.h>
@@ -27,6 +28,10 @@ namespace Ohm
 		io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;           // Enable Docking
 		io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;         // Enable Multi-Viewport / Platform Windows
 
+		// Platform windows are created on the main thread and rendered with their own contexts, neither of which
+		// the render thread can do.
+		if (Application::GetApplication().IsRenderThreadEnabled())
+			io.ConfigFlags &= ~ImGuiConfigFlags_ViewportsEnable;
 
 		io.Fonts->AddFontFromFileTTF("assets/fonts/Cascadia.ttf", 13.0f);
 		io.FontDefault = io.Fonts->AddFontFromFileTTF("assets/fonts/Cascadia.ttf", 13.0f);
@@ -84,6 +89,14 @@ namespace Ohm
 		io.DisplaySize = ImVec2((float)app.GetWindow().GetWidth(), (float)app.GetWindow().GetHeight());
 
 		ImGui::Render();
+
+		// The render thread draws a copy of this frame's lists once it has rendered the frame's scene.
+		if (app.IsRenderThreadEnabled())
+		{
+			app.GetRenderThread().SubmitUI(ImGui::GetDrawData());
+			return;
+		}
+
 		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
 		if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
@@ -0,0 +1,14 @@
+#pragma once
+#include <glm/glm.hpp>
+
+namespace Ohm
+{
+	struct AABB
+	{
+		glm::vec3 Min {0.0f};
+		glm::vec3 Max {0.0f};
+
+		glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+		glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+	};
+}
@@ -0,0 +1,635 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/BlockCompressor.h"
+#include "Ohm/Core/JobSystem.h"
+
+#include <cstring>
+#include <limits>
+
+namespace Ohm
+{
+	using TextureUtils::ImageInternalFormat;
+
+	// Fewer blocks than this aren't worth a job of their own.
+	static constexpr uint32_t MinBlocksPerChunk = 256;
+	// The covariance of sixteen texels converges in a handful of power iterations.
+	static constexpr uint32_t PrincipalAxisIterations = 4;
+	// Weights of BC7's 4 bit indices, out of 64.
+	static constexpr uint32_t BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+	static constexpr uint32_t BC7Mode6 = 1 << 6;
+
+	struct BitWriter
+	{
+		uint8_t* Out;
+		uint32_t Position = 0;
+
+		void Write(uint32_t value, uint32_t bitCount)
+		{
+			for (uint32_t i = 0; i < bitCount; i++, Position++)
+			{
+				if ((value >> i) & 1)
+					Out[Position >> 3] |= static_cast<uint8_t>(1 << (Position & 7));
+			}
+		}
+	};
+
+	struct BitReader
+	{
+		const uint8_t* In;
+		uint32_t Position = 0;
+
+		uint32_t Read(uint32_t bitCount)
+		{
+			uint32_t Value = 0;
+			for (uint32_t i = 0; i < bitCount; i++, Position++)
+				Value |= static_cast<uint32_t>((In[Position >> 3] >> (Position & 7)) & 1) << i;
+			return Value;
+		}
+	};
+
+	static float SquaredDistance(const glm::vec4& a, const glm::vec4& b)
+	{
+		const glm::vec4 Difference = a - b;
+		return glm::dot(Difference, Difference);
+	}
+
+	// Picks the nearest palette entry for every texel; returns the summed squared error.
+	static float SelectIndices(const glm::vec4* texels, const glm::vec4* palette, uint32_t paletteSize, uint8_t* indices)
+	{
+		float TotalError = 0.0f;
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			float BestError = std::numeric_limits<float>::max();
+			for (uint32_t Entry = 0; Entry < paletteSize; Entry++)
+			{
+				const float Error = SquaredDistance(texels[i], palette[Entry]);
+				if (Error < BestError)
+				{
+					BestError = Error;
+					indices[i] = static_cast<uint8_t>(Entry);
+				}
+			}
+			TotalError += BestError;
+		}
+		return TotalError;
+	}
+
+	// The two ends of the block's extent along the direction it varies most in.
+	static void GetPrincipalEndpoints(const glm::vec4* texels, glm::vec4& high, glm::vec4& low)
+	{
+		glm::vec4 Mean(0.0f), Min(std::numeric_limits<float>::max()), Max(-std::numeric_limits<float>::max());
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			Mean += texels[i];
+			Min = glm::min(Min, texels[i]);
+			Max = glm::max(Max, texels[i]);
+		}
+		Mean /= 16.0f;
+
+		float Covariance[4][4] = {};
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			const glm::vec4 Offset = texels[i] - Mean;
+			for (uint32_t Row = 0; Row < 4; Row++)
+			{
+				for (uint32_t Column = 0; Column < 4; Column++)
+					Covariance[Row][Column] += Offset[Row] * Offset[Column];
+			}
+		}
+
+		// Starting along the bounding box's diagonal, which is close already for most blocks.
+		glm::vec4 Axis = Max - Min;
+		for (uint32_t Iteration = 0; Iteration < PrincipalAxisIterations; Iteration++)
+		{
+			glm::vec4 Next(0.0f);
+			for (uint32_t Row = 0; Row < 4; Row++)
+			{
+				for (uint32_t Column = 0; Column < 4; Column++)
+					Next[Row] += Covariance[Row][Column] * Axis[Column];
+			}
+
+			const float Largest = glm::max(glm::max(glm::abs(Next.x), glm::abs(Next.y)), glm::max(glm::abs(Next.z), glm::abs(Next.w)));
+			if (Largest == 0.0f) break;
+			Axis = Next / Largest;
+		}
+
+		const float AxisLength = glm::length(Axis);
+		if (AxisLength == 0.0f)
+		{
+			high = low = Mean;
+			return;
+		}
+		Axis /= AxisLength;
+
+		float MinProjection = std::numeric_limits<float>::max(), MaxProjection = -std::numeric_limits<float>::max();
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			const float Projection = glm::dot(texels[i] - Mean, Axis);
+			MinProjection = glm::min(MinProjection, Projection);
+			MaxProjection = glm::max(MaxProjection, Projection);
+		}
+
+		high = glm::clamp(Mean + Axis * MaxProjection, glm::vec4(0.0f), glm::vec4(255.0f));
+		low = glm::clamp(Mean + Axis * MinProjection, glm::vec4(0.0f), glm::vec4(255.0f));
+	}
+
+	// Endpoints whose blends by weights (0 for start, 1 for end) reconstruct the texels with the least squared error.
+	// False when every texel picked the same weight, which leaves the line undetermined.
+	static bool FitEndpoints(const glm::vec4* texels, const float* weights, glm::vec4& start, glm::vec4& end)
+	{
+		float StartStart = 0.0f, StartEnd = 0.0f, EndEnd = 0.0f;
+		glm::vec4 StartTexel(0.0f), EndTexel(0.0f);
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			const float EndWeight = weights[i];
+			const float StartWeight = 1.0f - EndWeight;
+			StartStart += StartWeight * StartWeight;
+			StartEnd += StartWeight * EndWeight;
+			EndEnd += EndWeight * EndWeight;
+			StartTexel += StartWeight * texels[i];
+			EndTexel += EndWeight * texels[i];
+		}
+
+		const float Determinant = StartStart * EndEnd - StartEnd * StartEnd;
+		if (glm::abs(Determinant) < 1e-6f)
+			return false;
+
+		start = glm::clamp((StartTexel * EndEnd - EndTexel * StartEnd) / Determinant, glm::vec4(0.0f), glm::vec4(255.0f));
+		end = glm::clamp((EndTexel * StartStart - StartTexel * StartEnd) / Determinant, glm::vec4(0.0f), glm::vec4(255.0f));
+		return true;
+	}
+
+	//-------------------------BC1 colors-------------------------//
+
+	static uint16_t PackRGB565(const glm::vec4& color)
+	{
+		const uint32_t R = static_cast<uint32_t>(std::clamp(std::lround(color.r * 31.0f / 255.0f), 0l, 31l));
+		const uint32_t G = static_cast<uint32_t>(std::clamp(std::lround(color.g * 63.0f / 255.0f), 0l, 63l));
+		const uint32_t B = static_cast<uint32_t>(std::clamp(std::lround(color.b * 31.0f / 255.0f), 0l, 31l));
+		return static_cast<uint16_t>((R << 11) | (G << 5) | B);
+	}
+
+	static glm::vec4 UnpackRGB565(uint16_t packed)
+	{
+		const uint32_t R = (packed >> 11) & 31;
+		const uint32_t G = (packed >> 5) & 63;
+		const uint32_t B = packed & 31;
+		return { static_cast<float>((R << 3) | (R >> 2)), static_cast<float>((G << 2) | (G >> 4)), static_cast<float>((B << 3) | (B >> 2)), 255.0f };
+	}
+
+	// The colors a BC1 color block decodes to.  Endpoints in increasing order select three colors and transparent
+	// black, unless the block is part of a BC3 block, which is always four colors.
+	static void GetColorPalette(uint16_t packed0, uint16_t packed1, bool fourColorsOnly, glm::vec4 palette[4])
+	{
+		palette[0] = UnpackRGB565(packed0);
+		palette[1] = UnpackRGB565(packed1);
+		if (packed0 > packed1 || fourColorsOnly)
+		{
+			palette[2] = glm::floor((2.0f * palette[0] + palette[1]) / 3.0f);
+			palette[3] = glm::floor((palette[0] + 2.0f * palette[1]) / 3.0f);
+		}
+		else
+		{
+			palette[2] = glm::floor((palette[0] + palette[1]) / 2.0f);
+			palette[3] = glm::vec4(0.0f);
+		}
+	}
+
+	// Writes the 8 byte color block of BC1 and BC3, always with four colors so it decodes the same in either.
+	static void EncodeColorBlock(const glm::vec4* texels, uint8_t* out)
+	{
+		// Alpha is left out of the fit and the error.
+		glm::vec4 Colors[16];
+		for (uint32_t i = 0; i < 16; i++)
+			Colors[i] = glm::vec4(texels[i].r, texels[i].g, texels[i].b, 255.0f);
+
+		glm::vec4 Start, End;
+		GetPrincipalEndpoints(Colors, Start, End);
+
+		constexpr float PaletteWeights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+		uint16_t BestPacked[2] = {};
+		uint8_t BestIndices[16] = {};
+		float BestError = std::numeric_limits<float>::max();
+		for (uint32_t Attempt = 0; Attempt < 2; Attempt++)
+		{
+			uint16_t Packed0 = PackRGB565(Start);
+			uint16_t Packed1 = PackRGB565(End);
+			if (Packed0 < Packed1)
+				std::swap(Packed0, Packed1);
+
+			glm::vec4 Palette[4];
+			GetColorPalette(Packed0, Packed1, true, Palette);
+			uint8_t Indices[16];
+			const float Error = SelectIndices(Colors, Palette, Packed0 == Packed1 ? 1 : 4, Indices);
+			if (Error < BestError)
+			{
+				BestError = Error;
+				BestPacked[0] = Packed0;
+				BestPacked[1] = Packed1;
+				std::memcpy(BestIndices, Indices, sizeof(Indices));
+			}
+
+			float Weights[16];
+			for (uint32_t i = 0; i < 16; i++)
+				Weights[i] = PaletteWeights[Indices[i]];
+			if (Error == 0.0f || !FitEndpoints(Colors, Weights, Start, End))
+				break;
+		}
+
+		uint32_t PackedIndices = 0;
+		for (uint32_t i = 0; i < 16; i++)
+			PackedIndices |= static_cast<uint32_t>(BestIndices[i]) << (2 * i);
+
+		out[0] = static_cast<uint8_t>(BestPacked[0]);
+		out[1] = static_cast<uint8_t>(BestPacked[0] >> 8);
+		out[2] = static_cast<uint8_t>(BestPacked[1]);
+		out[3] = static_cast<uint8_t>(BestPacked[1] >> 8);
+		std::memcpy(out + 4, &PackedIndices, sizeof(PackedIndices));
+	}
+
+	static void DecodeColorBlock(const uint8_t* in, bool fourColorsOnly, glm::vec4 texels[16])
+	{
+		const uint16_t Packed0 = static_cast<uint16_t>(in[0] | (in[1] << 8));
+		const uint16_t Packed1 = static_cast<uint16_t>(in[2] | (in[3] << 8));
+		uint32_t PackedIndices;
+		std::memcpy(&PackedIndices, in + 4, sizeof(PackedIndices));
+
+		glm::vec4 Palette[4];
+		GetColorPalette(Packed0, Packed1, fourColorsOnly, Palette);
+		for (uint32_t i = 0; i < 16; i++)
+			texels[i] = Palette[(PackedIndices >> (2 * i)) & 3];
+	}
+
+	//-------------------------BC4 channels-------------------------//
+
+	// The values a BC4 block decodes to: eight between the endpoints when the first is larger, otherwise six between
+	// them plus 0 and 255.
+	static void GetChannelPalette(uint8_t endpoint0, uint8_t endpoint1, float palette[8])
+	{
+		const uint32_t A = endpoint0, B = endpoint1;
+		palette[0] = static_cast<float>(A);
+		palette[1] = static_cast<float>(B);
+		if (A > B)
+		{
+			for (uint32_t i = 1; i <= 6; i++)
+				palette[1 + i] = static_cast<float>(((7 - i) * A + i * B + 3) / 7);
+		}
+		else
+		{
+			for (uint32_t i = 1; i <= 4; i++)
+				palette[1 + i] = static_cast<float>(((5 - i) * A + i * B + 2) / 5);
+			palette[6] = 0.0f;
+			palette[7] = 255.0f;
+		}
+	}
+
+	static float SelectChannelIndices(const float* values, const float palette[8], uint8_t* indices)
+	{
+		float TotalError = 0.0f;
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			float BestError = std::numeric_limits<float>::max();
+			for (uint32_t Entry = 0; Entry < 8; Entry++)
+			{
+				const float Error = (values[i] - palette[Entry]) * (values[i] - palette[Entry]);
+				if (Error < BestError)
+				{
+					BestError = Error;
+					indices[i] = static_cast<uint8_t>(Entry);
+				}
+			}
+			TotalError += BestError;
+		}
+		return TotalError;
+	}
+
+	// Writes an 8 byte BC4 block: BC4 itself, BC3's alpha and each of BC5's channels.
+	static void EncodeChannelBlock(const float* values, uint8_t* out)
+	{
+		float Min = 255.0f, Max = 0.0f;
+		// Range of the values that 0 and 255 of the six value mode don't cover.
+		float InnerMin = 255.0f, InnerMax = 0.0f;
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			Min = glm::min(Min, values[i]);
+			Max = glm::max(Max, values[i]);
+			if (values[i] > 0.0f && values[i] < 255.0f)
+			{
+				InnerMin = glm::min(InnerMin, values[i]);
+				InnerMax = glm::max(InnerMax, values[i]);
+			}
+		}
+		if (InnerMin > InnerMax)
+			InnerMin = InnerMax = 0.0f;
+
+		const uint8_t Candidates[2][2] =
+		{
+			{ static_cast<uint8_t>(std::lround(Max)), static_cast<uint8_t>(std::lround(Min)) },
+			{ static_cast<uint8_t>(std::lround(InnerMin)), static_cast<uint8_t>(std::lround(InnerMax)) },
+		};
+
+		uint8_t BestIndices[16] = {};
+		uint32_t Best = 0;
+		float BestError = std::numeric_limits<float>::max();
+		for (uint32_t Candidate = 0; Candidate < 2; Candidate++)
+		{
+			float Palette[8];
+			GetChannelPalette(Candidates[Candidate][0], Candidates[Candidate][1], Palette);
+			uint8_t Indices[16];
+			const float Error = SelectChannelIndices(values, Palette, Indices);
+			if (Error < BestError)
+			{
+				BestError = Error;
+				Best = Candidate;
+				std::memcpy(BestIndices, Indices, sizeof(Indices));
+			}
+		}
+
+		out[0] = Candidates[Best][0];
+		out[1] = Candidates[Best][1];
+		uint64_t PackedIndices = 0;
+		for (uint32_t i = 0; i < 16; i++)
+			PackedIndices |= static_cast<uint64_t>(BestIndices[i]) << (3 * i);
+		for (uint32_t i = 0; i < 6; i++)
+			out[2 + i] = static_cast<uint8_t>(PackedIndices >> (8 * i));
+	}
+
+	static void DecodeChannelBlock(const uint8_t* in, float values[16])
+	{
+		float Palette[8];
+		GetChannelPalette(in[0], in[1], Palette);
+
+		uint64_t PackedIndices = 0;
+		for (uint32_t i = 0; i < 6; i++)
+			PackedIndices |= static_cast<uint64_t>(in[2 + i]) << (8 * i);
+		for (uint32_t i = 0; i < 16; i++)
+			values[i] = Palette[(PackedIndices >> (3 * i)) & 7];
+	}
+
+	//-------------------------BC7 mode 6-------------------------//
+
+	// Quantizes an endpoint to 7 bits a channel plus the low bit they share, trying both values of that bit.
+	static void QuantizeBC7Endpoint(const glm::vec4& endpoint, uint32_t quantized[4], uint32_t& lowBit)
+	{
+		float BestError = std::numeric_limits<float>::max();
+		for (uint32_t Bit = 0; Bit < 2; Bit++)
+		{
+			uint32_t Channels[4];
+			float Error = 0.0f;
+			for (uint32_t Channel = 0; Channel < 4; Channel++)
+			{
+				Channels[Channel] = static_cast<uint32_t>(std::clamp(std::lround((endpoint[Channel] - Bit) / 2.0f), 0l, 127l));
+				const float Reconstructed = static_cast<float>((Channels[Channel] << 1) | Bit);
+				Error += (Reconstructed - endpoint[Channel]) * (Reconstructed - endpoint[Channel]);
+			}
+
+			if (Error < BestError)
+			{
+				BestError = Error;
+				lowBit = Bit;
+				std::memcpy(quantized, Channels, sizeof(Channels));
+			}
+		}
+	}
+
+	static void GetBC7Palette(const uint32_t endpoint0[4], uint32_t lowBit0, const uint32_t endpoint1[4], uint32_t lowBit1, glm::vec4 palette[16])
+	{
+		for (uint32_t Entry = 0; Entry < 16; Entry++)
+		{
+			for (uint32_t Channel = 0; Channel < 4; Channel++)
+			{
+				const uint32_t A = (endpoint0[Channel] << 1) | lowBit0;
+				const uint32_t B = (endpoint1[Channel] << 1) | lowBit1;
+				palette[Entry][Channel] = static_cast<float>(((64 - BC7Weights[Entry]) * A + BC7Weights[Entry] * B + 32) >> 6);
+			}
+		}
+	}
+
+	static void EncodeBC7Block(const glm::vec4* texels, uint8_t* out)
+	{
+		glm::vec4 Start, End;
+		GetPrincipalEndpoints(texels, Start, End);
+
+		uint32_t BestEndpoints[2][4] = {}, BestLowBits[2] = {};
+		uint8_t BestIndices[16] = {};
+		float BestError = std::numeric_limits<float>::max();
+		for (uint32_t Attempt = 0; Attempt < 2; Attempt++)
+		{
+			uint32_t Endpoints[2][4], LowBits[2];
+			QuantizeBC7Endpoint(Start, Endpoints[0], LowBits[0]);
+			QuantizeBC7Endpoint(End, Endpoints[1], LowBits[1]);
+
+			glm::vec4 Palette[16];
+			GetBC7Palette(Endpoints[0], LowBits[0], Endpoints[1], LowBits[1], Palette);
+			uint8_t Indices[16];
+			const float Error = SelectIndices(texels, Palette, 16, Indices);
+			if (Error < BestError)
+			{
+				BestError = Error;
+				std::memcpy(BestEndpoints, Endpoints, sizeof(Endpoints));
+				std::memcpy(BestLowBits, LowBits, sizeof(LowBits));
+				std::memcpy(BestIndices, Indices, sizeof(Indices));
+			}
+
+			float Weights[16];
+			for (uint32_t i = 0; i < 16; i++)
+				Weights[i] = BC7Weights[Indices[i]] / 64.0f;
+			if (Error == 0.0f || !FitEndpoints(texels, Weights, Start, End))
+				break;
+		}
+
+		// The first texel's index is stored without its top bit, which must therefore be clear.
+		if (BestIndices[0] >= 8)
+		{
+			std::swap(BestEndpoints[0], BestEndpoints[1]);
+			std::swap(BestLowBits[0], BestLowBits[1]);
+			for (uint8_t& Index : BestIndices)
+				Index = static_cast<uint8_t>(15 - Index);
+		}
+
+		std::memset(out, 0, 16);
+		BitWriter Writer{ out };
+		Writer.Write(BC7Mode6, 7);
+		for (uint32_t Channel = 0; Channel < 4; Channel++)
+		{
+			Writer.Write(BestEndpoints[0][Channel], 7);
+			Writer.Write(BestEndpoints[1][Channel], 7);
+		}
+		Writer.Write(BestLowBits[0], 1);
+		Writer.Write(BestLowBits[1], 1);
+		Writer.Write(BestIndices[0], 3);
+		for (uint32_t i = 1; i < 16; i++)
+			Writer.Write(BestIndices[i], 4);
+	}
+
+	static void DecodeBC7Block(const uint8_t* in, glm::vec4 texels[16])
+	{
+		BitReader Reader{ in };
+		if (Reader.Read(7) != BC7Mode6)
+		{
+			for (uint32_t i = 0; i < 16; i++)
+				texels[i] = glm::vec4(0.0f, 0.0f, 0.0f, 255.0f);
+			return;
+		}
+
+		uint32_t Endpoints[2][4], LowBits[2];
+		for (uint32_t Channel = 0; Channel < 4; Channel++)
+		{
+			Endpoints[0][Channel] = Reader.Read(7);
+			Endpoints[1][Channel] = Reader.Read(7);
+		}
+		LowBits[0] = Reader.Read(1);
+		LowBits[1] = Reader.Read(1);
+
+		glm::vec4 Palette[16];
+		GetBC7Palette(Endpoints[0], LowBits[0], Endpoints[1], LowBits[1], Palette);
+		for (uint32_t i = 0; i < 16; i++)
+			texels[i] = Palette[Reader.Read(i == 0 ? 3 : 4)];
+	}
+
+	//-------------------------Images-------------------------//
+
+	static void EncodeBlock(ImageInternalFormat format, const glm::vec4 texels[16], uint8_t* out)
+	{
+		float Values[16];
+		switch (format)
+		{
+			case ImageInternalFormat::BC1:
+			{
+				EncodeColorBlock(texels, out);
+				break;
+			}
+			case ImageInternalFormat::BC3:
+			{
+				for (uint32_t i = 0; i < 16; i++)
+					Values[i] = texels[i].a;
+				EncodeChannelBlock(Values, out);
+				EncodeColorBlock(texels, out + 8);
+				break;
+			}
+			case ImageInternalFormat::BC4:
+			case ImageInternalFormat::BC5:
+			{
+				const uint32_t Channels = format == ImageInternalFormat::BC4 ? 1 : 2;
+				for (uint32_t Channel = 0; Channel < Channels; Channel++)
+				{
+					for (uint32_t i = 0; i < 16; i++)
+						Values[i] = texels[i][Channel];
+					EncodeChannelBlock(Values, out + 8 * Channel);
+				}
+				break;
+			}
+			case ImageInternalFormat::BC7:
+			{
+				EncodeBC7Block(texels, out);
+				break;
+			}
+			default: break;
+		}
+	}
+
+	static void DecodeBlock(ImageInternalFormat format, const uint8_t* in, glm::vec4 texels[16])
+	{
+		float Values[16];
+		switch (format)
+		{
+			case ImageInternalFormat::BC1:
+			{
+				DecodeColorBlock(in, false, texels);
+				break;
+			}
+			case ImageInternalFormat::BC3:
+			{
+				DecodeColorBlock(in + 8, true, texels);
+				DecodeChannelBlock(in, Values);
+				for (uint32_t i = 0; i < 16; i++)
+					texels[i].a = Values[i];
+				break;
+			}
+			case ImageInternalFormat::BC4:
+			case ImageInternalFormat::BC5:
+			{
+				for (uint32_t i = 0; i < 16; i++)
+					texels[i] = glm::vec4(0.0f, 0.0f, 0.0f, 255.0f);
+
+				const uint32_t Channels = format == ImageInternalFormat::BC4 ? 1 : 2;
+				for (uint32_t Channel = 0; Channel < Channels; Channel++)
+				{
+					DecodeChannelBlock(in + 8 * Channel, Values);
+					for (uint32_t i = 0; i < 16; i++)
+						texels[i][Channel] = Values[i];
+				}
+				break;
+			}
+			case ImageInternalFormat::BC7:
+			{
+				DecodeBC7Block(in, texels);
+				break;
+			}
+			default: break;
+		}
+	}
+
+	// Rows of blocks a ParallelFor chunk covers, so narrow mips don't become a job per row.
+	static uint32_t GetBlockRowsPerChunk(uint32_t blocksWide)
+	{
+		return glm::max(1u, MinBlocksPerChunk / blocksWide);
+	}
+
+	void BlockCompressor::Compress(ImageInternalFormat format, const uint8_t* rgba, uint32_t width, uint32_t height, uint8_t* out)
+	{
+		const uint32_t BlockBytes = TextureUtils::GetBytesPerBlock(format);
+		ASSERT(BlockBytes != 0, "Block Compressor: Format {} isn't block compressed.", static_cast<uint32_t>(format));
+
+		const uint32_t BlocksWide = (width + 3) / 4;
+		const uint32_t BlocksHigh = (height + 3) / 4;
+		JobSystem::ParallelFor(BlocksHigh, GetBlockRowsPerChunk(BlocksWide), [&](uint32_t begin, uint32_t end, uint32_t)
+			{
+				glm::vec4 Texels[16];
+				for (uint32_t BlockY = begin; BlockY < end; BlockY++)
+				{
+					for (uint32_t BlockX = 0; BlockX < BlocksWide; BlockX++)
+					{
+						for (uint32_t i = 0; i < 16; i++)
+						{
+							const uint32_t X = glm::min(BlockX * 4 + (i & 3), width - 1);
+							const uint32_t Y = glm::min(BlockY * 4 + (i >> 2), height - 1);
+							const uint8_t* Texel = rgba + (static_cast<size_t>(Y) * width + X) * 4;
+							Texels[i] = glm::vec4(Texel[0], Texel[1], Texel[2], Texel[3]);
+						}
+
+						EncodeBlock(format, Texels, out + (static_cast<size_t>(BlockY) * BlocksWide + BlockX) * BlockBytes);
+					}
+				}
+			});
+	}
+
+	void BlockCompressor::Decompress(ImageInternalFormat format, const uint8_t* blocks, uint32_t width, uint32_t height, uint8_t* rgba)
+	{
+		const uint32_t BlockBytes = TextureUtils::GetBytesPerBlock(format);
+		ASSERT(BlockBytes != 0, "Block Compressor: Format {} isn't block compressed.", static_cast<uint32_t>(format));
+
+		const uint32_t BlocksWide = (width + 3) / 4;
+		const uint32_t BlocksHigh = (height + 3) / 4;
+		JobSystem::ParallelFor(BlocksHigh, GetBlockRowsPerChunk(BlocksWide), [&](uint32_t begin, uint32_t end, uint32_t)
+			{
+				glm::vec4 Texels[16];
+				for (uint32_t BlockY = begin; BlockY < end; BlockY++)
+				{
+					for (uint32_t BlockX = 0; BlockX < BlocksWide; BlockX++)
+					{
+						DecodeBlock(format, blocks + (static_cast<size_t>(BlockY) * BlocksWide + BlockX) * BlockBytes, Texels);
+						for (uint32_t i = 0; i < 16; i++)
+						{
+							const uint32_t X = BlockX * 4 + (i & 3);
+							const uint32_t Y = BlockY * 4 + (i >> 2);
+							if (X >= width || Y >= height) continue;
+
+							uint8_t* Texel = rgba + (static_cast<size_t>(Y) * width + X) * 4;
+							for (uint32_t Channel = 0; Channel < 4; Channel++)
+								Texel[Channel] = static_cast<uint8_t>(Texels[i][Channel]);
+						}
+					}
+				}
+			});
+	}
+}
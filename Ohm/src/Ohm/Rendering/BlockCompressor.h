@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Ohm/Rendering/Utility/TextureUtils.h"
+
+namespace Ohm
+{
+	/*
+	 * CPU encoder for the block compressed formats of TextureUtils::ImageInternalFormat.  Every format stores 4x4
+	 * texels a block:
+	 *	BC1	RGB in 8 bytes.  Two 565 endpoints and four colors on the line between them.
+	 *	BC3	RGBA in 16 bytes.  A BC1 color block with a BC4 block for alpha.
+	 *	BC4	One channel in 8 bytes.  Two 8 bit endpoints and eight values between them.
+	 *	BC5	Two channels in 16 bytes.  A BC4 block each for red and green.
+	 *	BC7	RGBA in 16 bytes.  Only mode 6 is written: one endpoint pair of 7 bits a channel plus a shared low bit,
+	 *		and sixteen weights, which is better than BC1 and BC3 on anything but sharp two-color edges.
+	 *
+	 * Endpoints start at the extremes of a block along its principal axis and are refitted once by least squares to
+	 * the weights the texels picked; whichever of the two reconstructs the block better is kept.  Rows of blocks are
+	 * encoded in parallel on the job system.  A block only depends on its own texels, so the output doesn't depend
+	 * on the thread count.
+	 */
+	class BlockCompressor
+	{
+	public:
+		// rgba is width x height tightly packed RGBA8 texels.  Partial blocks at the right and bottom edges repeat
+		// the last column and row.  out must hold TextureUtils::GetCompressedImageSize bytes.
+		static void Compress(TextureUtils::ImageInternalFormat format, const uint8_t* rgba, uint32_t width, uint32_t height, uint8_t* out);
+		// The inverse, for measuring what compression lost.  Channels the format doesn't store come back as 0, and
+		// alpha as 255, as they sample.  BC7 blocks in modes other than 6 come back black.
+		static void Decompress(TextureUtils::ImageInternalFormat format, const uint8_t* blocks, uint32_t width, uint32_t height, uint8_t* rgba);
+	};
+}
@@ -9,7 +9,9 @@ namespace Ohm
 {
 	enum class ShaderDataType
 	{
-		None = 0, Float, Float2, Float3, Float4, Int, Mat3, Mat4, Sampler2D, SamplerCube, Image2D, ImageCube
+		None = 0, Float, Float2, Float3, Float4, Int, Mat3, Mat4, Sampler2D, SamplerCube, Image2D, ImageCube,
+		// Vertex attribute storage only.  Combine with BufferElement's normalized flag to read them as [-1, 1].
+		Short2, Half2, Int10_10_10_2
 	};
 
 	static std::unordered_map<ShaderDataType, const char*> ShaderDataTypeToString =
@@ -25,6 +27,9 @@ namespace Ohm
 		{ShaderDataType::SamplerCube,	"samplerCube"},
 		{ShaderDataType::Image2D,		"image2D"},
 		{ShaderDataType::ImageCube,		"imageCube"},
+		{ShaderDataType::Short2,		"vec2"},
+		{ShaderDataType::Half2,			"vec2"},
+		{ShaderDataType::Int10_10_10_2,	"vec4"},
 	};
 
 	static uint32_t ShaderDataTypeSize(ShaderDataType type)
@@ -43,6 +48,9 @@ namespace Ohm
 			case ShaderDataType::ImageCube:
 			case ShaderDataType::SamplerCube:
 			case ShaderDataType::Sampler2D:	return 3 * 4;
+			case ShaderDataType::Short2:	return 2 * 2;
+			case ShaderDataType::Half2:		return 2 * 2;
+			case ShaderDataType::Int10_10_10_2: return 4;
 			default:						return 0;
 		}
 	}
@@ -54,12 +62,17 @@ namespace Ohm
 		uint32_t Size;
 		uint32_t Offset;
 		bool Normalized;
+		// Attribute location; by default the one after the previous element's.
+		uint32_t Location = UINT32_MAX;
 
 		BufferElement() = default;
 
 		BufferElement(std::string name, ShaderDataType type, bool normalized = false)
 			:Name(std::move(name)), Type(type), Size(ShaderDataTypeSize(type)), Offset(0), Normalized(normalized) { }
 
+		BufferElement(std::string name, ShaderDataType type, bool normalized, uint32_t location)
+			:Name(std::move(name)), Type(type), Size(ShaderDataTypeSize(type)), Offset(0), Normalized(normalized), Location(location) { }
+
 		uint32_t GetComponentCount() const
 		{
 			switch (Type)
@@ -71,6 +84,9 @@ namespace Ohm
 				case ShaderDataType::Int:		return 1;
 				case ShaderDataType::Mat3:		return 3 * 3;
 				case ShaderDataType::Mat4:		return 4 * 4;
+				case ShaderDataType::Short2:	return 2;
+				case ShaderDataType::Half2:		return 2;
+				case ShaderDataType::Int10_10_10_2: return 4;
 				default:						return 0;
 			}
 		}
@@ -48,24 +48,51 @@ namespace Ohm
     }
     EnvironmentMapPipeline::~EnvironmentMapPipeline() = default;
 
-    void EnvironmentMapPipeline::BuildFromBlackTextureCube() const
+    void EnvironmentMapPipeline::BuildFromBlackTextureCube()
     {
         m_Specification->PipelineType = EnvironmentPipelineType::BlackCube;
+        m_UnfilteredRadianceCube = {};
+        m_FilteredRadianceCube = {};
+        m_IrradianceCube = {};
     }
 
-    void EnvironmentMapPipeline::BuildFromShader(const std::string& CreationShaderName) const
+    void EnvironmentMapPipeline::BuildFromShader(const std::string& CreationShaderName)
     {
         m_Specification->PipelineType = EnvironmentPipelineType::FromShader;
         GenerateFromShader(CreationShaderName);
+        ResolveCubeHandles();
     }
 
-    void EnvironmentMapPipeline::BuildFromEquirectangularImage(const std::string& FilePath) const
+    void EnvironmentMapPipeline::BuildFromEquirectangularImage(const std::string& FilePath)
     {
         m_Specification->PipelineType = EnvironmentPipelineType::FromFile;
         GenerateFromFile(FilePath);
+        ResolveCubeHandles();
     }
 
-    void EnvironmentMapPipeline::GenerateFromFile(const std::string& filePath) const
+    const Ref<TextureCube>& EnvironmentMapPipeline::GetUnfilteredRadianceCube() const
+    {
+        return m_UnfilteredRadianceCube.IsValid() ? TextureLibrary::GetCube(m_UnfilteredRadianceCube) : TextureLibrary::GetBlackTextureCube();
+    }
+
+    const Ref<TextureCube>& EnvironmentMapPipeline::GetFilteredRadianceCube() const
+    {
+        return m_FilteredRadianceCube.IsValid() ? TextureLibrary::GetCube(m_FilteredRadianceCube) : TextureLibrary::GetBlackTextureCube();
+    }
+
+    const Ref<TextureCube>& EnvironmentMapPipeline::GetIrradianceCube() const
+    {
+        return m_IrradianceCube.IsValid() ? TextureLibrary::GetCube(m_IrradianceCube) : TextureLibrary::GetBlackTextureCube();
+    }
+
+    void EnvironmentMapPipeline::ResolveCubeHandles()
+    {
+        m_UnfilteredRadianceCube = TextureLibrary::GetCubeHandle(m_Specification->GetUnfilteredCubeName());
+        m_FilteredRadianceCube = TextureLibrary::GetCubeHandle(m_Specification->GetFilteredCubeName());
+        m_IrradianceCube = TextureLibrary::GetCubeHandle(m_Specification->GetIrradianceCubeName());
+    }
+
+    void EnvironmentMapPipeline::GenerateFromFile(const std::string& filePath)
     {
         OHM_CORE_TRACE("-----Starting Environment Map Pipeline using file '{}'...-----", filePath);
         const Texture2DSpecification Specification
@@ -180,7 +207,7 @@ namespace Ohm
         OHM_CORE_TRACE("\t-----EnvironmentMapPipeline complete.  Radiance & Irradiance Maps are ready for use.-----");
     }
 
-    void EnvironmentMapPipeline::GenerateFromShader(const std::string& CreationShader) const
+    void EnvironmentMapPipeline::GenerateFromShader(const std::string& CreationShader)
     {
         OHM_CORE_TRACE("-----Starting Environment Map Pipeline using shader '{}'...-----", CreationShader);
 
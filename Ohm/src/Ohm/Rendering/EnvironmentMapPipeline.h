@@ -2,6 +2,7 @@
 #include <functional>
 #include <string>
 #include "TextureCube.h"
+#include "TextureLibrary.h"
 
 namespace Ohm
 {
@@ -56,17 +57,27 @@ namespace Ohm
         EnvironmentMapPipeline();
         ~EnvironmentMapPipeline();
 
-        void BuildFromBlackTextureCube() const;
-        void BuildFromShader(const std::string& CreationShaderName) const;
-        void BuildFromEquirectangularImage(const std::string& FilePath) const;
+        void BuildFromBlackTextureCube();
+        void BuildFromShader(const std::string& CreationShaderName);
+        void BuildFromEquirectangularImage(const std::string& FilePath);
         
         const EnvironmentMapSpecification& GetSpecification() const { return *m_Specification; }
         EnvironmentMapSpecification& GetSpecification() { return *m_Specification; }
+
+        // Resolved through handles taken when the maps were built, so the renderer never puts their names together.
+        // Until a map has been built, the Black TextureCube.
+        const Ref<TextureCube>& GetUnfilteredRadianceCube() const;
+        const Ref<TextureCube>& GetFilteredRadianceCube() const;
+        const Ref<TextureCube>& GetIrradianceCube() const;
         
     private:
-        void GenerateFromFile(const std::string& filePath) const;
-        void GenerateFromShader(const std::string& CreationShader) const;
+        void GenerateFromFile(const std::string& filePath);
+        void GenerateFromShader(const std::string& CreationShader);
+        void ResolveCubeHandles();
         Ref<EnvironmentMapSpecification> m_Specification;
+        TextureCubeHandle m_UnfilteredRadianceCube;
+        TextureCubeHandle m_FilteredRadianceCube;
+        TextureCubeHandle m_IrradianceCube;
     };
 }
 
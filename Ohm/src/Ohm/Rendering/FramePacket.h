@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Ohm/Rendering/EditorCamera.h"
+#include "Ohm/Rendering/Material.h"
+#include "Ohm/Rendering/Mesh.h"
+#include "Ohm/Rendering/EnvironmentMapPipeline.h"
+#include "Ohm/Rendering/RenderCommandBuffer.h"
+#include "Ohm/Rendering/IndirectDrawList.h"
+#include "Ohm/Rendering/MeshletDrawList.h"
+
+#include <glm/glm.hpp>
+
+namespace Ohm
+{
+	// Full keeps every intermediate target RGBA32F.  Reduced gives each pass the smallest format its data fits in.
+	enum class RenderTargetPrecision { Full = 0, Reduced };
+
+	// Where meshes with meshlets have them culled; Off draws them whole like any other mesh.
+	enum class MeshletCullingMode { Off = 0, CPU, GPU };
+
+	struct DirectionalLightData
+	{
+		glm::vec3 Radiance{ 1.0f };
+		float Intensity = 1.0f;
+		glm::vec3 Direction{ 0.0f, -1.0f, 0.0f };
+		float ShadowAmount = 1.0f;
+	};
+
+	struct EnvironmentLightData
+	{
+		Ref<EnvironmentMapPipeline> Pipeline;
+		EnvironmentPipelineType PipelineType = EnvironmentPipelineType::BlackCube;
+		std::string FromFileFilePath;
+		// Turbidity, azimuth and inclination of the Preetham sky.
+		glm::vec3 TAI{ 0.0f };
+		glm::vec3 SampleLODs{ 0.0f };
+		glm::vec3 SampleIntensities{ 1.0f };
+		// Set on the frame the environment maps have to be rebuilt.
+		bool NeedsUpdate = false;
+	};
+
+	// Everything the editor can change about how a frame is rendered.
+	struct SceneRenderSettings
+	{
+		float Exposure = 1.0f;
+		bool ApplyColorCorrection = true;
+		RenderTargetPrecision TargetPrecision = RenderTargetPrecision::Reduced;
+
+		bool BloomEnabled = true;
+		bool BloomDirtEnabled = true;
+		float BloomThreshold = 2.0f;
+		float BloomKnee = 0.220f;
+		float BloomIntensity = 0.2f;
+		float BloomDirtIntensity = 0.1f;
+
+		bool LODEnabled = true;
+		// Scales the screen size each LOD takes over at; above 1 switches to coarser LODs sooner.
+		float LODBias = 1.0f;
+
+		// Culls, selects LODs and builds the draws of the geometry pass on the GPU; see GPUDrivenQueue.
+		bool GPUDriven = false;
+
+		// Only applies off the GPU-driven path, to meshes drawn at LOD 0.
+		MeshletCullingMode MeshletCulling = MeshletCullingMode::CPU;
+		bool MeshletConeCulling = true;
+
+		// The texture viewer's targets are only kept alive while it's open.
+		bool TextureViewerVisible = true;
+	};
+
+	/*
+	 * Everything SceneRenderer needs to render one frame, copied out of the scene and the editor by the thread
+	 * that updates them.  Once built a packet is only ever read, so the thread rendering it never touches the
+	 * scene registry, the camera or the settings the UI is editing for the next frame.
+	 *
+	 * Materials are shared by reference through the command buffers' material tables; their parameters are guarded by
+	 * the material's own mutex.
+	 */
+	struct FramePacket
+	{
+		float ElapsedTime = 0.0f;
+		float DeltaTime = 0.0f;
+
+		EditorCamera Camera;
+		glm::vec2 ViewportSize{ 0.0f };
+
+		// Geometry that survived frustum culling, one buffer per recording thread.
+		std::vector<RenderCommandBuffer> GeometryCommands;
+		// All of the geometry, unculled, when the GPU-driven path is on; GeometryCommands is empty then.
+		IndirectDrawList IndirectGeometry;
+		// Visible geometry with meshlets, one list per recording thread, when meshlet culling is on.
+		std::vector<MeshletDrawList> MeshletGeometry;
+		uint32_t ObjectsTotal = 0;
+		uint32_t ObjectsVisible = 0;
+
+		DirectionalLightData DirectionalLight;
+		EnvironmentLightData EnvironmentLight;
+		SceneRenderSettings Settings;
+
+		// Texture viewer image to write to disk once the frame has rendered; -1 when there is none.
+		int32_t SaveImageIndex = -1;
+		std::string SaveImagePath;
+	};
+}
@@ -1,5 +1,6 @@
 #include "ohmpch.h"
 #include "Ohm/Rendering/Framebuffer.h"
+#include "Ohm/Rendering/RenderCommand.h"
 #include "Ohm/Rendering/Utility/TextureUtils.h"
 #include <glad/glad.h>
 
@@ -13,10 +14,15 @@ namespace Ohm
 		switch (format)
 		{
 			case FramebufferTextureFormat::RGBA32F:
+			case FramebufferTextureFormat::RGBA16F:
 			case FramebufferTextureFormat::RGBA8: 
 			{
 				return GL_RGBA;
 			}
+			case FramebufferTextureFormat::R11G11B10F:
+			{
+				return GL_RGB;
+			}
 			case FramebufferTextureFormat::RED_INTEGER: 
 			{
 				return GL_RED_INTEGER;
@@ -29,76 +35,83 @@ namespace Ohm
 		}
 	}
 
-	static void AttachColorTexture(uint32_t attachmentId, GLenum internalFormat, GLenum dataFormat, GLenum dataType, uint32_t width, uint32_t height, uint32_t index)
+	// Attachments are set up through their names; nothing here depends on which texture unit is active.
+	static void AttachColorTexture(uint32_t framebufferId, uint32_t attachmentId, GLenum internalFormat, uint32_t width, uint32_t height, uint32_t index)
 	{
 		uint32_t mips = TextureUtils::CalculateMipLevelCount(width, height);
 		glTextureStorage2D(attachmentId, mips, internalFormat, width, height);
-		glGenerateMipmap(GL_TEXTURE_2D);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + index, GL_TEXTURE_2D, attachmentId, 0);
+		glGenerateTextureMipmap(attachmentId);
+		glTextureParameteri(attachmentId, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTextureParameteri(attachmentId, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTextureParameteri(attachmentId, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(attachmentId, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(attachmentId, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		glNamedFramebufferTexture(framebufferId, GL_COLOR_ATTACHMENT0 + index, attachmentId, 0);
 	}
 
-	static void AttachDepthTexture(uint32_t attachmentId, GLenum internalFormat, GLenum depthAttachmentType, uint32_t width, uint32_t height)
+	static void AttachDepthTexture(uint32_t framebufferId, uint32_t attachmentId, GLenum internalFormat, GLenum depthAttachmentType, uint32_t width, uint32_t height)
 	{
-		glTexStorage2D(GL_TEXTURE_2D, 1, internalFormat, width, height);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTextureStorage2D(attachmentId, 1, internalFormat, width, height);
+		glTextureParameteri(attachmentId, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTextureParameteri(attachmentId, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTextureParameteri(attachmentId, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(attachmentId, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-		glFramebufferTexture2D(GL_FRAMEBUFFER, depthAttachmentType, GL_TEXTURE_2D, attachmentId, 0);
+		glNamedFramebufferTexture(framebufferId, depthAttachmentType, attachmentId, 0);
 	}
 
-	static void AttachLayeredDepthTarget(uint32_t AttachmentID, GLenum InternalFormat, uint32_t Width, uint32_t Height, uint32_t Layers)
+	static void AttachLayeredDepthTarget(uint32_t FramebufferID, uint32_t AttachmentID, GLenum InternalFormat, uint32_t Width, uint32_t Height, uint32_t Layers)
 	{
-		glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, InternalFormat, Width, Height, Layers, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+		glTextureStorage3D(AttachmentID, 1, InternalFormat, Width, Height, Layers);
+		glTextureParameteri(AttachmentID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTextureParameteri(AttachmentID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTextureParameteri(AttachmentID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+		glTextureParameteri(AttachmentID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
 		constexpr float BorderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-		glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, BorderColor);
-		glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, AttachmentID, 0);
+		glTextureParameterfv(AttachmentID, GL_TEXTURE_BORDER_COLOR, BorderColor);
+		glNamedFramebufferTexture(FramebufferID, GL_DEPTH_ATTACHMENT, AttachmentID, 0);
 	}
 
 	static bool IsDepthFormat(const FramebufferTextureFormat Format)
 	{
 		return Format == FramebufferTextureFormat::DEPTH24STENCIL8  || Format == FramebufferTextureFormat::DEPTH32F;
 	}
+
+	static GLenum ColorAttachmentInternalFormat(FramebufferTextureFormat format)
+	{
+		switch (format)
+		{
+			case FramebufferTextureFormat::RGBA8:		return GL_RGBA8;
+			case FramebufferTextureFormat::RGBA16F:		return GL_RGBA16F;
+			case FramebufferTextureFormat::RGBA32F:		return GL_RGBA32F;
+			case FramebufferTextureFormat::R11G11B10F:	return GL_R11F_G11F_B10F;
+			case FramebufferTextureFormat::RED_INTEGER:	return GL_R32I;
+			default:									return 0;
+		}
+	}
 	
 	Framebuffer::Framebuffer(FramebufferSpecification spec)
 		:m_Specification(std::move(spec))
 	{
-		for (auto textureFormatSpecification : m_Specification.AttachmentSpecification.FBOTextureSpecifications)
-		{
-			if (!IsDepthFormat(textureFormatSpecification.TextureFormat))
-				m_ColorAttachmentTextureSpecs.emplace_back(textureFormatSpecification);
-			else
-				m_DepthAttachmentTextureSpec = textureFormatSpecification;
-		}
-
-		Invalidate();
+		SetAttachments(m_Specification.AttachmentSpecification);
 	}
 
 	Framebuffer::~Framebuffer()
 	{
 		glDeleteFramebuffers(1, &m_ID);
+		RenderCommand::InvalidateStateCache();
 	}
 
 	void Framebuffer::Bind() const
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, m_ID);
+		RenderCommand::BindFramebuffer(m_ID);
 		glViewport(0, 0, m_Specification.Width, m_Specification.Height);
 	}
 
 	void Framebuffer::Unbind() const
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		RenderCommand::BindFramebuffer(0);
 	}
 
 	void Framebuffer::Invalidate()
@@ -108,13 +121,14 @@ namespace Ohm
 			glDeleteFramebuffers(1, &m_ID);
 			glDeleteTextures(m_ColorAttachmentIDs.size(), m_ColorAttachmentIDs.data());
 			glDeleteTextures(1, &m_DepthAttachmentID);
+			RenderCommand::InvalidateStateCache();
 
 			m_ColorAttachmentIDs.clear();
 			m_DepthAttachmentID = 0;
 		}
 
 		glCreateFramebuffers(1, &m_ID);
-		glBindFramebuffer(GL_FRAMEBUFFER, m_ID);
+		RenderCommand::BindFramebuffer(m_ID);
 
 		if (!m_ColorAttachmentTextureSpecs.empty())
 		{
@@ -124,23 +138,31 @@ namespace Ohm
 
 			for (size_t i = 0; i < m_ColorAttachmentIDs.size(); i++)
 			{
-				glBindTexture(GL_TEXTURE_2D, m_ColorAttachmentIDs[i]);
-
 				switch (m_ColorAttachmentTextureSpecs[i].TextureFormat)
 				{
 					case FramebufferTextureFormat::RGBA8:
 					{
-						AttachColorTexture(m_ColorAttachmentIDs[i], GL_RGBA8, GL_RGBA, GL_UNSIGNED_INT, m_Specification.Width, m_Specification.Height, i);
+						AttachColorTexture(m_ID, m_ColorAttachmentIDs[i], GL_RGBA8, m_Specification.Width, m_Specification.Height, i);
+						break;
+					}
+					case FramebufferTextureFormat::RGBA16F:
+					{
+						AttachColorTexture(m_ID, m_ColorAttachmentIDs[i], GL_RGBA16F, m_Specification.Width, m_Specification.Height, i);
 						break;
 					}
 					case FramebufferTextureFormat::RGBA32F:
 					{
-						AttachColorTexture(m_ColorAttachmentIDs[i], GL_RGBA32F, GL_RGBA, GL_FLOAT, m_Specification.Width, m_Specification.Height, i);
+						AttachColorTexture(m_ID, m_ColorAttachmentIDs[i], GL_RGBA32F, m_Specification.Width, m_Specification.Height, i);
+						break;
+					}
+					case FramebufferTextureFormat::R11G11B10F:
+					{
+						AttachColorTexture(m_ID, m_ColorAttachmentIDs[i], GL_R11F_G11F_B10F, m_Specification.Width, m_Specification.Height, i);
 						break;
 					}
 					case FramebufferTextureFormat::RED_INTEGER:
 					{
-						AttachColorTexture(m_ColorAttachmentIDs[i], GL_R32I, GL_RED_INTEGER, GL_INT, m_Specification.Width, m_Specification.Height, i);
+						AttachColorTexture(m_ID, m_ColorAttachmentIDs[i], GL_R32I, m_Specification.Width, m_Specification.Height, i);
 						break;
 					}
 				default: break;
@@ -153,18 +175,16 @@ namespace Ohm
 			if(m_Specification.IsLayered)
 			{
 				glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_DepthAttachmentID);
-				glBindTexture(GL_TEXTURE_2D_ARRAY, m_DepthAttachmentID);
-				AttachLayeredDepthTarget(m_DepthAttachmentID, GL_DEPTH_COMPONENT32F, m_Specification.Width, m_Specification.Height, m_Specification.Layers);
+				AttachLayeredDepthTarget(m_ID, m_DepthAttachmentID, GL_DEPTH_COMPONENT32F, m_Specification.Width, m_Specification.Height, m_Specification.Layers);
 			}
 			else
 			{
 				glCreateTextures(GL_TEXTURE_2D, 1, &m_DepthAttachmentID);
-				glBindTexture(GL_TEXTURE_2D, m_DepthAttachmentID);
 
 				if(m_DepthAttachmentTextureSpec.TextureFormat == FramebufferTextureFormat::DEPTH24STENCIL8)
-					AttachDepthTexture(m_DepthAttachmentID, GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL_ATTACHMENT, m_Specification.Width, m_Specification.Height);
+					AttachDepthTexture(m_ID, m_DepthAttachmentID, GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL_ATTACHMENT, m_Specification.Width, m_Specification.Height);
 				else if(m_DepthAttachmentTextureSpec.TextureFormat == FramebufferTextureFormat::DEPTH32F)
-					AttachDepthTexture(m_DepthAttachmentID, GL_DEPTH_COMPONENT32F, GL_DEPTH_ATTACHMENT, m_Specification.Width, m_Specification.Height);
+					AttachDepthTexture(m_ID, m_DepthAttachmentID, GL_DEPTH_COMPONENT32F, GL_DEPTH_ATTACHMENT, m_Specification.Width, m_Specification.Height);
 			}
 		}
 
@@ -182,7 +202,7 @@ namespace Ohm
 
 		const bool CompleteFBO = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
 		ASSERT(CompleteFBO, "Framebuffer Incomplete.")
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		RenderCommand::BindFramebuffer(0);
 	}
 
 	void Framebuffer::Resize(uint32_t width, uint32_t height)
@@ -193,22 +213,37 @@ namespace Ohm
 		Invalidate();
 	}
 
+	void Framebuffer::SetAttachments(const FramebufferAttachmentSpecification& attachments)
+	{
+		m_Specification.AttachmentSpecification = attachments;
+		m_ColorAttachmentTextureSpecs.clear();
+		m_DepthAttachmentTextureSpec = { FramebufferTextureFormat::None };
+
+		for (auto textureFormatSpecification : m_Specification.AttachmentSpecification.FBOTextureSpecifications)
+		{
+			if (!IsDepthFormat(textureFormatSpecification.TextureFormat))
+				m_ColorAttachmentTextureSpecs.emplace_back(textureFormatSpecification);
+			else
+				m_DepthAttachmentTextureSpec = textureFormatSpecification;
+		}
+
+		Invalidate();
+	}
+
 	void Framebuffer::BindDepthTexture(uint32_t slot) const
 	{
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTextureUnit(slot, m_DepthAttachmentID);
+		RenderCommand::BindTextureUnit(slot, m_DepthAttachmentID);
 	}
 
 	void Framebuffer::BindColorAttachment(uint32_t index, uint32_t slot) const
 	{
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTextureUnit(slot, m_ColorAttachmentIDs[index]);
+		RenderCommand::BindTextureUnit(slot, m_ColorAttachmentIDs[index]);
 	}
 
 	void Framebuffer::BindColorAttachmentToImageSlot(uint32_t unit, uint32_t level, TextureUtils::TextureAccessLevel access, TextureUtils::TextureShaderDataFormat shaderDataFormat, uint32_t index) const
 	{
 		const GLenum glShaderDataFormat = ConvertShaderFormatType(shaderDataFormat);
-		const GLenum internalFormat = ConvertInternalFormatMode(TextureUtils::ImageInternalFormat::RGBA32F);
+		const GLenum internalFormat = ColorAttachmentInternalFormat(m_ColorAttachmentTextureSpecs[index].TextureFormat);
 
 		if (glShaderDataFormat != internalFormat)
 		{
@@ -216,13 +251,12 @@ namespace Ohm
 			return;
 		}
 
-		glBindImageTexture(unit, m_ColorAttachmentIDs[index], level, GL_FALSE, 0, ConvertTextureAccessLevel(access), ConvertShaderFormatType(shaderDataFormat));
+		RenderCommand::BindImageTexture(unit, m_ColorAttachmentIDs[index], level, false, 0, ConvertTextureAccessLevel(access), glShaderDataFormat);
 	}
 
 	void Framebuffer::UnbindColorAttachment(uint32_t index, uint32_t slot) const
 	{
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTextureUnit(slot, 0);
+		RenderCommand::BindTextureUnit(slot, 0);
 	}
 
 	void Framebuffer::ReadColorData(void* pixels, uint32_t attachmentIndex) const
@@ -241,6 +275,21 @@ namespace Ohm
 		glClearTexImage(texID, 0, format, GL_INT, &value);
 	}
 
+	uint32_t Framebuffer::GetBytesPerPixel(FramebufferTextureFormat format)
+	{
+		switch (format)
+		{
+			case FramebufferTextureFormat::RGBA8:			return 4;
+			case FramebufferTextureFormat::RGBA16F:			return 8;
+			case FramebufferTextureFormat::RGBA32F:			return 16;
+			case FramebufferTextureFormat::R11G11B10F:		return 4;
+			case FramebufferTextureFormat::RED_INTEGER:		return 4;
+			case FramebufferTextureFormat::DEPTH24STENCIL8:	return 4;
+			case FramebufferTextureFormat::DEPTH32F:		return 4;
+			default:										return 0;
+		}
+	}
+
 	uint32_t Framebuffer::GetColorAttachmentID(uint32_t index) const
 	{
 		ASSERT(index <= m_ColorAttachmentIDs.size(), "FBO Error: No color attachment at index: {}", index);
@@ -14,7 +14,10 @@ namespace Ohm
 	{
 		None = 0,
 		RGBA8,
+		RGBA16F,
 		RGBA32F,
+		// Packed unsigned float, no alpha.  A quarter of RGBA32F for HDR color that never goes negative.
+		R11G11B10F,
 		RED_INTEGER,
 		DEPTH24STENCIL8,
 		DEPTH32F,
@@ -60,6 +63,7 @@ namespace Ohm
 
 		void Invalidate();
 		void Resize(uint32_t width, uint32_t height);
+		void SetAttachments(const FramebufferAttachmentSpecification& attachments);
 
 		void BindDepthTexture(uint32_t slot = 0) const;
 		void BindColorAttachment(uint32_t index = 0, uint32_t slot = 0) const;
@@ -76,15 +80,17 @@ namespace Ohm
 		const FramebufferSpecification& GetFramebufferSpecification() const { return m_Specification; }
 		glm::vec2 GetCurrentSize() { return {m_Specification.Width, m_Specification.Height}; }
 		bool SaveAttachmentAsEXR(const std::string& fileName, uint32_t attachmentIndex);
+
+		static uint32_t GetBytesPerPixel(FramebufferTextureFormat format);
 		
 	private:
 		FramebufferSpecification m_Specification;
-		uint32_t m_ID;
+		uint32_t m_ID = 0;
 
 		std::vector<FramebufferTextureSpecification> m_ColorAttachmentTextureSpecs;
 		std::vector<uint32_t> m_ColorAttachmentIDs;
 
 		FramebufferTextureSpecification m_DepthAttachmentTextureSpec{ FramebufferTextureFormat::None };
-		uint32_t m_DepthAttachmentID;
+		uint32_t m_DepthAttachmentID = 0;
 	};
 }
\ No newline at end of file
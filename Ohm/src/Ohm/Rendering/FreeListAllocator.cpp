@@ -0,0 +1,101 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/FreeListAllocator.h"
+
+namespace Ohm
+{
+	FreeListAllocator::FreeListAllocator(uint32_t capacity)
+	{
+		Reset(capacity);
+	}
+
+	void FreeListAllocator::Reset(uint32_t capacity)
+	{
+		m_FreeByOffset.clear();
+		m_FreeBySize.clear();
+		m_Capacity = capacity;
+		m_Used = 0;
+		if (capacity > 0)
+			InsertFreeBlock(0, capacity);
+	}
+
+	uint32_t FreeListAllocator::Allocate(uint32_t size)
+	{
+		ASSERT(size > 0, "Free List Allocator: Can't allocate an empty range.");
+
+		const auto BestFit = m_FreeBySize.lower_bound(size);
+		if (BestFit == m_FreeBySize.end())
+			return InvalidOffset;
+
+		const uint32_t BlockOffset = BestFit->second;
+		const uint32_t BlockSize = BestFit->first;
+		EraseFreeBlock(m_FreeByOffset.find(BlockOffset));
+
+		// The remainder stays free, behind the allocation.
+		if (BlockSize > size)
+			InsertFreeBlock(BlockOffset + size, BlockSize - size);
+
+		m_Used += size;
+		return BlockOffset;
+	}
+
+	void FreeListAllocator::Free(uint32_t offset, uint32_t size)
+	{
+		ASSERT(offset + size <= m_Capacity && size <= m_Used, "Free List Allocator: Freed range {}+{} was never allocated.", offset, size);
+		m_Used -= size;
+
+		uint32_t MergedOffset = offset;
+		uint32_t MergedSize = size;
+
+		const auto Next = m_FreeByOffset.lower_bound(offset);
+		if (Next != m_FreeByOffset.begin())
+		{
+			const auto Previous = std::prev(Next);
+			if (Previous->first + Previous->second == offset)
+			{
+				MergedOffset = Previous->first;
+				MergedSize += Previous->second;
+				EraseFreeBlock(Previous);
+			}
+		}
+
+		if (Next != m_FreeByOffset.end() && offset + size == Next->first)
+		{
+			MergedSize += Next->second;
+			EraseFreeBlock(Next);
+		}
+
+		InsertFreeBlock(MergedOffset, MergedSize);
+	}
+
+	void FreeListAllocator::Grow(uint32_t newCapacity)
+	{
+		if (newCapacity <= m_Capacity) return;
+
+		const uint32_t OldCapacity = m_Capacity;
+		m_Capacity = newCapacity;
+
+		// Freeing the new tail merges it with a free block that ends where the old capacity did.
+		m_Used += newCapacity - OldCapacity;
+		Free(OldCapacity, newCapacity - OldCapacity);
+	}
+
+	void FreeListAllocator::InsertFreeBlock(uint32_t offset, uint32_t size)
+	{
+		m_FreeByOffset.emplace(offset, size);
+		m_FreeBySize.emplace(size, offset);
+	}
+
+	void FreeListAllocator::EraseFreeBlock(std::map<uint32_t, uint32_t>::iterator block)
+	{
+		auto [First, Last] = m_FreeBySize.equal_range(block->second);
+		for (auto It = First; It != Last; ++It)
+		{
+			if (It->second == block->first)
+			{
+				m_FreeBySize.erase(It);
+				break;
+			}
+		}
+		m_FreeByOffset.erase(block);
+	}
+}
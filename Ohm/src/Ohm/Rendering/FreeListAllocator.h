@@ -0,0 +1,45 @@
+#pragma once
+
+#include <map>
+
+namespace Ohm
+{
+	/*
+	 * Hands out ranges of a linear space, in whatever unit the caller uses; it never touches the memory itself.
+	 *
+	 * Free blocks are tracked twice: by offset, so a freed range merges with the free blocks on either side of it,
+	 * and by size, so Allocate takes the smallest block that fits.  Both are O(log n) in the number of free blocks.
+	 * Not thread-safe.
+	 */
+	class FreeListAllocator
+	{
+	public:
+		static constexpr uint32_t InvalidOffset = UINT32_MAX;
+
+		FreeListAllocator(uint32_t capacity = 0);
+
+		// Returns InvalidOffset when no free block is large enough; Grow and try again.
+		uint32_t Allocate(uint32_t size);
+		// size must be what the range was allocated with.
+		void Free(uint32_t offset, uint32_t size);
+		// Adds free space at the end.  Allocated ranges keep their offsets.
+		void Grow(uint32_t newCapacity);
+		void Reset(uint32_t capacity);
+
+		uint32_t GetCapacity() const { return m_Capacity; }
+		uint32_t GetUsed() const { return m_Used; }
+		uint32_t GetFreeBlockCount() const { return static_cast<uint32_t>(m_FreeByOffset.size()); }
+		uint32_t GetLargestFreeBlock() const { return m_FreeBySize.empty() ? 0 : m_FreeBySize.rbegin()->first; }
+
+	private:
+		void InsertFreeBlock(uint32_t offset, uint32_t size);
+		void EraseFreeBlock(std::map<uint32_t, uint32_t>::iterator block);
+
+	private:
+		uint32_t m_Capacity = 0;
+		uint32_t m_Used = 0;
+		// Offset to size, and size to offset, of every free block.
+		std::map<uint32_t, uint32_t> m_FreeByOffset;
+		std::multimap<uint32_t, uint32_t> m_FreeBySize;
+	};
+}
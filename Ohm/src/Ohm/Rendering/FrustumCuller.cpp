@@ -0,0 +1,181 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/FrustumCuller.h"
+
+#if defined(__AVX__)
+	#include <immintrin.h>
+	#define OHM_CULL_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define OHM_CULL_SSE
+#endif
+
+namespace Ohm
+{
+#if defined(OHM_CULL_AVX)
+	static constexpr uint32_t s_LaneWidth = 8;
+#elif defined(OHM_CULL_SSE)
+	static constexpr uint32_t s_LaneWidth = 4;
+#else
+	static constexpr uint32_t s_LaneWidth = 1;
+#endif
+
+	void FrustumCuller::Begin(const glm::mat4& viewProjection)
+	{
+		// Gribb/Hartmann: each clip plane is the sum or difference of the matrix's fourth row and one of the others.
+		const glm::vec4 row0 = { viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0] };
+		const glm::vec4 row1 = { viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1] };
+		const glm::vec4 row2 = { viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2] };
+		const glm::vec4 row3 = { viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3] };
+
+		m_Planes[0] = row3 + row0;	// Left
+		m_Planes[1] = row3 - row0;	// Right
+		m_Planes[2] = row3 + row1;	// Bottom
+		m_Planes[3] = row3 - row1;	// Top
+		m_Planes[4] = row3 + row2;	// Near
+		m_Planes[5] = row3 - row2;	// Far
+
+		for (glm::vec4& plane : m_Planes)
+			plane /= glm::length(glm::vec3(plane));
+
+		m_Count = 0;
+		m_CenterX.clear(); m_CenterY.clear(); m_CenterZ.clear();
+		m_ExtentX.clear(); m_ExtentY.clear(); m_ExtentZ.clear();
+	}
+
+	uint32_t FrustumCuller::Submit(const AABB& localBounds, const glm::mat4& transform)
+	{
+		const uint32_t index = m_Count;
+		Resize(m_Count + 1);
+		Set(index, localBounds, transform);
+		return index;
+	}
+
+	void FrustumCuller::Resize(uint32_t count)
+	{
+		m_Count = count;
+		m_CenterX.resize(count); m_CenterY.resize(count); m_CenterZ.resize(count);
+		m_ExtentX.resize(count); m_ExtentY.resize(count); m_ExtentZ.resize(count);
+	}
+
+	void FrustumCuller::Set(uint32_t index, const AABB& localBounds, const glm::mat4& transform)
+	{
+		// Arvo's method: the world-space box around a transformed box is centered on the transformed center,
+		// with extents projected through the absolute value of the linear part of the transform.
+		const glm::vec3 center = transform * glm::vec4(localBounds.GetCenter(), 1.0f);
+		const glm::vec3 extents = localBounds.GetExtents();
+		const glm::mat3 absLinear = { glm::abs(glm::vec3(transform[0])), glm::abs(glm::vec3(transform[1])), glm::abs(glm::vec3(transform[2])) };
+		const glm::vec3 worldExtents = absLinear * extents;
+
+		m_CenterX[index] = center.x;
+		m_CenterY[index] = center.y;
+		m_CenterZ[index] = center.z;
+		m_ExtentX[index] = worldExtents.x;
+		m_ExtentY[index] = worldExtents.y;
+		m_ExtentZ[index] = worldExtents.z;
+	}
+
+	void FrustumCuller::CullScalar(uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; i++)
+		{
+			bool inside = true;
+			for (const glm::vec4& plane : m_Planes)
+			{
+				const float distance = plane.x * m_CenterX[i] + plane.y * m_CenterY[i] + plane.z * m_CenterZ[i] + plane.w;
+				const float radius = glm::abs(plane.x) * m_ExtentX[i] + glm::abs(plane.y) * m_ExtentY[i] + glm::abs(plane.z) * m_ExtentZ[i];
+				inside &= distance + radius >= 0.0f;
+			}
+
+			m_Visibility[i] = inside ? 1 : 0;
+		}
+	}
+
+	uint32_t FrustumCuller::Cull()
+	{
+		// Pad to a whole number of registers so the vector loop never needs a masked tail.
+		const uint32_t paddedCount = (m_Count + s_LaneWidth - 1) / s_LaneWidth * s_LaneWidth;
+		m_CenterX.resize(paddedCount); m_CenterY.resize(paddedCount); m_CenterZ.resize(paddedCount);
+		m_ExtentX.resize(paddedCount); m_ExtentY.resize(paddedCount); m_ExtentZ.resize(paddedCount);
+		m_Visibility.resize(paddedCount);
+
+		uint32_t i = 0;
+
+#if defined(OHM_CULL_AVX)
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 signMask = _mm256_set1_ps(-0.0f);
+		for (; i < paddedCount; i += s_LaneWidth)
+		{
+			const __m256 centerX = _mm256_loadu_ps(&m_CenterX[i]);
+			const __m256 centerY = _mm256_loadu_ps(&m_CenterY[i]);
+			const __m256 centerZ = _mm256_loadu_ps(&m_CenterZ[i]);
+			const __m256 extentX = _mm256_loadu_ps(&m_ExtentX[i]);
+			const __m256 extentY = _mm256_loadu_ps(&m_ExtentY[i]);
+			const __m256 extentZ = _mm256_loadu_ps(&m_ExtentZ[i]);
+
+			__m256 inside = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+			for (const glm::vec4& plane : m_Planes)
+			{
+				const __m256 nx = _mm256_set1_ps(plane.x);
+				const __m256 ny = _mm256_set1_ps(plane.y);
+				const __m256 nz = _mm256_set1_ps(plane.z);
+
+				__m256 distance = _mm256_add_ps(_mm256_mul_ps(centerX, nx), _mm256_set1_ps(plane.w));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(centerY, ny));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(centerZ, nz));
+
+				__m256 radius = _mm256_mul_ps(extentX, _mm256_andnot_ps(signMask, nx));
+				radius = _mm256_add_ps(radius, _mm256_mul_ps(extentY, _mm256_andnot_ps(signMask, ny)));
+				radius = _mm256_add_ps(radius, _mm256_mul_ps(extentZ, _mm256_andnot_ps(signMask, nz)));
+
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_GE_OQ));
+			}
+
+			const int mask = _mm256_movemask_ps(inside);
+			for (uint32_t lane = 0; lane < s_LaneWidth; lane++)
+				m_Visibility[i + lane] = (mask >> lane) & 1;
+		}
+#elif defined(OHM_CULL_SSE)
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		for (; i < paddedCount; i += s_LaneWidth)
+		{
+			const __m128 centerX = _mm_loadu_ps(&m_CenterX[i]);
+			const __m128 centerY = _mm_loadu_ps(&m_CenterY[i]);
+			const __m128 centerZ = _mm_loadu_ps(&m_CenterZ[i]);
+			const __m128 extentX = _mm_loadu_ps(&m_ExtentX[i]);
+			const __m128 extentY = _mm_loadu_ps(&m_ExtentY[i]);
+			const __m128 extentZ = _mm_loadu_ps(&m_ExtentZ[i]);
+
+			__m128 inside = _mm_cmpeq_ps(zero, zero);
+			for (const glm::vec4& plane : m_Planes)
+			{
+				const __m128 nx = _mm_set1_ps(plane.x);
+				const __m128 ny = _mm_set1_ps(plane.y);
+				const __m128 nz = _mm_set1_ps(plane.z);
+
+				__m128 distance = _mm_add_ps(_mm_mul_ps(centerX, nx), _mm_set1_ps(plane.w));
+				distance = _mm_add_ps(distance, _mm_mul_ps(centerY, ny));
+				distance = _mm_add_ps(distance, _mm_mul_ps(centerZ, nz));
+
+				__m128 radius = _mm_mul_ps(extentX, _mm_andnot_ps(signMask, nx));
+				radius = _mm_add_ps(radius, _mm_mul_ps(extentY, _mm_andnot_ps(signMask, ny)));
+				radius = _mm_add_ps(radius, _mm_mul_ps(extentZ, _mm_andnot_ps(signMask, nz)));
+
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+			}
+
+			const int mask = _mm_movemask_ps(inside);
+			for (uint32_t lane = 0; lane < s_LaneWidth; lane++)
+				m_Visibility[i + lane] = (mask >> lane) & 1;
+		}
+#endif
+
+		CullScalar(i, m_Count);
+
+		uint32_t visibleCount = 0;
+		for (uint32_t index = 0; index < m_Count; index++)
+			visibleCount += m_Visibility[index];
+
+		return visibleCount;
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Ohm/Rendering/AABB.h"
+
+#include <glm/glm.hpp>
+
+namespace Ohm
+{
+	/*
+	 * Tests world-space bounding boxes against the six planes of a view-projection matrix.
+	 *
+	 * Submitted bounds are transformed to world space on the way in and stored as a structure of arrays
+	 * (center and extent per axis), padded to the SIMD width, so Cull() tests a full register of boxes
+	 * against each plane at once.  AVX is used when the compiler targets it, SSE2 otherwise.
+	 */
+	class FrustumCuller
+	{
+	public:
+		void Begin(const glm::mat4& viewProjection);
+		// Returns the index used to query the result with IsVisible().
+		uint32_t Submit(const AABB& localBounds, const glm::mat4& transform);
+		// Alternative to Submit for filling the culler from several threads: size it once, then Set each index.
+		void Resize(uint32_t count);
+		void Set(uint32_t index, const AABB& localBounds, const glm::mat4& transform);
+		// Returns the number of visible bounds.
+		uint32_t Cull();
+
+		bool IsVisible(uint32_t index) const { return m_Visibility[index] != 0; }
+		uint32_t GetCount() const { return m_Count; }
+
+	private:
+		void CullScalar(uint32_t begin, uint32_t end);
+
+		glm::vec4 m_Planes[6];
+		uint32_t m_Count = 0;
+
+		std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+		std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+		std::vector<uint8_t> m_Visibility;
+	};
+}
@@ -0,0 +1,110 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/GPUDrivenQueue.h"
+#include "Ohm/Rendering/Renderer.h"
+
+#include <glad/glad.h>
+
+namespace Ohm
+{
+	// Storage buffer bindings of GPUCulling.shader; 0 is the renderer's instance buffer.
+	static constexpr uint32_t ObjectBinding = 1;
+	static constexpr uint32_t GroupBinding = 2;
+	static constexpr uint32_t CommandBinding = 3;
+	static constexpr uint32_t SlotBinding = 4;
+	static constexpr uint32_t ResultBinding = 5;
+
+	// Dispatches of GPUCulling.shader, in order.
+	enum CullingStage : int { CullObjects = 0, AssignInstances, WriteInstances };
+
+	static constexpr uint32_t InitialObjectCapacity = 4096;
+	static constexpr uint32_t InitialCommandCapacity = 256;
+
+	GPUDrivenQueue::GPUDrivenQueue()
+	{
+		m_ObjectBuffer = CreateRef<StorageBuffer>(sizeof(IndirectDrawObject) * InitialObjectCapacity, ObjectBinding);
+		m_GroupBuffer = CreateRef<StorageBuffer>(sizeof(IndirectDrawGroup) * InitialCommandCapacity, GroupBinding);
+		m_CommandBuffer = CreateRef<StorageBuffer>(sizeof(DrawElementsIndirectCommand) * InitialCommandCapacity, CommandBinding);
+		m_SlotBuffer = CreateRef<StorageBuffer>(sizeof(glm::uvec2) * InitialObjectCapacity, SlotBinding);
+		m_Results = CreateScope<ReadbackRing>(sizeof(CullingResults), ResultBinding);
+
+		m_CullingShader = ShaderLibrary::Get("GPUCulling");
+		m_Uniforms.Stage = m_CullingShader->GetUniformHandle("u_Stage");
+		m_Uniforms.ObjectCount = m_CullingShader->GetUniformHandle("u_ObjectCount");
+		m_Uniforms.CommandCount = m_CullingShader->GetUniformHandle("u_CommandCount");
+		m_Uniforms.ViewProjection = m_CullingShader->GetUniformHandle("u_ViewProjection");
+		m_Uniforms.CameraPosition = m_CullingShader->GetUniformHandle("u_CameraPosition");
+		m_Uniforms.TanHalfFOV = m_CullingShader->GetUniformHandle("u_TanHalfFOV");
+		m_Uniforms.LODBias = m_CullingShader->GetUniformHandle("u_LODBias");
+		m_Uniforms.SelectLODs = m_CullingShader->GetUniformHandle("u_SelectLODs");
+	}
+
+	void GPUDrivenQueue::RecordPreviousResults()
+	{
+		// Only the newest finished frame is recorded, so the statistics stay one frame's worth.
+		CullingResults Results;
+		uint32_t NewestSlot = ReadbackRing::NoSlot;
+		for (uint32_t Slot = m_Results->ReadFinished(&Results); Slot != ReadbackRing::NoSlot; Slot = m_Results->ReadFinished(&Results))
+			NewestSlot = Slot;
+		if (NewestSlot == ReadbackRing::NoSlot) return;
+
+		Renderer::RecordCullingResults(m_ObjectCounts[NewestSlot], Results.VisibleObjects);
+		Renderer::RecordIndirectDrawResults(Results.VisibleObjects, Results.TrianglesPerLOD);
+	}
+
+	void GPUDrivenQueue::Flush(const IndirectDrawList& drawList, const EditorCamera& camera, bool selectLODs, float lodBias, const RenderQueuePreDrawFn& preDrawFn)
+	{
+		RecordPreviousResults();
+
+		const uint32_t ObjectCount = drawList.GetObjectCount();
+		if (ObjectCount == 0) return;
+
+		const std::vector<DrawElementsIndirectCommand>& Commands = drawList.GetCommands();
+		const uint32_t CommandCount = static_cast<uint32_t>(Commands.size());
+
+		// Commands go up with no instances; the culling dispatch counts them in.
+		m_ObjectBuffer->SetData(drawList.GetObjects().data(), ObjectCount * sizeof(IndirectDrawObject));
+		m_GroupBuffer->SetData(drawList.GetGroups().data(), static_cast<uint32_t>(drawList.GetGroups().size() * sizeof(IndirectDrawGroup)));
+		m_CommandBuffer->SetData(Commands.data(), CommandCount * sizeof(DrawElementsIndirectCommand));
+		if (m_SlotBuffer->GetSize() < ObjectCount * sizeof(glm::uvec2))
+			m_SlotBuffer->Resize(ObjectCount * sizeof(glm::uvec2));
+		RenderCommand::BindBufferBase(GL_SHADER_STORAGE_BUFFER, SlotBinding, m_SlotBuffer->GetID());
+		const CullingResults ClearedResults;
+		const uint32_t ResultSlot = m_Results->Begin(&ClearedResults);
+		m_ObjectCounts[ResultSlot] = ObjectCount;
+		Renderer::ReserveInstanceData(ObjectCount);
+
+		m_CullingShader->Bind();
+		m_CullingShader->UploadUniformInt(m_Uniforms.ObjectCount, static_cast<int>(ObjectCount));
+		m_CullingShader->UploadUniformInt(m_Uniforms.CommandCount, static_cast<int>(CommandCount));
+		m_CullingShader->UploadUniformMat4(m_Uniforms.ViewProjection, camera.GetViewProjection());
+		m_CullingShader->UploadUniformFloat3(m_Uniforms.CameraPosition, camera.GetPosition());
+		m_CullingShader->UploadUniformFloat(m_Uniforms.TanHalfFOV, glm::tan(glm::radians(camera.GetFOV()) * 0.5f));
+		m_CullingShader->UploadUniformFloat(m_Uniforms.LODBias, lodBias);
+		m_CullingShader->UploadUniformInt(m_Uniforms.SelectLODs, selectLODs ? 1 : 0);
+
+		const uint32_t ObjectGroups = (ObjectCount + WorkGroupSize - 1) / WorkGroupSize;
+
+		m_CullingShader->UploadUniformInt(m_Uniforms.Stage, CullObjects);
+		m_CullingShader->DispatchCompute(ObjectGroups, 1, 1);
+		m_CullingShader->EnableShaderStorageBarrierBit();
+
+		// Groups, and so commands, number in the tens; one invocation walks them all.
+		m_CullingShader->UploadUniformInt(m_Uniforms.Stage, AssignInstances);
+		m_CullingShader->DispatchCompute(1, 1, 1);
+		m_CullingShader->EnableShaderStorageBarrierBit();
+
+		m_CullingShader->UploadUniformInt(m_Uniforms.Stage, WriteInstances);
+		m_CullingShader->DispatchCompute(ObjectGroups, 1, 1);
+		m_CullingShader->EnableShaderStorageBarrierBit();
+		m_CullingShader->EnableCommandBarrierBit();
+		m_Results->End();
+
+		for (const IndirectDrawBatch& Batch : drawList.GetBatches())
+		{
+			std::lock_guard<std::mutex> Lock(Batch.BatchMaterial->GetMutex());
+			if (preDrawFn)
+				preDrawFn(Batch.BatchMaterial);
+			Renderer::DrawIndirect(Batch.Format, Batch.BatchMaterial, m_CommandBuffer->GetID(), Batch.FirstCommand, Batch.CommandCount);
+		}
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Ohm/Rendering/IndirectDrawList.h"
+#include "Ohm/Rendering/RenderQueue.h"
+#include "Ohm/Rendering/ReadbackRing.h"
+#include "Ohm/Rendering/StorageBuffer.h"
+#include "Ohm/Rendering/Shader.h"
+#include "Ohm/Rendering/EditorCamera.h"
+
+namespace Ohm
+{
+	/*
+	 * Draws an IndirectDrawList with culling and LOD selection done on the GPU.
+	 *
+	 * Objects, groups and draw commands are uploaded to storage buffers, then GPUCulling.shader runs in three
+	 * dispatches: the first frustum culls each object and picks its LOD the way Mesh::SelectLOD does, counting it
+	 * into that LOD's command; the second turns the counts into instance ranges; the third writes the visible
+	 * transforms into the renderer's instance buffer.  Each batch is then a single glMultiDrawElementsIndirect, so
+	 * the CPU cost no longer depends on how many objects there are.  Only core GL 4.5 and
+	 * ARB_shader_draw_parameters are used, so the path also runs on Mesa's llvmpipe.
+	 *
+	 * Visible object and triangle counts are read back through a ReadbackRing once the GPU is done with them,
+	 * usually a frame or two late.
+	 */
+	class GPUDrivenQueue
+	{
+	public:
+		static constexpr uint32_t WorkGroupSize = 64;
+
+		GPUDrivenQueue();
+
+		void Flush(const IndirectDrawList& drawList, const EditorCamera& camera, bool selectLODs, float lodBias, const RenderQueuePreDrawFn& preDrawFn = nullptr);
+
+	private:
+		void RecordPreviousResults();
+
+	private:
+		// std430 layout of the shader's result buffer.
+		struct CullingResults
+		{
+			uint32_t VisibleObjects = 0;
+			uint32_t TrianglesPerLOD[MaxMeshLODs]{};
+		};
+
+		Ref<StorageBuffer> m_ObjectBuffer;
+		Ref<StorageBuffer> m_GroupBuffer;
+		Ref<StorageBuffer> m_CommandBuffer;
+		Ref<StorageBuffer> m_SlotBuffer;
+		Scope<ReadbackRing> m_Results;
+
+		Ref<Shader> m_CullingShader;
+		struct
+		{
+			UniformHandle Stage;
+			UniformHandle ObjectCount;
+			UniformHandle CommandCount;
+			UniformHandle ViewProjection;
+			UniformHandle CameraPosition;
+			UniformHandle TanHalfFOV;
+			UniformHandle LODBias;
+			UniformHandle SelectLODs;
+		} m_Uniforms;
+
+		// Object count of the frame each result slot was written for.
+		uint32_t m_ObjectCounts[ReadbackRing::SlotCount]{};
+	};
+}
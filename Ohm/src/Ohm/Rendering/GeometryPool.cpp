@@ -0,0 +1,251 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/GeometryPool.h"
+#include "Ohm/Rendering/RenderCommand.h"
+
+#include <GLFW/glfw3.h>
+#include <glad/glad.h>
+
+namespace Ohm
+{
+	static BufferLayout CreateVertexLayout(VertexFormat vertexFormat)
+	{
+		if (vertexFormat == VertexFormat::Packed)
+		{
+			// Locations 1-4 are left to the full format, see VertexInput.glsl.
+			return BufferLayout
+			(
+				{
+					{ "a_Position", ShaderDataType::Float3 },
+					{ "a_PackedNormal", ShaderDataType::Short2, true, 5 },
+					{ "a_PackedTangent", ShaderDataType::Int10_10_10_2, true, 6 },
+					{ "a_PackedTexCoord", ShaderDataType::Half2, false, 7 }
+				}
+			);
+		}
+
+		return BufferLayout
+		(
+			{
+				{ "a_Position", ShaderDataType::Float3 },
+				{ "a_Normal",	ShaderDataType::Float3 },
+				{ "a_Tangent", ShaderDataType::Float3 },
+				{ "a_Binormal", ShaderDataType::Float3 },
+				{ "a_TexCoord", ShaderDataType::Float2 }
+			}
+		);
+	}
+
+	// Counted by EndFrame; ranges are stamped with it when they're freed.
+	static std::atomic<uint64_t> s_FrameIndex{ 0 };
+
+	GeometryPool& GeometryPool::Get(VertexFormat vertexFormat)
+	{
+		static GeometryPool s_FullPool(VertexFormat::Full);
+		static GeometryPool s_PackedPool(VertexFormat::Packed);
+		return vertexFormat == VertexFormat::Packed ? s_PackedPool : s_FullPool;
+	}
+
+	void GeometryPool::Shutdown()
+	{
+		Get(VertexFormat::Full).ReleaseBuffers();
+		Get(VertexFormat::Packed).ReleaseBuffers();
+	}
+
+	void GeometryPool::EndFrame()
+	{
+		const uint64_t FrameIndex = ++s_FrameIndex;
+		Get(VertexFormat::Full).ReclaimFreedRanges(FrameIndex);
+		Get(VertexFormat::Packed).ReclaimFreedRanges(FrameIndex);
+	}
+
+	void GeometryPool::ReclaimFreedRanges(uint64_t frameIndex)
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+
+		while (!m_FreedRanges.empty() && m_FreedRanges.front().FrameIndex + FramesBeforeReuse <= frameIndex)
+		{
+			const GeometryAllocation& Allocation = m_FreedRanges.front().Allocation;
+			m_VertexAllocator.Free(Allocation.BaseVertex, Allocation.VertexCount);
+			m_IndexAllocator.Free(Allocation.FirstIndex, Allocation.IndexCount);
+			m_FreedRanges.pop_front();
+		}
+	}
+
+	GeometryPool::GeometryPool(VertexFormat vertexFormat)
+		:m_VertexFormat(vertexFormat), m_Layout(CreateVertexLayout(vertexFormat))
+	{
+	}
+
+	void GeometryPool::CreateBuffers()
+	{
+		m_VertexAllocator.Reset(InitialVertexCapacity);
+		m_IndexAllocator.Reset(InitialIndexCapacity);
+
+		m_VertexBuffer = CreateRef<VertexBuffer>(InitialVertexCapacity * GetVertexStride());
+		m_VertexBuffer->SetLayout(m_Layout);
+		m_IndexBuffer = CreateRef<IndexBuffer>(InitialIndexCapacity);
+		m_BindingsDirty = true;
+	}
+
+	void GeometryPool::ReleaseBuffers()
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+
+		m_VertexArray.reset();
+		m_VertexBuffer.reset();
+		m_IndexBuffer.reset();
+		m_RetiredVertexBuffers.clear();
+		m_RetiredIndexBuffers.clear();
+		m_FreedRanges.clear();
+		m_VertexAllocator.Reset(0);
+		m_IndexAllocator.Reset(0);
+		m_AllocationCount = 0;
+		m_BindingsDirty = true;
+	}
+
+	void GeometryPool::GrowVertexBuffer(uint32_t vertexCount)
+	{
+		const uint32_t OldCapacity = m_VertexAllocator.GetCapacity();
+		const uint32_t NewCapacity = std::max(OldCapacity * 2, OldCapacity + vertexCount);
+		ASSERT(static_cast<uint64_t>(NewCapacity) * GetVertexStride() <= UINT32_MAX, "Geometry Pool: Vertex buffer would outgrow 4 GB.");
+
+		const Ref<VertexBuffer> Grown = CreateRef<VertexBuffer>(NewCapacity * GetVertexStride());
+		Grown->SetLayout(m_Layout);
+		glCopyNamedBufferSubData(m_VertexBuffer->GetID(), Grown->GetID(), 0, 0, static_cast<GLsizeiptr>(OldCapacity) * GetVertexStride());
+
+		m_RetiredVertexBuffers.push_back(m_VertexBuffer);
+		m_VertexBuffer = Grown;
+		m_VertexAllocator.Grow(NewCapacity);
+		m_GrowCount++;
+		m_BindingsDirty = true;
+		OHM_CORE_TRACE("Geometry Pool: Vertex buffer grown to {} vertices.", NewCapacity);
+	}
+
+	void GeometryPool::GrowIndexBuffer(uint32_t indexCount)
+	{
+		const uint32_t OldCapacity = m_IndexAllocator.GetCapacity();
+		const uint32_t NewCapacity = std::max(OldCapacity * 2, OldCapacity + indexCount);
+		ASSERT(static_cast<uint64_t>(NewCapacity) * sizeof(uint32_t) <= UINT32_MAX, "Geometry Pool: Index buffer would outgrow 4 GB.");
+
+		const Ref<IndexBuffer> Grown = CreateRef<IndexBuffer>(NewCapacity);
+		glCopyNamedBufferSubData(m_IndexBuffer->GetID(), Grown->GetID(), 0, 0, static_cast<GLsizeiptr>(OldCapacity) * sizeof(uint32_t));
+
+		m_RetiredIndexBuffers.push_back(m_IndexBuffer);
+		m_IndexBuffer = Grown;
+		m_IndexAllocator.Grow(NewCapacity);
+		m_GrowCount++;
+		m_BindingsDirty = true;
+		OHM_CORE_TRACE("Geometry Pool: Index buffer grown to {} indices.", NewCapacity);
+	}
+
+	GeometryAllocation GeometryPool::Allocate(uint32_t vertexCount, uint32_t indexCount)
+	{
+		ASSERT(vertexCount > 0 && indexCount > 0, "Geometry Pool: Meshes need vertices and indices.");
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+
+		if (!m_VertexBuffer)
+			CreateBuffers();
+
+		GeometryAllocation Allocation;
+		Allocation.VertexCount = vertexCount;
+		Allocation.IndexCount = indexCount;
+
+		Allocation.BaseVertex = m_VertexAllocator.Allocate(vertexCount);
+		if (Allocation.BaseVertex == FreeListAllocator::InvalidOffset)
+		{
+			GrowVertexBuffer(vertexCount);
+			Allocation.BaseVertex = m_VertexAllocator.Allocate(vertexCount);
+		}
+
+		Allocation.FirstIndex = m_IndexAllocator.Allocate(indexCount);
+		if (Allocation.FirstIndex == FreeListAllocator::InvalidOffset)
+		{
+			GrowIndexBuffer(indexCount);
+			Allocation.FirstIndex = m_IndexAllocator.Allocate(indexCount);
+		}
+
+		m_AllocationCount++;
+		return Allocation;
+	}
+
+	void GeometryPool::Free(const GeometryAllocation& allocation)
+	{
+		if (!allocation.IsValid()) return;
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+
+		// The buffers went away with Shutdown, and the allocation with them.
+		if (!m_VertexBuffer) return;
+
+		// Draws already recorded may still read the range, so it's only reused once EndFrame has reclaimed it.
+		m_FreedRanges.push_back({ allocation, s_FrameIndex.load() });
+		m_AllocationCount--;
+	}
+
+	void GeometryPool::UploadVertices(const GeometryAllocation& allocation, const void* vertices)
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		m_VertexBuffer->SetData(vertices, allocation.VertexCount * GetVertexStride(), allocation.BaseVertex * GetVertexStride());
+	}
+
+	void GeometryPool::UploadIndices(const GeometryAllocation& allocation, const uint32_t* indices)
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		m_IndexBuffer->SetData(indices, allocation.IndexCount, allocation.FirstIndex);
+	}
+
+	void GeometryPool::ReadVertices(const GeometryAllocation& allocation, void* vertices) const
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		m_VertexBuffer->GetData(vertices, allocation.VertexCount * GetVertexStride(), allocation.BaseVertex * GetVertexStride());
+	}
+
+	void GeometryPool::ReadIndices(const GeometryAllocation& allocation, uint32_t* indices, uint32_t count, uint32_t firstIndex) const
+	{
+		ASSERT(firstIndex + count <= allocation.IndexCount, "Geometry Pool: Read past the end of the allocation.");
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		m_IndexBuffer->GetData(indices, count, allocation.FirstIndex + firstIndex);
+	}
+
+	void GeometryPool::Bind()
+	{
+		if (m_BindingsDirty.load(std::memory_order_acquire))
+		{
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+
+			if (!m_VertexArray)
+			{
+				m_VertexArray = CreateRef<VertexArray>();
+				m_VertexArrayContext = glfwGetCurrentContext();
+			}
+
+			if (m_VertexBuffer)
+			{
+				m_VertexArray->EnableVertexAttributes(m_VertexBuffer);
+				m_VertexArray->SetIndexBuffer(m_IndexBuffer);
+			}
+
+			// Deleting them invalidates the state cache, so the vertex array is bound again below.
+			m_RetiredVertexBuffers.clear();
+			m_RetiredIndexBuffers.clear();
+			m_BindingsDirty = false;
+		}
+
+		ASSERT(glfwGetCurrentContext() == m_VertexArrayContext, "Geometry Pool: Bound on a context its vertex array doesn't exist in; draw through RenderThread::Enqueue.");
+		m_VertexArray->Bind();
+	}
+
+	GeometryPool::Statistics GeometryPool::GetStats() const
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+
+		Statistics Stats;
+		Stats.AllocationCount = m_AllocationCount;
+		Stats.FreeBlockCount = m_VertexAllocator.GetFreeBlockCount() + m_IndexAllocator.GetFreeBlockCount();
+		Stats.VertexBytesUsed = static_cast<uint64_t>(m_VertexAllocator.GetUsed()) * GetVertexStride();
+		Stats.VertexBytesCapacity = static_cast<uint64_t>(m_VertexAllocator.GetCapacity()) * GetVertexStride();
+		Stats.IndexBytesUsed = static_cast<uint64_t>(m_IndexAllocator.GetUsed()) * sizeof(uint32_t);
+		Stats.IndexBytesCapacity = static_cast<uint64_t>(m_IndexAllocator.GetCapacity()) * sizeof(uint32_t);
+		Stats.GrowCount = m_GrowCount;
+		return Stats;
+	}
+}
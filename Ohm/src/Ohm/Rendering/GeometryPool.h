@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Ohm/Rendering/VertexArray.h"
+#include "Ohm/Rendering/Vertex.h"
+#include "Ohm/Rendering/FreeListAllocator.h"
+
+namespace Ohm
+{
+	// A mesh's ranges of its pool's buffers, in vertices and indices.  Indices are relative to BaseVertex.
+	struct GeometryAllocation
+	{
+		uint32_t BaseVertex = 0;
+		uint32_t VertexCount = 0;
+		uint32_t FirstIndex = 0;
+		uint32_t IndexCount = 0;
+
+		bool IsValid() const { return VertexCount > 0; }
+	};
+
+	/*
+	 * Holds the vertices and indices of every mesh with the same vertex format in one vertex buffer and one index
+	 * buffer, bound to a single vertex array.  Meshes are drawn with a base vertex and first index into them, so going
+	 * from one mesh to the next doesn't change any binding, and a run of draws can be submitted as one multi-draw.
+	 *
+	 * Ranges come from a FreeListAllocator.  A full buffer is replaced with one at least twice its size and its
+	 * contents copied over on the GPU; allocations keep their offsets.  The vertex array isn't shared between GL
+	 * contexts, so it's created, and pointed at replaced buffers, by Bind on the context that draws; binding from any
+	 * other context asserts.  Allocating and uploading work from any thread with a context.
+	 */
+	class GeometryPool
+	{
+	public:
+		static constexpr uint32_t InitialVertexCapacity = 1 << 16;
+		static constexpr uint32_t InitialIndexCapacity = 1 << 18;
+		// Frames a freed range is held before it can be allocated again.  The render thread may still be replaying a
+		// frame that draws from it, and the GPU may be another frame or two behind.
+		static constexpr uint32_t FramesBeforeReuse = 3;
+
+		static GeometryPool& Get(VertexFormat vertexFormat);
+		// Deletes the GL objects of every pool.  Allocations still alive are forgotten.
+		static void Shutdown();
+		// Hands ranges freed FramesBeforeReuse frames ago back to the allocators.  Called once per frame.
+		static void EndFrame();
+
+		GeometryPool(VertexFormat vertexFormat);
+		GeometryPool(const GeometryPool&) = delete;
+
+		GeometryAllocation Allocate(uint32_t vertexCount, uint32_t indexCount);
+		void Free(const GeometryAllocation& allocation);
+
+		// vertices holds allocation.VertexCount vertices of the pool's format.
+		void UploadVertices(const GeometryAllocation& allocation, const void* vertices);
+		void UploadIndices(const GeometryAllocation& allocation, const uint32_t* indices);
+		// Read back from the GPU; they stall until it's done with the buffers.
+		void ReadVertices(const GeometryAllocation& allocation, void* vertices) const;
+		void ReadIndices(const GeometryAllocation& allocation, uint32_t* indices, uint32_t count, uint32_t firstIndex = 0) const;
+
+		void Bind();
+
+		VertexFormat GetVertexFormat() const { return m_VertexFormat; }
+		uint32_t GetVertexStride() const { return m_Layout.GetStride(); }
+
+		struct Statistics
+		{
+			uint32_t AllocationCount = 0;
+			uint32_t FreeBlockCount = 0;
+			uint64_t VertexBytesUsed = 0;
+			uint64_t VertexBytesCapacity = 0;
+			uint64_t IndexBytesUsed = 0;
+			uint64_t IndexBytesCapacity = 0;
+			// Buffers replaced by larger ones so far.
+			uint32_t GrowCount = 0;
+		};
+		Statistics GetStats() const;
+
+	private:
+		void CreateBuffers();
+		void GrowVertexBuffer(uint32_t vertexCount);
+		void GrowIndexBuffer(uint32_t indexCount);
+		void ReleaseBuffers();
+		void ReclaimFreedRanges(uint64_t frameIndex);
+
+	private:
+		VertexFormat m_VertexFormat;
+		BufferLayout m_Layout;
+
+		mutable std::mutex m_Mutex;
+		FreeListAllocator m_VertexAllocator;
+		FreeListAllocator m_IndexAllocator;
+		uint32_t m_AllocationCount = 0;
+		uint32_t m_GrowCount = 0;
+
+		struct FreedRange
+		{
+			GeometryAllocation Allocation;
+			uint64_t FrameIndex = 0;
+		};
+		// Freed, but not yet back in the allocators; oldest first.
+		std::deque<FreedRange> m_FreedRanges;
+
+		Ref<VertexBuffer> m_VertexBuffer;
+		Ref<IndexBuffer> m_IndexBuffer;
+		// Created by the first Bind; see the class comment.
+		Ref<VertexArray> m_VertexArray;
+		// The GLFW window whose context the vertex array was created in.
+		const void* m_VertexArrayContext = nullptr;
+		// Set when the buffers were replaced since the vertex array last pointed at them.
+		std::atomic<bool> m_BindingsDirty{ true };
+		// Replaced buffers, deleted once the vertex array no longer references them.
+		std::vector<Ref<VertexBuffer>> m_RetiredVertexBuffers;
+		std::vector<Ref<IndexBuffer>> m_RetiredIndexBuffers;
+	};
+}
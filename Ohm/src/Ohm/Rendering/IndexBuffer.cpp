@@ -1,39 +1,50 @@
 #include "ohmpch.h"
 #include "Ohm/Rendering/IndexBuffer.h"
+#include "Ohm/Rendering/RenderCommand.h"
 
 #include <glad/glad.h>
 
 
 namespace Ohm
 {
-	IndexBuffer::IndexBuffer(uint32_t* indices, uint32_t count)
+	IndexBuffer::IndexBuffer(const uint32_t* indices, uint32_t count)
 		:m_Count(count)
 	{
 		glCreateBuffers(1, &m_ID);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ID);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * count, indices, GL_STATIC_DRAW);
+		// DSA upload: binding GL_ELEMENT_ARRAY_BUFFER here would attach it to whichever vertex array is bound.
+		glNamedBufferData(m_ID, sizeof(uint32_t) * count, indices, GL_STATIC_DRAW);
 	}
 
 	IndexBuffer::IndexBuffer(uint32_t count)
 		:m_Count(count)
 	{
 		glCreateBuffers(1, &m_ID);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ID);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * count, nullptr, GL_DYNAMIC_DRAW);
+		glNamedBufferData(m_ID, sizeof(uint32_t) * count, nullptr, GL_DYNAMIC_DRAW);
 	}
 
 	IndexBuffer::~IndexBuffer()
 	{
 		glDeleteBuffers(1, &m_ID);
+		RenderCommand::InvalidateStateCache();
+	}
+
+	void IndexBuffer::SetData(const uint32_t* indices, uint32_t count, uint32_t firstIndex)
+	{
+		glNamedBufferSubData(m_ID, sizeof(uint32_t) * firstIndex, sizeof(uint32_t) * count, indices);
+	}
+
+	void IndexBuffer::GetData(uint32_t* indices, uint32_t count, uint32_t firstIndex) const
+	{
+		glGetNamedBufferSubData(m_ID, sizeof(uint32_t) * firstIndex, sizeof(uint32_t) * count, indices);
 	}
 
 	void IndexBuffer::Bind() const
 	{
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ID);
+		RenderCommand::BindIndexBuffer(m_ID);
 	}
 
 	void IndexBuffer::Unbind() const
 	{
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		RenderCommand::BindIndexBuffer(0);
 	}
 }
\ No newline at end of file
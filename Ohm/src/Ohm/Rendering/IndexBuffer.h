@@ -8,11 +8,14 @@ namespace Ohm
 	public:
 
 		IndexBuffer(uint32_t count);
-		IndexBuffer(uint32_t* indices, uint32_t count);
+		IndexBuffer(const uint32_t* indices, uint32_t count);
 		~IndexBuffer();
 
 		void Bind() const;
 		void Unbind() const;
+		void SetData(const uint32_t* indices, uint32_t count, uint32_t firstIndex = 0);
+		// Reads count indices back from firstIndex on; stalls until the GPU is done with the buffer.
+		void GetData(uint32_t* indices, uint32_t count, uint32_t firstIndex = 0) const;
 
 		uint32_t GetID() const { return m_ID; }
 		uint32_t GetIndexCount() const { return m_Count; }
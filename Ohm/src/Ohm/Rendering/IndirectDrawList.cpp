@@ -0,0 +1,87 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/IndirectDrawList.h"
+
+#include <tuple>
+
+namespace Ohm
+{
+	void IndirectDrawList::Clear()
+	{
+		m_Objects.clear();
+		m_Groups.clear();
+		m_Commands.clear();
+		m_Batches.clear();
+		m_GroupSources.clear();
+		m_GroupIndices.clear();
+		m_LastMesh = nullptr;
+		m_LastMaterial = nullptr;
+	}
+
+	void IndirectDrawList::Record(const Ref<Mesh>& mesh, const Ref<Material>& material, const glm::mat4& transform)
+	{
+		IndirectDrawObject& Object = m_Objects.emplace_back();
+		Object.Transform = transform;
+		Object.GroupIndex = GetGroupIndex(mesh, material);
+	}
+
+	uint32_t IndirectDrawList::GetGroupIndex(const Ref<Mesh>& mesh, const Ref<Material>& material)
+	{
+		if (mesh.get() == m_LastMesh && material.get() == m_LastMaterial)
+			return m_LastGroupIndex;
+
+		auto [It, Inserted] = m_GroupIndices.try_emplace({ mesh.get(), material.get() }, static_cast<uint32_t>(m_Groups.size()));
+		if (Inserted)
+		{
+			IndirectDrawGroup& Group = m_Groups.emplace_back();
+			const AABB& Bounds = mesh->GetBounds();
+			Group.BoundsCenter = glm::vec4((Bounds.Min + Bounds.Max) * 0.5f, 0.0f);
+			Group.BoundsExtent = glm::vec4((Bounds.Max - Bounds.Min) * 0.5f, 0.0f);
+			Group.LODCount = mesh->GetLODCount();
+			for (uint32_t i = 0; i < Group.LODCount; i++)
+				Group.LODScreenSizes[i] = mesh->GetLOD(i).ScreenSize;
+
+			m_GroupSources.emplace_back(mesh, material);
+		}
+
+		m_LastMesh = mesh.get();
+		m_LastMaterial = material.get();
+		m_LastGroupIndex = It->second;
+		return m_LastGroupIndex;
+	}
+
+	void IndirectDrawList::Finish()
+	{
+		// Groups keep their indices, objects refer to them; only their commands are laid out in material order.
+		std::vector<uint32_t> Order(m_Groups.size());
+		for (uint32_t i = 0; i < Order.size(); i++)
+			Order[i] = i;
+
+		const auto SortKey = [this](uint32_t group)
+		{
+			const auto& [GroupMesh, GroupMaterial] = m_GroupSources[group];
+			return std::make_tuple(GroupMaterial->GetShader()->GetID(), GroupMaterial->GetRuntimeID(), static_cast<uint32_t>(GroupMesh->GetVertexFormat()));
+		};
+		std::sort(Order.begin(), Order.end(), [&SortKey](uint32_t a, uint32_t b) { return SortKey(a) < SortKey(b); });
+
+		m_Commands.clear();
+		m_Batches.clear();
+		for (const uint32_t GroupIndex : Order)
+		{
+			const auto& [GroupMesh, GroupMaterial] = m_GroupSources[GroupIndex];
+			IndirectDrawGroup& Group = m_Groups[GroupIndex];
+			Group.FirstCommand = static_cast<uint32_t>(m_Commands.size());
+
+			const GeometryAllocation& Geometry = GroupMesh->GetGeometry();
+			for (uint32_t i = 0; i < Group.LODCount; i++)
+			{
+				const MeshLOD& LOD = GroupMesh->GetLOD(i);
+				m_Commands.push_back({ LOD.IndexCount, 0, Geometry.FirstIndex + LOD.IndexOffset, static_cast<int32_t>(Geometry.BaseVertex), 0 });
+			}
+
+			const bool Continues = !m_Batches.empty() && m_Batches.back().BatchMaterial == GroupMaterial && m_Batches.back().Format == GroupMesh->GetVertexFormat();
+			if (!Continues)
+				m_Batches.push_back({ GroupMaterial, GroupMesh->GetVertexFormat(), Group.FirstCommand, 0 });
+			m_Batches.back().CommandCount += Group.LODCount;
+		}
+	}
+}
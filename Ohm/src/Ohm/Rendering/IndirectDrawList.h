@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Ohm/Rendering/Material.h"
+#include "Ohm/Rendering/Mesh.h"
+#include "Ohm/Rendering/RenderCommand.h"
+
+#include <glm/glm.hpp>
+#include <map>
+
+namespace Ohm
+{
+	// std430 layouts of GPUCulling.shader's object and group buffers.
+	struct IndirectDrawObject
+	{
+		glm::mat4 Transform{ 1.0f };
+		uint32_t GroupIndex = 0;
+		uint32_t Padding[3]{};
+	};
+
+	// Every object drawing the same mesh with the same material.  Each of the mesh's LODs has a draw command, from
+	// FirstCommand on.
+	struct IndirectDrawGroup
+	{
+		// Local-space bounds of the mesh.
+		glm::vec4 BoundsCenter{ 0.0f };
+		glm::vec4 BoundsExtent{ 0.0f };
+		uint32_t FirstCommand = 0;
+		uint32_t LODCount = 0;
+		uint32_t Padding[2]{};
+		float LODScreenSizes[MaxMeshLODs]{};
+	};
+
+	// Consecutive commands that can go out as one multi-draw: same material, same geometry pool.
+	struct IndirectDrawBatch
+	{
+		Ref<Material> BatchMaterial;
+		VertexFormat Format = VertexFormat::Full;
+		uint32_t FirstCommand = 0;
+		uint32_t CommandCount = 0;
+	};
+
+	/*
+	 * The scene's geometry, before culling, for GPUDrivenQueue.  Recorded without touching GL, like a
+	 * RenderCommandBuffer, but visibility and LODs are left to the GPU: every object is recorded, and its group
+	 * gets a draw command per LOD with no instances yet.
+	 *
+	 * Finish orders the groups by material, so each batch's commands are contiguous.
+	 */
+	class IndirectDrawList
+	{
+	public:
+		void Clear();
+		void Record(const Ref<Mesh>& mesh, const Ref<Material>& material, const glm::mat4& transform);
+		void Finish();
+
+		const std::vector<IndirectDrawObject>& GetObjects() const { return m_Objects; }
+		const std::vector<IndirectDrawGroup>& GetGroups() const { return m_Groups; }
+		const std::vector<DrawElementsIndirectCommand>& GetCommands() const { return m_Commands; }
+		const std::vector<IndirectDrawBatch>& GetBatches() const { return m_Batches; }
+		uint32_t GetObjectCount() const { return static_cast<uint32_t>(m_Objects.size()); }
+
+	private:
+		uint32_t GetGroupIndex(const Ref<Mesh>& mesh, const Ref<Material>& material);
+
+	private:
+		std::vector<IndirectDrawObject> m_Objects;
+		std::vector<IndirectDrawGroup> m_Groups;
+		std::vector<DrawElementsIndirectCommand> m_Commands;
+		std::vector<IndirectDrawBatch> m_Batches;
+
+		// Mesh and material of each group, which also keep them alive until the list is rendered.
+		std::vector<std::pair<Ref<Mesh>, Ref<Material>>> m_GroupSources;
+		std::map<std::pair<const Mesh*, const Material*>, uint32_t> m_GroupIndices;
+
+		// Entities sharing a mesh and material tend to be recorded back to back.
+		const Mesh* m_LastMesh = nullptr;
+		const Material* m_LastMaterial = nullptr;
+		uint32_t m_LastGroupIndex = 0;
+	};
+}
@@ -8,6 +8,8 @@
 
 namespace Ohm
 {
+	std::atomic<uint32_t> Material::s_NextRuntimeID{ 0 };
+
 	Material::Material(std::string name, const Ref<Shader>& shader)
 		: m_Shader(shader), m_Name(std::move(name))
 	{
@@ -23,22 +25,17 @@ namespace Ohm
 
 	void Material::BindSamplerTexturesToRenderContext()
 	{
-		const std::vector<ShaderUniform> Sampler2DUniforms = m_Shader->GetBaseBlockUniformsOfType(ShaderDataType::Sampler2D);
-		for(const ShaderUniform& Uniform : Sampler2DUniforms)
+		for (const auto& [name, uniform] : m_Shader->GetBaseBlockUniforms())
 		{
-			const auto* TexUniform = Get<TextureUniform>(Uniform.GetName());
-			TextureLibrary::BindTextureToSlot(TexUniform->RendererID, TexUniform->TextureUnit);
-		}
+			if (uniform.GetType() != ShaderDataType::Sampler2D && uniform.GetType() != ShaderDataType::SamplerCube)
+				continue;
 
-		const std::vector<ShaderUniform> SamplerCubeUniforms = m_Shader->GetBaseBlockUniformsOfType(ShaderDataType::SamplerCube);
-		for(const ShaderUniform& Uniform : SamplerCubeUniforms)
-		{
-			const auto* TexUniform = Get<TextureUniform>(Uniform.GetName());
-			TextureLibrary::BindTextureToSlot(TexUniform->RendererID, TexUniform->TextureUnit);
+			const auto* texUniform = m_BaseBlockStorageBuffer.Read<TextureUniform>(uniform.GetBufferOffset());
+			TextureLibrary::BindTextureToSlot(texUniform->RendererID, texUniform->TextureUnit);
 		}
 	}
 
-	MaterialUniformData Material::GetMaterialUniformData()
+	MaterialUniformData Material::GetMaterialUniformData() const
 	{
 		MaterialUniformData data;
 
@@ -50,51 +47,44 @@ namespace Ohm
 			{
 			case ShaderDataType::Float:
 				{
-					float* value = Get<float>(uniformName);
+					const float* value = Get<float>(uniformName);
 					data.FloatUniforms[uniformName] = *value;
 					break;
 				}
 			case ShaderDataType::Float2:
 				{
-					glm::vec2* value = Get<glm::vec2>(uniformName);
+					const glm::vec2* value = Get<glm::vec2>(uniformName);
 					data.Vec2Uniforms[uniformName] = *value;
 					break;
 				}
 			case ShaderDataType::Float3:
 				{
-					glm::vec3* value = Get<glm::vec3>(uniformName);
+					const glm::vec3* value = Get<glm::vec3>(uniformName);
 					data.Vec3Uniforms[uniformName] = *value;
 					break;
 				}
 			case ShaderDataType::Float4:
 				{
-					glm::vec4* value = Get<glm::vec4>(uniformName);
+					const glm::vec4* value = Get<glm::vec4>(uniformName);
 					data.Vec4Uniforms[uniformName] = *value;
 					break;
 				}
 			case ShaderDataType::Sampler2D:
 			case ShaderDataType::SamplerCube:
 				{
-					TextureUniform* value = Get<TextureUniform>(uniformName);
+					const TextureUniform* value = Get<TextureUniform>(uniformName);
 					data.TextureUniforms[uniformName] = *value;
 					break;
 				}
 			case ShaderDataType::Int:
 				{
-					int* value = Get<int>(uniformName);
+					const int* value = Get<int>(uniformName);
 					data.IntUniforms[uniformName] = *value;
 					break;
 				}
 			case ShaderDataType::Mat3:
-				{
-					glm::mat3* value = Get<glm::mat3>(uniformName);
-					break;
-				}
 			case ShaderDataType::Mat4:
-				{
-					glm::mat4* value = Get<glm::mat4>(uniformName);
-					break;
-				}
+				break;
 			}
 		}
 
@@ -107,23 +97,31 @@ namespace Ohm
 
 		if (uniforms.empty()) return;
 
-		uint32_t bufferSize = 0;
-
-		for (auto& [name, uniform] : uniforms)
-			bufferSize += uniform.GetSize();
-
-		m_BaseBlockStorageBuffer.Allocate(bufferSize);
+		m_BaseBlockStorageBuffer.Allocate(m_Shader->GetBaseBlockStorageSize());
 		m_BaseBlockStorageBuffer.ZeroInitialize();
+
+		if (m_Shader->HasParameterBlock())
+			m_ParameterBuffer = CreateScope<UniformBuffer>(m_Shader->GetParameterBlockSize(), m_Shader->GetParameterBlockBinding());
 	}
 
-	void Material::InitializeBaseBlockStorageBufferWithUniformDefaults() const
+	void Material::InitializeBaseBlockStorageBufferWithUniformDefaults()
 	{
 		const auto& uniforms = m_Shader->GetBaseBlockUniforms();
 
 		if (uniforms.empty()) return;
 
+		if (m_Shader->HasParameterBlock())
+		{
+			const Buffer& defaults = m_Shader->GetParameterBlockDefaults();
+			m_BaseBlockStorageBuffer.Write<byte>(defaults.Data, defaults.Size, 0);
+			MarkParametersDirty();
+		}
+
 		for (auto& [name, uniform] : uniforms)
 		{
+			if (uniform.IsParameterBlockMember())
+				continue;
+
 			switch (uniform.GetType())
 			{
 			case ShaderDataType::Float:
@@ -151,14 +149,14 @@ namespace Ohm
 			case ShaderDataType::SamplerCube:
 				{
 					TextureUniform* data = (TextureUniform*)m_Shader->GetUniformData(uniform.GetType(), uniform.GetLocation());
-					data->RendererID = TextureLibrary::GetCube("Black TextureCube")->GetID();
+					data->RendererID = TextureLibrary::GetBlackTextureCube()->GetID();
 					m_BaseBlockStorageBuffer.Write<TextureUniform>(data, uniform.GetSize(), uniform.GetBufferOffset());
 					break;
 				}
 			case ShaderDataType::Sampler2D:
 				{
 					TextureUniform* data = (TextureUniform*)m_Shader->GetUniformData(uniform.GetType(), uniform.GetLocation());
-					data->RendererID = TextureLibrary::Get2D("White Texture")->GetID();
+					data->RendererID = TextureLibrary::GetWhiteTexture()->GetID();
 					m_BaseBlockStorageBuffer.Write<TextureUniform>(data, uniform.GetSize(), uniform.GetBufferOffset());
 					break;
 				}
@@ -180,70 +178,77 @@ namespace Ohm
 		return &uniforms.at(name);
 	}
 
-	void Material::UploadStagedUniforms()
+	uint32_t Material::UploadParameterBlock()
+	{
+		if (!m_ParameterBuffer)
+			return 0;
+
+		uint32_t uploadedBytes = 0;
+		if (m_DirtyBegin < m_DirtyEnd)
+		{
+			uploadedBytes = m_DirtyEnd - m_DirtyBegin;
+			m_ParameterBuffer->Update(static_cast<byte*>(m_BaseBlockStorageBuffer.Data) + m_DirtyBegin, uploadedBytes, m_DirtyBegin);
+			m_DirtyBegin = UINT32_MAX;
+			m_DirtyEnd = 0;
+		}
+
+		m_ParameterBuffer->BindRange(0, m_Shader->GetParameterBlockSize());
+		return uploadedBytes;
+	}
+
+	uint32_t Material::UploadStagedUniforms()
 	{
-		BindSamplerTexturesToRenderContext();
 		m_Shader->Bind();
-		for (auto& [name, uniform] : m_Shader->GetBaseBlockUniforms())
+		const uint32_t uploadedBytes = UploadParameterBlock();
+
+		// Values are read straight from the staging buffer by offset and uploaded through the shader's
+		// pre-resolved location table, so nothing here hashes a name or queries GL for a location.
+		for (const auto& [name, uniform] : m_Shader->GetBaseBlockUniforms())
 		{
-			std::string uniformName = uniform.GetName();
+			if (uniform.IsParameterBlockMember())
+				continue;
+
+			const uint32_t offset = uniform.GetBufferOffset();
+			const UniformHandle handle = uniform.GetHandle();
 
 			switch (uniform.GetType())
 			{
 			case ShaderDataType::Float:
-				{
-					float* value = Get<float>(uniformName);
-					m_Shader->UploadUniformFloat(uniformName, *value);
-					break;
-				}
+				m_Shader->UploadUniformFloat(handle, *m_BaseBlockStorageBuffer.Read<float>(offset));
+				break;
 			case ShaderDataType::Float2:
-				{
-					glm::vec2* value = Get<glm::vec2>(uniformName);
-					m_Shader->UploadUniformFloat2(uniformName, *value);
-					break;
-				}
+				m_Shader->UploadUniformFloat2(handle, *m_BaseBlockStorageBuffer.Read<glm::vec2>(offset));
+				break;
 			case ShaderDataType::Float3:
-				{
-					glm::vec3* value = Get<glm::vec3>(uniformName);
-					m_Shader->UploadUniformFloat3(uniformName, *value);
-					break;
-				}
+				m_Shader->UploadUniformFloat3(handle, *m_BaseBlockStorageBuffer.Read<glm::vec3>(offset));
+				break;
 			case ShaderDataType::Float4:
-				{
-					glm::vec4* value = Get<glm::vec4>(uniformName);
-					m_Shader->UploadUniformFloat4(uniformName, *value);
-					break;
-				}
+				m_Shader->UploadUniformFloat4(handle, *m_BaseBlockStorageBuffer.Read<glm::vec4>(offset));
+				break;
 			case ShaderDataType::SamplerCube:
 			case ShaderDataType::Sampler2D:
 				{
-					const TextureUniform* value = Get<TextureUniform>(uniformName);
-					m_Shader->UploadUniformInt(uniformName, value->TextureUnit);
+					const auto* value = m_BaseBlockStorageBuffer.Read<TextureUniform>(offset);
+					TextureLibrary::BindTextureToSlot(value->RendererID, value->TextureUnit);
+					m_Shader->UploadUniformInt(handle, value->TextureUnit);
 					break;
 				}
 			case ShaderDataType::Int:
-				{
-					int* value = Get<int>(uniformName);
-					m_Shader->UploadUniformInt(uniformName, *value);
-					break;
-				}
+				m_Shader->UploadUniformInt(handle, *m_BaseBlockStorageBuffer.Read<int>(offset));
+				break;
 			case ShaderDataType::Mat3:
-				{
-					glm::mat3* value = Get<glm::mat3>(uniformName);
-					m_Shader->UploadUniformMat3(uniformName, *value);
-					break;
-				}
+				m_Shader->UploadUniformMat3(handle, *m_BaseBlockStorageBuffer.Read<glm::mat3>(offset));
+				break;
 			case ShaderDataType::Mat4:
-				{
-					glm::mat4* value = Get<glm::mat4>(uniformName);
-					m_Shader->UploadUniformMat4(uniformName, *value);
-					break;
-				}
+				m_Shader->UploadUniformMat4(handle, *m_BaseBlockStorageBuffer.Read<glm::mat4>(offset));
+				break;
 			case ShaderDataType::Image2D:
 			case ShaderDataType::ImageCube:
 			case ShaderDataType::None:
 				break;
 			}
 		}
+
+		return uploadedBytes;
 	}
 }
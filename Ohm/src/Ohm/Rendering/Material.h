@@ -34,20 +34,53 @@ namespace Ohm
 
 		Ref<Shader> GetShader() const { return m_Shader; }
 		const std::string& GetName() const { return m_Name; }
+		uint32_t GetRuntimeID() const { return m_RuntimeID; }
 
-		void UploadStagedUniforms();
+		// Returns the number of parameter block bytes sent to the GPU by this call.
+		uint32_t UploadStagedUniforms();
 		void BindSamplerTexturesToRenderContext();
 
 		template<typename T>
 		void Set(const std::string& name, const T& data)
+		{
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			SetLocked(name, data);
+		}
+
+		// Set for code already holding GetMutex(), like a RenderQueuePreDrawFn.
+		template<typename T>
+		void SetLocked(const std::string& name, const T& data)
 		{
 			const auto* uniform = FindBaseBlockShaderUniform(name);
 			
 			if (uniform == nullptr)
 				return;
-			m_BaseBlockStorageBuffer.Write<T>((uint8_t*)&data, uniform->GetSize(), uniform->GetBufferOffset());
+			SetLocked(*uniform, data);
 		}
 
+		// For code that sets the same uniform every frame: the uniform is looked up once with
+		// FindBaseBlockShaderUniform on the material's shader, rather than by name on every call.
+		template<typename T>
+		void SetLocked(const ShaderUniform& uniform, const T& data)
+		{
+			m_BaseBlockStorageBuffer.Write<T>((uint8_t*)&data, uniform.GetSize(), uniform.GetBufferOffset());
+
+			if (uniform.IsParameterBlockMember())
+				MarkParametersDirty(uniform.GetBufferOffset(), uniform.GetSize());
+		}
+
+		// For code holding on to the pointer from Get<T> and writing through it later, like the material inspector.
+		void MarkParametersDirty(uint32_t offset, uint32_t size)
+		{
+			m_DirtyBegin = std::min(m_DirtyBegin, offset);
+			m_DirtyEnd = std::max(m_DirtyEnd, offset + size);
+		}
+		void MarkParametersDirty() { MarkParametersDirty(0, m_Shader->GetParameterBlockSize()); }
+
+		const void* GetParameterBlockData() const { return m_BaseBlockStorageBuffer.Data; }
+		uint32_t GetParameterBlockSize() const { return m_Shader->GetParameterBlockSize(); }
+
+		// The value is assumed to be written through the pointer, so a parameter block member is marked dirty.
 		template<typename T>
 		T* Get(const std::string& name)
 		{
@@ -55,7 +88,20 @@ namespace Ohm
 
 			if (uniform == nullptr)
 				return nullptr;
-		
+
+			if (uniform->IsParameterBlockMember())
+				MarkParametersDirty(uniform->GetBufferOffset(), uniform->GetSize());
+			return m_BaseBlockStorageBuffer.Read<T>(uniform->GetBufferOffset());
+		}
+
+		template<typename T>
+		const T* Get(const std::string& name) const
+		{
+			const auto* uniform = FindBaseBlockShaderUniform(name);
+
+			if (uniform == nullptr)
+				return nullptr;
+
 			return m_BaseBlockStorageBuffer.Read<T>(uniform->GetBufferOffset());
 		}
 
@@ -66,19 +112,44 @@ namespace Ohm
 		}
 
 		const ShaderUniform* FindBaseBlockShaderUniform(const std::string& name) const;
+		// fn(uint32_t rendererID) for each 2D texture the material samples, without collecting them first.
+		template<typename Fn>
+		void ForEachTexture2DID(Fn&& fn) const
+		{
+			for (const auto& [name, uniform] : m_Shader->GetBaseBlockUniforms())
+			{
+				if (uniform.GetType() == ShaderDataType::Sampler2D)
+					fn(m_BaseBlockStorageBuffer.Read<TextureUniform>(uniform.GetBufferOffset())->RendererID);
+			}
+		}
 		
-		MaterialUniformData GetMaterialUniformData();
+		MaterialUniformData GetMaterialUniformData() const;
 		void Bind() const { m_Shader->Bind(); }
 		void Unbind() const { m_Shader->Unbind(); }
 
+		// Held by the editor while it edits parameters and by the renderer while it uploads them, which happen on
+		// different threads when rendering has a thread of its own.
+		std::mutex& GetMutex() const { return m_Mutex; }
+
 	private:
 		void AllocateBaseBlockStorageBuffer();
-		void InitializeBaseBlockStorageBufferWithUniformDefaults() const;
+		void InitializeBaseBlockStorageBufferWithUniformDefaults();
+		uint32_t UploadParameterBlock();
 
 		Ref<Shader> m_Shader;
 		Buffer m_BaseBlockStorageBuffer;
 		std::unordered_map<std::string, Buffer> m_NamedBlockStorageBuffers;
+		// std140 copy of the shader's MaterialParameters block and the byte range not yet uploaded to it.
+		Scope<UniformBuffer> m_ParameterBuffer;
+		uint32_t m_DirtyBegin = UINT32_MAX;
+		uint32_t m_DirtyEnd = 0;
 		std::string m_Name;
+		mutable std::mutex m_Mutex;
+		// Dense per-process identifier, used for render queue sort keys.
+		uint32_t m_RuntimeID = s_NextRuntimeID++;
+
+		// Materials can be created from any thread, the render thread included.
+		static std::atomic<uint32_t> s_NextRuntimeID;
 
 		friend class SimpleEntity;
 	};
@@ -1,84 +1,244 @@
 #include "ohmpch.h"
 #include "Ohm/Rendering/Mesh.h"
+#include "Ohm/Rendering/MeshSimplifier.h"
+#include "Ohm/Rendering/TangentGenerator.h"
+#include "Ohm/Rendering/RenderCommand.h"
 #include <glad/glad.h>
 
 namespace Ohm
 {
 #define PI 3.14159265359
 
-	Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, Primitive primitive)
-		: m_PrimitiveType(primitive), m_Vertices(vertices), m_Indices(indices)
+	// Meshes smaller than twice this don't get LODs, and no LOD is simplified below it.
+	static constexpr uint32_t MinLODTriangleCount = 64;
+	// Screen size at which LOD 0 starts to give way.
+	static constexpr float FullDetailScreenSize = 0.5f;
+
+	std::atomic<uint32_t> Mesh::s_NextRuntimeID{ 0 };
+
+	static std::atomic<uint64_t> s_ResidentBytes{ 0 };
+	static std::atomic<uint64_t> s_ReleasedBytes{ 0 };
+
+	Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, Primitive primitive, VertexFormat vertexFormat, bool generateLODs, bool buildMeshlets)
+		: m_PrimitiveType(primitive), m_VertexFormat(vertexFormat), m_Vertices(vertices), m_Indices(indices)
 	{
-		CreateRenderPrimitives();
+		m_OptimizationReport = MeshOptimizer::Optimize(m_Vertices, m_Indices);
+		m_VertexCount = static_cast<uint32_t>(m_Vertices.size());
+		m_LODs = { { 0, static_cast<uint32_t>(m_Indices.size()), 0.0f, 0.0f } };
+		if (generateLODs)
+			GenerateLODs();
+		if (buildMeshlets)
+			m_Meshlets = MeshletBuilder::Build(m_Vertices, m_Indices);
+
+		CalculateBounds();
+		m_UVDensity = CalculateUVDensity(m_Vertices.data(), m_Indices.data(), static_cast<uint32_t>(m_Indices.size()));
+		if (m_LODIndices.empty())
+			CreateRenderPrimitives(m_Vertices.data(), m_Indices.data(), static_cast<uint32_t>(m_Indices.size()));
+		else
+		{
+			std::vector<uint32_t> AllIndices;
+			AllIndices.reserve(m_Indices.size() + m_LODIndices.size());
+			AllIndices.insert(AllIndices.end(), m_Indices.begin(), m_Indices.end());
+			AllIndices.insert(AllIndices.end(), m_LODIndices.begin(), m_LODIndices.end());
+			CreateRenderPrimitives(m_Vertices.data(), AllIndices.data(), static_cast<uint32_t>(AllIndices.size()));
+		}
+
+		m_HasCPUData = true;
+		s_ResidentBytes += GetCPUDataSize();
 	}
 
-	static void CalculateTandBTriangle(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+	Mesh::Mesh(const PreparedMeshData& data, VertexFormat vertexFormat, MeshResidency residency)
+		: m_Residency(residency), m_VertexCount(data.VertexCount), m_VertexFormat(vertexFormat), m_Bounds(data.Bounds),
+		m_OptimizationReport(data.OptimizationReport), m_LODs(data.LODs, data.LODs + data.LODCount), m_Meshlets(data.Meshlets, data.Meshlets + data.MeshletCount)
 	{
-		for(uint32_t TriangleIndex = 0; TriangleIndex < indices.size(); TriangleIndex += 3)
+		ASSERT(data.LODCount > 0 && data.LODs[0].IndexOffset == 0, "Prepared mesh data needs LOD 0 at the start of its indices.");
+		m_UVDensity = CalculateUVDensity(data.Vertices, data.Indices, data.LODs[0].IndexCount);
+
+		CreateRenderPrimitives(data.Vertices, data.Indices, data.IndexCount);
+
+		if (m_Residency == MeshResidency::Keep)
 		{
-			const uint32_t IndexA = indices[TriangleIndex];
-			const uint32_t IndexB = indices[TriangleIndex + 1];
-			const uint32_t IndexC = indices[TriangleIndex + 2];
-			Vertex& A = vertices[IndexA];
-			Vertex& B = vertices[IndexB];
-			Vertex& C = vertices[IndexC];
-
-			const glm::vec3 edge1 = B.Position - A.Position;
-			const glm::vec3 edge2 = C.Position - A.Position;
-			const glm::vec2 deltaUV1 = B.TexCoord - A.TexCoord;
-			const glm::vec2 deltaUV2 = C.TexCoord - A.TexCoord;
-			const float f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
-
-			glm::vec3 Tangent;
-			Tangent.x = f * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
-			Tangent.y = f * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
-			Tangent.z = f * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z);
-
-			glm::vec3 Binormal;
-			Binormal.x = f * (-deltaUV2.x * edge1.x + deltaUV1.x * edge2.x);
-			Binormal.y = f * (-deltaUV2.x * edge1.y + deltaUV1.x * edge2.y);
-			Binormal.z = f * (-deltaUV2.x * edge1.z + deltaUV1.x * edge2.z);
-
-			A.Tangent = B.Tangent = C.Tangent = Tangent;
-			A.Binormal = B.Binormal = C.Binormal = Binormal;
+			m_Vertices.assign(data.Vertices, data.Vertices + data.VertexCount);
+			m_Indices.assign(data.Indices, data.Indices + m_LODs[0].IndexCount);
+			m_LODIndices.assign(data.Indices + m_LODs[0].IndexCount, data.Indices + data.IndexCount);
+			m_HasCPUData = true;
+			s_ResidentBytes += GetCPUDataSize();
 		}
+		else
+			s_ReleasedBytes += GetCPUDataSize();
 	}
-	
+
+	Mesh::~Mesh()
+	{
+		GeometryPool::Get(m_VertexFormat).Free(m_Geometry);
+
+		if (m_HasCPUData)
+			s_ResidentBytes -= GetCPUDataSize();
+		else if (!m_LODs.empty())
+			s_ReleasedBytes -= GetCPUDataSize();
+	}
+
+	uint64_t Mesh::GetCPUDataSize() const
+	{
+		uint64_t IndexCount = 0;
+		for (const MeshLOD& LOD : m_LODs)
+			IndexCount += LOD.IndexCount;
+		return static_cast<uint64_t>(m_VertexCount) * sizeof(Vertex) + IndexCount * sizeof(uint32_t);
+	}
+
+	void Mesh::SetResidency(MeshResidency residency)
+	{
+		m_Residency = residency;
+		if (m_Residency == MeshResidency::Keep)
+			FetchCPUData();
+		else
+			ReleaseCPUData();
+	}
+
+	bool Mesh::FetchCPUData()
+	{
+		if (m_HasCPUData) return true;
+		if (m_Residency == MeshResidency::BoundsOnly) return false;
+
+		const GeometryPool& Pool = GeometryPool::Get(m_VertexFormat);
+		if (m_VertexFormat == VertexFormat::Packed)
+		{
+			std::vector<PackedVertex> PackedVertices(m_VertexCount);
+			Pool.ReadVertices(m_Geometry, PackedVertices.data());
+			m_Vertices.resize(m_VertexCount);
+			for (uint32_t i = 0; i < m_VertexCount; i++)
+				m_Vertices[i] = PackedVertices[i].Unpack();
+		}
+		else
+		{
+			m_Vertices.resize(m_VertexCount);
+			Pool.ReadVertices(m_Geometry, m_Vertices.data());
+		}
+
+		m_Indices.resize(GetIndexCount());
+		m_LODIndices.resize(m_Geometry.IndexCount - GetIndexCount());
+		Pool.ReadIndices(m_Geometry, m_Indices.data(), static_cast<uint32_t>(m_Indices.size()));
+		if (!m_LODIndices.empty())
+			Pool.ReadIndices(m_Geometry, m_LODIndices.data(), static_cast<uint32_t>(m_LODIndices.size()), GetIndexCount());
+
+		m_HasCPUData = true;
+		s_ReleasedBytes -= GetCPUDataSize();
+		s_ResidentBytes += GetCPUDataSize();
+		return true;
+	}
+
+	void Mesh::ReleaseCPUData()
+	{
+		if (!m_HasCPUData || m_Residency == MeshResidency::Keep) return;
+
+		// clear() keeps the capacity, so swap with empty vectors to give the memory back.
+		std::vector<Vertex>().swap(m_Vertices);
+		std::vector<uint32_t>().swap(m_Indices);
+		std::vector<uint32_t>().swap(m_LODIndices);
+
+		m_HasCPUData = false;
+		s_ResidentBytes -= GetCPUDataSize();
+		s_ReleasedBytes += GetCPUDataSize();
+	}
+
+	MeshMemoryStats Mesh::GetMemoryStats()
+	{
+		return { s_ResidentBytes.load(), s_ReleasedBytes.load() };
+	}
+
 	void Mesh::Bind() const
 	{
-		m_VertexArray->Bind();
-		m_VertexBuffer->Bind();
-		m_IndexBuffer->Bind();
+		GeometryPool::Get(m_VertexFormat).Bind();
 	}
 
 	void Mesh::Unbind() const
 	{
-		m_VertexArray->Unbind();
-		m_VertexBuffer->Unbind();
-		m_IndexBuffer->Unbind();
+		RenderCommand::BindVertexArray(0);
 	}
 
-	void Mesh::CreateRenderPrimitives()
+	void Mesh::GenerateLODs()
 	{
-		m_VertexArray = CreateRef<VertexArray>();
-		float* baseVertexPtr = &m_Vertices.data()->Position.x;
-		m_VertexBuffer = CreateRef<VertexBuffer>(baseVertexPtr, m_Vertices.size() * sizeof(Vertex));
+		// Each LOD halves the one before it, simplified from it rather than from LOD 0 so the chain stays nested.
+		std::vector<uint32_t> Previous = m_Indices;
+		float Error = 0.0f;
 
-		const BufferLayout layout = BufferLayout
-		(
-			{
-				{ "a_Position", ShaderDataType::Float3 },
-				{ "a_Normal",	ShaderDataType::Float3 },
-				{ "a_Tangent", ShaderDataType::Float3 },
-				{ "a_Binormal", ShaderDataType::Float3 },
-				{ "a_TexCoord", ShaderDataType::Float2 }
-			}
-		);
-		m_VertexBuffer->SetLayout(layout);
+		while (m_LODs.size() < MaxMeshLODs)
+		{
+			const size_t TargetIndexCount = Previous.size() / 6 * 3;
+			if (TargetIndexCount / 3 < MinLODTriangleCount) break;
+
+			float CollapseError = 0.0f;
+			std::vector<uint32_t> Simplified = MeshSimplifier::Simplify(m_Vertices, Previous, TargetIndexCount, &CollapseError);
+
+			// Locked seams and borders can stop the simplifier early; an LOD that barely saves anything isn't worth a switch.
+			if (Simplified.size() > Previous.size() * 3 / 4) break;
+
+			MeshOptimizer::OptimizeVertexCache(Simplified, static_cast<uint32_t>(m_Vertices.size()));
+			Error += CollapseError;
+
+			// Triangle count should follow screen area, the square of screen size.
+			const float TriangleRatio = static_cast<float>(Simplified.size()) / static_cast<float>(m_Indices.size());
+			m_LODs.push_back({ static_cast<uint32_t>(m_Indices.size() + m_LODIndices.size()), static_cast<uint32_t>(Simplified.size()), Error, FullDetailScreenSize * glm::sqrt(TriangleRatio) });
+
+			m_LODIndices.insert(m_LODIndices.end(), Simplified.begin(), Simplified.end());
+			Previous.swap(Simplified);
+		}
+	}
+
+	uint32_t Mesh::SelectLOD(float screenSize, float bias) const
+	{
+		uint32_t LOD = 0;
+		while (LOD + 1 < m_LODs.size() && screenSize < m_LODs[LOD + 1].ScreenSize * bias)
+			LOD++;
+		return LOD;
+	}
+
+	float Mesh::CalculateUVDensity(const Vertex* vertices, const uint32_t* indices, uint32_t indexCount)
+	{
+		// The square root of the ratio of the areas, so it scales like a length.
+		double Area = 0.0, UVArea = 0.0;
+		for (uint32_t i = 0; i + 2 < indexCount; i += 3)
+		{
+			const Vertex& V0 = vertices[indices[i]];
+			const Vertex& V1 = vertices[indices[i + 1]];
+			const Vertex& V2 = vertices[indices[i + 2]];
+			Area += glm::length(glm::cross(V1.Position - V0.Position, V2.Position - V0.Position)) * 0.5;
+
+			const glm::vec2 UV1 = V1.TexCoord - V0.TexCoord, UV2 = V2.TexCoord - V0.TexCoord;
+			UVArea += glm::abs(UV1.x * UV2.y - UV1.y * UV2.x) * 0.5;
+		}
+		return Area > 0.0 ? static_cast<float>(glm::sqrt(UVArea / Area)) : 0.0f;
+	}
+
+	void Mesh::CalculateBounds()
+	{
+		if (m_Vertices.empty())
+			return;
+
+		m_Bounds.Min = m_Bounds.Max = m_Vertices[0].Position;
+		for (const Vertex& vertex : m_Vertices)
+		{
+			m_Bounds.Min = glm::min(m_Bounds.Min, vertex.Position);
+			m_Bounds.Max = glm::max(m_Bounds.Max, vertex.Position);
+		}
+	}
+
+	void Mesh::CreateRenderPrimitives(const Vertex* vertices, const uint32_t* indices, uint32_t indexCount)
+	{
+		GeometryPool& Pool = GeometryPool::Get(m_VertexFormat);
+		m_Geometry = Pool.Allocate(m_VertexCount, indexCount);
+
+		if (m_VertexFormat == VertexFormat::Packed)
+		{
+			std::vector<PackedVertex> packedVertices(m_VertexCount);
+			for (size_t i = 0; i < m_VertexCount; i++)
+				packedVertices[i] = PackedVertex::Pack(vertices[i]);
+			Pool.UploadVertices(m_Geometry, packedVertices.data());
+		}
+		else
+			Pool.UploadVertices(m_Geometry, vertices);
 
-		m_IndexBuffer = CreateRef<IndexBuffer>(m_Indices.data(), m_Indices.size());
-		m_VertexArray->EnableVertexAttributes(m_VertexBuffer);
-		m_VertexArray->SetIndexBuffer(m_IndexBuffer);
+		Pool.UploadIndices(m_Geometry, indices);
 	}
 
 	Ref<Mesh> MeshFactory::Create(Primitive primitiveType)
@@ -114,7 +274,7 @@ namespace Ohm
 		{
 			0, 1, 2, 2, 3, 0
 	   };
-		CalculateTandBTriangle(vertices, indices);
+		TangentGenerator::Generate(vertices, indices);
 		
 		return CreateRef<Mesh>(vertices, indices, Primitive::Plane);
 	}
@@ -234,7 +394,7 @@ namespace Ohm
 			22, 23, 20
 		};
 
-		CalculateTandBTriangle(vertices, indices);
+		TangentGenerator::Generate(vertices, indices);
 
 		return CreateRef<Mesh>(vertices, indices, Primitive::Cube);
 	}
@@ -290,9 +450,9 @@ namespace Ohm
 			}
 		}
 
-		CalculateTandBTriangle(vertices, indices);
+		TangentGenerator::Generate(vertices, indices);
 
-		return CreateRef<Mesh>(vertices, indices, Primitive::Sphere);
+		return CreateRef<Mesh>(vertices, indices, Primitive::Sphere, VertexFormat::Full, true, true);
 	}
 
 	static int AddIcosphereVertex(const glm::vec3& v, std::vector<Vertex>& vertices, uint32_t* index)
@@ -409,9 +569,9 @@ namespace Ohm
 			indices.push_back(triangle.C);
 		}
 
-		CalculateTandBTriangle(vertices, indices);
+		TangentGenerator::Generate(vertices, indices);
 		
-		return CreateRef<Mesh>(vertices, indices, Primitive::Icosphere);
+		return CreateRef<Mesh>(vertices, indices, Primitive::Icosphere, VertexFormat::Full, true, true);
 	}
 
 	Ref<Mesh> MeshFactory::Skybox()
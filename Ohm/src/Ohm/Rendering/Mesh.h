@@ -1,43 +1,160 @@
 #pragma once
 
-#include "Ohm/Rendering/VertexArray.h"
 #include "Ohm/Rendering/Vertex.h"
-#include "Ohm/Rendering/BufferLayout.h"
-#include "Ohm/Rendering/IndexBuffer.h"
-#include "Ohm/Rendering/VertexBuffer.h"
+#include "Ohm/Rendering/GeometryPool.h"
+#include "Ohm/Rendering/AABB.h"
+#include "Ohm/Rendering/MeshOptimizer.h"
+#include "Ohm/Rendering/MeshletBuilder.h"
 
 namespace Ohm
 {
 	enum class Primitive { None = 0, Triangle, Quad, FullScreenQuad, Plane, Cube, Sphere, TessellatedQuad, Icosphere, Skybox };
 
+	static constexpr uint32_t MaxMeshLODs = 8;
+
+	// A range of the mesh's indices.  Every LOD indexes the same vertices.
+	struct MeshLOD
+	{
+		uint32_t IndexOffset = 0;
+		uint32_t IndexCount = 0;
+		// Largest simplification error accumulated down to this LOD, in the mesh's units.
+		float Error = 0.0f;
+		// Bounding-sphere screen size below which this LOD is used; see Mesh::SelectLOD.
+		float ScreenSize = 0.0f;
+	};
+
+	// What a mesh keeps in system memory once its buffers are uploaded.
+	enum class MeshResidency
+	{
+		// Vertices and indices stay resident.
+		Keep = 0,
+		// Freed after upload.  FetchCPUData reads them back from the GPU buffers when something needs them again.
+		DropAfterUpload,
+		// Freed after upload for good; bounds, counts and LOD ranges are all that's left.
+		BoundsOnly
+	};
+
+	// CPU-side geometry of every mesh alive, in bytes.
+	struct MeshMemoryStats
+	{
+		uint64_t ResidentBytes = 0;
+		// Freed by residency policies; what holding a second copy of all uploaded geometry would cost.
+		uint64_t ReleasedBytes = 0;
+	};
+
+	// Geometry that has already been optimized and split into LODs, the way MeshImporter caches it.  Indices holds
+	// every LOD back to back.  The pointers only need to outlive the Mesh constructor.
+	struct PreparedMeshData
+	{
+		const Vertex* Vertices = nullptr;
+		uint32_t VertexCount = 0;
+		const uint32_t* Indices = nullptr;
+		uint32_t IndexCount = 0;
+		const MeshLOD* LODs = nullptr;
+		uint32_t LODCount = 0;
+		const Meshlet* Meshlets = nullptr;
+		uint32_t MeshletCount = 0;
+		AABB Bounds;
+		MeshOptimizationReport OptimizationReport;
+	};
+
 	class Mesh
 	{
 	public:
 		Mesh() = default;
-		Mesh(const Mesh&) = default;
-		Mesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, Primitive primitive = Primitive::None);
+		// Copies would share the geometry allocation and throw the memory accounting off.
+		Mesh(const Mesh&) = delete;
+		Mesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, Primitive primitive = Primitive::None, VertexFormat vertexFormat = VertexFormat::Full, bool generateLODs = true, bool buildMeshlets = false);
+		// Uploads the data as it is, skipping optimization and LOD generation.  Only Keep copies it to the CPU side.
+		Mesh(const PreparedMeshData& data, VertexFormat vertexFormat = VertexFormat::Full, MeshResidency residency = MeshResidency::Keep);
+		~Mesh();
 
-		const Ref<IndexBuffer>& GetIndexBuffer() const { return m_IndexBuffer; }
-		const Ref<VertexBuffer>& GetVertexBuffer() const { return m_VertexBuffer; }
+		// Where the mesh lives in its vertex format's GeometryPool.  LOD index offsets are relative to FirstIndex.
+		const GeometryAllocation& GetGeometry() const { return m_Geometry; }
 
+		// Empty while the CPU data isn't resident; see HasCPUData.
 		const std::vector<Vertex>& GetVertices() const { return m_Vertices; }
 		const std::vector<uint32_t>& GetIndices() const { return m_Indices; }
+		// Indices of LOD 1 onwards, as they follow GetIndices() in the mesh's index range.
+		const std::vector<uint32_t>& GetLODIndices() const { return m_LODIndices; }
+		// Counts of LOD 0, valid whatever the residency.
+		uint32_t GetVertexCount() const { return m_VertexCount; }
+		uint32_t GetIndexCount() const { return m_LODs.empty() ? 0 : m_LODs[0].IndexCount; }
+		uint32_t GetTriangleCount() const { return GetIndexCount() / 3; }
 		Primitive GetPrimitiveType() const { return m_PrimitiveType; }
+		uint32_t GetRuntimeID() const { return m_RuntimeID; }
+		VertexFormat GetVertexFormat() const { return m_VertexFormat; }
+		uint32_t GetVertexStride() const { return GeometryPool::Get(m_VertexFormat).GetVertexStride(); }
+		uint64_t GetVertexBufferSize() const { return static_cast<uint64_t>(m_VertexCount) * GetVertexStride(); }
+		// File the mesh was imported from, empty for generated meshes.
+		const std::string& GetSourcePath() const { return m_SourcePath; }
+		void SetSourcePath(const std::string& sourcePath) { m_SourcePath = sourcePath; }
 
-		void Unbind() const;
+		// Applies the policy straight away: data is released, or fetched back when switching to Keep.
+		void SetResidency(MeshResidency residency);
+		MeshResidency GetResidency() const { return m_Residency; }
+		bool HasCPUData() const { return m_HasCPUData; }
+		// Reads vertices and indices back from the GPU; needs the GL context, so call it on the thread that renders.
+		// Packed meshes come back decoded.  The data stays until ReleaseCPUData, or for good under Keep.  Returns
+		// false under BoundsOnly.
+		bool FetchCPUData();
+		// Frees the CPU data again, unless the policy is Keep.
+		void ReleaseCPUData();
+
+		static MeshMemoryStats GetMemoryStats();
+		// Local-space bounds of the vertex positions.
+		const AABB& GetBounds() const { return m_Bounds; }
+		// Units of UV per unit of the mesh's surface, averaged over its area; zero when it has no UVs.  Valid whatever
+		// the residency.
+		float GetUVDensity() const { return m_UVDensity; }
+		// Cache and overdraw figures from before and after the mesh was reordered for upload.
+		const MeshOptimizationReport& GetOptimizationReport() const { return m_OptimizationReport; }
+
+		// LOD 0 is the full mesh, GetIndices(); the rest follow it in the mesh's index range.
+		const std::vector<MeshLOD>& GetLODs() const { return m_LODs; }
+		const MeshLOD& GetLOD(uint32_t lod) const { return m_LODs[lod]; }
+		uint32_t GetLODCount() const { return static_cast<uint32_t>(m_LODs.size()); }
+		// screenSize is the bounding sphere's radius over half the viewport height.  A larger bias switches earlier.
+		uint32_t SelectLOD(float screenSize, float bias = 1.0f) const;
+
+		// Clusters of LOD 0 for MeshletCuller, in index order.  Empty unless the mesh was built with them.  Always
+		// resident, like the bounds.
+		const std::vector<Meshlet>& GetMeshlets() const { return m_Meshlets; }
+		bool HasMeshlets() const { return !m_Meshlets.empty(); }
+
+		// Binds the vertex array shared by every mesh of the same vertex format.
 		void Bind() const;
-		const Ref<VertexArray>& GetVAO() { return m_VertexArray; }
+		void Unbind() const;
 
 	private:
-		void CreateRenderPrimitives();
+		void CreateRenderPrimitives(const Vertex* vertices, const uint32_t* indices, uint32_t indexCount);
+		void CalculateBounds();
+		static float CalculateUVDensity(const Vertex* vertices, const uint32_t* indices, uint32_t indexCount);
+		void GenerateLODs();
+		uint64_t GetCPUDataSize() const;
 
-		Primitive m_PrimitiveType;
+		Primitive m_PrimitiveType = Primitive::None;
+		// Dense per-process identifier, used for render queue sort keys.
+		uint32_t m_RuntimeID = s_NextRuntimeID++;
+		std::string m_SourcePath;
+		MeshResidency m_Residency = MeshResidency::Keep;
+		bool m_HasCPUData = false;
+		uint32_t m_VertexCount = 0;
+		VertexFormat m_VertexFormat = VertexFormat::Full;
+		AABB m_Bounds;
+		float m_UVDensity = 0.0f;
+		MeshOptimizationReport m_OptimizationReport;
 		std::vector<Vertex> m_Vertices;
 		std::vector<uint32_t> m_Indices;
+		std::vector<MeshLOD> m_LODs;
+		// Indices of LOD 1 onwards, kept together so they upload as one range with LOD 0.
+		std::vector<uint32_t> m_LODIndices;
+		std::vector<Meshlet> m_Meshlets;
+
+		GeometryAllocation m_Geometry;
 
-		Ref<VertexArray> m_VertexArray;
-		Ref<VertexBuffer> m_VertexBuffer;
-		Ref<IndexBuffer> m_IndexBuffer;
+		// Meshes are built on the job system as well as the main thread.
+		static std::atomic<uint32_t> s_NextRuntimeID;
 	};
 
 	class MeshFactory
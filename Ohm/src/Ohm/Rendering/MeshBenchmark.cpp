@@ -0,0 +1,262 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/MeshBenchmark.h"
+#include "Ohm/Rendering/Mesh.h"
+#include "Ohm/Rendering/Shader.h"
+#include "Ohm/Rendering/Framebuffer.h"
+#include "Ohm/Rendering/RenderCommand.h"
+#include "Ohm/Rendering/TangentGenerator.h"
+#include "Ohm/Core/JobSystem.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glad/glad.h>
+
+#include <chrono>
+#include <limits>
+
+namespace Ohm
+{
+	static std::mutex s_BenchmarkMutex;
+	static std::atomic<bool> s_VertexFormatBenchmarkRequested{ false };
+	static bool s_HasVertexFormatResult = false;
+	static VertexFormatBenchmarkResult s_VertexFormatResult;
+	static std::atomic<bool> s_TangentBenchmarkRequested{ false };
+	static bool s_HasTangentResult = false;
+	static TangentBenchmarkResult s_TangentResult;
+
+	void MeshBenchmark::RequestVertexFormatBenchmark()
+	{
+		s_VertexFormatBenchmarkRequested = true;
+	}
+
+	bool MeshBenchmark::IsVertexFormatBenchmarkPending()
+	{
+		return s_VertexFormatBenchmarkRequested;
+	}
+
+	bool MeshBenchmark::GetVertexFormatResult(VertexFormatBenchmarkResult& outResult)
+	{
+		std::lock_guard<std::mutex> Lock(s_BenchmarkMutex);
+		if (!s_HasVertexFormatResult) return false;
+
+		outResult = s_VertexFormatResult;
+		return true;
+	}
+
+	void MeshBenchmark::RequestTangentBenchmark()
+	{
+		s_TangentBenchmarkRequested = true;
+	}
+
+	bool MeshBenchmark::IsTangentBenchmarkPending()
+	{
+		return s_TangentBenchmarkRequested;
+	}
+
+	bool MeshBenchmark::GetTangentResult(TangentBenchmarkResult& outResult)
+	{
+		std::lock_guard<std::mutex> Lock(s_BenchmarkMutex);
+		if (!s_HasTangentResult) return false;
+
+		outResult = s_TangentResult;
+		return true;
+	}
+
+	void MeshBenchmark::RunPending()
+	{
+		if (s_VertexFormatBenchmarkRequested)
+		{
+			const VertexFormatBenchmarkResult Result = RunVertexFormatBenchmark();
+			{
+				std::lock_guard<std::mutex> Lock(s_BenchmarkMutex);
+				s_VertexFormatResult = Result;
+				s_HasVertexFormatResult = true;
+			}
+			s_VertexFormatBenchmarkRequested = false;
+
+			constexpr double BytesPerMB = 1024.0 * 1024.0;
+			OHM_CORE_INFO("Vertex Format Benchmark ({} vertices, {} triangles, {} draws):", Result.VertexCount, Result.TriangleCount, Result.MeasuredDraws);
+			const char* FormatNames[] = { "Full", "Packed" };
+			for (uint32_t i = 0; i < 2; i++)
+			{
+				const auto& Format = Result.Formats[i];
+				OHM_CORE_INFO("  {}: {} B/vertex, {:.2f} MB, {:.3f} ms upload, {:.3f} ms GPU/draw",
+					FormatNames[i], Format.Stride, Format.VertexBufferBytes / BytesPerMB, Format.UploadMilliseconds, Format.GPUMillisecondsPerDraw);
+			}
+			OHM_CORE_INFO("  Packed error: normal {:.4f} deg, tangent {:.4f} deg, texcoord {:.6f}",
+				Result.MaxNormalErrorDegrees, Result.MaxTangentErrorDegrees, Result.MaxTexCoordError);
+		}
+
+		if (s_TangentBenchmarkRequested)
+		{
+			const TangentBenchmarkResult Result = RunTangentBenchmark();
+			{
+				std::lock_guard<std::mutex> Lock(s_BenchmarkMutex);
+				s_TangentResult = Result;
+				s_HasTangentResult = true;
+			}
+			s_TangentBenchmarkRequested = false;
+
+			OHM_CORE_INFO("Tangent Benchmark ({} vertices, {} triangles, {} threads): {:.3f} ms, {:.1f} M triangles/s",
+				Result.VertexCount, Result.TriangleCount, Result.ThreadCount, Result.Milliseconds, Result.MillionTrianglesPerSecond);
+			OHM_CORE_INFO("  Max tangent error {:.4f} deg, max orthogonality error {:.6f}", Result.MaxTangentErrorDegrees, Result.MaxOrthogonalityError);
+		}
+	}
+
+	static float AngleDegrees(const glm::vec3& a, const glm::vec3& b)
+	{
+		return glm::degrees(glm::acos(glm::clamp(glm::dot(a, b), -1.0f, 1.0f)));
+	}
+
+	VertexFormatBenchmarkResult MeshBenchmark::RunVertexFormatBenchmark()
+	{
+		constexpr uint32_t IcosphereLevel = 7;
+		constexpr uint32_t WarmupDraws = 4;
+		constexpr uint32_t MeasuredDraws = 64;
+		constexpr uint32_t TargetSize = 128;
+
+		const Ref<Mesh> Source = MeshFactory::Icosphere(IcosphereLevel, 1.0f);
+		const std::vector<Vertex>& Vertices = Source->GetVertices();
+
+		VertexFormatBenchmarkResult Result;
+		Result.VertexCount = static_cast<uint32_t>(Vertices.size());
+		Result.TriangleCount = static_cast<uint32_t>(Source->GetIndices().size() / 3);
+		Result.MeasuredDraws = MeasuredDraws;
+
+		// Round trip through the packed format on the CPU; Unpack matches the shader's decode.
+		for (const Vertex& Original : Vertices)
+		{
+			const Vertex Decoded = PackedVertex::Pack(Original).Unpack();
+			const glm::vec3 Normal = glm::normalize(Original.Normal);
+			Result.MaxNormalErrorDegrees = glm::max(Result.MaxNormalErrorDegrees, AngleDegrees(Normal, Decoded.Normal));
+
+			const glm::vec3 Tangent = Original.Tangent - Normal * glm::dot(Normal, Original.Tangent);
+			if (glm::dot(Tangent, Tangent) > 1e-12f)
+				Result.MaxTangentErrorDegrees = glm::max(Result.MaxTangentErrorDegrees, AngleDegrees(glm::normalize(Tangent), Decoded.Tangent));
+
+			const glm::vec2 TexCoordError = glm::abs(Original.TexCoord - Decoded.TexCoord);
+			Result.MaxTexCoordError = glm::max(Result.MaxTexCoordError, glm::max(TexCoordError.x, TexCoordError.y));
+		}
+
+		FramebufferSpecification TargetSpec;
+		TargetSpec.Width = TargetSpec.Height = TargetSize;
+		TargetSpec.AttachmentSpecification = { FramebufferTextureFormat::RGBA8, FramebufferTextureFormat::Depth };
+		const Ref<Framebuffer> Target = CreateRef<Framebuffer>(TargetSpec);
+
+		const Ref<Shader>& BenchmarkShader = ShaderLibrary::Get("VertexFormatBenchmark");
+		const glm::mat4 Projection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 10.0f);
+		const glm::mat4 View = glm::lookAt(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+		uint32_t Query = 0;
+		glCreateQueries(GL_TIME_ELAPSED, 1, &Query);
+
+		Target->Bind();
+		BenchmarkShader->Bind();
+		BenchmarkShader->UploadUniformMat4("u_ViewProjection", Projection * View);
+
+		for (uint32_t i = 0; i < 2; i++)
+		{
+			const auto UploadStart = std::chrono::high_resolution_clock::now();
+			const Ref<Mesh> BenchmarkMesh = CreateRef<Mesh>(Vertices, Source->GetIndices(), Primitive::None, static_cast<VertexFormat>(i), false);
+			glFinish();
+			const auto UploadEnd = std::chrono::high_resolution_clock::now();
+
+			VertexFormatBenchmarkResult::Format& Format = Result.Formats[i];
+			Format.Stride = BenchmarkMesh->GetVertexStride();
+			Format.VertexBufferBytes = BenchmarkMesh->GetVertexBufferSize();
+			// The source mesh is already optimized, but the constructor still runs and measures the optimizer.
+			Format.UploadMilliseconds = std::chrono::duration<float, std::milli>(UploadEnd - UploadStart).count() - BenchmarkMesh->GetOptimizationReport().Milliseconds;
+
+			const GeometryAllocation& Geometry = BenchmarkMesh->GetGeometry();
+			BenchmarkMesh->Bind();
+			RenderCommand::Clear(true, true);
+			for (uint32_t Draw = 0; Draw < WarmupDraws; Draw++)
+				RenderCommand::DrawIndexedBaseVertex(BenchmarkMesh->GetIndexCount(), Geometry.FirstIndex, Geometry.BaseVertex);
+
+			glBeginQuery(GL_TIME_ELAPSED, Query);
+			for (uint32_t Draw = 0; Draw < MeasuredDraws; Draw++)
+				RenderCommand::DrawIndexedBaseVertex(BenchmarkMesh->GetIndexCount(), Geometry.FirstIndex, Geometry.BaseVertex);
+			glEndQuery(GL_TIME_ELAPSED);
+
+			GLuint64 ElapsedNanoseconds = 0;
+			glGetQueryObjectui64v(Query, GL_QUERY_RESULT, &ElapsedNanoseconds);
+			Format.GPUMillisecondsPerDraw = static_cast<float>(ElapsedNanoseconds / 1e6) / MeasuredDraws;
+		}
+
+		Target->Unbind();
+		glDeleteQueries(1, &Query);
+
+		return Result;
+	}
+
+	TangentBenchmarkResult MeshBenchmark::RunTangentBenchmark()
+	{
+		// A UV sphere of 1024 x 512 quads: just over a million triangles, with a known tangent frame at every vertex.
+		constexpr uint32_t Columns = 1024;
+		constexpr uint32_t Rows = 512;
+		constexpr uint32_t MeasuredRuns = 5;
+		constexpr float Pi = 3.14159265359f;
+
+		std::vector<Vertex> Vertices;
+		Vertices.reserve((Columns + 1) * (Rows + 1));
+		for (uint32_t Row = 0; Row <= Rows; Row++)
+		{
+			const float Theta = Pi * Row / Rows;
+			for (uint32_t Column = 0; Column <= Columns; Column++)
+			{
+				const float Phi = 2.0f * Pi * Column / Columns;
+				Vertex& Created = Vertices.emplace_back();
+				Created.Normal = { glm::sin(Theta) * glm::cos(Phi), glm::cos(Theta), glm::sin(Theta) * glm::sin(Phi) };
+				Created.Position = Created.Normal;
+				Created.TexCoord = { static_cast<float>(Column) / Columns, 1.0f - static_cast<float>(Row) / Rows };
+			}
+		}
+
+		std::vector<uint32_t> Indices;
+		Indices.reserve(Columns * Rows * 6);
+		for (uint32_t Row = 0; Row < Rows; Row++)
+		{
+			for (uint32_t Column = 0; Column < Columns; Column++)
+			{
+				const uint32_t TopLeft = Row * (Columns + 1) + Column;
+				const uint32_t BottomLeft = TopLeft + Columns + 1;
+				Indices.insert(Indices.end(), { TopLeft, TopLeft + 1, BottomLeft, TopLeft + 1, BottomLeft + 1, BottomLeft });
+			}
+		}
+
+		TangentBenchmarkResult Result;
+		Result.VertexCount = static_cast<uint32_t>(Vertices.size());
+		Result.TriangleCount = static_cast<uint32_t>(Indices.size() / 3);
+		Result.ThreadCount = JobSystem::GetThreadCount();
+
+		// The first run is a warmup and isn't counted.
+		Result.Milliseconds = std::numeric_limits<float>::max();
+		for (uint32_t Run = 0; Run <= MeasuredRuns; Run++)
+		{
+			const auto Start = std::chrono::high_resolution_clock::now();
+			TangentGenerator::Generate(Vertices, Indices);
+			const float Milliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - Start).count();
+			if (Run > 0)
+				Result.Milliseconds = glm::min(Result.Milliseconds, Milliseconds);
+		}
+		Result.MillionTrianglesPerSecond = Result.TriangleCount / (Result.Milliseconds * 1000.0f);
+
+		for (uint32_t Row = 0; Row <= Rows; Row++)
+		{
+			for (uint32_t Column = 0; Column <= Columns; Column++)
+			{
+				const Vertex& Generated = Vertices[Row * (Columns + 1) + Column];
+				Result.MaxOrthogonalityError = glm::max(Result.MaxOrthogonalityError, glm::abs(glm::dot(Generated.Normal, Generated.Tangent)));
+				Result.MaxOrthogonalityError = glm::max(Result.MaxOrthogonalityError, glm::abs(glm::dot(Generated.Tangent, Generated.Binormal)));
+
+				// Every triangle at the poles shares one position, so the frame there is arbitrary.
+				if (Row == 0 || Row == Rows) continue;
+
+				// +U runs along increasing Phi.
+				const float Phi = 2.0f * Pi * Column / Columns;
+				Result.MaxTangentErrorDegrees = glm::max(Result.MaxTangentErrorDegrees, AngleDegrees(glm::vec3(-glm::sin(Phi), 0.0f, glm::cos(Phi)), Generated.Tangent));
+			}
+		}
+
+		return Result;
+	}
+}
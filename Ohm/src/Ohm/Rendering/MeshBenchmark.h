@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Ohm/Rendering/Vertex.h"
+
+namespace Ohm
+{
+	struct VertexFormatBenchmarkResult
+	{
+		struct Format
+		{
+			uint32_t Stride = 0;
+			uint64_t VertexBufferBytes = 0;
+			// Packing (where there is any) plus buffer creation.
+			float UploadMilliseconds = 0.0f;
+			// GPU time of one draw of the whole mesh into a small target, so vertex work dominates.
+			float GPUMillisecondsPerDraw = 0.0f;
+		};
+
+		uint32_t VertexCount = 0;
+		uint32_t TriangleCount = 0;
+		uint32_t MeasuredDraws = 0;
+		Format Formats[2];
+
+		// Largest round-trip errors of the packed format.
+		float MaxNormalErrorDegrees = 0.0f;
+		float MaxTangentErrorDegrees = 0.0f;
+		float MaxTexCoordError = 0.0f;
+	};
+
+	struct TangentBenchmarkResult
+	{
+		uint32_t VertexCount = 0;
+		uint32_t TriangleCount = 0;
+		uint32_t ThreadCount = 0;
+		// Best of the measured runs.
+		float Milliseconds = 0.0f;
+		float MillionTrianglesPerSecond = 0.0f;
+
+		// Against the analytic frame of the benchmark's UV sphere, away from the poles.
+		float MaxTangentErrorDegrees = 0.0f;
+		// Largest |dot(normal, tangent)| and |dot(tangent, binormal)|.
+		float MaxOrthogonalityError = 0.0f;
+	};
+
+	/*
+	 * Benchmarks that have to run with the renderer's context current, or that would stall the UI.  The UI requests
+	 * a run and reads the last result back from any thread; the Get functions return false until a run has finished.
+	 * RunPending runs whatever was requested on the thread that renders.
+	 */
+	class MeshBenchmark
+	{
+	public:
+		static void RequestVertexFormatBenchmark();
+		static bool IsVertexFormatBenchmarkPending();
+		static bool GetVertexFormatResult(VertexFormatBenchmarkResult& outResult);
+
+		static void RequestTangentBenchmark();
+		static bool IsTangentBenchmarkPending();
+		static bool GetTangentResult(TangentBenchmarkResult& outResult);
+
+		static void RunPending();
+
+	private:
+		static VertexFormatBenchmarkResult RunVertexFormatBenchmark();
+		static TangentBenchmarkResult RunTangentBenchmark();
+	};
+}
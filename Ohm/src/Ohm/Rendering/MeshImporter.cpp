@@ -0,0 +1,1007 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/MeshImporter.h"
+#include "Ohm/Rendering/TangentGenerator.h"
+#include "Ohm/Core/AssetCache.h"
+#include "Ohm/Core/JobSystem.h"
+#include "Ohm/Core/MappedFile.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <yaml-cpp/yaml.h>
+
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+namespace Ohm
+{
+	static constexpr char CacheMagic[4] = { 'O', 'H', 'M', 'M' };
+	static constexpr const char* CacheExtension = ".ohmmesh";
+
+	// OBJ chunks smaller than this aren't worth a job of their own.
+	static constexpr size_t MinObjChunkBytes = 256 * 1024;
+	// More chunks than threads, so a chunk heavy on faces doesn't hold everyone up.
+	static constexpr uint32_t ObjChunksPerThread = 4;
+
+	/*
+	 * The cache file is this header, the LOD table, the meshlets, the vertices and then the indices of every LOD back to
+	 * back, all exactly as the mesh uploads them.
+	 */
+	struct MeshCacheHeader
+	{
+		char Magic[4];
+		uint32_t Version;
+		// The SourceStamp of the model the cache was built from.
+		uint64_t SourceSize;
+		int64_t SourceWriteTime;
+		// sizeof(Vertex) when the cache was written.
+		uint32_t VertexSize;
+		uint32_t VertexCount;
+		uint32_t IndexCount;
+		uint32_t LODCount;
+		AABB Bounds;
+		MeshOptimizationReport OptimizationReport;
+		uint32_t MeshletCount;
+	};
+	static_assert(sizeof(MeshCacheHeader) % 8 == 0, "The mesh cache header must not have implicit padding.");
+	static_assert(std::is_trivially_copyable_v<MeshCacheHeader>, "The mesh cache header is written and read as raw bytes.");
+	static_assert(std::is_trivially_copyable_v<Vertex> && std::is_trivially_copyable_v<MeshLOD> && std::is_trivially_copyable_v<Meshlet>, "Cached geometry is written and read as raw bytes.");
+
+	struct ImportedGeometry
+	{
+		std::vector<Vertex> Vertices;
+		std::vector<uint32_t> Indices;
+	};
+
+	static float MillisecondsSince(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// Area-weighted smooth normals for the vertices in [vertexBegin, vertexEnd), from the triangles in
+	// [indexBegin, indexEnd), which must only reference those vertices.
+	static void GenerateNormals(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t vertexBegin, uint32_t vertexEnd, size_t indexBegin, size_t indexEnd)
+	{
+		for (uint32_t i = vertexBegin; i < vertexEnd; i++)
+			vertices[i].Normal = glm::vec3(0.0f);
+
+		for (size_t i = indexBegin; i + 2 < indexEnd; i += 3)
+		{
+			Vertex& A = vertices[indices[i + 0]];
+			Vertex& B = vertices[indices[i + 1]];
+			Vertex& C = vertices[indices[i + 2]];
+
+			// Left unnormalized so larger triangles weigh more.
+			const glm::vec3 AreaNormal = glm::cross(B.Position - A.Position, C.Position - A.Position);
+			A.Normal += AreaNormal;
+			B.Normal += AreaNormal;
+			C.Normal += AreaNormal;
+		}
+
+		for (uint32_t i = vertexBegin; i < vertexEnd; i++)
+		{
+			const float Length = glm::length(vertices[i].Normal);
+			vertices[i].Normal = Length > 0.0f ? vertices[i].Normal / Length : glm::vec3(0.0f, 1.0f, 0.0f);
+		}
+	}
+
+	//-------------------------OBJ-------------------------//
+
+	// Zero-based indices into the file's positions, texture coordinates and normals; -1 when absent.
+	struct ObjCorner
+	{
+		int32_t Position = -1;
+		int32_t TexCoord = -1;
+		int32_t Normal = -1;
+
+		bool operator==(const ObjCorner& other) const { return Position == other.Position && TexCoord == other.TexCoord && Normal == other.Normal; }
+	};
+
+	struct ObjCornerHash
+	{
+		size_t operator()(const ObjCorner& corner) const
+		{
+			return (static_cast<uint32_t>(corner.Position) * 73856093u) ^ (static_cast<uint32_t>(corner.TexCoord) * 19349663u) ^ (static_cast<uint32_t>(corner.Normal) * 83492791u);
+		}
+	};
+
+	struct ObjChunk
+	{
+		const char* Begin = nullptr;
+		const char* End = nullptr;
+
+		uint32_t PositionCount = 0;
+		uint32_t TexCoordCount = 0;
+		uint32_t NormalCount = 0;
+		// Index of the chunk's first position, texture coordinate and normal in the whole file.
+		uint32_t PositionBase = 0;
+		uint32_t TexCoordBase = 0;
+		uint32_t NormalBase = 0;
+
+		// Three per triangle; polygons are triangulated as fans.
+		std::vector<ObjCorner> Corners;
+		bool Valid = true;
+	};
+
+	enum class ObjLine { Other = 0, Position, TexCoord, Normal, Face };
+
+	static const char* SkipSpaces(const char* text, const char* end)
+	{
+		while (text < end && (*text == ' ' || *text == '\t' || *text == '\r'))
+			text++;
+		return text;
+	}
+
+	// Calls fn(lineBegin, lineEnd) for every line, with leading whitespace skipped.
+	template<typename LineFn>
+	static void ForEachLine(const char* begin, const char* end, LineFn&& fn)
+	{
+		while (begin < end)
+		{
+			const char* LineEnd = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+			if (!LineEnd) LineEnd = end;
+			fn(SkipSpaces(begin, LineEnd), LineEnd);
+			begin = LineEnd + 1;
+		}
+	}
+
+	static ObjLine ClassifyObjLine(const char* line, const char* end)
+	{
+		if (end - line < 2) return ObjLine::Other;
+
+		const bool Separated = line[1] == ' ' || line[1] == '\t';
+		if (line[0] == 'f' && Separated) return ObjLine::Face;
+		if (line[0] != 'v') return ObjLine::Other;
+		if (Separated) return ObjLine::Position;
+		if (line[1] == 't') return ObjLine::TexCoord;
+		if (line[1] == 'n') return ObjLine::Normal;
+		return ObjLine::Other;
+	}
+
+	// Returns the end of the number, or nullptr if there isn't one.
+	static const char* ParseFloat(const char* text, const char* end, float& value)
+	{
+		text = SkipSpaces(text, end);
+		if (text < end && *text == '+') text++;
+		const std::from_chars_result Result = std::from_chars(text, end, value);
+		return Result.ec == std::errc() ? Result.ptr : nullptr;
+	}
+
+	// OBJ indices start at 1; negative ones count back from the last element defined so far.
+	static bool ParseObjIndex(const char*& text, const char* end, uint32_t definedSoFar, int32_t& index)
+	{
+		int32_t Value = 0;
+		const std::from_chars_result Result = std::from_chars(text, end, Value);
+		if (Result.ec != std::errc() || Value == 0) return false;
+
+		text = Result.ptr;
+		index = Value > 0 ? Value - 1 : static_cast<int32_t>(definedSoFar) + Value;
+		return index >= 0;
+	}
+
+	static bool ParseObjFace(const char* text, const char* end, uint32_t positions, uint32_t texCoords, uint32_t normals, std::vector<ObjCorner>& polygon)
+	{
+		polygon.clear();
+		while ((text = SkipSpaces(text, end)) < end)
+		{
+			ObjCorner Corner;
+			if (!ParseObjIndex(text, end, positions, Corner.Position)) return false;
+			if (text < end && *text == '/')
+			{
+				text++;
+				if (text < end && *text != '/' && !ParseObjIndex(text, end, texCoords, Corner.TexCoord)) return false;
+				if (text < end && *text == '/')
+				{
+					text++;
+					if (!ParseObjIndex(text, end, normals, Corner.Normal)) return false;
+				}
+			}
+			polygon.push_back(Corner);
+		}
+		return polygon.size() >= 3;
+	}
+
+	static void CountObjChunk(ObjChunk& chunk)
+	{
+		ForEachLine(chunk.Begin, chunk.End, [&chunk](const char* line, const char* lineEnd)
+		{
+			switch (ClassifyObjLine(line, lineEnd))
+			{
+				case ObjLine::Position:		chunk.PositionCount++; break;
+				case ObjLine::TexCoord:		chunk.TexCoordCount++; break;
+				case ObjLine::Normal:		chunk.NormalCount++; break;
+			default: ;
+			}
+		});
+	}
+
+	// Writes the chunk's attributes straight into the file-wide arrays at the chunk's bases.
+	static void ParseObjChunk(ObjChunk& chunk, std::vector<glm::vec3>& positions, std::vector<glm::vec2>& texCoords, std::vector<glm::vec3>& normals)
+	{
+		uint32_t Positions = chunk.PositionBase;
+		uint32_t TexCoords = chunk.TexCoordBase;
+		uint32_t Normals = chunk.NormalBase;
+		std::vector<ObjCorner> Polygon;
+
+		ForEachLine(chunk.Begin, chunk.End, [&](const char* line, const char* lineEnd)
+		{
+			if (!chunk.Valid) return;
+
+			const char* Text = line + 2;
+			switch (ClassifyObjLine(line, lineEnd))
+			{
+				case ObjLine::Position:
+				{
+					glm::vec3& Position = positions[Positions++];
+					chunk.Valid = (Text = ParseFloat(Text, lineEnd, Position.x)) && (Text = ParseFloat(Text, lineEnd, Position.y)) && ParseFloat(Text, lineEnd, Position.z);
+					break;
+				}
+				case ObjLine::TexCoord:
+				{
+					// A third, w coordinate is allowed and ignored.
+					glm::vec2& TexCoord = texCoords[TexCoords++];
+					chunk.Valid = (Text = ParseFloat(Text, lineEnd, TexCoord.x)) && ParseFloat(Text, lineEnd, TexCoord.y);
+					break;
+				}
+				case ObjLine::Normal:
+				{
+					glm::vec3& Normal = normals[Normals++];
+					chunk.Valid = (Text = ParseFloat(Text, lineEnd, Normal.x)) && (Text = ParseFloat(Text, lineEnd, Normal.y)) && ParseFloat(Text, lineEnd, Normal.z);
+					break;
+				}
+				case ObjLine::Face:
+				{
+					chunk.Valid = ParseObjFace(Text, lineEnd, Positions, TexCoords, Normals, Polygon);
+					for (size_t i = 1; chunk.Valid && i + 1 < Polygon.size(); i++)
+					{
+						chunk.Corners.push_back(Polygon[0]);
+						chunk.Corners.push_back(Polygon[i]);
+						chunk.Corners.push_back(Polygon[i + 1]);
+					}
+					break;
+				}
+			default: ;
+			}
+		});
+	}
+
+	static bool ParseObj(const std::string& filePath, const char* data, size_t size, ImportedGeometry& geometry)
+	{
+		const char* End = data + size;
+		const uint32_t ChunkCount = static_cast<uint32_t>(std::clamp<size_t>(size / MinObjChunkBytes, 1, JobSystem::GetThreadCount() * ObjChunksPerThread));
+
+		std::vector<ObjChunk> Chunks(ChunkCount);
+		const char* Begin = data;
+		for (uint32_t i = 0; i < ChunkCount; i++)
+		{
+			const char* ChunkEnd = i + 1 == ChunkCount ? End : std::max(Begin, data + size * (i + 1) / ChunkCount);
+			// Chunks end after a newline so no line is split between two of them.
+			if (ChunkEnd < End)
+			{
+				const char* Newline = static_cast<const char*>(std::memchr(ChunkEnd, '\n', End - ChunkEnd));
+				ChunkEnd = Newline ? Newline + 1 : End;
+			}
+
+			Chunks[i].Begin = Begin;
+			Chunks[i].End = ChunkEnd;
+			Begin = ChunkEnd;
+		}
+
+		// Counting first gives every chunk its bases, so relative indices resolve while parsing and attributes
+		// don't need merging afterwards.
+		JobSystem::ParallelFor(ChunkCount, 1, [&Chunks](uint32_t begin, uint32_t end, uint32_t)
+		{
+			for (uint32_t i = begin; i < end; i++)
+				CountObjChunk(Chunks[i]);
+		});
+
+		uint32_t PositionCount = 0, TexCoordCount = 0, NormalCount = 0;
+		for (ObjChunk& Chunk : Chunks)
+		{
+			Chunk.PositionBase = PositionCount;
+			Chunk.TexCoordBase = TexCoordCount;
+			Chunk.NormalBase = NormalCount;
+			PositionCount += Chunk.PositionCount;
+			TexCoordCount += Chunk.TexCoordCount;
+			NormalCount += Chunk.NormalCount;
+		}
+
+		std::vector<glm::vec3> Positions(PositionCount);
+		std::vector<glm::vec2> TexCoords(TexCoordCount);
+		std::vector<glm::vec3> Normals(NormalCount);
+		JobSystem::ParallelFor(ChunkCount, 1, [&](uint32_t begin, uint32_t end, uint32_t)
+		{
+			for (uint32_t i = begin; i < end; i++)
+				ParseObjChunk(Chunks[i], Positions, TexCoords, Normals);
+		});
+
+		size_t CornerCount = 0;
+		bool HasNormals = NormalCount > 0;
+		for (const ObjChunk& Chunk : Chunks)
+		{
+			if (!Chunk.Valid)
+			{
+				OHM_CORE_ERROR("Mesh Importer: '{}' has malformed vertex or face data.", filePath);
+				return false;
+			}
+
+			CornerCount += Chunk.Corners.size();
+			for (const ObjCorner& Corner : Chunk.Corners)
+				HasNormals = HasNormals && Corner.Normal >= 0;
+		}
+
+		if (CornerCount == 0)
+		{
+			OHM_CORE_ERROR("Mesh Importer: '{}' has no faces.", filePath);
+			return false;
+		}
+
+		// Every distinct position/texture coordinate/normal combination becomes one vertex.  Normals are only used
+		// when every corner has one; otherwise they are all generated.
+		std::unordered_map<ObjCorner, uint32_t, ObjCornerHash> VertexLookup;
+		VertexLookup.reserve(CornerCount);
+		geometry.Indices.reserve(CornerCount);
+		geometry.Vertices.reserve(CornerCount / 3);
+
+		for (const ObjChunk& Chunk : Chunks)
+		{
+			for (ObjCorner Corner : Chunk.Corners)
+			{
+				if (!HasNormals)
+					Corner.Normal = -1;
+
+				if (static_cast<uint32_t>(Corner.Position) >= PositionCount ||
+					(Corner.TexCoord >= 0 && static_cast<uint32_t>(Corner.TexCoord) >= TexCoordCount) ||
+					(Corner.Normal >= 0 && static_cast<uint32_t>(Corner.Normal) >= NormalCount))
+				{
+					OHM_CORE_ERROR("Mesh Importer: '{}' has a face referencing a vertex that doesn't exist.", filePath);
+					return false;
+				}
+
+				const auto [It, Inserted] = VertexLookup.try_emplace(Corner, static_cast<uint32_t>(geometry.Vertices.size()));
+				if (Inserted)
+				{
+					Vertex& Created = geometry.Vertices.emplace_back();
+					Created.Position = Positions[Corner.Position];
+					if (Corner.TexCoord >= 0)
+						Created.TexCoord = TexCoords[Corner.TexCoord];
+					if (Corner.Normal >= 0)
+						Created.Normal = glm::normalize(Normals[Corner.Normal]);
+				}
+				geometry.Indices.push_back(It->second);
+			}
+		}
+
+		const uint32_t VertexCount = static_cast<uint32_t>(geometry.Vertices.size());
+		if (!HasNormals)
+			GenerateNormals(geometry.Vertices, geometry.Indices, 0, VertexCount, 0, geometry.Indices.size());
+		TangentGenerator::Generate(geometry.Vertices, geometry.Indices, 0, VertexCount, 0, geometry.Indices.size());
+		return true;
+	}
+
+	//-------------------------glTF-------------------------//
+
+	static constexpr uint32_t GltfByte = 5120;
+	static constexpr uint32_t GltfUnsignedByte = 5121;
+	static constexpr uint32_t GltfShort = 5122;
+	static constexpr uint32_t GltfUnsignedShort = 5123;
+	static constexpr uint32_t GltfUnsignedInt = 5125;
+	static constexpr uint32_t GltfFloat = 5126;
+	static constexpr uint32_t GltfTriangles = 4;
+
+	static constexpr uint32_t GlbMagic = 0x46546C67;
+	static constexpr uint32_t GlbJsonChunk = 0x4E4F534A;
+	static constexpr uint32_t GlbBinaryChunk = 0x004E4942;
+
+	struct GltfBuffer
+	{
+		const uint8_t* Data = nullptr;
+		uint64_t Size = 0;
+	};
+
+	// An accessor resolved down to its bytes.  Data is null for attributes the primitive doesn't have.
+	struct GltfAccessor
+	{
+		const uint8_t* Data = nullptr;
+		uint32_t Count = 0;
+		uint32_t Stride = 0;
+		uint32_t ComponentType = 0;
+		uint32_t ComponentCount = 0;
+		bool Normalized = false;
+	};
+
+	// Everything a job needs to decode one primitive, so workers never touch the document.
+	struct GltfPrimitive
+	{
+		GltfAccessor Positions;
+		GltfAccessor Normals;
+		GltfAccessor Tangents;
+		GltfAccessor TexCoords;
+		GltfAccessor Indices;
+		glm::mat4 Transform { 1.0f };
+
+		uint32_t VertexOffset = 0;
+		uint32_t VertexCount = 0;
+		size_t IndexOffset = 0;
+		uint32_t IndexCount = 0;
+	};
+
+	static uint32_t GetGltfComponentSize(uint32_t componentType)
+	{
+		switch (componentType)
+		{
+			case GltfByte:
+			case GltfUnsignedByte:		return 1;
+			case GltfShort:
+			case GltfUnsignedShort:		return 2;
+			case GltfUnsignedInt:
+			case GltfFloat:				return 4;
+		default: ;
+		}
+		return 0;
+	}
+
+	static uint32_t GetGltfComponentCount(const std::string& type)
+	{
+		if (type == "SCALAR") return 1;
+		if (type == "VEC2") return 2;
+		if (type == "VEC3") return 3;
+		if (type == "VEC4") return 4;
+		return 0;
+	}
+
+	static float ReadGltfComponent(const uint8_t* data, uint32_t componentType, bool normalized)
+	{
+		switch (componentType)
+		{
+			case GltfFloat:				{ float Value; std::memcpy(&Value, data, sizeof(Value)); return Value; }
+			case GltfUnsignedInt:		{ uint32_t Value; std::memcpy(&Value, data, sizeof(Value)); return static_cast<float>(Value); }
+			case GltfUnsignedByte:		return normalized ? *data / 255.0f : *data;
+			case GltfByte:				{ const float Value = static_cast<int8_t>(*data); return normalized ? std::max(Value / 127.0f, -1.0f) : Value; }
+			case GltfUnsignedShort:		{ uint16_t Value; std::memcpy(&Value, data, sizeof(Value)); return normalized ? Value / 65535.0f : Value; }
+			case GltfShort:				{ int16_t Value; std::memcpy(&Value, data, sizeof(Value)); return normalized ? std::max(Value / 32767.0f, -1.0f) : Value; }
+		default: ;
+		}
+		return 0.0f;
+	}
+
+	static glm::vec4 ReadGltfElement(const GltfAccessor& accessor, uint32_t element)
+	{
+		glm::vec4 Value(0.0f);
+		const uint8_t* Element = accessor.Data + static_cast<size_t>(element) * accessor.Stride;
+		const uint32_t ComponentSize = GetGltfComponentSize(accessor.ComponentType);
+		for (uint32_t i = 0; i < accessor.ComponentCount; i++)
+			Value[i] = ReadGltfComponent(Element + i * ComponentSize, accessor.ComponentType, accessor.Normalized);
+		return Value;
+	}
+
+	static uint32_t ReadGltfIndex(const GltfAccessor& accessor, uint32_t element)
+	{
+		const uint8_t* Element = accessor.Data + static_cast<size_t>(element) * accessor.Stride;
+		switch (accessor.ComponentType)
+		{
+			case GltfUnsignedByte:		return *Element;
+			case GltfUnsignedShort:		{ uint16_t Index; std::memcpy(&Index, Element, sizeof(Index)); return Index; }
+			case GltfUnsignedInt:		{ uint32_t Index; std::memcpy(&Index, Element, sizeof(Index)); return Index; }
+		default: ;
+		}
+		return 0;
+	}
+
+	static bool ResolveGltfAccessor(const YAML::Node& document, const std::vector<GltfBuffer>& buffers, const YAML::Node& accessorIndex, uint32_t componentCount, GltfAccessor& accessor)
+	{
+		const YAML::Node Accessors = document["accessors"];
+		const uint32_t Index = accessorIndex.as<uint32_t>();
+		if (!Accessors || Index >= Accessors.size()) return false;
+
+		// Accessors without a buffer view are all zeros, and sparse ones patch their view; neither is worth
+		// supporting for mesh attributes.
+		const YAML::Node Accessor = Accessors[Index];
+		if (!Accessor["bufferView"] || Accessor["sparse"]) return false;
+
+		const YAML::Node BufferViews = document["bufferViews"];
+		const uint32_t ViewIndex = Accessor["bufferView"].as<uint32_t>();
+		if (!BufferViews || ViewIndex >= BufferViews.size()) return false;
+
+		const YAML::Node View = BufferViews[ViewIndex];
+		const uint32_t BufferIndex = View["buffer"].as<uint32_t>();
+		if (BufferIndex >= buffers.size()) return false;
+
+		accessor.ComponentType = Accessor["componentType"].as<uint32_t>();
+		accessor.ComponentCount = GetGltfComponentCount(Accessor["type"].as<std::string>());
+		accessor.Count = Accessor["count"].as<uint32_t>();
+		accessor.Normalized = Accessor["normalized"] && Accessor["normalized"].as<bool>();
+
+		const uint32_t ComponentSize = GetGltfComponentSize(accessor.ComponentType);
+		if (ComponentSize == 0 || accessor.ComponentCount != componentCount) return false;
+
+		const uint32_t ElementSize = ComponentSize * accessor.ComponentCount;
+		accessor.Stride = View["byteStride"] ? View["byteStride"].as<uint32_t>() : ElementSize;
+
+		const uint64_t ViewOffset = View["byteOffset"] ? View["byteOffset"].as<uint64_t>() : 0;
+		const uint64_t ViewLength = View["byteLength"].as<uint64_t>();
+		const uint64_t AccessorOffset = Accessor["byteOffset"] ? Accessor["byteOffset"].as<uint64_t>() : 0;
+		if (ViewOffset + ViewLength > buffers[BufferIndex].Size) return false;
+		// The last element only needs its own size, not a whole stride.
+		if (accessor.Count > 0 && AccessorOffset + static_cast<uint64_t>(accessor.Count - 1) * accessor.Stride + ElementSize > ViewLength) return false;
+
+		accessor.Data = buffers[BufferIndex].Data + ViewOffset + AccessorOffset;
+		return true;
+	}
+
+	static void CollectGltfMesh(const YAML::Node& document, const std::vector<GltfBuffer>& buffers, uint32_t meshIndex, const glm::mat4& transform,
+		const std::string& filePath, std::vector<GltfPrimitive>& primitives)
+	{
+		const YAML::Node Meshes = document["meshes"];
+		if (!Meshes || meshIndex >= Meshes.size()) return;
+
+		for (const YAML::Node& Source : Meshes[meshIndex]["primitives"])
+		{
+			const uint32_t Mode = Source["mode"] ? Source["mode"].as<uint32_t>() : GltfTriangles;
+			const YAML::Node Attributes = Source["attributes"];
+
+			GltfPrimitive Primitive;
+			Primitive.Transform = transform;
+			if (Mode != GltfTriangles || !Attributes["POSITION"] ||
+				!ResolveGltfAccessor(document, buffers, Attributes["POSITION"], 3, Primitive.Positions) ||
+				(Source["indices"] && !ResolveGltfAccessor(document, buffers, Source["indices"], 1, Primitive.Indices)))
+			{
+				OHM_CORE_WARN("Mesh Importer: Skipped a primitive of '{}' that isn't an indexed or plain triangle list.", filePath);
+				continue;
+			}
+
+			// Optional attributes that can't be read, or don't match the positions, are generated instead.
+			Primitive.VertexCount = Primitive.Positions.Count;
+			const auto ResolveOptional = [&](const char* name, uint32_t componentCount, GltfAccessor& accessor)
+			{
+				if (Attributes[name] && (!ResolveGltfAccessor(document, buffers, Attributes[name], componentCount, accessor) || accessor.Count != Primitive.VertexCount))
+					accessor = GltfAccessor();
+			};
+			ResolveOptional("NORMAL", 3, Primitive.Normals);
+			ResolveOptional("TANGENT", 4, Primitive.Tangents);
+			ResolveOptional("TEXCOORD_0", 2, Primitive.TexCoords);
+
+			Primitive.IndexCount = Primitive.Indices.Data ? Primitive.Indices.Count : Primitive.VertexCount;
+			Primitive.IndexCount -= Primitive.IndexCount % 3;
+			if (Primitive.IndexCount > 0)
+				primitives.push_back(Primitive);
+		}
+	}
+
+	static glm::mat4 GetGltfNodeTransform(const YAML::Node& node)
+	{
+		if (const YAML::Node Matrix = node["matrix"])
+		{
+			// Column major, like glm.
+			glm::mat4 Transform;
+			for (uint32_t i = 0; i < 16; i++)
+				Transform[i / 4][i % 4] = Matrix[i].as<float>();
+			return Transform;
+		}
+
+		glm::vec3 Translation(0.0f), Scale(1.0f);
+		glm::quat Rotation(1.0f, 0.0f, 0.0f, 0.0f);
+		if (const YAML::Node T = node["translation"])
+			Translation = { T[0].as<float>(), T[1].as<float>(), T[2].as<float>() };
+		if (const YAML::Node R = node["rotation"])
+			Rotation = glm::quat(R[3].as<float>(), R[0].as<float>(), R[1].as<float>(), R[2].as<float>());
+		if (const YAML::Node S = node["scale"])
+			Scale = { S[0].as<float>(), S[1].as<float>(), S[2].as<float>() };
+
+		return glm::translate(glm::mat4(1.0f), Translation) * glm::mat4_cast(Rotation) * glm::scale(glm::mat4(1.0f), Scale);
+	}
+
+	static void CollectGltfNode(const YAML::Node& document, const std::vector<GltfBuffer>& buffers, uint32_t nodeIndex, const glm::mat4& parentTransform,
+		uint32_t depth, const std::string& filePath, std::vector<GltfPrimitive>& primitives)
+	{
+		const YAML::Node Nodes = document["nodes"];
+		// Node hierarchies can't have cycles, so deeper than the node count means a malformed file.
+		if (!Nodes || nodeIndex >= Nodes.size() || depth > Nodes.size()) return;
+
+		const YAML::Node Node = Nodes[nodeIndex];
+		const glm::mat4 Transform = parentTransform * GetGltfNodeTransform(Node);
+		if (Node["mesh"])
+			CollectGltfMesh(document, buffers, Node["mesh"].as<uint32_t>(), Transform, filePath, primitives);
+
+		for (const YAML::Node& Child : Node["children"])
+			CollectGltfNode(document, buffers, Child.as<uint32_t>(), Transform, depth + 1, filePath, primitives);
+	}
+
+	static bool DecodeBase64(const std::string& text, size_t begin, std::vector<uint8_t>& bytes)
+	{
+		const auto DecodeCharacter = [](char c) -> int32_t
+		{
+			if (c >= 'A' && c <= 'Z') return c - 'A';
+			if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+			if (c >= '0' && c <= '9') return c - '0' + 52;
+			if (c == '+') return 62;
+			if (c == '/') return 63;
+			return -1;
+		};
+
+		bytes.reserve((text.size() - begin) * 3 / 4);
+		uint32_t Accumulator = 0;
+		uint32_t Bits = 0;
+		for (size_t i = begin; i < text.size() && text[i] != '='; i++)
+		{
+			const int32_t Value = DecodeCharacter(text[i]);
+			if (Value < 0) return false;
+
+			Accumulator = Accumulator << 6 | static_cast<uint32_t>(Value);
+			Bits += 6;
+			if (Bits >= 8)
+			{
+				Bits -= 8;
+				bytes.push_back(static_cast<uint8_t>(Accumulator >> Bits));
+			}
+		}
+		return true;
+	}
+
+	// Writes the primitive's vertices and indices straight into its own ranges of the geometry.
+	static bool DecodeGltfPrimitive(const GltfPrimitive& primitive, ImportedGeometry& geometry)
+	{
+		const glm::mat3 Linear(primitive.Transform);
+		const glm::mat3 NormalMatrix = glm::transpose(glm::inverse(Linear));
+		// A mirroring transform flips the winding and the tangent frame's handedness.
+		const bool Mirrored = glm::determinant(Linear) < 0.0f;
+
+		for (uint32_t i = 0; i < primitive.VertexCount; i++)
+		{
+			Vertex& Decoded = geometry.Vertices[primitive.VertexOffset + i];
+			Decoded.Position = glm::vec3(primitive.Transform * glm::vec4(glm::vec3(ReadGltfElement(primitive.Positions, i)), 1.0f));
+
+			if (primitive.Normals.Data)
+				Decoded.Normal = glm::normalize(NormalMatrix * glm::vec3(ReadGltfElement(primitive.Normals, i)));
+
+			// glTF puts the texture origin at the top left; textures are loaded flipped, so V is flipped to match.
+			if (primitive.TexCoords.Data)
+			{
+				const glm::vec4 TexCoord = ReadGltfElement(primitive.TexCoords, i);
+				Decoded.TexCoord = { TexCoord.x, 1.0f - TexCoord.y };
+			}
+
+			if (primitive.Normals.Data && primitive.Tangents.Data)
+			{
+				const glm::vec4 Tangent = ReadGltfElement(primitive.Tangents, i);
+				Decoded.Tangent = glm::normalize(Linear * glm::vec3(Tangent));
+				// glTF's bitangent is cross(normal, tangent) * w and points along +V, which the flip above reverses.
+				const float Handedness = (Tangent.w < 0.0f ? -1.0f : 1.0f) * (Mirrored ? -1.0f : 1.0f);
+				Decoded.Binormal = -glm::cross(Decoded.Normal, Decoded.Tangent) * Handedness;
+			}
+		}
+
+		bool Valid = true;
+		for (uint32_t i = 0; i < primitive.IndexCount; i += 3)
+		{
+			uint32_t Triangle[3];
+			for (uint32_t Corner = 0; Corner < 3; Corner++)
+			{
+				Triangle[Corner] = primitive.Indices.Data ? ReadGltfIndex(primitive.Indices, i + Corner) : i + Corner;
+				if (Triangle[Corner] >= primitive.VertexCount)
+				{
+					Valid = false;
+					Triangle[Corner] = 0;
+				}
+			}
+			if (Mirrored)
+				std::swap(Triangle[1], Triangle[2]);
+
+			for (uint32_t Corner = 0; Corner < 3; Corner++)
+				geometry.Indices[primitive.IndexOffset + i + Corner] = primitive.VertexOffset + Triangle[Corner];
+		}
+
+		const uint32_t VertexEnd = primitive.VertexOffset + primitive.VertexCount;
+		const size_t IndexEnd = primitive.IndexOffset + primitive.IndexCount;
+		if (!primitive.Normals.Data)
+			GenerateNormals(geometry.Vertices, geometry.Indices, primitive.VertexOffset, VertexEnd, primitive.IndexOffset, IndexEnd);
+		if (!primitive.Normals.Data || !primitive.Tangents.Data)
+			TangentGenerator::Generate(geometry.Vertices, geometry.Indices, primitive.VertexOffset, VertexEnd, primitive.IndexOffset, IndexEnd);
+		return Valid;
+	}
+
+	static bool ParseGltf(const std::string& filePath, const uint8_t* data, size_t size, ImportedGeometry& geometry)
+	{
+		std::string Json;
+		GltfBuffer BinaryChunk;
+
+		uint32_t Magic = 0;
+		if (size >= sizeof(Magic))
+			std::memcpy(&Magic, data, sizeof(Magic));
+
+		if (Magic == GlbMagic)
+		{
+			// 12 byte header, then chunks of a length, a type and the data.
+			for (size_t Offset = 12; Offset + 8 <= size;)
+			{
+				uint32_t ChunkHeader[2];
+				std::memcpy(ChunkHeader, data + Offset, sizeof(ChunkHeader));
+				Offset += sizeof(ChunkHeader);
+				if (ChunkHeader[0] > size - Offset) break;
+
+				if (ChunkHeader[1] == GlbJsonChunk)
+					Json.assign(reinterpret_cast<const char*>(data + Offset), ChunkHeader[0]);
+				else if (ChunkHeader[1] == GlbBinaryChunk)
+					BinaryChunk = { data + Offset, ChunkHeader[0] };
+				Offset += ChunkHeader[0];
+			}
+		}
+		else
+			Json.assign(reinterpret_cast<const char*>(data), size);
+
+		std::vector<GltfPrimitive> Primitives;
+		// Keep the external and embedded buffers alive while the primitives are decoded.
+		std::vector<Scope<MappedFile>> MappedBuffers;
+		std::vector<std::vector<uint8_t>> DecodedBuffers;
+
+		try
+		{
+			// yaml-cpp reads JSON, which saves a second parser.
+			const YAML::Node Document = YAML::Load(Json);
+			const std::filesystem::path Directory = std::filesystem::path(filePath).parent_path();
+
+			std::vector<GltfBuffer> Buffers;
+			for (const YAML::Node& Buffer : Document["buffers"])
+			{
+				const uint64_t ByteLength = Buffer["byteLength"].as<uint64_t>();
+				GltfBuffer Resolved;
+
+				if (!Buffer["uri"])
+					Resolved = BinaryChunk;
+				else
+				{
+					const std::string Uri = Buffer["uri"].as<std::string>();
+					if (Uri.compare(0, 5, "data:") == 0)
+					{
+						const size_t Base64 = Uri.find(";base64,");
+						std::vector<uint8_t>& Decoded = DecodedBuffers.emplace_back();
+						if (Base64 != std::string::npos && DecodeBase64(Uri, Base64 + 8, Decoded))
+							Resolved = { Decoded.data(), Decoded.size() };
+					}
+					else
+					{
+						const Scope<MappedFile>& Mapped = MappedBuffers.emplace_back(CreateScope<MappedFile>((Directory / Uri).string()));
+						Resolved = { Mapped->GetData(), Mapped->GetSize() };
+					}
+				}
+
+				if (!Resolved.Data || Resolved.Size < ByteLength)
+				{
+					OHM_CORE_ERROR("Mesh Importer: '{}' has a buffer that is missing or shorter than declared.", filePath);
+					return false;
+				}
+				Buffers.push_back({ Resolved.Data, ByteLength });
+			}
+
+			const YAML::Node Nodes = Document["nodes"];
+			std::vector<uint32_t> Roots;
+			if (const YAML::Node Scenes = Document["scenes"])
+			{
+				const uint32_t SceneIndex = Document["scene"] ? Document["scene"].as<uint32_t>() : 0;
+				if (SceneIndex < Scenes.size())
+					for (const YAML::Node& Root : Scenes[SceneIndex]["nodes"])
+						Roots.push_back(Root.as<uint32_t>());
+			}
+			else if (Nodes)
+			{
+				// Without scenes, every node that isn't a child is a root.
+				std::vector<uint8_t> IsChild(Nodes.size(), 0);
+				for (const YAML::Node& Node : Nodes)
+					for (const YAML::Node& Child : Node["children"])
+						if (Child.as<uint32_t>() < IsChild.size())
+							IsChild[Child.as<uint32_t>()] = 1;
+				for (uint32_t i = 0; i < IsChild.size(); i++)
+					if (!IsChild[i])
+						Roots.push_back(i);
+			}
+
+			for (const uint32_t Root : Roots)
+				CollectGltfNode(Document, Buffers, Root, glm::mat4(1.0f), 0, filePath, Primitives);
+
+			// A file of bare meshes is imported as it is.
+			if (Roots.empty() && Document["meshes"])
+				for (uint32_t i = 0; i < Document["meshes"].size(); i++)
+					CollectGltfMesh(Document, Buffers, i, glm::mat4(1.0f), filePath, Primitives);
+		}
+		catch (const YAML::Exception& e)
+		{
+			OHM_CORE_ERROR("Mesh Importer: '{}' isn't valid glTF: {}", filePath, e.what());
+			return false;
+		}
+
+		if (Primitives.empty())
+		{
+			OHM_CORE_ERROR("Mesh Importer: '{}' has no triangles.", filePath);
+			return false;
+		}
+
+		uint64_t VertexCount = 0;
+		size_t IndexCount = 0;
+		for (GltfPrimitive& Primitive : Primitives)
+		{
+			Primitive.VertexOffset = static_cast<uint32_t>(VertexCount);
+			Primitive.IndexOffset = IndexCount;
+			VertexCount += Primitive.VertexCount;
+			IndexCount += Primitive.IndexCount;
+		}
+
+		if (VertexCount > UINT32_MAX)
+		{
+			OHM_CORE_ERROR("Mesh Importer: '{}' has more vertices than 32-bit indices can address.", filePath);
+			return false;
+		}
+
+		geometry.Vertices.resize(VertexCount);
+		geometry.Indices.resize(IndexCount);
+
+		std::atomic<bool> Valid{ true };
+		JobSystem::ParallelFor(static_cast<uint32_t>(Primitives.size()), 1, [&](uint32_t begin, uint32_t end, uint32_t)
+		{
+			for (uint32_t i = begin; i < end; i++)
+				if (!DecodeGltfPrimitive(Primitives[i], geometry))
+					Valid = false;
+		});
+
+		if (!Valid)
+		{
+			OHM_CORE_ERROR("Mesh Importer: '{}' has indices past the end of their vertices.", filePath);
+			return false;
+		}
+		return true;
+	}
+
+	//-------------------------Cache-------------------------//
+
+	static Ref<Mesh> LoadCache(const std::string& cachePath, const SourceStamp& stamp, VertexFormat vertexFormat, MeshResidency residency)
+	{
+		const MappedFile Cache(cachePath);
+		if (!Cache.IsValid() || Cache.GetSize() < sizeof(MeshCacheHeader))
+			return nullptr;
+
+		MeshCacheHeader Header;
+		std::memcpy(&Header, Cache.GetData(), sizeof(Header));
+		if (std::memcmp(Header.Magic, CacheMagic, sizeof(CacheMagic)) != 0 || Header.Version != MeshImporter::CacheVersion || Header.VertexSize != sizeof(Vertex) ||
+			Header.SourceSize != stamp.Size || Header.SourceWriteTime != stamp.WriteTime)
+		{
+			OHM_CORE_TRACE("Mesh Importer: '{}' is out of date.", cachePath);
+			return nullptr;
+		}
+
+		const uint64_t LODBytes = static_cast<uint64_t>(Header.LODCount) * sizeof(MeshLOD);
+		const uint64_t MeshletBytes = static_cast<uint64_t>(Header.MeshletCount) * sizeof(Meshlet);
+		const uint64_t VertexBytes = static_cast<uint64_t>(Header.VertexCount) * sizeof(Vertex);
+		const uint64_t IndexBytes = static_cast<uint64_t>(Header.IndexCount) * sizeof(uint32_t);
+		bool Valid = Header.VertexCount > 0 && Header.IndexCount > 0 && Header.LODCount > 0 && Header.LODCount <= MaxMeshLODs &&
+			sizeof(MeshCacheHeader) + LODBytes + MeshletBytes + VertexBytes + IndexBytes == Cache.GetSize();
+
+		PreparedMeshData Prepared;
+		Prepared.LODs = reinterpret_cast<const MeshLOD*>(Cache.GetData() + sizeof(MeshCacheHeader));
+		for (uint32_t i = 0; Valid && i < Header.LODCount; i++)
+			Valid = static_cast<uint64_t>(Prepared.LODs[i].IndexOffset) + Prepared.LODs[i].IndexCount <= Header.IndexCount;
+
+		Prepared.Meshlets = reinterpret_cast<const Meshlet*>(Cache.GetData() + sizeof(MeshCacheHeader) + LODBytes);
+		for (uint32_t i = 0; Valid && i < Header.MeshletCount; i++)
+			Valid = static_cast<uint64_t>(Prepared.Meshlets[i].IndexOffset) + Prepared.Meshlets[i].IndexCount <= Prepared.LODs[0].IndexCount;
+
+		// Every index is checked too; the mesh and the pool trust them, and one past the vertices reads out of bounds.
+		const uint32_t* Indices = reinterpret_cast<const uint32_t*>(Cache.GetData() + sizeof(MeshCacheHeader) + LODBytes + MeshletBytes + VertexBytes);
+		for (uint32_t i = 0; Valid && i < Header.IndexCount; i++)
+			Valid = Indices[i] < Header.VertexCount;
+
+		if (!Valid || Prepared.LODs[0].IndexOffset != 0)
+		{
+			OHM_CORE_WARN("Mesh Importer: '{}' is corrupt and will be rebuilt.", cachePath);
+			return nullptr;
+		}
+
+		Prepared.LODCount = Header.LODCount;
+		Prepared.MeshletCount = Header.MeshletCount;
+		Prepared.Vertices = reinterpret_cast<const Vertex*>(Cache.GetData() + sizeof(MeshCacheHeader) + LODBytes + MeshletBytes);
+		Prepared.VertexCount = Header.VertexCount;
+		Prepared.Indices = Indices;
+		Prepared.IndexCount = Header.IndexCount;
+		Prepared.Bounds = Header.Bounds;
+		Prepared.OptimizationReport = Header.OptimizationReport;
+
+		// Uploads straight from the mapping; nothing is copied unless the residency keeps a CPU copy.
+		return CreateRef<Mesh>(Prepared, vertexFormat, residency);
+	}
+
+	static void WriteCache(const std::string& cachePath, const SourceStamp& stamp, const Mesh& mesh)
+	{
+		const std::vector<Vertex>& Vertices = mesh.GetVertices();
+		const std::vector<uint32_t>& Indices = mesh.GetIndices();
+		const std::vector<uint32_t>& LODIndices = mesh.GetLODIndices();
+		const std::vector<MeshLOD>& LODs = mesh.GetLODs();
+		const std::vector<Meshlet>& Meshlets = mesh.GetMeshlets();
+
+		MeshCacheHeader Header = {};
+		std::memcpy(Header.Magic, CacheMagic, sizeof(CacheMagic));
+		Header.Version = MeshImporter::CacheVersion;
+		Header.SourceSize = stamp.Size;
+		Header.SourceWriteTime = stamp.WriteTime;
+		Header.VertexSize = sizeof(Vertex);
+		Header.VertexCount = static_cast<uint32_t>(Vertices.size());
+		Header.IndexCount = static_cast<uint32_t>(Indices.size() + LODIndices.size());
+		Header.LODCount = static_cast<uint32_t>(LODs.size());
+		Header.Bounds = mesh.GetBounds();
+		Header.OptimizationReport = mesh.GetOptimizationReport();
+		Header.MeshletCount = static_cast<uint32_t>(Meshlets.size());
+
+		AssetCache::Write(cachePath, {
+			{ &Header, sizeof(Header) },
+			{ LODs.data(), LODs.size() * sizeof(MeshLOD) },
+			{ Meshlets.data(), Meshlets.size() * sizeof(Meshlet) },
+			{ Vertices.data(), Vertices.size() * sizeof(Vertex) },
+			{ Indices.data(), Indices.size() * sizeof(uint32_t) },
+			{ LODIndices.data(), LODIndices.size() * sizeof(uint32_t) } });
+	}
+
+	static std::string GetExtension(const std::string& filePath)
+	{
+		std::string Extension = std::filesystem::path(filePath).extension().string();
+		std::transform(Extension.begin(), Extension.end(), Extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return Extension;
+	}
+
+	bool MeshImporter::IsSupported(const std::string& filePath)
+	{
+		const std::string Extension = GetExtension(filePath);
+		return Extension == ".obj" || Extension == ".gltf" || Extension == ".glb";
+	}
+
+	std::string MeshImporter::GetCachePath(const std::string& filePath)
+	{
+		return filePath + CacheExtension;
+	}
+
+	Ref<Mesh> MeshImporter::Load(const std::string& filePath, VertexFormat vertexFormat, MeshResidency residency)
+	{
+		const auto Start = std::chrono::steady_clock::now();
+
+		SourceStamp Stamp;
+		if (!IsSupported(filePath) || !AssetCache::GetSourceStamp(filePath, Stamp))
+		{
+			OHM_CORE_ERROR("Mesh Importer: Can't import '{}'; expected an existing .obj, .gltf or .glb file.", filePath);
+			return nullptr;
+		}
+
+		const std::string CachePath = GetCachePath(filePath);
+		if (Ref<Mesh> Cached = LoadCache(CachePath, Stamp, vertexFormat, residency))
+		{
+			Cached->SetSourcePath(filePath);
+			OHM_CORE_INFO("Mesh Importer: Loaded '{}' ({} triangles) from its cache in {:.2f} ms.", filePath, Cached->GetTriangleCount(), MillisecondsSince(Start));
+			return Cached;
+		}
+
+		ImportedGeometry Geometry;
+		{
+			const MappedFile Source(filePath);
+			if (!Source.IsValid())
+			{
+				OHM_CORE_ERROR("Mesh Importer: Can't read '{}'.", filePath);
+				return nullptr;
+			}
+
+			const bool Parsed = GetExtension(filePath) == ".obj" ?
+				ParseObj(filePath, reinterpret_cast<const char*>(Source.GetData()), Source.GetSize(), Geometry) :
+				ParseGltf(filePath, Source.GetData(), Source.GetSize(), Geometry);
+			if (!Parsed)
+				return nullptr;
+		}
+		const float ParseMilliseconds = MillisecondsSince(Start);
+
+		const Ref<Mesh> Imported = CreateRef<Mesh>(Geometry.Vertices, Geometry.Indices, Primitive::None, vertexFormat, true, true);
+		Geometry = ImportedGeometry();
+
+		WriteCache(CachePath, Stamp, *Imported);
+		Imported->SetResidency(residency);
+		Imported->SetSourcePath(filePath);
+
+		OHM_CORE_INFO("Mesh Importer: Imported '{}' ({} vertices, {} triangles, {} LODs) in {:.2f} ms, {:.2f} ms of it parsing.",
+			filePath, Imported->GetVertexCount(), Imported->GetTriangleCount(), Imported->GetLODCount(), MillisecondsSince(Start), ParseMilliseconds);
+		return Imported;
+	}
+}
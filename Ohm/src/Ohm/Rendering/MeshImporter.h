@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Ohm/Rendering/Mesh.h"
+
+namespace Ohm
+{
+	/*
+	 * Loads meshes from Wavefront OBJ and glTF 2.0 (.gltf with external or embedded buffers, and .glb) files.
+	 *
+	 * Files are parsed on the job system: OBJ files are split into line-aligned chunks, glTF files into their
+	 * primitives.  Every primitive of the default scene is baked into one mesh with its node transforms applied.
+	 * Missing normals and tangents are generated.  The result goes through the usual optimization, LOD generation and
+	 * meshlet building and is then written to a binary cache next to the source file, "<file>.ohmmesh".
+	 *
+	 * The next load of an unchanged file maps the cache into memory and uploads from it as it is, without parsing,
+	 * optimizing or copying anything.  A cache is rebuilt when the source file's size or modification time no longer
+	 * match, or when it was written with a different CacheVersion.
+	 *
+	 * Loading creates GL buffers, so it has the same threading rules as creating any other mesh.
+	 */
+	class MeshImporter
+	{
+	public:
+		// Bump whenever the cache layout, Vertex, or anything that changes the cached geometry changes.
+		static constexpr uint32_t CacheVersion = 3;
+
+		// Returns nullptr, with an error logged, if the file can't be read or parsed.
+		static Ref<Mesh> Load(const std::string& filePath, VertexFormat vertexFormat = VertexFormat::Full, MeshResidency residency = MeshResidency::DropAfterUpload);
+		static bool IsSupported(const std::string& filePath);
+		static std::string GetCachePath(const std::string& filePath);
+	};
+}
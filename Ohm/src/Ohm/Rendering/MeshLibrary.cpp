@@ -0,0 +1,149 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/MeshLibrary.h"
+#include "Ohm/Rendering/MeshImporter.h"
+#include "Ohm/Core/Hash.h"
+
+#include <future>
+
+namespace Ohm
+{
+	struct MeshLibraryEntry
+	{
+		std::weak_ptr<Mesh> Built;
+		// Valid while a thread is building the mesh; other requests for the key wait on it rather than build it again.
+		std::shared_future<Ref<Mesh>> Building;
+	};
+
+	static std::mutex s_MeshLibraryMutex;
+	static std::unordered_map<std::string, MeshLibraryEntry> s_Meshes;
+
+	// Defaults MeshFactory::Create uses for the parameterized primitives.
+	static constexpr float DefaultSphereRadius = 1.0f;
+	static constexpr uint32_t DefaultIcosphereLevel = 5;
+	static constexpr float DefaultIcosphereRadius = 1.0f;
+	static constexpr uint32_t DefaultTessellatedQuadResolution = 10;
+
+	Ref<Mesh> MeshLibrary::GetOrCreate(const std::string& key, const std::function<Ref<Mesh>()>& generate)
+	{
+		std::promise<Ref<Mesh>> Promise;
+		{
+			std::unique_lock<std::mutex> Lock(s_MeshLibraryMutex);
+
+			MeshLibraryEntry& Entry = s_Meshes[key];
+			if (Ref<Mesh> Existing = Entry.Built.lock())
+				return Existing;
+
+			if (Entry.Building.valid())
+			{
+				const std::shared_future<Ref<Mesh>> Building = Entry.Building;
+				Lock.unlock();
+				return Building.get();
+			}
+			Entry.Building = Promise.get_future().share();
+		}
+
+		// Built without the lock, so an import doesn't hold up requests for other meshes or GetStats.
+		Ref<Mesh> Created = generate();
+		// Nothing reads shared geometry back on the CPU every frame, so it doesn't hold a second copy of it.
+		if (Created)
+			Created->SetResidency(MeshResidency::DropAfterUpload);
+
+		{
+			std::lock_guard<std::mutex> Lock(s_MeshLibraryMutex);
+			MeshLibraryEntry& Entry = s_Meshes[key];
+			Entry.Building = {};
+			// Failed imports aren't remembered, so a fixed file can be tried again.
+			if (Created)
+				Entry.Built = Created;
+		}
+		Promise.set_value(Created);
+
+		if (Created)
+			OHM_CORE_TRACE("Mesh Library: Built '{}'.", key);
+		return Created;
+	}
+
+	Ref<Mesh> MeshLibrary::GetPrimitive(Primitive primitiveType)
+	{
+		switch (primitiveType)
+		{
+			case Primitive::Sphere:				return GetSphere(DefaultSphereRadius);
+			case Primitive::Icosphere:			return GetIcosphere(DefaultIcosphereLevel, DefaultIcosphereRadius);
+			case Primitive::TessellatedQuad:	return GetTessellatedQuad(DefaultTessellatedQuadResolution);
+			case Primitive::None:				return nullptr;
+		default: ;
+		}
+
+		// The rest take no parameters.
+		return GetOrCreate(MeshFactory::MeshPrimitiveToString(primitiveType), [primitiveType]() { return MeshFactory::Create(primitiveType); });
+	}
+
+	Ref<Mesh> MeshLibrary::GetSphere(float radius)
+	{
+		return GetOrCreate(fmt::format("Sphere({})", radius), [radius]() { return MeshFactory::Sphere(radius); });
+	}
+
+	Ref<Mesh> MeshLibrary::GetIcosphere(uint32_t level, float radius)
+	{
+		return GetOrCreate(fmt::format("Icosphere({}, {})", level, radius), [level, radius]() { return MeshFactory::Icosphere(level, radius); });
+	}
+
+	Ref<Mesh> MeshLibrary::GetTessellatedQuad(uint32_t resolution)
+	{
+		return GetOrCreate(fmt::format("TessellatedQuad({})", resolution), [resolution]() { return MeshFactory::TessellatedQuad(resolution); });
+	}
+
+	// A hit isn't compared against the data, which the shared mesh no longer keeps, so the key relies on 128 bit
+	// hashes.  They're of the raw bytes; Vertex is all floats, so there's no padding to differ between equal meshes.
+	static std::string GetContentKey(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, VertexFormat vertexFormat)
+	{
+		const Hash128 VertexHash = HashBytes128(vertices.data(), vertices.size() * sizeof(Vertex));
+		const Hash128 IndexHash = HashBytes128(indices.data(), indices.size() * sizeof(uint32_t));
+
+		return fmt::format("Content({:016x}{:016x}, {:016x}{:016x}, {}, {}, {})", VertexHash.High, VertexHash.Low, IndexHash.High, IndexHash.Low,
+			vertices.size(), indices.size(), static_cast<uint32_t>(vertexFormat));
+	}
+
+	Ref<Mesh> MeshLibrary::GetImported(const std::string& filePath, VertexFormat vertexFormat)
+	{
+		// The path key saves importing the same file twice.  Behind it, the import is shared by content, so the same
+		// geometry reached through another path or a re-exported file ends up as one mesh; a duplicate is dropped
+		// as soon as it's hashed.  A cache hit and a fresh import hash the same optimized data.
+		return GetOrCreate(fmt::format("File({}, {})", filePath, static_cast<uint32_t>(vertexFormat)), [&filePath, vertexFormat]()
+			{
+				const Ref<Mesh> Imported = MeshImporter::Load(filePath, vertexFormat, MeshResidency::Keep);
+				if (!Imported)
+					return Imported;
+
+				return GetOrCreate(GetContentKey(Imported->GetVertices(), Imported->GetIndices(), vertexFormat), [&Imported]() { return Imported; });
+			});
+	}
+
+	Ref<Mesh> MeshLibrary::GetOrCreate(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, VertexFormat vertexFormat)
+	{
+		return GetOrCreate(GetContentKey(vertices, indices, vertexFormat), [&vertices, &indices, vertexFormat]() { return CreateRef<Mesh>(vertices, indices, Primitive::None, vertexFormat); });
+	}
+
+	MeshLibrary::Statistics MeshLibrary::GetStats()
+	{
+		std::lock_guard<std::mutex> Lock(s_MeshLibraryMutex);
+
+		Statistics Stats;
+		for (auto It = s_Meshes.begin(); It != s_Meshes.end();)
+		{
+			const Ref<Mesh> Alive = It->second.Built.lock();
+			if (!Alive)
+			{
+				It = It->second.Building.valid() ? std::next(It) : s_Meshes.erase(It);
+				continue;
+			}
+
+			Stats.MeshCount++;
+			// Less the reference taken just above.
+			Stats.HandleCount += static_cast<uint32_t>(Alive.use_count() - 1);
+			Stats.VertexBufferBytes += Alive->GetVertexBufferSize();
+			++It;
+		}
+		return Stats;
+	}
+}
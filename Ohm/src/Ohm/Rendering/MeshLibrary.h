@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Ohm/Rendering/Mesh.h"
+
+namespace Ohm
+{
+	/*
+	 * Shares meshes between everything that asks for the same geometry.  Procedural meshes are keyed by generator and
+	 * parameters, and everything else by a hash of its vertex and index data, so a scene of ten thousand cubes holds a
+	 * single cube.
+	 *
+	 * The library only keeps weak references: a mesh lives as long as some handle to it does, and the next request
+	 * after that builds it again.  Every function may be called from any thread; meshes are built on the caller's,
+	 * outside the library's lock, and a request for a mesh another thread is building waits for that build.
+	 *
+	 * Library meshes use MeshResidency::DropAfterUpload; call Mesh::FetchCPUData before reading their vertices.
+	 */
+	class MeshLibrary
+	{
+	public:
+		// The mesh MeshFactory::Create builds for the primitive, with the same default parameters.
+		static Ref<Mesh> GetPrimitive(Primitive primitiveType);
+		static Ref<Mesh> GetSphere(float radius);
+		static Ref<Mesh> GetIcosphere(uint32_t level, float radius);
+		static Ref<Mesh> GetTessellatedQuad(uint32_t resolution);
+
+		// Imported through MeshImporter and shared by content, so files with the same geometry share a mesh.  Returns
+		// nullptr if the import fails.
+		static Ref<Mesh> GetImported(const std::string& filePath, VertexFormat vertexFormat = VertexFormat::Full);
+		// Deduplicated by content.  Meshes with the same data but a different vertex format are kept apart.
+		static Ref<Mesh> GetOrCreate(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, VertexFormat vertexFormat = VertexFormat::Full);
+
+		struct Statistics
+		{
+			// Distinct meshes still alive.
+			uint32_t MeshCount = 0;
+			// Handles to them held outside the library.
+			uint32_t HandleCount = 0;
+			uint64_t VertexBufferBytes = 0;
+		};
+		static Statistics GetStats();
+
+	private:
+		static Ref<Mesh> GetOrCreate(const std::string& key, const std::function<Ref<Mesh>()>& generate);
+	};
+}
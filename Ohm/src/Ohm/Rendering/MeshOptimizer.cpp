@@ -0,0 +1,455 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/MeshOptimizer.h"
+#include "Ohm/Core/JobSystem.h"
+
+#include <chrono>
+
+namespace Ohm
+{
+	// Forsyth's scoring constants.  The scoring cache is modelled as LRU and is larger than the FIFO the statistics
+	// simulate, which keeps the optimizer from overfitting to one cache size.
+	static constexpr uint32_t ScoringCacheSize = 32;
+	static constexpr float CacheDecayPower = 1.5f;
+	static constexpr float LastTriangleScore = 0.75f;
+	static constexpr float ValenceBoostScale = 2.0f;
+	static constexpr float ValenceBoostPower = 0.5f;
+
+	static constexpr uint32_t OverdrawResolution = 256;
+	// Projected depths lie in [-0.5, 0.5], so this is behind everything.
+	static constexpr float OverdrawClearDepth = 1.0f;
+
+	static float ScoreVertex(int32_t cachePosition, uint32_t liveTriangles)
+	{
+		// Nothing left to draw through this vertex.
+		if (liveTriangles == 0) return -1.0f;
+
+		float Score = 0.0f;
+		if (cachePosition >= 0)
+		{
+			// The last triangle's vertices get a fixed score so the next triangle doesn't just repeat its edge.
+			if (cachePosition < 3)
+				Score = LastTriangleScore;
+			else
+				Score = glm::pow(1.0f - static_cast<float>(cachePosition - 3) / (ScoringCacheSize - 3), CacheDecayPower);
+		}
+
+		// Finish off vertices with few triangles left so they don't have to be reloaded later.
+		return Score + ValenceBoostScale * glm::pow(static_cast<float>(liveTriangles), -ValenceBoostPower);
+	}
+
+	// FIFO cache simulation by timestamps: a vertex is cached while fewer than Size misses happened since its own.
+	struct VertexCacheSimulator
+	{
+		std::vector<uint32_t> Timestamps;
+		uint32_t Time;
+		uint32_t Size;
+
+		VertexCacheSimulator(size_t vertexCount, uint32_t size)
+			: Timestamps(vertexCount, 0), Time(size + 1), Size(size) { }
+
+		uint32_t Process(const uint32_t* triangle)
+		{
+			uint32_t Misses = 0;
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				if (Time - Timestamps[triangle[i]] > Size)
+				{
+					Timestamps[triangle[i]] = Time++;
+					Misses++;
+				}
+			}
+			return Misses;
+		}
+
+		void Reset() { Time += Size + 1; }
+	};
+
+	MeshOptimizationReport MeshOptimizer::Optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		const auto Start = std::chrono::high_resolution_clock::now();
+
+		MeshOptimizationReport Report;
+		Report.Before = Analyze(vertices, indices);
+
+		OptimizeVertexCache(indices, static_cast<uint32_t>(vertices.size()));
+		OptimizeOverdraw(indices, vertices);
+		OptimizeVertexFetch(vertices, indices);
+
+		Report.After = Analyze(vertices, indices);
+		Report.Milliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - Start).count();
+		return Report;
+	}
+
+	void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount)
+	{
+		const uint32_t TriangleCount = static_cast<uint32_t>(indices.size() / 3);
+		if (TriangleCount < 2) return;
+
+		// Triangles adjacent to each vertex.  Each vertex's live triangles are kept at the front of its range.
+		std::vector<uint32_t> LiveTriangles(vertexCount, 0);
+		for (const uint32_t Index : indices)
+			LiveTriangles[Index]++;
+
+		std::vector<uint32_t> AdjacencyOffsets(vertexCount + 1, 0);
+		for (uint32_t VertexIndex = 0; VertexIndex < vertexCount; VertexIndex++)
+			AdjacencyOffsets[VertexIndex + 1] = AdjacencyOffsets[VertexIndex] + LiveTriangles[VertexIndex];
+
+		std::vector<uint32_t> Adjacency(indices.size());
+		{
+			std::vector<uint32_t> Fill(AdjacencyOffsets.begin(), AdjacencyOffsets.end() - 1);
+			for (uint32_t Triangle = 0; Triangle < TriangleCount; Triangle++)
+				for (uint32_t i = 0; i < 3; i++)
+					Adjacency[Fill[indices[Triangle * 3 + i]]++] = Triangle;
+		}
+
+		std::vector<float> VertexScores(vertexCount);
+		for (uint32_t VertexIndex = 0; VertexIndex < vertexCount; VertexIndex++)
+			VertexScores[VertexIndex] = ScoreVertex(-1, LiveTriangles[VertexIndex]);
+
+		std::vector<float> TriangleScores(TriangleCount);
+		for (uint32_t Triangle = 0; Triangle < TriangleCount; Triangle++)
+		{
+			const uint32_t* Corners = &indices[Triangle * 3];
+			TriangleScores[Triangle] = VertexScores[Corners[0]] + VertexScores[Corners[1]] + VertexScores[Corners[2]];
+		}
+
+		auto RescoreVertex = [&](uint32_t vertex, int32_t cachePosition)
+		{
+			const float Score = ScoreVertex(cachePosition, LiveTriangles[vertex]);
+			const float Delta = Score - VertexScores[vertex];
+			VertexScores[vertex] = Score;
+
+			const uint32_t* Triangles = &Adjacency[AdjacencyOffsets[vertex]];
+			for (uint32_t i = 0; i < LiveTriangles[vertex]; i++)
+				TriangleScores[Triangles[i]] += Delta;
+		};
+
+		std::vector<uint32_t> Reordered;
+		Reordered.reserve(indices.size());
+		std::vector<bool> Emitted(TriangleCount, false);
+
+		uint32_t Cache[ScoringCacheSize + 3];
+		uint32_t NextCache[ScoringCacheSize + 3];
+		uint32_t CacheCount = 0;
+		uint32_t Cursor = 0;
+		int64_t Best = -1;
+
+		while (Reordered.size() < indices.size())
+		{
+			// Nothing in the cache has a triangle left; carry on from the first one not drawn yet.
+			if (Best < 0)
+			{
+				while (Emitted[Cursor]) Cursor++;
+				Best = Cursor;
+			}
+
+			const uint32_t* Corners = &indices[Best * 3];
+			Emitted[Best] = true;
+			Reordered.insert(Reordered.end(), Corners, Corners + 3);
+
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				const uint32_t VertexIndex = Corners[i];
+				uint32_t* Triangles = &Adjacency[AdjacencyOffsets[VertexIndex]];
+				uint32_t* Last = Triangles + LiveTriangles[VertexIndex] - 1;
+				std::swap(*std::find(Triangles, Last + 1, static_cast<uint32_t>(Best)), *Last);
+				LiveTriangles[VertexIndex]--;
+			}
+
+			// The triangle's corners move to the front of the LRU cache.
+			uint32_t NextCount = 0;
+			for (uint32_t i = 0; i < 3; i++)
+				if (std::find(NextCache, NextCache + NextCount, Corners[i]) == NextCache + NextCount)
+					NextCache[NextCount++] = Corners[i];
+			for (uint32_t i = 0; i < CacheCount; i++)
+				if (std::find(Corners, Corners + 3, Cache[i]) == Corners + 3)
+					NextCache[NextCount++] = Cache[i];
+
+			for (uint32_t i = ScoringCacheSize; i < NextCount; i++)
+				RescoreVertex(NextCache[i], -1);
+
+			CacheCount = std::min(NextCount, ScoringCacheSize);
+			std::copy(NextCache, NextCache + CacheCount, Cache);
+			for (uint32_t i = 0; i < CacheCount; i++)
+				RescoreVertex(Cache[i], static_cast<int32_t>(i));
+
+			// Only triangles touching the cache can have changed, so the next one is picked from those.
+			Best = -1;
+			float BestScore = -1.0f;
+			for (uint32_t i = 0; i < CacheCount; i++)
+			{
+				const uint32_t* Triangles = &Adjacency[AdjacencyOffsets[Cache[i]]];
+				for (uint32_t j = 0; j < LiveTriangles[Cache[i]]; j++)
+				{
+					if (TriangleScores[Triangles[j]] > BestScore)
+					{
+						BestScore = TriangleScores[Triangles[j]];
+						Best = Triangles[j];
+					}
+				}
+			}
+		}
+
+		indices.swap(Reordered);
+	}
+
+	void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, float threshold)
+	{
+		const uint32_t TriangleCount = static_cast<uint32_t>(indices.size() / 3);
+		if (TriangleCount < 2) return;
+
+		VertexCacheSimulator Simulator(vertices.size(), AnalysisCacheSize);
+
+		// Hard boundaries: triangles that miss on all three corners start from a cold cache anyway, so cutting
+		// there costs nothing.
+		std::vector<uint32_t> HardBoundaries = { 0 };
+		Simulator.Process(&indices[0]);
+		for (uint32_t Triangle = 1; Triangle < TriangleCount; Triangle++)
+			if (Simulator.Process(&indices[Triangle * 3]) == 3)
+				HardBoundaries.push_back(Triangle);
+		HardBoundaries.push_back(TriangleCount);
+
+		// Soft boundaries: within each hard cluster, cut once the piece so far is about as cache efficient as the
+		// whole cluster.  Every cut restarts the cache, which is what threshold pays for.
+		std::vector<uint32_t> Clusters;
+		for (size_t i = 0; i + 1 < HardBoundaries.size(); i++)
+		{
+			const uint32_t ClusterStart = HardBoundaries[i];
+			const uint32_t ClusterEnd = HardBoundaries[i + 1];
+
+			Simulator.Reset();
+			uint32_t ClusterMisses = 0;
+			for (uint32_t Triangle = ClusterStart; Triangle < ClusterEnd; Triangle++)
+				ClusterMisses += Simulator.Process(&indices[Triangle * 3]);
+			const float Target = threshold * static_cast<float>(ClusterMisses) / static_cast<float>(ClusterEnd - ClusterStart);
+
+			Simulator.Reset();
+			Clusters.push_back(ClusterStart);
+			uint32_t PieceStart = ClusterStart;
+			uint32_t PieceMisses = 0;
+			for (uint32_t Triangle = ClusterStart; Triangle + 1 < ClusterEnd; Triangle++)
+			{
+				PieceMisses += Simulator.Process(&indices[Triangle * 3]);
+				if (static_cast<float>(PieceMisses) <= Target * static_cast<float>(Triangle + 1 - PieceStart))
+				{
+					Simulator.Reset();
+					PieceStart = Triangle + 1;
+					PieceMisses = 0;
+					Clusters.push_back(PieceStart);
+				}
+			}
+		}
+		Clusters.push_back(TriangleCount);
+
+		const uint32_t ClusterCount = static_cast<uint32_t>(Clusters.size() - 1);
+		if (ClusterCount < 2) return;
+
+		// Area weighted centroid and normal of each cluster and of the whole mesh.
+		std::vector<glm::vec3> ClusterCentroids(ClusterCount, glm::vec3(0.0f));
+		std::vector<glm::vec3> ClusterNormals(ClusterCount, glm::vec3(0.0f));
+		glm::vec3 MeshCentroid(0.0f);
+		float MeshArea = 0.0f;
+
+		for (uint32_t Cluster = 0; Cluster < ClusterCount; Cluster++)
+		{
+			float ClusterArea = 0.0f;
+			for (uint32_t Triangle = Clusters[Cluster]; Triangle < Clusters[Cluster + 1]; Triangle++)
+			{
+				const glm::vec3& A = vertices[indices[Triangle * 3 + 0]].Position;
+				const glm::vec3& B = vertices[indices[Triangle * 3 + 1]].Position;
+				const glm::vec3& C = vertices[indices[Triangle * 3 + 2]].Position;
+
+				const glm::vec3 AreaNormal = glm::cross(B - A, C - A);
+				const float Area = glm::length(AreaNormal);
+				ClusterCentroids[Cluster] += (A + B + C) * (Area / 3.0f);
+				ClusterNormals[Cluster] += AreaNormal;
+				ClusterArea += Area;
+			}
+
+			MeshCentroid += ClusterCentroids[Cluster];
+			MeshArea += ClusterArea;
+			if (ClusterArea > 0.0f)
+				ClusterCentroids[Cluster] /= ClusterArea;
+		}
+		if (MeshArea > 0.0f)
+			MeshCentroid /= MeshArea;
+
+		// Clusters facing away from the centre are the ones most likely to be in front, so they go first.
+		std::vector<float> SortKeys(ClusterCount, 0.0f);
+		for (uint32_t Cluster = 0; Cluster < ClusterCount; Cluster++)
+		{
+			const float NormalLength = glm::length(ClusterNormals[Cluster]);
+			if (NormalLength > 0.0f)
+				SortKeys[Cluster] = glm::dot(ClusterCentroids[Cluster] - MeshCentroid, ClusterNormals[Cluster] / NormalLength);
+		}
+
+		std::vector<uint32_t> ClusterOrder(ClusterCount);
+		for (uint32_t Cluster = 0; Cluster < ClusterCount; Cluster++)
+			ClusterOrder[Cluster] = Cluster;
+		std::stable_sort(ClusterOrder.begin(), ClusterOrder.end(), [&SortKeys](uint32_t a, uint32_t b) { return SortKeys[a] > SortKeys[b]; });
+
+		std::vector<uint32_t> Reordered;
+		Reordered.reserve(indices.size());
+		for (const uint32_t Cluster : ClusterOrder)
+			Reordered.insert(Reordered.end(), indices.begin() + Clusters[Cluster] * 3, indices.begin() + Clusters[Cluster + 1] * 3);
+
+		indices.swap(Reordered);
+	}
+
+	void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		std::vector<uint32_t> Remap(vertices.size(), UINT32_MAX);
+		std::vector<Vertex> Reordered;
+		Reordered.reserve(vertices.size());
+
+		for (uint32_t& Index : indices)
+		{
+			if (Remap[Index] == UINT32_MAX)
+			{
+				Remap[Index] = static_cast<uint32_t>(Reordered.size());
+				Reordered.push_back(vertices[Index]);
+			}
+			Index = Remap[Index];
+		}
+
+		vertices.swap(Reordered);
+	}
+
+	// Rasterizes one triangle already in pixel space (z is depth) with a less-than depth test, counting the pixels
+	// that pass.  Triangles not counter-clockwise on screen are back-facing and skipped, as the renderer culls them.
+	static uint64_t RasterizeOverdrawTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, float* depth)
+	{
+		const float Area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+		if (Area <= 0.0f) return 0;
+
+		const int32_t Size = static_cast<int32_t>(OverdrawResolution);
+		const int32_t MinX = std::max(static_cast<int32_t>(glm::floor(glm::min(a.x, glm::min(b.x, c.x)))), 0);
+		const int32_t MinY = std::max(static_cast<int32_t>(glm::floor(glm::min(a.y, glm::min(b.y, c.y)))), 0);
+		const int32_t MaxX = std::min(static_cast<int32_t>(glm::ceil(glm::max(a.x, glm::max(b.x, c.x)))), Size - 1);
+		const int32_t MaxY = std::min(static_cast<int32_t>(glm::ceil(glm::max(a.y, glm::max(b.y, c.y)))), Size - 1);
+
+		auto Edge = [](const glm::vec3& from, const glm::vec3& to, float x, float y)
+		{
+			return (to.x - from.x) * (y - from.y) - (to.y - from.y) * (x - from.x);
+		};
+
+		uint64_t Shaded = 0;
+		for (int32_t Y = MinY; Y <= MaxY; Y++)
+		{
+			for (int32_t X = MinX; X <= MaxX; X++)
+			{
+				const float PixelX = static_cast<float>(X) + 0.5f;
+				const float PixelY = static_cast<float>(Y) + 0.5f;
+				const float WeightA = Edge(b, c, PixelX, PixelY);
+				const float WeightB = Edge(c, a, PixelX, PixelY);
+				const float WeightC = Edge(a, b, PixelX, PixelY);
+				if (WeightA < 0.0f || WeightB < 0.0f || WeightC < 0.0f) continue;
+
+				const float Depth = (WeightA * a.z + WeightB * b.z + WeightC * c.z) / Area;
+				float& Stored = depth[Y * Size + X];
+				if (Depth < Stored)
+				{
+					Stored = Depth;
+					Shaded++;
+				}
+			}
+		}
+
+		return Shaded;
+	}
+
+	static float AnalyzeOverdraw(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+	{
+		if (vertices.empty()) return 0.0f;
+
+		glm::vec3 Min = vertices[0].Position, Max = vertices[0].Position;
+		for (const Vertex& Source : vertices)
+		{
+			Min = glm::min(Min, Source.Position);
+			Max = glm::max(Max, Source.Position);
+		}
+		const float Extent = glm::max(Max.x - Min.x, glm::max(Max.y - Min.y, Max.z - Min.z));
+		if (!(Extent > 0.0f)) return 0.0f;
+
+		// Looking down each axis both ways.  Right x Up = -Forward, as in view space, so front faces stay
+		// counter-clockwise on screen.
+		struct View { glm::vec3 Forward, Up; };
+		static const View Views[] =
+		{
+			{ {  1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } }, { { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+			{ { 0.0f,  1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, { { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+			{ { 0.0f, 0.0f,  1.0f }, { 0.0f, 1.0f, 0.0f } }, { { 0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f, 0.0f } },
+		};
+		constexpr uint32_t ViewCount = sizeof(Views) / sizeof(Views[0]);
+
+		uint64_t Shaded[ViewCount] = {};
+		uint64_t Covered[ViewCount] = {};
+
+		JobSystem::ParallelFor(ViewCount, 1, [&](uint32_t begin, uint32_t end, uint32_t)
+		{
+			std::vector<float> Depth(OverdrawResolution * OverdrawResolution);
+			std::vector<glm::vec3> Projected(vertices.size());
+
+			for (uint32_t ViewIndex = begin; ViewIndex < end; ViewIndex++)
+			{
+				const View& Current = Views[ViewIndex];
+				const glm::vec3 Right = glm::cross(Current.Up, -Current.Forward);
+
+				// Bounds are normalized to a unit cube centred on the origin, then to pixels.
+				for (size_t i = 0; i < vertices.size(); i++)
+				{
+					const glm::vec3 Position = (vertices[i].Position - Min) / Extent - 0.5f;
+					Projected[i].x = (glm::dot(Position, Right) + 0.5f) * OverdrawResolution;
+					Projected[i].y = (glm::dot(Position, Current.Up) + 0.5f) * OverdrawResolution;
+					Projected[i].z = glm::dot(Position, Current.Forward);
+				}
+
+				std::fill(Depth.begin(), Depth.end(), OverdrawClearDepth);
+				for (size_t i = 0; i + 2 < indices.size(); i += 3)
+					Shaded[ViewIndex] += RasterizeOverdrawTriangle(Projected[indices[i]], Projected[indices[i + 1]], Projected[indices[i + 2]], Depth.data());
+
+				Covered[ViewIndex] = std::count_if(Depth.begin(), Depth.end(), [](float depth) { return depth != OverdrawClearDepth; });
+			}
+		});
+
+		uint64_t TotalShaded = 0, TotalCovered = 0;
+		for (uint32_t i = 0; i < ViewCount; i++)
+		{
+			TotalShaded += Shaded[i];
+			TotalCovered += Covered[i];
+		}
+
+		return TotalCovered > 0 ? static_cast<float>(TotalShaded) / static_cast<float>(TotalCovered) : 0.0f;
+	}
+
+	MeshOptimizationStats MeshOptimizer::Analyze(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+	{
+		MeshOptimizationStats Stats;
+		const uint32_t TriangleCount = static_cast<uint32_t>(indices.size() / 3);
+		if (TriangleCount == 0) return Stats;
+
+		VertexCacheSimulator Simulator(vertices.size(), AnalysisCacheSize);
+		std::vector<bool> Referenced(vertices.size(), false);
+		uint32_t Misses = 0;
+		uint32_t UniqueVertices = 0;
+
+		for (uint32_t Triangle = 0; Triangle < TriangleCount; Triangle++)
+		{
+			const uint32_t* Corners = &indices[Triangle * 3];
+			Misses += Simulator.Process(Corners);
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				if (!Referenced[Corners[i]])
+				{
+					Referenced[Corners[i]] = true;
+					UniqueVertices++;
+				}
+			}
+		}
+
+		Stats.ACMR = static_cast<float>(Misses) / static_cast<float>(TriangleCount);
+		Stats.ATVR = static_cast<float>(Misses) / static_cast<float>(UniqueVertices);
+		Stats.Overdraw = AnalyzeOverdraw(vertices, indices);
+		return Stats;
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Ohm/Rendering/Vertex.h"
+
+#include <vector>
+
+namespace Ohm
+{
+	struct MeshOptimizationStats
+	{
+		// Average cache miss ratio: post-transform cache misses per triangle.  0.5 is the practical floor for a
+		// regular grid, 3.0 means no vertex is ever reused.
+		float ACMR = 0.0f;
+		// Average transform to vertex ratio: cache misses per unique vertex.  1.0 means every vertex is shaded once.
+		float ATVR = 0.0f;
+		// Pixels shaded per pixel covered, averaged over six axis-aligned views.  1.0 means no overdraw.
+		float Overdraw = 0.0f;
+	};
+
+	struct MeshOptimizationReport
+	{
+		MeshOptimizationStats Before;
+		MeshOptimizationStats After;
+		float Milliseconds = 0.0f;
+	};
+
+	/*
+	 * Reorders triangle lists for the GPU before they are uploaded:
+	 *	1. Triangles are reordered for post-transform vertex cache hits (Forsyth's linear-speed optimizer).
+	 *	2. Runs of that order are cut into clusters at cache restarts and the clusters are sorted outward-facing first,
+	 *	   so a mesh tends to occlude its own back side instead of drawing over it.
+	 *	3. Vertices are renumbered in the order the index buffer first touches them, so fetches walk memory forward.
+	 * None of the steps change what is drawn, only the order.
+	 */
+	class MeshOptimizer
+	{
+	public:
+		// Entries of the FIFO cache the statistics simulate; roughly what current desktop hardware reuses.
+		static constexpr uint32_t AnalysisCacheSize = 16;
+
+		// Runs all three steps in place and measures the mesh before and after.
+		static MeshOptimizationReport Optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+		static void OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount);
+		// Clusters may grow until their cache efficiency is within threshold of the unclustered order.
+		static void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, float threshold = 1.05f);
+		// Drops vertices no triangle references.
+		static void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+		static MeshOptimizationStats Analyze(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
+	};
+}
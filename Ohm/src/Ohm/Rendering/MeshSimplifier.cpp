@@ -0,0 +1,252 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/MeshSimplifier.h"
+
+#include <cstring>
+
+namespace Ohm
+{
+	// Symmetric 4x4 quadric, area weighted.  Evaluating it and dividing by Weight gives the mean squared distance
+	// to the planes that were added.
+	struct Quadric
+	{
+		double A00 = 0.0, A11 = 0.0, A22 = 0.0, A01 = 0.0, A02 = 0.0, A12 = 0.0;
+		double B0 = 0.0, B1 = 0.0, B2 = 0.0;
+		double C = 0.0;
+		double Weight = 0.0;
+
+		static Quadric FromPlane(const glm::vec3& normal, float distance, float weight)
+		{
+			Quadric Q;
+			Q.A00 = weight * normal.x * normal.x; Q.A11 = weight * normal.y * normal.y; Q.A22 = weight * normal.z * normal.z;
+			Q.A01 = weight * normal.x * normal.y; Q.A02 = weight * normal.x * normal.z; Q.A12 = weight * normal.y * normal.z;
+			Q.B0 = weight * normal.x * distance; Q.B1 = weight * normal.y * distance; Q.B2 = weight * normal.z * distance;
+			Q.C = weight * distance * distance;
+			Q.Weight = weight;
+			return Q;
+		}
+
+		Quadric& operator+=(const Quadric& other)
+		{
+			A00 += other.A00; A11 += other.A11; A22 += other.A22;
+			A01 += other.A01; A02 += other.A02; A12 += other.A12;
+			B0 += other.B0; B1 += other.B1; B2 += other.B2;
+			C += other.C;
+			Weight += other.Weight;
+			return *this;
+		}
+
+		double Evaluate(const glm::vec3& p) const
+		{
+			const double X = p.x, Y = p.y, Z = p.z;
+			const double Error =
+				A00 * X * X + A11 * Y * Y + A22 * Z * Z +
+				2.0 * (A01 * X * Y + A02 * X * Z + A12 * Y * Z) +
+				2.0 * (B0 * X + B1 * Y + B2 * Z) + C;
+			return Weight > 0.0 ? glm::abs(Error) / Weight : 0.0;
+		}
+	};
+
+	struct CollapseCandidate
+	{
+		uint32_t Source;
+		uint32_t Target;
+		double Cost;
+	};
+
+	// Moving source to target must not turn any of source's remaining triangles over.
+	static bool CollapseFlipsTriangle(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+		const uint32_t* triangles, uint32_t triangleCount, uint32_t source, uint32_t target)
+	{
+		const glm::vec3& From = vertices[source].Position;
+		const glm::vec3& To = vertices[target].Position;
+
+		for (uint32_t i = 0; i < triangleCount; i++)
+		{
+			const uint32_t* Corners = &indices[triangles[i] * 3];
+			// Triangles along the collapsed edge disappear.
+			if (Corners[0] == target || Corners[1] == target || Corners[2] == target) continue;
+
+			// Rotate so the source is first; the other two corners keep their winding.
+			const uint32_t First = Corners[0] == source ? 0 : Corners[1] == source ? 1 : 2;
+			const glm::vec3& B = vertices[Corners[(First + 1) % 3]].Position;
+			const glm::vec3& C = vertices[Corners[(First + 2) % 3]].Position;
+
+			const glm::vec3 Before = glm::cross(B - From, C - From);
+			const glm::vec3 After = glm::cross(B - To, C - To);
+			if (glm::dot(Before, After) <= 0.0f)
+				return true;
+		}
+
+		return false;
+	}
+
+	std::vector<uint32_t> MeshSimplifier::Simplify(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, size_t targetIndexCount, float* outError)
+	{
+		std::vector<uint32_t> Result = indices;
+		double MaxCost = 0.0;
+		const uint32_t VertexCount = static_cast<uint32_t>(vertices.size());
+
+		// Vertices sharing a position are attribute seams.  Positions are compared bitwise; generated and imported
+		// meshes duplicate them exactly.
+		std::vector<uint32_t> Canonical(VertexCount);
+		{
+			struct PositionHash
+			{
+				size_t operator()(const std::array<uint32_t, 3>& bits) const
+				{
+					return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+				}
+			};
+
+			std::unordered_map<std::array<uint32_t, 3>, uint32_t, PositionHash> FirstAtPosition;
+			FirstAtPosition.reserve(VertexCount);
+			for (uint32_t i = 0; i < VertexCount; i++)
+			{
+				std::array<uint32_t, 3> Bits;
+				std::memcpy(Bits.data(), &vertices[i].Position.x, sizeof(Bits));
+				Canonical[i] = FirstAtPosition.try_emplace(Bits, i).first->second;
+			}
+		}
+
+		std::vector<uint8_t> Locked(VertexCount, 0);
+		{
+			std::vector<uint32_t> Copies(VertexCount, 0);
+			for (uint32_t i = 0; i < VertexCount; i++)
+				Copies[Canonical[i]]++;
+			for (uint32_t i = 0; i < VertexCount; i++)
+				Locked[i] = Copies[Canonical[i]] > 1;
+
+			// An edge nothing walks the other way is on a border.  Edges are compared by position so seams don't
+			// count as borders.
+			std::unordered_set<uint64_t> Edges;
+			Edges.reserve(Result.size());
+			for (size_t i = 0; i < Result.size(); i += 3)
+				for (uint32_t Corner = 0; Corner < 3; Corner++)
+					Edges.insert(static_cast<uint64_t>(Canonical[Result[i + Corner]]) << 32 | Canonical[Result[i + (Corner + 1) % 3]]);
+
+			for (size_t i = 0; i < Result.size(); i += 3)
+			{
+				for (uint32_t Corner = 0; Corner < 3; Corner++)
+				{
+					const uint32_t A = Result[i + Corner];
+					const uint32_t B = Result[i + (Corner + 1) % 3];
+					if (Edges.count(static_cast<uint64_t>(Canonical[B]) << 32 | Canonical[A]) == 0)
+						Locked[A] = Locked[B] = 1;
+				}
+			}
+		}
+
+		std::vector<Quadric> Quadrics(VertexCount);
+		for (size_t i = 0; i < Result.size(); i += 3)
+		{
+			const glm::vec3& A = vertices[Result[i + 0]].Position;
+			const glm::vec3& B = vertices[Result[i + 1]].Position;
+			const glm::vec3& C = vertices[Result[i + 2]].Position;
+
+			const glm::vec3 AreaNormal = glm::cross(B - A, C - A);
+			const float DoubleArea = glm::length(AreaNormal);
+			if (DoubleArea <= 0.0f) continue;
+
+			const glm::vec3 Normal = AreaNormal / DoubleArea;
+			const Quadric Plane = Quadric::FromPlane(Normal, -glm::dot(Normal, A), DoubleArea * 0.5f);
+			for (uint32_t Corner = 0; Corner < 3; Corner++)
+				Quadrics[Result[i + Corner]] += Plane;
+		}
+
+		std::vector<uint32_t> TriangleOffsets(VertexCount + 1);
+		std::vector<uint32_t> VertexTriangles;
+		std::vector<CollapseCandidate> Candidates;
+		std::vector<uint32_t> Remap(VertexCount);
+		std::vector<uint8_t> Touched(VertexCount);
+
+		// Each pass collapses a set of edges whose neighbourhoods don't overlap, so the flip test of one collapse
+		// can't be invalidated by another in the same pass.
+		while (Result.size() > targetIndexCount)
+		{
+			const uint32_t TriangleCount = static_cast<uint32_t>(Result.size() / 3);
+
+			std::fill(TriangleOffsets.begin(), TriangleOffsets.end(), 0);
+			for (const uint32_t Index : Result)
+				TriangleOffsets[Index + 1]++;
+			for (uint32_t i = 0; i < VertexCount; i++)
+				TriangleOffsets[i + 1] += TriangleOffsets[i];
+
+			VertexTriangles.resize(Result.size());
+			{
+				std::vector<uint32_t> Fill(TriangleOffsets.begin(), TriangleOffsets.end() - 1);
+				for (uint32_t Triangle = 0; Triangle < TriangleCount; Triangle++)
+					for (uint32_t Corner = 0; Corner < 3; Corner++)
+						VertexTriangles[Fill[Result[Triangle * 3 + Corner]]++] = Triangle;
+			}
+
+			Candidates.clear();
+			for (size_t i = 0; i < Result.size(); i += 3)
+			{
+				for (uint32_t Corner = 0; Corner < 3; Corner++)
+				{
+					const uint32_t A = Result[i + Corner];
+					const uint32_t B = Result[i + (Corner + 1) % 3];
+					if (A == B) continue;
+
+					Quadric Combined = Quadrics[A];
+					Combined += Quadrics[B];
+					if (!Locked[A]) Candidates.push_back({ A, B, Combined.Evaluate(vertices[B].Position) });
+					if (!Locked[B]) Candidates.push_back({ B, A, Combined.Evaluate(vertices[A].Position) });
+				}
+			}
+			if (Candidates.empty()) break;
+
+			std::sort(Candidates.begin(), Candidates.end(), [](const CollapseCandidate& a, const CollapseCandidate& b) { return a.Cost < b.Cost; });
+
+			for (uint32_t i = 0; i < VertexCount; i++)
+				Remap[i] = i;
+			std::fill(Touched.begin(), Touched.end(), 0);
+
+			// Most collapses remove two triangles.
+			const size_t TrianglesToRemove = (Result.size() - targetIndexCount + 2) / 3;
+			size_t TrianglesRemoved = 0;
+
+			for (const CollapseCandidate& Candidate : Candidates)
+			{
+				if (TrianglesRemoved >= TrianglesToRemove) break;
+				if (Touched[Candidate.Source] || Touched[Candidate.Target]) continue;
+
+				const uint32_t* Triangles = &VertexTriangles[TriangleOffsets[Candidate.Source]];
+				const uint32_t SourceTriangleCount = TriangleOffsets[Candidate.Source + 1] - TriangleOffsets[Candidate.Source];
+				if (CollapseFlipsTriangle(vertices, Result, Triangles, SourceTriangleCount, Candidate.Source, Candidate.Target)) continue;
+
+				Remap[Candidate.Source] = Candidate.Target;
+				Quadrics[Candidate.Target] += Quadrics[Candidate.Source];
+				MaxCost = std::max(MaxCost, Candidate.Cost);
+
+				for (uint32_t j = 0; j < SourceTriangleCount; j++)
+				{
+					const uint32_t* Corners = &Result[Triangles[j] * 3];
+					if (Corners[0] == Candidate.Target || Corners[1] == Candidate.Target || Corners[2] == Candidate.Target)
+						TrianglesRemoved++;
+					Touched[Corners[0]] = Touched[Corners[1]] = Touched[Corners[2]] = 1;
+				}
+			}
+
+			if (TrianglesRemoved == 0) break;
+
+			size_t Write = 0;
+			for (size_t i = 0; i < Result.size(); i += 3)
+			{
+				const uint32_t A = Remap[Result[i + 0]];
+				const uint32_t B = Remap[Result[i + 1]];
+				const uint32_t C = Remap[Result[i + 2]];
+				if (A == B || B == C || C == A) continue;
+
+				Result[Write++] = A;
+				Result[Write++] = B;
+				Result[Write++] = C;
+			}
+			Result.resize(Write);
+		}
+
+		if (outError)
+			*outError = static_cast<float>(glm::sqrt(MaxCost));
+		return Result;
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Ohm/Rendering/Vertex.h"
+
+#include <vector>
+
+namespace Ohm
+{
+	/*
+	 * Quadric error metric simplification by edge collapse (Garland and Heckbert).  Vertices are only ever collapsed
+	 * onto one of their neighbours, never moved or created, so every level of detail indexes the original vertex
+	 * buffer and they can all share it.
+	 *
+	 * Vertices on open borders and on attribute seams (several vertices sharing a position) are locked so the
+	 * silhouette of open meshes and UV/normal splits survive; they can still have other vertices collapsed onto them.
+	 */
+	class MeshSimplifier
+	{
+	public:
+		// Returns at most targetIndexCount indices unless locked vertices or flips stop it first.  outError receives
+		// the largest collapse error, as a distance in the mesh's units.
+		static std::vector<uint32_t> Simplify(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, size_t targetIndexCount, float* outError = nullptr);
+	};
+}
@@ -0,0 +1,124 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/MeshletBuilder.h"
+
+namespace Ohm
+{
+	// Fills in the bounds of a meshlet whose index range is already set.
+	static void ComputeMeshletBounds(const std::vector<Vertex>& vertices, const uint32_t* indices, Meshlet& meshlet)
+	{
+		const uint32_t TriangleCount = meshlet.IndexCount / 3;
+
+		// Sphere around the box of the positions, grown to the farthest of them.
+		glm::vec3 Min = vertices[indices[0]].Position;
+		glm::vec3 Max = Min;
+		for (uint32_t i = 0; i < meshlet.IndexCount; i++)
+		{
+			Min = glm::min(Min, vertices[indices[i]].Position);
+			Max = glm::max(Max, vertices[indices[i]].Position);
+		}
+
+		const glm::vec3 Center = (Min + Max) * 0.5f;
+		float Radius2 = 0.0f;
+		for (uint32_t i = 0; i < meshlet.IndexCount; i++)
+		{
+			const glm::vec3 Offset = vertices[indices[i]].Position - Center;
+			Radius2 = glm::max(Radius2, glm::dot(Offset, Offset));
+		}
+		meshlet.BoundingSphere = glm::vec4(Center, glm::sqrt(Radius2));
+
+		// The cone's axis is the average face normal, its width the face normal farthest from it.
+		std::vector<glm::vec3> Normals(TriangleCount);
+		glm::vec3 Axis(0.0f);
+		for (uint32_t Triangle = 0; Triangle < TriangleCount; Triangle++)
+		{
+			const glm::vec3& A = vertices[indices[Triangle * 3 + 0]].Position;
+			const glm::vec3& B = vertices[indices[Triangle * 3 + 1]].Position;
+			const glm::vec3& C = vertices[indices[Triangle * 3 + 2]].Position;
+			const glm::vec3 Normal = glm::cross(B - A, C - A);
+			const float Length = glm::length(Normal);
+			Normals[Triangle] = Length > 0.0f ? Normal / Length : glm::vec3(0.0f);
+			Axis += Normals[Triangle];
+		}
+
+		const float AxisLength = glm::length(Axis);
+		if (AxisLength <= 0.0f) return;
+		Axis /= AxisLength;
+
+		float MinDot = 1.0f;
+		for (const glm::vec3& Normal : Normals)
+		{
+			// Degenerate triangles can't be seen from any side.
+			if (Normal != glm::vec3(0.0f))
+				MinDot = glm::min(MinDot, glm::dot(Normal, Axis));
+		}
+
+		// Normals spread over a hemisphere or more: there is always a side the meshlet faces.
+		if (MinDot <= 0.0f) return;
+
+		// The apex sits far enough back along the axis that every triangle's plane passes in front of it.
+		float MaxT = 0.0f;
+		for (uint32_t Triangle = 0; Triangle < TriangleCount; Triangle++)
+		{
+			const glm::vec3& Normal = Normals[Triangle];
+			if (Normal == glm::vec3(0.0f)) continue;
+
+			const glm::vec3& Corner = vertices[indices[Triangle * 3]].Position;
+			const float Distance = glm::dot(Center - Corner, Normal);
+			MaxT = glm::max(MaxT, Distance / glm::dot(Axis, Normal));
+		}
+
+		meshlet.ConeApex = glm::vec4(Center - Axis * MaxT, 1.0f);
+		meshlet.ConeAxisCutoff = glm::vec4(Axis, glm::sqrt(1.0f - MinDot * MinDot));
+	}
+
+	std::vector<Meshlet> MeshletBuilder::Build(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+	{
+		std::vector<Meshlet> Meshlets;
+		if (indices.size() < 3) return Meshlets;
+		Meshlets.reserve(indices.size() / 3 / MaxMeshletTriangles + 1);
+
+		// Meshlet that last used each vertex, plus one; a vertex is new to the current meshlet unless it matches.
+		std::vector<uint32_t> VertexOwner(vertices.size(), 0);
+
+		Meshlet Current;
+		const auto FinishCurrent = [&]()
+		{
+			if (Current.IndexCount == 0) return;
+			ComputeMeshletBounds(vertices, indices.data() + Current.IndexOffset, Current);
+			Meshlets.push_back(Current);
+			Current = Meshlet();
+		};
+
+		for (uint32_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			uint32_t NewVertices = 0;
+			for (uint32_t Corner = 0; Corner < 3; Corner++)
+			{
+				const uint32_t Index = indices[i + Corner];
+				// A triangle can repeat a vertex; count it once.
+				const bool Repeated = (Corner > 0 && indices[i] == Index) || (Corner > 1 && indices[i + 1] == Index);
+				NewVertices += VertexOwner[Index] != Meshlets.size() + 1 && !Repeated;
+			}
+
+			if (Current.VertexCount + NewVertices > MaxMeshletVertices || Current.IndexCount / 3 + 1 > MaxMeshletTriangles)
+				FinishCurrent();
+
+			if (Current.IndexCount == 0)
+				Current.IndexOffset = i;
+			const uint32_t Owner = static_cast<uint32_t>(Meshlets.size()) + 1;
+			for (uint32_t Corner = 0; Corner < 3; Corner++)
+			{
+				uint32_t& VertexMeshlet = VertexOwner[indices[i + Corner]];
+				if (VertexMeshlet != Owner)
+				{
+					VertexMeshlet = Owner;
+					Current.VertexCount++;
+				}
+			}
+			Current.IndexCount += 3;
+		}
+		FinishCurrent();
+
+		return Meshlets;
+	}
+}
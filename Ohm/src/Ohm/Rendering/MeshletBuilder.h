@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Ohm/Rendering/Vertex.h"
+
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Ohm
+{
+	static constexpr uint32_t MaxMeshletVertices = 64;
+	static constexpr uint32_t MaxMeshletTriangles = 124;
+
+	/*
+	 * A cluster of a mesh's LOD 0 triangles, with what culling needs to reject it as a whole.  Laid out as std430
+	 * for MeshletCulling.shader.
+	 */
+	struct Meshlet
+	{
+		// Local-space bounding sphere: center in xyz, radius in w.
+		glm::vec4 BoundingSphere{ 0.0f };
+		// Every triangle faces away from any point behind the apex, inside the cone around -axis:
+		// dot(normalize(apex - eye), axis) >= cutoff.
+		glm::vec4 ConeApex{ 0.0f };
+		// Axis in xyz, cutoff in w; a cutoff above 1 means the triangles spread too far for the cone to cull anything.
+		glm::vec4 ConeAxisCutoff{ 0.0f, 0.0f, 1.0f, 2.0f };
+		// Range of the mesh's indices, relative to its FirstIndex like MeshLOD::IndexOffset.
+		uint32_t IndexOffset = 0;
+		uint32_t IndexCount = 0;
+		uint32_t VertexCount = 0;
+		uint32_t Padding = 0;
+	};
+	static_assert(sizeof(Meshlet) == 64, "Meshlet must match MeshletCulling.shader's layout.");
+
+	/*
+	 * Cuts a triangle list into meshlets of at most MaxMeshletVertices unique vertices and MaxMeshletTriangles
+	 * triangles.
+	 *
+	 * Triangles are taken in the order they already have, a new meshlet starting whenever the next triangle would
+	 * break a limit.  MeshOptimizer's vertex cache order keeps neighbouring triangles together, so the clusters come
+	 * out compact, and every meshlet is a contiguous range of the index buffer: drawing a set of meshlets is a set of
+	 * ranges of the buffer the mesh already has, with no reordering and no extra indices.
+	 */
+	class MeshletBuilder
+	{
+	public:
+		static std::vector<Meshlet> Build(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
+	};
+}
@@ -0,0 +1,150 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/MeshletCuller.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define OHM_MESHLET_SSE
+#endif
+
+namespace Ohm
+{
+	void MeshletCuller::Begin(const glm::mat4& viewProjection, const glm::vec3& cameraPosition, bool coneCulling)
+	{
+		m_ViewProjection = viewProjection;
+		m_CameraPosition = cameraPosition;
+		m_ConeCulling = coneCulling;
+	}
+
+	MeshletCullInstance MeshletCuller::PrepareInstance(const glm::mat4& transform) const
+	{
+		// Gribb/Hartmann on the full transform gives the planes in local space directly.
+		const glm::mat4 Rows = glm::transpose(m_ViewProjection * transform);
+
+		MeshletCullInstance Instance;
+		Instance.Planes[0] = Rows[3] + Rows[0];	// Left
+		Instance.Planes[1] = Rows[3] - Rows[0];	// Right
+		Instance.Planes[2] = Rows[3] + Rows[1];	// Bottom
+		Instance.Planes[3] = Rows[3] - Rows[1];	// Top
+		Instance.Planes[4] = Rows[3] + Rows[2];	// Near
+		Instance.Planes[5] = Rows[3] - Rows[2];	// Far
+		for (glm::vec4& Plane : Instance.Planes)
+		{
+			const float Length = glm::length(glm::vec3(Plane));
+			if (Length > 0.0f)
+				Plane /= Length;
+		}
+
+		const bool Mirrored = glm::determinant(glm::mat3(transform)) <= 0.0f;
+		Instance.CameraPosition = glm::vec4(glm::vec3(glm::inverse(transform) * glm::vec4(m_CameraPosition, 1.0f)), m_ConeCulling && !Mirrored ? 1.0f : 0.0f);
+		return Instance;
+	}
+
+	static bool IsMeshletVisible(const Meshlet& meshlet, const MeshletCullInstance& instance)
+	{
+		const glm::vec3 Center(meshlet.BoundingSphere);
+		for (const glm::vec4& Plane : instance.Planes)
+		{
+			if (glm::dot(glm::vec3(Plane), Center) + Plane.w < -meshlet.BoundingSphere.w)
+				return false;
+		}
+
+		const float Cutoff = meshlet.ConeAxisCutoff.w;
+		if (instance.CameraPosition.w == 0.0f || Cutoff > 1.0f)
+			return true;
+
+		const glm::vec3 ToApex = glm::vec3(meshlet.ConeApex) - glm::vec3(instance.CameraPosition);
+		return glm::dot(ToApex, glm::vec3(meshlet.ConeAxisCutoff)) < Cutoff * glm::length(ToApex);
+	}
+
+	uint32_t MeshletCuller::Cull(const Mesh& mesh, const MeshletCullInstance& instance, uint32_t baseInstance, std::vector<DrawElementsIndirectCommand>& outCommands, uint32_t& outVisibleTriangles) const
+	{
+		const std::vector<Meshlet>& Meshlets = mesh.GetMeshlets();
+		const GeometryAllocation& Geometry = mesh.GetGeometry();
+		const uint32_t MeshletCount = static_cast<uint32_t>(Meshlets.size());
+
+		uint32_t VisibleCount = 0;
+		// Extends the last command when the meshlet follows straight on from it.
+		const auto Emit = [&](const Meshlet& meshlet, bool previousVisible)
+		{
+			if (previousVisible)
+				outCommands.back().Count += meshlet.IndexCount;
+			else
+				outCommands.push_back({ meshlet.IndexCount, 1, Geometry.FirstIndex + meshlet.IndexOffset, static_cast<int32_t>(Geometry.BaseVertex), baseInstance });
+			outVisibleTriangles += meshlet.IndexCount / 3;
+			VisibleCount++;
+		};
+
+		bool PreviousVisible = false;
+		uint32_t i = 0;
+#if defined(OHM_MESHLET_SSE)
+		const __m128 Zero = _mm_setzero_ps();
+		const __m128 One = _mm_set1_ps(1.0f);
+		const bool TestCones = instance.CameraPosition.w != 0.0f;
+		const __m128 CameraX = _mm_set1_ps(instance.CameraPosition.x);
+		const __m128 CameraY = _mm_set1_ps(instance.CameraPosition.y);
+		const __m128 CameraZ = _mm_set1_ps(instance.CameraPosition.z);
+
+		for (; i + 4 <= MeshletCount; i += 4)
+		{
+			__m128 CenterX = _mm_loadu_ps(&Meshlets[i + 0].BoundingSphere.x);
+			__m128 CenterY = _mm_loadu_ps(&Meshlets[i + 1].BoundingSphere.x);
+			__m128 CenterZ = _mm_loadu_ps(&Meshlets[i + 2].BoundingSphere.x);
+			__m128 Radius = _mm_loadu_ps(&Meshlets[i + 3].BoundingSphere.x);
+			_MM_TRANSPOSE4_PS(CenterX, CenterY, CenterZ, Radius);
+
+			__m128 Visible = _mm_cmpeq_ps(Zero, Zero);
+			const __m128 NegativeRadius = _mm_sub_ps(Zero, Radius);
+			for (const glm::vec4& Plane : instance.Planes)
+			{
+				__m128 Distance = _mm_add_ps(_mm_mul_ps(CenterX, _mm_set1_ps(Plane.x)), _mm_set1_ps(Plane.w));
+				Distance = _mm_add_ps(Distance, _mm_mul_ps(CenterY, _mm_set1_ps(Plane.y)));
+				Distance = _mm_add_ps(Distance, _mm_mul_ps(CenterZ, _mm_set1_ps(Plane.z)));
+				Visible = _mm_and_ps(Visible, _mm_cmpge_ps(Distance, NegativeRadius));
+			}
+
+			if (TestCones)
+			{
+				__m128 ApexX = _mm_loadu_ps(&Meshlets[i + 0].ConeApex.x);
+				__m128 ApexY = _mm_loadu_ps(&Meshlets[i + 1].ConeApex.x);
+				__m128 ApexZ = _mm_loadu_ps(&Meshlets[i + 2].ConeApex.x);
+				__m128 ApexW = _mm_loadu_ps(&Meshlets[i + 3].ConeApex.x);
+				_MM_TRANSPOSE4_PS(ApexX, ApexY, ApexZ, ApexW);
+
+				__m128 AxisX = _mm_loadu_ps(&Meshlets[i + 0].ConeAxisCutoff.x);
+				__m128 AxisY = _mm_loadu_ps(&Meshlets[i + 1].ConeAxisCutoff.x);
+				__m128 AxisZ = _mm_loadu_ps(&Meshlets[i + 2].ConeAxisCutoff.x);
+				__m128 Cutoff = _mm_loadu_ps(&Meshlets[i + 3].ConeAxisCutoff.x);
+				_MM_TRANSPOSE4_PS(AxisX, AxisY, AxisZ, Cutoff);
+
+				const __m128 ToApexX = _mm_sub_ps(ApexX, CameraX);
+				const __m128 ToApexY = _mm_sub_ps(ApexY, CameraY);
+				const __m128 ToApexZ = _mm_sub_ps(ApexZ, CameraZ);
+				const __m128 Along = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ToApexX, AxisX), _mm_mul_ps(ToApexY, AxisY)), _mm_mul_ps(ToApexZ, AxisZ));
+				const __m128 Distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ToApexX, ToApexX), _mm_mul_ps(ToApexY, ToApexY)), _mm_mul_ps(ToApexZ, ToApexZ)));
+
+				const __m128 BackFacing = _mm_and_ps(_mm_cmple_ps(Cutoff, One), _mm_cmpge_ps(Along, _mm_mul_ps(Cutoff, Distance)));
+				Visible = _mm_andnot_ps(BackFacing, Visible);
+			}
+
+			const int Mask = _mm_movemask_ps(Visible);
+			for (uint32_t Lane = 0; Lane < 4; Lane++)
+			{
+				const bool LaneVisible = (Mask >> Lane) & 1;
+				if (LaneVisible)
+					Emit(Meshlets[i + Lane], PreviousVisible);
+				PreviousVisible = LaneVisible;
+			}
+		}
+#endif
+
+		for (; i < MeshletCount; i++)
+		{
+			const bool Visible = IsMeshletVisible(Meshlets[i], instance);
+			if (Visible)
+				Emit(Meshlets[i], PreviousVisible);
+			PreviousVisible = Visible;
+		}
+
+		return VisibleCount;
+	}
+}
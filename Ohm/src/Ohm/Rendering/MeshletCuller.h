@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Ohm/Rendering/Mesh.h"
+#include "Ohm/Rendering/RenderCommand.h"
+
+#include <glm/glm.hpp>
+
+namespace Ohm
+{
+	// Frustum planes and eye position in one instance's local space, so meshlet bounds are tested as they are stored.
+	// std430 for MeshletCulling.shader.
+	struct MeshletCullInstance
+	{
+		// Normalized, so a sphere is outside once it's more than its radius behind one of them.
+		glm::vec4 Planes[6];
+		// w is 1 when normal cones may be tested.  They aren't under a mirroring transform, which turns the mesh's
+		// back faces to the front.
+		glm::vec4 CameraPosition{ 0.0f };
+	};
+
+	/*
+	 * Culls the meshlets of single mesh instances on the CPU.  A meshlet is dropped when its bounding sphere is
+	 * outside the frustum or, with cone culling on, when its normal cone faces away from the eye.  Cone culling
+	 * assumes one-sided geometry, the way back-face culling does.
+	 *
+	 * Everything is tested in the instance's local space, which is exact for any transform, non-uniform scale
+	 * included.  Meshlets are tested four at a time with SSE where available; their std430 vectors transpose
+	 * straight into registers.
+	 */
+	class MeshletCuller
+	{
+	public:
+		void Begin(const glm::mat4& viewProjection, const glm::vec3& cameraPosition, bool coneCulling);
+		MeshletCullInstance PrepareInstance(const glm::mat4& transform) const;
+
+		// Appends one command per run of visible meshlets, which are neighbours in the index buffer, and adds their
+		// triangles to outVisibleTriangles.  Returns the number of visible meshlets.
+		uint32_t Cull(const Mesh& mesh, const MeshletCullInstance& instance, uint32_t baseInstance, std::vector<DrawElementsIndirectCommand>& outCommands, uint32_t& outVisibleTriangles) const;
+
+	private:
+		glm::mat4 m_ViewProjection{ 1.0f };
+		glm::vec3 m_CameraPosition{ 0.0f };
+		bool m_ConeCulling = true;
+	};
+}
@@ -0,0 +1,81 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/MeshletDrawList.h"
+
+namespace Ohm
+{
+	void MeshletDrawList::Begin(const MeshletCuller& culler, bool cullOnCPU)
+	{
+		Clear();
+		m_Culler = &culler;
+		m_CullOnCPU = cullOnCPU;
+	}
+
+	bool MeshletDrawList::Record(const Ref<Mesh>& mesh, const Ref<Material>& material, const glm::mat4& transform)
+	{
+		MeshletDraw Draw;
+		Draw.Transform = transform;
+		Draw.CullInstance = m_Culler->PrepareInstance(transform);
+
+		m_MeshletsTotal += static_cast<uint32_t>(mesh->GetMeshlets().size());
+		m_TrianglesTotal += mesh->GetLOD(0).IndexCount / 3;
+
+		if (m_CullOnCPU)
+		{
+			// The instance is the draw's ordinal in the queue, which isn't known yet; the queue fills it in.
+			Draw.FirstCommand = static_cast<uint32_t>(m_Commands.size());
+			const uint32_t VisibleMeshlets = m_Culler->Cull(*mesh, Draw.CullInstance, 0, m_Commands, m_TrianglesVisible);
+			Draw.CommandCount = static_cast<uint32_t>(m_Commands.size()) - Draw.FirstCommand;
+			m_MeshletsVisible += VisibleMeshlets;
+			if (VisibleMeshlets == 0) return false;
+		}
+
+		Draw.MeshIndex = GetMeshIndex(mesh);
+		Draw.MaterialIndex = GetMaterialIndex(material);
+		m_Draws.push_back(Draw);
+		return true;
+	}
+
+	uint32_t MeshletDrawList::GetMeshIndex(const Ref<Mesh>& mesh)
+	{
+		if (mesh.get() == m_LastMesh)
+			return m_LastMeshIndex;
+
+		auto [It, Inserted] = m_MeshIndices.try_emplace(mesh.get(), static_cast<uint32_t>(m_Meshes.size()));
+		if (Inserted)
+			m_Meshes.push_back(mesh);
+
+		m_LastMesh = mesh.get();
+		m_LastMeshIndex = It->second;
+		return m_LastMeshIndex;
+	}
+
+	uint32_t MeshletDrawList::GetMaterialIndex(const Ref<Material>& material)
+	{
+		if (material.get() == m_LastMaterial)
+			return m_LastMaterialIndex;
+
+		auto [It, Inserted] = m_MaterialIndices.try_emplace(material.get(), static_cast<uint32_t>(m_Materials.size()));
+		if (Inserted)
+			m_Materials.push_back(material);
+
+		m_LastMaterial = material.get();
+		m_LastMaterialIndex = It->second;
+		return m_LastMaterialIndex;
+	}
+
+	void MeshletDrawList::Clear()
+	{
+		m_Draws.clear();
+		m_Commands.clear();
+		m_Meshes.clear();
+		m_MeshIndices.clear();
+		m_LastMesh = nullptr;
+		m_LastMeshIndex = 0;
+		m_Materials.clear();
+		m_MaterialIndices.clear();
+		m_LastMaterial = nullptr;
+		m_LastMaterialIndex = 0;
+		m_MeshletsTotal = m_MeshletsVisible = 0;
+		m_TrianglesTotal = m_TrianglesVisible = 0;
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Ohm/Rendering/Material.h"
+#include "Ohm/Rendering/Mesh.h"
+#include "Ohm/Rendering/MeshletCuller.h"
+
+#include <glm/glm.hpp>
+
+namespace Ohm
+{
+	struct MeshletDraw
+	{
+		glm::mat4 Transform{ 1.0f };
+		MeshletCullInstance CullInstance;
+		// Indices into the recording list's mesh and material tables.
+		uint32_t MeshIndex = 0;
+		uint32_t MaterialIndex = 0;
+		// Commands of the meshlets that survived culling on the CPU; none when culling is left to the GPU.
+		uint32_t FirstCommand = 0;
+		uint32_t CommandCount = 0;
+	};
+
+	/*
+	 * Draws of meshes with meshlets, recorded without touching GL like a RenderCommandBuffer, one list per recording
+	 * thread.  Every draw gets its instance's culling planes; with CPU culling its meshlets are also culled on the
+	 * spot, and the draw keeps only the index ranges that are left.
+	 */
+	class MeshletDrawList
+	{
+	public:
+		void Begin(const MeshletCuller& culler, bool cullOnCPU);
+		// Returns false, recording nothing, when every meshlet was culled.
+		bool Record(const Ref<Mesh>& mesh, const Ref<Material>& material, const glm::mat4& transform);
+		void Clear();
+
+		const std::vector<MeshletDraw>& GetDraws() const { return m_Draws; }
+		const std::vector<Ref<Mesh>>& GetMeshes() const { return m_Meshes; }
+		const std::vector<Ref<Material>>& GetMaterials() const { return m_Materials; }
+		const std::vector<DrawElementsIndirectCommand>& GetCommands() const { return m_Commands; }
+		uint32_t GetDrawCount() const { return static_cast<uint32_t>(m_Draws.size()); }
+
+		// Culling counts of the CPU path; the GPU path reads its own back.
+		uint32_t GetMeshletsTotal() const { return m_MeshletsTotal; }
+		uint32_t GetMeshletsVisible() const { return m_MeshletsVisible; }
+		uint32_t GetTrianglesTotal() const { return m_TrianglesTotal; }
+		uint32_t GetTrianglesVisible() const { return m_TrianglesVisible; }
+
+	private:
+		uint32_t GetMeshIndex(const Ref<Mesh>& mesh);
+		uint32_t GetMaterialIndex(const Ref<Material>& material);
+
+	private:
+		const MeshletCuller* m_Culler = nullptr;
+		bool m_CullOnCPU = true;
+
+		std::vector<MeshletDraw> m_Draws;
+		std::vector<DrawElementsIndirectCommand> m_Commands;
+		std::vector<Ref<Mesh>> m_Meshes;
+		std::unordered_map<const Mesh*, uint32_t> m_MeshIndices;
+		std::vector<Ref<Material>> m_Materials;
+		std::unordered_map<const Material*, uint32_t> m_MaterialIndices;
+
+		// The last mesh and material looked up, as in RenderCommandBuffer.
+		const Mesh* m_LastMesh = nullptr;
+		uint32_t m_LastMeshIndex = 0;
+		const Material* m_LastMaterial = nullptr;
+		uint32_t m_LastMaterialIndex = 0;
+
+		uint32_t m_MeshletsTotal = 0;
+		uint32_t m_MeshletsVisible = 0;
+		uint32_t m_TrianglesTotal = 0;
+		uint32_t m_TrianglesVisible = 0;
+	};
+}
@@ -0,0 +1,168 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/MeshletQueue.h"
+#include "Ohm/Rendering/Renderer.h"
+
+#include <glad/glad.h>
+
+namespace Ohm
+{
+	// Storage buffer bindings of MeshletCulling.shader.
+	static constexpr uint32_t MeshletBinding = 1;
+	static constexpr uint32_t ObjectBinding = 2;
+	static constexpr uint32_t CommandBinding = 3;
+	static constexpr uint32_t ResultBinding = 4;
+
+	static constexpr uint32_t InitialMeshletCapacity = 4096;
+	static constexpr uint32_t InitialObjectCapacity = 1024;
+	static constexpr uint32_t InitialCommandCapacity = 4096;
+	static constexpr uint32_t MaxWorkGroupsX = 65535;
+
+	MeshletQueue::MeshletQueue()
+	{
+		static_assert(sizeof(MeshletObject) == 128, "MeshletObject must match MeshletCulling.shader's layout.");
+
+		m_MeshletBuffer = CreateRef<StorageBuffer>(sizeof(Meshlet) * InitialMeshletCapacity, MeshletBinding);
+		m_ObjectBuffer = CreateRef<StorageBuffer>(sizeof(MeshletObject) * InitialObjectCapacity, ObjectBinding);
+		m_CommandBuffer = CreateRef<StorageBuffer>(sizeof(DrawElementsIndirectCommand) * InitialCommandCapacity, CommandBinding);
+		m_Results = CreateScope<ReadbackRing>(sizeof(CullingResults), ResultBinding);
+
+		m_CullingShader = ShaderLibrary::Get("MeshletCulling");
+		m_ObjectCountUniform = m_CullingShader->GetUniformHandle("u_ObjectCount");
+	}
+
+	void MeshletQueue::RecordPreviousResults()
+	{
+		// Only the newest finished frame is recorded, as in GPUDrivenQueue.
+		CullingResults Results;
+		uint32_t NewestSlot = ReadbackRing::NoSlot;
+		for (uint32_t Slot = m_Results->ReadFinished(&Results); Slot != ReadbackRing::NoSlot; Slot = m_Results->ReadFinished(&Results))
+			NewestSlot = Slot;
+		if (NewestSlot == ReadbackRing::NoSlot) return;
+
+		Renderer::RecordMeshletResults(m_MeshletsTotals[NewestSlot], Results.VisibleMeshlets, m_TrianglesTotals[NewestSlot], Results.VisibleTriangles);
+	}
+
+	uint32_t MeshletQueue::GetFirstMeshlet(const Ref<Mesh>& mesh)
+	{
+		auto [It, Inserted] = m_FirstMeshlets.try_emplace(mesh.get(), static_cast<uint32_t>(m_Meshlets.size()));
+		if (Inserted)
+		{
+			m_Meshlets.insert(m_Meshlets.end(), mesh->GetMeshlets().begin(), mesh->GetMeshlets().end());
+			m_MeshletSources.push_back(mesh);
+			m_MeshletsDirty = true;
+		}
+		return It->second;
+	}
+
+	void MeshletQueue::Flush(const std::vector<MeshletDrawList>& drawLists, bool cullOnGPU, const RenderQueuePreDrawFn& preDrawFn)
+	{
+		RecordPreviousResults();
+
+		m_SortEntries.clear();
+		uint32_t MeshletsTotal = 0, MeshletsVisible = 0, TrianglesTotal = 0, TrianglesVisible = 0;
+		for (const MeshletDrawList& List : drawLists)
+		{
+			for (const MeshletDraw& Draw : List.GetDraws())
+			{
+				const Ref<Material>& DrawMaterial = List.GetMaterials()[Draw.MaterialIndex];
+				const VertexFormat Format = List.GetMeshes()[Draw.MeshIndex]->GetVertexFormat();
+				m_SortEntries.push_back({ { DrawMaterial->GetShader()->GetID(), DrawMaterial->GetRuntimeID(), static_cast<uint32_t>(Format) }, &List, &Draw });
+			}
+
+			MeshletsTotal += List.GetMeshletsTotal();
+			MeshletsVisible += List.GetMeshletsVisible();
+			TrianglesTotal += List.GetTrianglesTotal();
+			TrianglesVisible += List.GetTrianglesVisible();
+		}
+
+		if (!cullOnGPU)
+			Renderer::RecordMeshletResults(MeshletsTotal, MeshletsVisible, TrianglesTotal, TrianglesVisible);
+		if (m_SortEntries.empty()) return;
+
+		std::sort(m_SortEntries.begin(), m_SortEntries.end(), [](const SortEntry& a, const SortEntry& b) { return a.Key < b.Key; });
+
+		// Each draw is one instance, its transform at its place in the sorted order.
+		m_Transforms.clear();
+		m_Commands.clear();
+		m_Objects.clear();
+		m_Batches.clear();
+		for (const SortEntry& Entry : m_SortEntries)
+		{
+			const MeshletDraw& Draw = *Entry.Draw;
+			const Ref<Mesh>& DrawMesh = Entry.List->GetMeshes()[Draw.MeshIndex];
+			const Ref<Material>& DrawMaterial = Entry.List->GetMaterials()[Draw.MaterialIndex];
+			const uint32_t InstanceIndex = static_cast<uint32_t>(m_Transforms.size());
+			const uint32_t FirstCommand = static_cast<uint32_t>(m_Commands.size());
+			m_Transforms.push_back(Draw.Transform);
+
+			if (cullOnGPU)
+			{
+				const std::vector<Meshlet>& Meshlets = DrawMesh->GetMeshlets();
+				const GeometryAllocation& Geometry = DrawMesh->GetGeometry();
+				for (const Meshlet& Current : Meshlets)
+					m_Commands.push_back({ Current.IndexCount, 1, Geometry.FirstIndex + Current.IndexOffset, static_cast<int32_t>(Geometry.BaseVertex), InstanceIndex });
+
+				MeshletObject& Object = m_Objects.emplace_back();
+				Object.CullInstance = Draw.CullInstance;
+				Object.FirstMeshlet = GetFirstMeshlet(DrawMesh);
+				Object.MeshletCount = static_cast<uint32_t>(Meshlets.size());
+				Object.FirstCommand = FirstCommand;
+			}
+			else
+			{
+				const std::vector<DrawElementsIndirectCommand>& Commands = Entry.List->GetCommands();
+				for (uint32_t i = 0; i < Draw.CommandCount; i++)
+				{
+					m_Commands.push_back(Commands[Draw.FirstCommand + i]);
+					m_Commands.back().BaseInstance = InstanceIndex;
+				}
+			}
+
+			const uint32_t CommandCount = static_cast<uint32_t>(m_Commands.size()) - FirstCommand;
+			const bool Continues = !m_Batches.empty() && m_Batches.back().BatchMaterial == DrawMaterial && m_Batches.back().Format == DrawMesh->GetVertexFormat();
+			if (!Continues)
+				m_Batches.push_back({ DrawMaterial, DrawMesh->GetVertexFormat(), FirstCommand, 0 });
+			m_Batches.back().CommandCount += CommandCount;
+		}
+
+		Renderer::UploadInstanceData(m_Transforms);
+		m_CommandBuffer->SetData(m_Commands.data(), static_cast<uint32_t>(m_Commands.size() * sizeof(DrawElementsIndirectCommand)));
+
+		if (cullOnGPU)
+		{
+			if (m_MeshletsDirty)
+			{
+				m_MeshletBuffer->SetData(m_Meshlets.data(), static_cast<uint32_t>(m_Meshlets.size() * sizeof(Meshlet)));
+				m_MeshletsDirty = false;
+			}
+			RenderCommand::BindBufferBase(GL_SHADER_STORAGE_BUFFER, MeshletBinding, m_MeshletBuffer->GetID());
+			m_ObjectBuffer->SetData(m_Objects.data(), static_cast<uint32_t>(m_Objects.size() * sizeof(MeshletObject)));
+			const CullingResults ClearedResults;
+			const uint32_t ResultSlot = m_Results->Begin(&ClearedResults);
+			m_MeshletsTotals[ResultSlot] = MeshletsTotal;
+			m_TrianglesTotals[ResultSlot] = TrianglesTotal;
+
+			const uint32_t ObjectCount = static_cast<uint32_t>(m_Objects.size());
+			m_CullingShader->Bind();
+			m_CullingShader->UploadUniformInt(m_ObjectCountUniform, static_cast<int>(ObjectCount));
+
+			// One work group per object; beyond the dispatch limit they wrap onto further rows.
+			const uint32_t GroupsX = glm::min(ObjectCount, MaxWorkGroupsX);
+			const uint32_t GroupsY = (ObjectCount + MaxWorkGroupsX - 1) / MaxWorkGroupsX;
+			m_CullingShader->DispatchCompute(GroupsX, GroupsY, 1);
+			m_CullingShader->EnableShaderStorageBarrierBit();
+			m_CullingShader->EnableCommandBarrierBit();
+			m_Results->End();
+		}
+
+		for (const Batch& Current : m_Batches)
+		{
+			if (Current.CommandCount == 0) continue;
+
+			std::lock_guard<std::mutex> Lock(Current.BatchMaterial->GetMutex());
+			if (preDrawFn)
+				preDrawFn(Current.BatchMaterial);
+			Renderer::DrawIndirect(Current.Format, Current.BatchMaterial, m_CommandBuffer->GetID(), Current.FirstCommand, Current.CommandCount);
+		}
+	}
+}
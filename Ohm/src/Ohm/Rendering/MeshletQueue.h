@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Ohm/Rendering/MeshletDrawList.h"
+#include "Ohm/Rendering/RenderQueue.h"
+#include "Ohm/Rendering/ReadbackRing.h"
+#include "Ohm/Rendering/StorageBuffer.h"
+#include "Ohm/Rendering/Shader.h"
+
+#include <tuple>
+
+namespace Ohm
+{
+	/*
+	 * Draws the MeshletDrawLists of a frame.  There are no mesh shaders in GL 4.5, so a meshlet is drawn as its range
+	 * of the mesh's index buffer: the visible meshlets of an object become indirect draw commands, and each batch of
+	 * objects sharing a material and a geometry pool is one glMultiDrawElementsIndirect.
+	 *
+	 * With CPU culling the lists already hold the surviving ranges.  With GPU culling every meshlet gets a command and
+	 * MeshletCulling.shader clears the instance count of those it rejects; the meshlets of each mesh are uploaded
+	 * once and kept.  Counts from the GPU are read back through a ReadbackRing, like GPUDrivenQueue's.
+	 */
+	class MeshletQueue
+	{
+	public:
+		MeshletQueue();
+
+		void Flush(const std::vector<MeshletDrawList>& drawLists, bool cullOnGPU, const RenderQueuePreDrawFn& preDrawFn = nullptr);
+
+	private:
+		void RecordPreviousResults();
+		uint32_t GetFirstMeshlet(const Ref<Mesh>& mesh);
+
+	private:
+		// std430 layouts of MeshletCulling.shader's object and result buffers.
+		struct MeshletObject
+		{
+			MeshletCullInstance CullInstance;
+			uint32_t FirstMeshlet = 0;
+			uint32_t MeshletCount = 0;
+			uint32_t FirstCommand = 0;
+			uint32_t Padding = 0;
+		};
+
+		struct CullingResults
+		{
+			uint32_t VisibleMeshlets = 0;
+			uint32_t VisibleTriangles = 0;
+		};
+
+		// Consecutive commands drawn with one material from one geometry pool.
+		struct Batch
+		{
+			Ref<Material> BatchMaterial;
+			VertexFormat Format = VertexFormat::Full;
+			uint32_t FirstCommand = 0;
+			uint32_t CommandCount = 0;
+		};
+
+		struct SortEntry
+		{
+			std::tuple<uint32_t, uint32_t, uint32_t> Key;
+			const MeshletDrawList* List = nullptr;
+			const MeshletDraw* Draw = nullptr;
+		};
+
+		std::vector<SortEntry> m_SortEntries;
+		std::vector<glm::mat4> m_Transforms;
+		std::vector<DrawElementsIndirectCommand> m_Commands;
+		std::vector<MeshletObject> m_Objects;
+		std::vector<Batch> m_Batches;
+
+		Ref<StorageBuffer> m_MeshletBuffer;
+		Ref<StorageBuffer> m_ObjectBuffer;
+		Ref<StorageBuffer> m_CommandBuffer;
+		Scope<ReadbackRing> m_Results;
+
+		// Meshlets of every mesh drawn so far, in the order they were first drawn.  The meshes are kept alive, so a
+		// pointer is never reused for different meshlets.
+		std::vector<Meshlet> m_Meshlets;
+		std::vector<Ref<Mesh>> m_MeshletSources;
+		std::unordered_map<const Mesh*, uint32_t> m_FirstMeshlets;
+		bool m_MeshletsDirty = false;
+
+		Ref<Shader> m_CullingShader;
+		UniformHandle m_ObjectCountUniform;
+
+		// Totals of the frame each result slot was written for.
+		uint32_t m_MeshletsTotals[ReadbackRing::SlotCount]{};
+		uint32_t m_TrianglesTotals[ReadbackRing::SlotCount]{};
+	};
+}
@@ -0,0 +1,286 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/MipGenerator.h"
+#include "Ohm/Core/JobSystem.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define OHM_MIP_SSE
+#endif
+
+namespace Ohm
+{
+	static constexpr float Pi = 3.14159265359f;
+	// The Kaiser window NVIDIA Texture Tools filters mips with: three destination texels either side, alpha 4.
+	static constexpr float KaiserWidth = 3.0f;
+	static constexpr float KaiserAlpha = 4.0f;
+	// Fine enough that the darkest sRGB steps, where the curve is steepest, still round correctly.
+	static constexpr uint32_t LinearToSRGBTableSize = 1 << 14;
+	// Neighbouring bands filter the source rows they share twice, so bands shouldn't be much thinner than this.
+	static constexpr uint32_t MaxRowsPerChunk = 32;
+
+	// The source texels making up every destination texel along one axis, TapCount a texel, unused taps weighted zero.
+	struct FilterKernel
+	{
+		uint32_t TapCount = 0;
+		std::vector<uint32_t> Indices;
+		std::vector<float> Weights;
+	};
+
+	struct ColorTables
+	{
+		float SRGBToLinear[256];
+		uint8_t LinearToSRGB[LinearToSRGBTableSize];
+
+		ColorTables()
+		{
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				const float Encoded = i / 255.0f;
+				SRGBToLinear[i] = Encoded <= 0.04045f ? Encoded / 12.92f : std::pow((Encoded + 0.055f) / 1.055f, 2.4f);
+			}
+
+			for (uint32_t i = 0; i < LinearToSRGBTableSize; i++)
+			{
+				const float Linear = static_cast<float>(i) / (LinearToSRGBTableSize - 1);
+				const float Encoded = Linear <= 0.0031308f ? Linear * 12.92f : 1.055f * std::pow(Linear, 1.0f / 2.4f) - 0.055f;
+				LinearToSRGB[i] = static_cast<uint8_t>(std::lround(glm::clamp(Encoded, 0.0f, 1.0f) * 255.0f));
+			}
+		}
+	};
+
+	static const ColorTables& GetColorTables()
+	{
+		static const ColorTables Tables;
+		return Tables;
+	}
+
+	// Modified Bessel function of the first kind, order zero, from its power series.
+	static float BesselI0(float x)
+	{
+		const float QuarterSquared = x * x * 0.25f;
+		float Sum = 1.0f, Term = 1.0f;
+		for (uint32_t k = 1; k < 32 && Term > Sum * 1e-8f; k++)
+		{
+			Term *= QuarterSquared / static_cast<float>(k * k);
+			Sum += Term;
+		}
+		return Sum;
+	}
+
+	// x is in destination texels.
+	static float KaiserSinc(float x)
+	{
+		const float Window = x / KaiserWidth;
+		if (glm::abs(Window) >= 1.0f) return 0.0f;
+
+		const float Sinc = x == 0.0f ? 1.0f : std::sin(Pi * x) / (Pi * x);
+		return Sinc * BesselI0(KaiserAlpha * std::sqrt(1.0f - Window * Window)) / BesselI0(KaiserAlpha);
+	}
+
+	static FilterKernel BuildKernel(uint32_t sourceSize, uint32_t size, MipFilter filter)
+	{
+		const float Scale = static_cast<float>(sourceSize) / size;
+		const float Support = (filter == MipFilter::Box ? 0.5f : KaiserWidth) * Scale;
+
+		// Source texels [First, First + Count) of each destination texel overlap its support.
+		std::vector<int32_t> First(size);
+		FilterKernel Kernel;
+		for (uint32_t i = 0; i < size; i++)
+		{
+			const float Center = (i + 0.5f) * Scale;
+			First[i] = static_cast<int32_t>(std::floor(Center - Support));
+			const int32_t End = static_cast<int32_t>(std::ceil(Center + Support));
+			Kernel.TapCount = glm::max(Kernel.TapCount, static_cast<uint32_t>(End - First[i]));
+		}
+
+		Kernel.Indices.resize(static_cast<size_t>(size) * Kernel.TapCount);
+		Kernel.Weights.resize(static_cast<size_t>(size) * Kernel.TapCount);
+		for (uint32_t i = 0; i < size; i++)
+		{
+			const float Center = (i + 0.5f) * Scale;
+			uint32_t* Indices = Kernel.Indices.data() + static_cast<size_t>(i) * Kernel.TapCount;
+			float* Weights = Kernel.Weights.data() + static_cast<size_t>(i) * Kernel.TapCount;
+
+			float Sum = 0.0f;
+			for (uint32_t Tap = 0; Tap < Kernel.TapCount; Tap++)
+			{
+				const int32_t Source = First[i] + static_cast<int32_t>(Tap);
+				float Weight;
+				if (filter == MipFilter::Box)
+				{
+					const float Overlap = glm::min(Source + 1.0f, Center + Support) - glm::max(static_cast<float>(Source), Center - Support);
+					Weight = glm::max(Overlap, 0.0f);
+				}
+				else
+					Weight = KaiserSinc((Source + 0.5f - Center) / Scale);
+
+				Indices[Tap] = static_cast<uint32_t>(glm::clamp(Source, 0, static_cast<int32_t>(sourceSize) - 1));
+				Weights[Tap] = Weight;
+				Sum += Weight;
+			}
+
+			for (uint32_t Tap = 0; Tap < Kernel.TapCount; Tap++)
+				Weights[Tap] /= Sum;
+		}
+
+		return Kernel;
+	}
+
+	// One row of 8 bit texels to four linear floats a texel; channels an image doesn't have are left zero.
+	static void DecodeRow(const uint8_t* row, uint32_t width, uint32_t channels, bool srgb, const ColorTables& tables, float* decoded)
+	{
+		for (uint32_t X = 0; X < width; X++)
+		{
+			const uint8_t* Texel = row + static_cast<size_t>(X) * channels;
+			float* Out = decoded + static_cast<size_t>(X) * 4;
+			for (uint32_t Channel = 0; Channel < 4; Channel++)
+			{
+				if (Channel >= channels)
+					Out[Channel] = 0.0f;
+				else
+					Out[Channel] = srgb && Channel < 3 ? tables.SRGBToLinear[Texel[Channel]] : Texel[Channel] / 255.0f;
+			}
+		}
+	}
+
+	static void EncodeRow(const float* filtered, uint32_t width, uint32_t channels, bool srgb, bool normalMap, const ColorTables& tables, uint8_t* row)
+	{
+		for (uint32_t X = 0; X < width; X++)
+		{
+			float Texel[4];
+			std::copy(filtered + static_cast<size_t>(X) * 4, filtered + static_cast<size_t>(X) * 4 + 4, Texel);
+			if (normalMap)
+			{
+				glm::vec3 Normal(Texel[0] * 2.0f - 1.0f, Texel[1] * 2.0f - 1.0f, Texel[2] * 2.0f - 1.0f);
+				const float Length = glm::length(Normal);
+				Normal = Length > 0.0f ? Normal / Length : glm::vec3(0.0f, 0.0f, 1.0f);
+				Texel[0] = Normal.x * 0.5f + 0.5f;
+				Texel[1] = Normal.y * 0.5f + 0.5f;
+				Texel[2] = Normal.z * 0.5f + 0.5f;
+			}
+
+			uint8_t* Out = row + static_cast<size_t>(X) * channels;
+			for (uint32_t Channel = 0; Channel < channels; Channel++)
+			{
+				// The Kaiser filter's negative lobes can overshoot.
+				const float Value = glm::clamp(Texel[Channel], 0.0f, 1.0f);
+				Out[Channel] = srgb && Channel < 3 ? tables.LinearToSRGB[std::lround(Value * (LinearToSRGBTableSize - 1))] : static_cast<uint8_t>(std::lround(Value * 255.0f));
+			}
+		}
+	}
+
+	static void FilterRowHorizontally(const float* decoded, const FilterKernel& kernel, uint32_t width, float* filtered)
+	{
+		for (uint32_t X = 0; X < width; X++)
+		{
+			const uint32_t* Indices = kernel.Indices.data() + static_cast<size_t>(X) * kernel.TapCount;
+			const float* Weights = kernel.Weights.data() + static_cast<size_t>(X) * kernel.TapCount;
+#ifdef OHM_MIP_SSE
+			__m128 Sum = _mm_setzero_ps();
+			for (uint32_t Tap = 0; Tap < kernel.TapCount; Tap++)
+				Sum = _mm_add_ps(Sum, _mm_mul_ps(_mm_set1_ps(Weights[Tap]), _mm_loadu_ps(decoded + static_cast<size_t>(Indices[Tap]) * 4)));
+			_mm_storeu_ps(filtered + static_cast<size_t>(X) * 4, Sum);
+#else
+			float Sum[4] = {};
+			for (uint32_t Tap = 0; Tap < kernel.TapCount; Tap++)
+			{
+				const float* Texel = decoded + static_cast<size_t>(Indices[Tap]) * 4;
+				for (uint32_t Channel = 0; Channel < 4; Channel++)
+					Sum[Channel] += Weights[Tap] * Texel[Channel];
+			}
+			std::copy(Sum, Sum + 4, filtered + static_cast<size_t>(X) * 4);
+#endif
+		}
+	}
+
+	// row += weight * source, over count floats.
+	static void AccumulateRow(const float* source, float weight, size_t count, float* row)
+	{
+		size_t i = 0;
+#ifdef OHM_MIP_SSE
+		const __m128 Weight = _mm_set1_ps(weight);
+		for (; i + 4 <= count; i += 4)
+			_mm_storeu_ps(row + i, _mm_add_ps(_mm_loadu_ps(row + i), _mm_mul_ps(Weight, _mm_loadu_ps(source + i))));
+#endif
+		for (; i < count; i++)
+			row[i] += weight * source[i];
+	}
+
+	void MipGenerator::GenerateLevel(const uint8_t* source, uint32_t sourceWidth, uint32_t sourceHeight, uint8_t* destination, uint32_t width, uint32_t height,
+		uint32_t channels, const MipSettings& settings)
+	{
+		ASSERT(channels >= 1 && channels <= 4, "Mip Generator: Images have 1 to 4 channels, not {}.", channels);
+
+		const ColorTables& Tables = GetColorTables();
+		const FilterKernel Horizontal = BuildKernel(sourceWidth, width, settings.Filter);
+		const FilterKernel Vertical = BuildKernel(sourceHeight, height, settings.Filter);
+		const bool SRGB = settings.SRGB && channels >= 3;
+		const bool NormalMap = settings.NormalMap && channels >= 3;
+
+		const uint32_t RowsPerChunk = glm::clamp(height / (JobSystem::GetThreadCount() * 4), 1u, MaxRowsPerChunk);
+		JobSystem::ParallelFor(height, RowsPerChunk, [&](uint32_t begin, uint32_t end, uint32_t)
+			{
+				// The source rows this band of destination rows reaches, each filtered horizontally once.
+				uint32_t FirstSourceRow = sourceHeight, LastSourceRow = 0;
+				for (size_t i = static_cast<size_t>(begin) * Vertical.TapCount; i < static_cast<size_t>(end) * Vertical.TapCount; i++)
+				{
+					FirstSourceRow = glm::min(FirstSourceRow, Vertical.Indices[i]);
+					LastSourceRow = glm::max(LastSourceRow, Vertical.Indices[i]);
+				}
+
+				const size_t FilteredRowFloats = static_cast<size_t>(width) * 4;
+				std::vector<float> Decoded(static_cast<size_t>(sourceWidth) * 4);
+				std::vector<float> Filtered((LastSourceRow - FirstSourceRow + 1) * FilteredRowFloats);
+				for (uint32_t SourceRow = FirstSourceRow; SourceRow <= LastSourceRow; SourceRow++)
+				{
+					DecodeRow(source + static_cast<size_t>(SourceRow) * sourceWidth * channels, sourceWidth, channels, SRGB, Tables, Decoded.data());
+					FilterRowHorizontally(Decoded.data(), Horizontal, width, Filtered.data() + (SourceRow - FirstSourceRow) * FilteredRowFloats);
+				}
+
+				std::vector<float> Row(FilteredRowFloats);
+				for (uint32_t Y = begin; Y < end; Y++)
+				{
+					std::fill(Row.begin(), Row.end(), 0.0f);
+					for (uint32_t Tap = 0; Tap < Vertical.TapCount; Tap++)
+					{
+						const size_t Index = static_cast<size_t>(Y) * Vertical.TapCount + Tap;
+						if (Vertical.Weights[Index] == 0.0f) continue;
+						AccumulateRow(Filtered.data() + (Vertical.Indices[Index] - FirstSourceRow) * FilteredRowFloats, Vertical.Weights[Index], FilteredRowFloats, Row.data());
+					}
+
+					EncodeRow(Row.data(), width, channels, SRGB, NormalMap, Tables, destination + static_cast<size_t>(Y) * width * channels);
+				}
+			});
+	}
+
+	std::vector<uint8_t> MipGenerator::GenerateChain(const uint8_t* level0, uint32_t width, uint32_t height, uint32_t channels, uint32_t levelCount,
+		const MipSettings& settings, std::vector<MipLevel>& levels)
+	{
+		levels.clear();
+		size_t TotalBytes = 0;
+		for (uint32_t i = 1; i < levelCount; i++)
+		{
+			MipLevel& Level = levels.emplace_back();
+			Level.Width = glm::max(width >> i, 1u);
+			Level.Height = glm::max(height >> i, 1u);
+			Level.Offset = TotalBytes;
+			TotalBytes += static_cast<size_t>(Level.Width) * Level.Height * channels;
+		}
+
+		std::vector<uint8_t> Data(TotalBytes);
+		const uint8_t* Source = level0;
+		uint32_t SourceWidth = width, SourceHeight = height;
+		for (const MipLevel& Level : levels)
+		{
+			uint8_t* Destination = Data.data() + Level.Offset;
+			GenerateLevel(Source, SourceWidth, SourceHeight, Destination, Level.Width, Level.Height, channels, settings);
+			Source = Destination;
+			SourceWidth = Level.Width;
+			SourceHeight = Level.Height;
+		}
+
+		return Data;
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+namespace Ohm
+{
+	enum class MipFilter { Box = 0, Kaiser };
+
+	struct MipSettings
+	{
+		MipFilter Filter = MipFilter::Kaiser;
+		// The first three channels of a three or four channel image are sRGB encoded and are filtered as linear light.
+		bool SRGB = false;
+		// The first three channels hold a tangent space normal, which is renormalized after filtering.
+		bool NormalMap = false;
+	};
+
+	struct MipLevel
+	{
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		// Into the data GenerateChain returns.
+		size_t Offset = 0;
+	};
+
+	/*
+	 * Mip chains of 8 bit images on the CPU, so they can be cached with a texture and built off the render thread.
+	 *
+	 * Each level is filtered from the one before, separably: rows of the source are decoded to linear floats and
+	 * filtered horizontally, then the rows a destination row covers are filtered vertically and encoded back.  The
+	 * box filter averages exactly the area a destination texel covers.  The Kaiser filter is a windowed sinc three
+	 * destination texels wide, which keeps detail a box blurs away without ringing noticeably.  Edges are clamped.
+	 *
+	 * Bands of destination rows are filtered in parallel on the job system, a texel's channels at a time with SSE
+	 * where available.  The output doesn't depend on the thread count.
+	 */
+	class MipGenerator
+	{
+	public:
+		// Filters source down to a width x height destination.  Both are tightly packed, with channels 8 bit channels
+		// a texel.
+		static void GenerateLevel(const uint8_t* source, uint32_t sourceWidth, uint32_t sourceHeight, uint8_t* destination, uint32_t width, uint32_t height,
+			uint32_t channels, const MipSettings& settings);
+		// Levels 1 to levelCount - 1 of level0, halving each axis down to one texel, back to back.  levels[i]
+		// receives the size and offset of level i + 1.
+		static std::vector<uint8_t> GenerateChain(const uint8_t* level0, uint32_t width, uint32_t height, uint32_t channels, uint32_t levelCount,
+			const MipSettings& settings, std::vector<MipLevel>& levels);
+	};
+}
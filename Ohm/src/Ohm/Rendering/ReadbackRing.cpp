@@ -0,0 +1,65 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/ReadbackRing.h"
+
+#include <glad/glad.h>
+
+namespace Ohm
+{
+	ReadbackRing::ReadbackRing(uint32_t size, uint32_t binding)
+		:m_Size(size)
+	{
+		for (Ref<StorageBuffer>& Buffer : m_Buffers)
+			Buffer = CreateRef<StorageBuffer>(size, binding);
+	}
+
+	ReadbackRing::~ReadbackRing()
+	{
+		for (void* Fence : m_Fences)
+		{
+			if (Fence != nullptr)
+				glDeleteSync(static_cast<GLsync>(Fence));
+		}
+	}
+
+	uint32_t ReadbackRing::Begin(const void* clearedData)
+	{
+		if (m_InFlightCount == SlotCount)
+		{
+			glDeleteSync(static_cast<GLsync>(m_Fences[m_OldestSlot]));
+			m_Fences[m_OldestSlot] = nullptr;
+			m_OldestSlot = (m_OldestSlot + 1) % SlotCount;
+			m_InFlightCount--;
+		}
+
+		const uint32_t Slot = (m_OldestSlot + m_InFlightCount) % SlotCount;
+		m_Buffers[Slot]->SetData(clearedData, m_Size);
+		return Slot;
+	}
+
+	void ReadbackRing::End()
+	{
+		// The barrier makes the pass's writes visible to the read; the fence tells when they have landed.
+		glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+		const uint32_t Slot = (m_OldestSlot + m_InFlightCount) % SlotCount;
+		m_Fences[Slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_InFlightCount++;
+	}
+
+	uint32_t ReadbackRing::ReadFinished(void* data)
+	{
+		if (m_InFlightCount == 0)
+			return NoSlot;
+
+		const uint32_t Slot = m_OldestSlot;
+		const GLenum Status = glClientWaitSync(static_cast<GLsync>(m_Fences[Slot]), 0, 0);
+		if (Status != GL_ALREADY_SIGNALED && Status != GL_CONDITION_SATISFIED)
+			return NoSlot;
+
+		glGetNamedBufferSubData(m_Buffers[Slot]->GetID(), 0, m_Size, data);
+		glDeleteSync(static_cast<GLsync>(m_Fences[Slot]));
+		m_Fences[Slot] = nullptr;
+		m_OldestSlot = (m_OldestSlot + 1) % SlotCount;
+		m_InFlightCount--;
+		return Slot;
+	}
+}
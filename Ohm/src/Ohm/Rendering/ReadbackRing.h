@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Ohm/Rendering/StorageBuffer.h"
+
+namespace Ohm
+{
+	/*
+	 * Storage buffers for small results a compute pass writes every frame and the CPU reads back later, like culling
+	 * counts.  Each frame's pass writes the next slot, which is fenced once the pass is submitted.  A slot is only
+	 * read after its fence has signalled, polled without waiting, so reading never stalls on the GPU; results that
+	 * aren't ready stay in flight for a later frame.  When every slot is still in flight the oldest is dropped
+	 * rather than waited for.
+	 */
+	class ReadbackRing
+	{
+	public:
+		static constexpr uint32_t SlotCount = 3;
+		static constexpr uint32_t NoSlot = UINT32_MAX;
+
+		ReadbackRing(uint32_t size, uint32_t binding);
+		~ReadbackRing();
+		ReadbackRing(const ReadbackRing&) = delete;
+		ReadbackRing& operator=(const ReadbackRing&) = delete;
+
+		// Clears the next slot to clearedData and binds it for the pass about to write it.  Returns the slot, for
+		// callers that keep CPU side values to go with the results.
+		uint32_t Begin(const void* clearedData);
+		// Called once the pass's dispatches are submitted.
+		void End();
+		// Copies the results of the oldest slot the GPU is done with into data and frees the slot.  Returns the
+		// slot, or NoSlot when nothing has finished.
+		uint32_t ReadFinished(void* data);
+
+	private:
+		Ref<StorageBuffer> m_Buffers[SlotCount];
+		void* m_Fences[SlotCount]{};
+		uint32_t m_Size;
+		// Slots in flight run from m_OldestSlot for m_InFlightCount slots, in submission order.
+		uint32_t m_OldestSlot = 0;
+		uint32_t m_InFlightCount = 0;
+	};
+}
@@ -24,30 +24,135 @@ namespace Ohm
 		}
 	}
 
+	// Sentinel for "unknown", forcing the next bind through to GL.
+	static constexpr uint32_t s_UnknownState = UINT32_MAX;
+
+	struct IndexedBufferBinding
+	{
+		uint32_t BufferID = s_UnknownState;
+		uint64_t Offset = 0;
+		uint64_t Size = 0;
+	};
+
+	struct ImageUnitBinding
+	{
+		uint32_t TextureID = s_UnknownState;
+		uint32_t Level = 0;
+		bool Layered = false;
+		uint32_t Layer = 0;
+		uint32_t Access = 0;
+		uint32_t Format = 0;
+
+		bool operator==(const ImageUnitBinding& other) const
+		{
+			return TextureID == other.TextureID && Level == other.Level && Layered == other.Layered && Layer == other.Layer && Access == other.Access && Format == other.Format;
+		}
+	};
+
+	// Plain arrays only: buffers and textures released during static destruction still invalidate the cache.
+	struct GLStateCache
+	{
+		static constexpr uint32_t MaxTextureUnits = 32;
+		static constexpr uint32_t MaxImageUnits = 8;
+		static constexpr uint32_t MaxIndexedBufferBindings = 16;
+
+		uint32_t Program = s_UnknownState;
+		uint32_t VertexArray = s_UnknownState;
+		uint32_t VertexBuffer = s_UnknownState;
+		uint32_t IndexBuffer = s_UnknownState;
+		uint32_t Framebuffer = s_UnknownState;
+		uint32_t ActiveTextureUnit = s_UnknownState;
+		uint32_t PixelUnpackBuffer = s_UnknownState;
+		uint32_t UnpackAlignment = s_UnknownState;
+		uint32_t DepthTest = s_UnknownState;
+		uint32_t Blend = s_UnknownState;
+		uint32_t DepthFunc = s_UnknownState;
+
+		uint32_t TextureUnits[MaxTextureUnits];
+		ImageUnitBinding ImageUnits[MaxImageUnits];
+		IndexedBufferBinding UniformBuffers[MaxIndexedBufferBindings];
+		IndexedBufferBinding StorageBuffers[MaxIndexedBufferBindings];
+
+		uint64_t SkippedStateChanges = 0;
+
+		GLStateCache() { Invalidate(); }
+
+		void Invalidate()
+		{
+			Program = VertexArray = VertexBuffer = IndexBuffer = Framebuffer = s_UnknownState;
+			ActiveTextureUnit = PixelUnpackBuffer = UnpackAlignment = s_UnknownState;
+			DepthTest = Blend = DepthFunc = s_UnknownState;
+
+			for (uint32_t& textureID : TextureUnits)
+				textureID = s_UnknownState;
+			for (ImageUnitBinding& image : ImageUnits)
+				image = ImageUnitBinding();
+			for (IndexedBufferBinding& buffer : UniformBuffers)
+				buffer = IndexedBufferBinding();
+			for (IndexedBufferBinding& buffer : StorageBuffers)
+				buffer = IndexedBufferBinding();
+		}
+
+		// Returns true when the cached value already matches, otherwise records the new value.
+		bool Matches(uint32_t& cached, uint32_t value)
+		{
+			if (cached == value)
+			{
+				SkippedStateChanges++;
+				return true;
+			}
+
+			cached = value;
+			return false;
+		}
+
+		IndexedBufferBinding* GetIndexedBinding(uint32_t target, uint32_t binding)
+		{
+			if (binding >= MaxIndexedBufferBindings)
+				return nullptr;
+
+			switch (target)
+			{
+			case GL_UNIFORM_BUFFER:			return &UniformBuffers[binding];
+			case GL_SHADER_STORAGE_BUFFER:	return &StorageBuffers[binding];
+			default:						return nullptr;
+			}
+		}
+	};
+
+	// Binding state belongs to a context and each thread drives its own, so every thread gets its own cache.
+	static thread_local GLStateCache s_StateCache;
+
+	static void SetCapability(GLenum capability, uint32_t& cached, bool enabled)
+	{
+		if (s_StateCache.Matches(cached, enabled ? 1 : 0))
+			return;
+
+		if (enabled)
+			glEnable(capability);
+		else
+			glDisable(capability);
+	}
+
 	void RenderCommand::Initialize()
 	{
+		s_StateCache.Invalidate();
+
 		glEnable(GL_DEBUG_OUTPUT);
 		glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
 		glDebugMessageCallback(OpenGLMessageCallback, nullptr);
 
 		glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
 
-		glEnable(GL_BLEND);
+		SetCapability(GL_BLEND, s_StateCache.Blend, true);
 		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glEnable(GL_DEPTH_TEST);
+		SetCapability(GL_DEPTH_TEST, s_StateCache.DepthTest, true);
 	}
 
 	void RenderCommand::SetFlags(uint32_t flags)
 	{
-		if (flags & (uint32_t)RenderFlag::DepthTest)
-			glEnable(GL_DEPTH_TEST);
-		else
-			glDisable(GL_DEPTH_TEST);
-
-		if (flags & (uint32_t)RenderFlag::Blend)
-			glEnable(GL_BLEND);
-		else
-			glDisable(GL_BLEND);
+		SetCapability(GL_DEPTH_TEST, s_StateCache.DepthTest, flags & (uint32_t)RenderFlag::DepthTest);
+		SetCapability(GL_BLEND, s_StateCache.Blend, flags & (uint32_t)RenderFlag::Blend);
 	}
 
 	void RenderCommand::SetDrawMode(DrawMode drawMode)
@@ -95,50 +200,176 @@ namespace Ohm
 		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
 	}
 
-	void RenderCommand::SetDepthFlag(DepthFlag depthFlag)
+	void RenderCommand::DrawIndexedBaseVertex(uint32_t indexCount, uint32_t firstIndex, uint32_t baseVertex, uint32_t instanceCount, uint32_t baseInstance)
+	{
+		const void* offset = reinterpret_cast<const void*>(static_cast<uintptr_t>(firstIndex) * sizeof(uint32_t));
+		glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, offset, instanceCount, static_cast<GLint>(baseVertex), baseInstance);
+	}
+
+	void RenderCommand::MultiDrawIndexedIndirect(uint32_t commandBufferID, uint32_t firstCommand, uint32_t commandCount)
+	{
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBufferID);
+		const void* offset = reinterpret_cast<const void*>(static_cast<uintptr_t>(firstCommand) * sizeof(DrawElementsIndirectCommand));
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, offset, commandCount, 0);
+	}
+
+	static GLenum DepthFlagToGLenum(DepthFlag depthFlag)
 	{
 		switch (depthFlag)
 		{
-		case DepthFlag::Never:
-			{
-				glDepthFunc(GL_NEVER);
-				break;
-			}
-		case DepthFlag::Less:
-			{
-				glDepthFunc(GL_LESS);
-				break;
-			}
-		case DepthFlag::Equal:
-			{
-				glDepthFunc(GL_EQUAL);
-				break;
-			}
-		case DepthFlag::LEqual:
-			{
-				glDepthFunc(GL_LEQUAL);
-				break;
-			}
-		case DepthFlag::Greater:
-			{
-				glDepthFunc(GL_GREATER);
-				break;
-			}
-		case DepthFlag::NotEqual:
-			{
-				glDepthFunc(GL_NOTEQUAL);
-				break;
-			}
-		case DepthFlag::GEqual:
-			{
-				glDepthFunc(GL_GEQUAL);
-				break;
-			}
-		case DepthFlag::Always:
+		case DepthFlag::Never:		return GL_NEVER;
+		case DepthFlag::Less:		return GL_LESS;
+		case DepthFlag::Equal:		return GL_EQUAL;
+		case DepthFlag::LEqual:		return GL_LEQUAL;
+		case DepthFlag::Greater:	return GL_GREATER;
+		case DepthFlag::NotEqual:	return GL_NOTEQUAL;
+		case DepthFlag::GEqual:		return GL_GEQUAL;
+		case DepthFlag::Always:		return GL_ALWAYS;
+		}
+
+		return GL_LESS;
+	}
+
+	void RenderCommand::SetDepthFlag(DepthFlag depthFlag)
+	{
+		const GLenum depthFunc = DepthFlagToGLenum(depthFlag);
+		if (s_StateCache.Matches(s_StateCache.DepthFunc, depthFunc))
+			return;
+
+		glDepthFunc(depthFunc);
+	}
+
+	void RenderCommand::BindProgram(uint32_t programID)
+	{
+		if (s_StateCache.Matches(s_StateCache.Program, programID))
+			return;
+
+		glUseProgram(programID);
+	}
+
+	void RenderCommand::BindVertexArray(uint32_t vertexArrayID)
+	{
+		if (s_StateCache.Matches(s_StateCache.VertexArray, vertexArrayID))
+			return;
+
+		glBindVertexArray(vertexArrayID);
+		// Each vertex array carries its own element buffer binding.
+		s_StateCache.IndexBuffer = s_UnknownState;
+	}
+
+	void RenderCommand::BindVertexBuffer(uint32_t bufferID)
+	{
+		if (s_StateCache.Matches(s_StateCache.VertexBuffer, bufferID))
+			return;
+
+		glBindBuffer(GL_ARRAY_BUFFER, bufferID);
+	}
+
+	void RenderCommand::BindIndexBuffer(uint32_t bufferID)
+	{
+		if (s_StateCache.Matches(s_StateCache.IndexBuffer, bufferID))
+			return;
+
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bufferID);
+	}
+
+	void RenderCommand::BindBufferBase(uint32_t target, uint32_t binding, uint32_t bufferID)
+	{
+		IndexedBufferBinding* cached = s_StateCache.GetIndexedBinding(target, binding);
+		if (cached && cached->BufferID == bufferID && cached->Size == 0)
+		{
+			s_StateCache.SkippedStateChanges++;
+			return;
+		}
+
+		glBindBufferBase(target, binding, bufferID);
+		if (cached)
+			*cached = { bufferID, 0, 0 };
+	}
+
+	void RenderCommand::BindBufferRange(uint32_t target, uint32_t binding, uint32_t bufferID, uint64_t offset, uint64_t size)
+	{
+		IndexedBufferBinding* cached = s_StateCache.GetIndexedBinding(target, binding);
+		if (cached && cached->BufferID == bufferID && cached->Offset == offset && cached->Size == size)
+		{
+			s_StateCache.SkippedStateChanges++;
+			return;
+		}
+
+		glBindBufferRange(target, binding, bufferID, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+		if (cached)
+			*cached = { bufferID, offset, size };
+	}
+
+	void RenderCommand::BindTextureUnit(uint32_t slot, uint32_t textureID)
+	{
+		if (slot < GLStateCache::MaxTextureUnits && s_StateCache.Matches(s_StateCache.TextureUnits[slot], textureID))
+			return;
+
+		glBindTextureUnit(slot, textureID);
+	}
+
+	void RenderCommand::SetActiveTextureUnit(uint32_t slot)
+	{
+		if (s_StateCache.Matches(s_StateCache.ActiveTextureUnit, slot))
+			return;
+
+		glActiveTexture(GL_TEXTURE0 + slot);
+	}
+
+	void RenderCommand::BindImageTexture(uint32_t unit, uint32_t textureID, uint32_t level, bool layered, uint32_t layer, uint32_t access, uint32_t format)
+	{
+		const ImageUnitBinding binding = { textureID, level, layered, layer, access, format };
+		if (unit < GLStateCache::MaxImageUnits)
+		{
+			if (s_StateCache.ImageUnits[unit] == binding)
 			{
-				glDepthFunc(GL_ALWAYS);
-				break;
+				s_StateCache.SkippedStateChanges++;
+				return;
 			}
+
+			s_StateCache.ImageUnits[unit] = binding;
 		}
+
+		glBindImageTexture(unit, textureID, level, layered ? GL_TRUE : GL_FALSE, layer, access, format);
+	}
+
+	void RenderCommand::BindFramebuffer(uint32_t framebufferID)
+	{
+		if (s_StateCache.Matches(s_StateCache.Framebuffer, framebufferID))
+			return;
+
+		glBindFramebuffer(GL_FRAMEBUFFER, framebufferID);
+	}
+
+	void RenderCommand::BindPixelUnpackBuffer(uint32_t bufferID)
+	{
+		if (s_StateCache.Matches(s_StateCache.PixelUnpackBuffer, bufferID))
+			return;
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, bufferID);
+	}
+
+	void RenderCommand::SetUnpackAlignment(uint32_t alignment)
+	{
+		if (s_StateCache.Matches(s_StateCache.UnpackAlignment, alignment))
+			return;
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, static_cast<GLint>(alignment));
+	}
+
+	void RenderCommand::InvalidateStateCache()
+	{
+		s_StateCache.Invalidate();
+	}
+
+	uint64_t RenderCommand::GetSkippedStateChanges()
+	{
+		return s_StateCache.SkippedStateChanges;
+	}
+
+	void RenderCommand::ResetStateStatistics()
+	{
+		s_StateCache.SkippedStateChanges = 0;
 	}
 }
\ No newline at end of file
@@ -16,6 +16,16 @@ namespace Ohm
 	enum class DrawMode { None = 0, Fill, WireFrame };
 	enum class FaceCullMode { None = 0, Front, Back };
 
+	// Layout glMultiDrawElementsIndirect reads from the draw indirect buffer.
+	struct DrawElementsIndirectCommand
+	{
+		uint32_t Count = 0;
+		uint32_t InstanceCount = 0;
+		uint32_t FirstIndex = 0;
+		int32_t BaseVertex = 0;
+		uint32_t BaseInstance = 0;
+	};
+
 	class RenderCommand
 	{
 	public:
@@ -27,6 +37,35 @@ namespace Ohm
 		static void ClearColor(float r, float g, float b, float a);
 		static void ClearColor(const glm::vec4& color);
 		static void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0);
+		// Draws from the bound vertex array's buffers, with indices offset by baseVertex; see GeometryPool.
+		static void DrawIndexedBaseVertex(uint32_t indexCount, uint32_t firstIndex, uint32_t baseVertex, uint32_t instanceCount = 1, uint32_t baseInstance = 0);
+		// Draws commandCount DrawElementsIndirectCommands from the buffer, starting at firstCommand.
+		static void MultiDrawIndexedIndirect(uint32_t commandBufferID, uint32_t firstCommand, uint32_t commandCount);
 		static void SetDepthFlag(DepthFlag depthFlag);
+
+		// Binding calls below go through a shadow copy of the context state and are dropped when they wouldn't
+		// change anything.  Targets, access and format arguments are the raw GL enums.
+		static void BindProgram(uint32_t programID);
+		static void BindVertexArray(uint32_t vertexArrayID);
+		static void BindVertexBuffer(uint32_t bufferID);
+		// The element buffer binding belongs to the bound vertex array.
+		static void BindIndexBuffer(uint32_t bufferID);
+		static void BindBufferBase(uint32_t target, uint32_t binding, uint32_t bufferID);
+		static void BindBufferRange(uint32_t target, uint32_t binding, uint32_t bufferID, uint64_t offset, uint64_t size);
+		static void BindTextureUnit(uint32_t slot, uint32_t textureID);
+		// Only for entry points without a DSA form that work on the active unit's binding.
+		static void SetActiveTextureUnit(uint32_t slot);
+		static void BindImageTexture(uint32_t unit, uint32_t textureID, uint32_t level, bool layered, uint32_t layer, uint32_t access, uint32_t format);
+		static void BindFramebuffer(uint32_t framebufferID);
+		// Source of glTexture*SubImage* data while non-zero; see TextureUploader.
+		static void BindPixelUnpackBuffer(uint32_t bufferID);
+		// GL_UNPACK_ALIGNMENT, in bytes.  Restore GL's default of 4 once done with tightly packed rows.
+		static void SetUnpackAlignment(uint32_t alignment);
+
+		// Forget everything the cache knows.  Required after GL objects are deleted (their names may be reused)
+		// and after any code that touches bindings without going through RenderCommand.
+		static void InvalidateStateCache();
+		static uint64_t GetSkippedStateChanges();
+		static void ResetStateStatistics();
 	};
 }
\ No newline at end of file
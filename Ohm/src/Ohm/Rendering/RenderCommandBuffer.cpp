@@ -0,0 +1,69 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/RenderCommandBuffer.h"
+
+namespace Ohm
+{
+	void RenderCommandBuffer::Begin(const EditorCamera& camera)
+	{
+		Clear();
+		m_ViewMatrix = camera.GetView();
+		m_FarClip = camera.GetFarClip();
+	}
+
+	void RenderCommandBuffer::RecordDraw(DrawPass pass, const Ref<Mesh>& mesh, const Ref<Material>& material, const glm::mat4& transform, uint32_t lod)
+	{
+		const uint32_t MaterialIndex = GetMaterialIndex(material);
+		const auto& [ShaderID, MaterialID] = m_MaterialKeys[MaterialIndex];
+
+		// Distance along the view axis of the object's origin; the camera looks down -Z in view space.
+		const float ViewDepth = -(m_ViewMatrix * transform[3]).z;
+		const uint64_t Key = RenderQueue::MakeSortKey(pass, ShaderID, MaterialID, RenderQueue::MakeMeshID(*mesh, lod), ViewDepth / m_FarClip);
+
+		m_DrawCommands.push_back({ Key, lod, GetMeshIndex(mesh), MaterialIndex, transform });
+	}
+
+	uint32_t RenderCommandBuffer::GetMeshIndex(const Ref<Mesh>& mesh)
+	{
+		if (mesh.get() == m_LastMesh)
+			return m_LastMeshIndex;
+
+		auto [It, Inserted] = m_MeshIndices.try_emplace(mesh.get(), static_cast<uint32_t>(m_Meshes.size()));
+		if (Inserted)
+			m_Meshes.push_back(mesh);
+
+		m_LastMesh = mesh.get();
+		m_LastMeshIndex = It->second;
+		return m_LastMeshIndex;
+	}
+
+	uint32_t RenderCommandBuffer::GetMaterialIndex(const Ref<Material>& material)
+	{
+		if (material.get() == m_LastMaterial)
+			return m_LastMaterialIndex;
+
+		auto [It, Inserted] = m_MaterialIndices.try_emplace(material.get(), static_cast<uint32_t>(m_Materials.size()));
+		if (Inserted)
+		{
+			m_Materials.push_back(material);
+			m_MaterialKeys.emplace_back(material->GetShader()->GetID(), material->GetRuntimeID());
+		}
+
+		m_LastMaterial = material.get();
+		m_LastMaterialIndex = It->second;
+		return m_LastMaterialIndex;
+	}
+
+	void RenderCommandBuffer::Clear()
+	{
+		m_DrawCommands.clear();
+		m_Materials.clear();
+		m_MaterialKeys.clear();
+		m_MaterialIndices.clear();
+		m_Meshes.clear();
+		m_MeshIndices.clear();
+		m_LastMaterial = nullptr;
+		m_LastMaterialIndex = 0;
+		m_LastMesh = nullptr;
+		m_LastMeshIndex = 0;
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Ohm/Rendering/RenderQueue.h"
+
+#include <glm/glm.hpp>
+
+namespace Ohm
+{
+	struct DrawCommand
+	{
+		uint64_t SortKey = 0;
+		uint32_t LOD = 0;
+		// Indices into the recording buffer's mesh and material tables.
+		uint32_t MeshIndex = 0;
+		uint32_t MaterialIndex = 0;
+		glm::mat4 Transform{ 1.0f };
+	};
+
+	/*
+	 * A list of draws recorded without touching GL, so any thread can fill one.  Sort keys are computed while
+	 * recording, which leaves the thread that replays the buffer through a RenderQueue only a merge and a sort.
+	 *
+	 * Each mesh and material is referenced once in the buffer's tables and draws refer to them by index.  Threads
+	 * recording draws for the same mesh or material never share its reference count, and the meshes stay alive until
+	 * the buffer has been replayed, on whichever thread renders.
+	 */
+	class RenderCommandBuffer
+	{
+	public:
+		void Begin(const EditorCamera& camera);
+		void RecordDraw(DrawPass pass, const Ref<Mesh>& mesh, const Ref<Material>& material, const glm::mat4& transform, uint32_t lod = 0);
+		void Clear();
+
+		const std::vector<DrawCommand>& GetDrawCommands() const { return m_DrawCommands; }
+		const std::vector<Ref<Material>>& GetMaterials() const { return m_Materials; }
+		const std::vector<Ref<Mesh>>& GetMeshes() const { return m_Meshes; }
+		uint32_t GetDrawCount() const { return static_cast<uint32_t>(m_DrawCommands.size()); }
+
+	private:
+		uint32_t GetMaterialIndex(const Ref<Material>& material);
+		uint32_t GetMeshIndex(const Ref<Mesh>& mesh);
+
+	private:
+		glm::mat4 m_ViewMatrix{ 1.0f };
+		float m_FarClip = 1000.0f;
+
+		std::vector<DrawCommand> m_DrawCommands;
+		std::vector<Ref<Material>> m_Materials;
+		// Shader ID and runtime ID of each table entry, looked up once rather than per draw.
+		std::vector<std::pair<uint32_t, uint32_t>> m_MaterialKeys;
+		std::unordered_map<const Material*, uint32_t> m_MaterialIndices;
+
+		std::vector<Ref<Mesh>> m_Meshes;
+		std::unordered_map<const Mesh*, uint32_t> m_MeshIndices;
+
+		// Entities sharing a material or a mesh tend to be recorded back to back.
+		const Material* m_LastMaterial = nullptr;
+		uint32_t m_LastMaterialIndex = 0;
+		const Mesh* m_LastMesh = nullptr;
+		uint32_t m_LastMeshIndex = 0;
+	};
+}
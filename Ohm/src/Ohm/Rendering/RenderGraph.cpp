@@ -0,0 +1,522 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/RenderGraph.h"
+#include "Ohm/Rendering/Utility/TextureUtils.h"
+
+#include <glad/glad.h>
+#include <imgui.h>
+
+namespace Ohm
+{
+	static uint64_t CalculateMipChainSize(uint32_t width, uint32_t height, uint32_t mipCount, uint32_t bytesPerPixel)
+	{
+		uint64_t Size = 0;
+		for (uint32_t Mip = 0; Mip < mipCount; Mip++)
+		{
+			Size += static_cast<uint64_t>(glm::max(width >> Mip, 1u)) * glm::max(height >> Mip, 1u) * bytesPerPixel;
+		}
+		return Size;
+	}
+
+	static bool SpecificationsMatch(const FramebufferSpecification& a, const FramebufferSpecification& b)
+	{
+		if (a.Width != b.Width || a.Height != b.Height || a.IsLayered != b.IsLayered || a.Layers != b.Layers)
+			return false;
+
+		const auto& AttachmentsA = a.AttachmentSpecification.FBOTextureSpecifications;
+		const auto& AttachmentsB = b.AttachmentSpecification.FBOTextureSpecifications;
+		if (AttachmentsA.size() != AttachmentsB.size())
+			return false;
+
+		for (size_t i = 0; i < AttachmentsA.size(); i++)
+		{
+			if (AttachmentsA[i].TextureFormat != AttachmentsB[i].TextureFormat)
+				return false;
+		}
+		return true;
+	}
+
+	// Everything but the name; a physical texture is renamed freely as it's handed between resources.
+	static bool SpecificationsMatch(const Texture2DSpecification& a, const Texture2DSpecification& b)
+	{
+		return a.WrapModeS == b.WrapModeS && a.WrapModeT == b.WrapModeT &&
+			a.MinFilterMode == b.MinFilterMode && a.MagFilterMode == b.MagFilterMode &&
+			a.InternalFormat == b.InternalFormat && a.PixelLayoutFormat == b.PixelLayoutFormat && a.DataType == b.DataType &&
+			a.Width == b.Width && a.Height == b.Height;
+	}
+
+	// Only image stores are incoherent; framebuffer writes and sampling are ordered by GL between commands.
+	static GLbitfield BarrierBitsForAccess(RenderGraphAccess previous, RenderGraphAccess next)
+	{
+		if (previous != RenderGraphAccess::ImageStore)
+			return 0;
+
+		switch (next)
+		{
+			case RenderGraphAccess::Sampled:		return GL_TEXTURE_FETCH_BARRIER_BIT;
+			case RenderGraphAccess::ImageLoad:
+			case RenderGraphAccess::ImageStore:		return GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+			case RenderGraphAccess::RenderTarget:	return GL_FRAMEBUFFER_BARRIER_BIT;
+			default:								return 0;
+		}
+	}
+
+	RenderGraphResource RenderGraphBuilder::CreateFramebuffer(const std::string& name, const FramebufferSpecification& specification)
+	{
+		RenderGraph::ResourceNode Node;
+		Node.Name = name;
+		Node.Type = RenderGraphResourceType::Framebuffer;
+		Node.FramebufferSpec = specification;
+		Node.Producer = m_PassIndex;
+		return m_Graph.AddResource(std::move(Node));
+	}
+
+	RenderGraphResource RenderGraphBuilder::CreateTexture(const std::string& name, const Texture2DSpecification& specification)
+	{
+		RenderGraph::ResourceNode Node;
+		Node.Name = name;
+		Node.Type = RenderGraphResourceType::Texture;
+		Node.TextureSpec = specification;
+		Node.TextureSpec.Name = name;
+		Node.Producer = m_PassIndex;
+		return m_Graph.AddResource(std::move(Node));
+	}
+
+	RenderGraphResource RenderGraphBuilder::Read(RenderGraphResource resource, RenderGraphAccess access)
+	{
+		ASSERT(resource.IsValid() && resource.Index < m_Graph.m_Resources.size(), "Render Graph: Pass '{}' reads an invalid resource.", m_Graph.m_Passes[m_PassIndex].Name);
+		m_Graph.m_Passes[m_PassIndex].Reads.push_back({ resource.Index, access });
+		return resource;
+	}
+
+	RenderGraphResource RenderGraphBuilder::Write(RenderGraphResource resource, RenderGraphAccess access)
+	{
+		ASSERT(resource.IsValid() && resource.Index < m_Graph.m_Resources.size(), "Render Graph: Pass '{}' writes an invalid resource.", m_Graph.m_Passes[m_PassIndex].Name);
+		m_Graph.m_Passes[m_PassIndex].Writes.push_back({ resource.Index, access });
+
+		// Writing something another pass created builds on its contents, which makes that pass a dependency.
+		const RenderGraph::ResourceNode& Resource = m_Graph.m_Resources[resource.Index];
+		if (Resource.Producer != m_PassIndex && Resource.Producer != UINT32_MAX)
+			m_Graph.m_Passes[m_PassIndex].Reads.push_back({ resource.Index, RenderGraphAccess::None });
+
+		return resource;
+	}
+
+	void RenderGraphBuilder::SetSideEffects()
+	{
+		m_Graph.m_Passes[m_PassIndex].HasSideEffects = true;
+	}
+
+	RenderGraph::~RenderGraph()
+	{
+		for (auto& [Name, Timer] : m_PassTimers)
+			glDeleteQueries(TimerQueryLatency, Timer.Queries);
+	}
+
+	void RenderGraph::Begin()
+	{
+		m_Passes.clear();
+		m_Resources.clear();
+		m_Compiled = false;
+	}
+
+	void RenderGraph::AddPass(const std::string& name, const RenderGraphSetupFn& setupFn, const RenderGraphExecuteFn& executeFn)
+	{
+		const uint32_t PassIndex = static_cast<uint32_t>(m_Passes.size());
+
+		PassNode Node;
+		Node.Name = name;
+		Node.ExecuteFn = executeFn;
+		m_Passes.push_back(std::move(Node));
+
+		RenderGraphBuilder Builder(*this, PassIndex);
+		setupFn(Builder);
+	}
+
+	RenderGraphResource RenderGraph::ImportFramebuffer(const std::string& name, const Ref<Framebuffer>& framebuffer)
+	{
+		ResourceNode Node;
+		Node.Name = name;
+		Node.Type = RenderGraphResourceType::Framebuffer;
+		Node.FramebufferSpec = framebuffer->GetFramebufferSpecification();
+		Node.Imported = true;
+		Node.ImportedFramebuffer = framebuffer;
+		return AddResource(std::move(Node));
+	}
+
+	RenderGraphResource RenderGraph::ImportExternal(const std::string& name)
+	{
+		ResourceNode Node;
+		Node.Name = name;
+		Node.Type = RenderGraphResourceType::External;
+		Node.Imported = true;
+		return AddResource(std::move(Node));
+	}
+
+	void RenderGraph::MarkOutput(RenderGraphResource resource)
+	{
+		ASSERT(resource.IsValid() && resource.Index < m_Resources.size(), "Render Graph: Can't mark an invalid resource as output.");
+		m_Resources[resource.Index].IsOutput = true;
+	}
+
+	RenderGraphResource RenderGraph::AddResource(ResourceNode&& node)
+	{
+		m_Resources.push_back(std::move(node));
+		return { static_cast<uint32_t>(m_Resources.size() - 1) };
+	}
+
+	void RenderGraph::Compile()
+	{
+		CullPasses();
+		ComputeLifetimes();
+		AssignPhysicalResources();
+		ComputeBarriers();
+		m_Compiled = true;
+	}
+
+	void RenderGraph::CullPasses()
+	{
+		for (auto& Pass : m_Passes)
+		{
+			bool IsRoot = Pass.HasSideEffects;
+			for (const auto& Write : Pass.Writes)
+				IsRoot |= m_Resources[Write.Resource].IsOutput;
+			Pass.Culled = !IsRoot;
+		}
+
+		// Producers always precede their readers, so a single backwards sweep reaches every contributing pass.
+		for (int32_t PassIndex = static_cast<int32_t>(m_Passes.size()) - 1; PassIndex >= 0; PassIndex--)
+		{
+			if (m_Passes[PassIndex].Culled) continue;
+
+			for (const auto& Read : m_Passes[PassIndex].Reads)
+			{
+				for (int32_t WriterIndex = 0; WriterIndex < PassIndex; WriterIndex++)
+				{
+					PassNode& Writer = m_Passes[WriterIndex];
+					if (!Writer.Culled) continue;
+
+					for (const auto& Write : Writer.Writes)
+					{
+						if (Write.Resource != Read.Resource) continue;
+						Writer.Culled = false;
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	void RenderGraph::ComputeLifetimes()
+	{
+		for (uint32_t PassIndex = 0; PassIndex < m_Passes.size(); PassIndex++)
+		{
+			const PassNode& Pass = m_Passes[PassIndex];
+			if (Pass.Culled) continue;
+
+			const auto Touch = [this, PassIndex](uint32_t resourceIndex)
+			{
+				ResourceNode& Resource = m_Resources[resourceIndex];
+				Resource.FirstUse = glm::min(Resource.FirstUse, PassIndex);
+				Resource.LastUse = glm::max(Resource.LastUse, PassIndex);
+			};
+
+			for (const auto& Read : Pass.Reads)
+				Touch(Read.Resource);
+			for (const auto& Write : Pass.Writes)
+				Touch(Write.Resource);
+		}
+
+		// Outputs are consumed after the graph has run.
+		for (auto& Resource : m_Resources)
+		{
+			if (Resource.IsOutput && Resource.FirstUse != UINT32_MAX)
+				Resource.LastUse = static_cast<uint32_t>(m_Passes.size());
+		}
+	}
+
+	void RenderGraph::AssignPhysicalResources()
+	{
+		std::vector<uint32_t> TransientResources;
+		for (uint32_t ResourceIndex = 0; ResourceIndex < m_Resources.size(); ResourceIndex++)
+		{
+			const ResourceNode& Resource = m_Resources[ResourceIndex];
+			if (Resource.Imported || Resource.FirstUse == UINT32_MAX) continue;
+			TransientResources.push_back(ResourceIndex);
+		}
+
+		std::stable_sort(TransientResources.begin(), TransientResources.end(),
+			[this](uint32_t a, uint32_t b) { return m_Resources[a].FirstUse < m_Resources[b].FirstUse; });
+
+		for (auto& Physical : m_PhysicalResources)
+		{
+			Physical.Claimed = false;
+			Physical.LastUse = 0;
+		}
+
+		const auto Matches = [this](const PhysicalResource& physical, const ResourceNode& resource)
+		{
+			if (physical.Type != resource.Type)
+				return false;
+			return resource.Type == RenderGraphResourceType::Framebuffer ?
+				SpecificationsMatch(physical.FramebufferSpec, resource.FramebufferSpec) :
+				SpecificationsMatch(physical.TextureSpec, resource.TextureSpec);
+		};
+
+		bool PoolChanged = false;
+		m_Stats.UnaliasedBytes = 0;
+
+		for (const uint32_t ResourceIndex : TransientResources)
+		{
+			ResourceNode& Resource = m_Resources[ResourceIndex];
+			m_Stats.UnaliasedBytes += CalculateSize(Resource);
+
+			uint32_t PhysicalIndex = UINT32_MAX;
+
+			// First choice: storage already handed out this frame whose previous owner is dead by now.
+			for (uint32_t i = 0; i < m_PhysicalResources.size() && PhysicalIndex == UINT32_MAX; i++)
+			{
+				const PhysicalResource& Physical = m_PhysicalResources[i];
+				if (Physical.Claimed && Physical.LastUse < Resource.FirstUse && Matches(Physical, Resource))
+					PhysicalIndex = i;
+			}
+
+			// Then storage kept from last frame.
+			for (uint32_t i = 0; i < m_PhysicalResources.size() && PhysicalIndex == UINT32_MAX; i++)
+			{
+				const PhysicalResource& Physical = m_PhysicalResources[i];
+				if (!Physical.Claimed && Matches(Physical, Resource))
+					PhysicalIndex = i;
+			}
+
+			if (PhysicalIndex == UINT32_MAX)
+			{
+				PhysicalResource Physical;
+				Physical.Type = Resource.Type;
+				Physical.SizeInBytes = CalculateSize(Resource);
+				if (Resource.Type == RenderGraphResourceType::Framebuffer)
+				{
+					Physical.FramebufferSpec = Resource.FramebufferSpec;
+					Physical.FramebufferTarget = CreateRef<Framebuffer>(Resource.FramebufferSpec);
+				}
+				else
+				{
+					Physical.TextureSpec = Resource.TextureSpec;
+					Physical.TextureTarget = CreateRef<Texture2D>(Resource.TextureSpec);
+				}
+
+				m_PhysicalResources.push_back(std::move(Physical));
+				PhysicalIndex = static_cast<uint32_t>(m_PhysicalResources.size() - 1);
+				PoolChanged = true;
+			}
+
+			PhysicalResource& Physical = m_PhysicalResources[PhysicalIndex];
+			Physical.Claimed = true;
+			Physical.LastUse = Resource.LastUse;
+			Resource.PhysicalIndex = PhysicalIndex;
+		}
+
+		// Release whatever this frame didn't need.  Nothing refers to physical indices across frames.
+		std::vector<uint32_t> Remap(m_PhysicalResources.size(), UINT32_MAX);
+		std::vector<PhysicalResource> Kept;
+		for (uint32_t i = 0; i < m_PhysicalResources.size(); i++)
+		{
+			if (!m_PhysicalResources[i].Claimed)
+			{
+				PoolChanged = true;
+				continue;
+			}
+			Remap[i] = static_cast<uint32_t>(Kept.size());
+			Kept.push_back(std::move(m_PhysicalResources[i]));
+		}
+		m_PhysicalResources = std::move(Kept);
+
+		for (const uint32_t ResourceIndex : TransientResources)
+			m_Resources[ResourceIndex].PhysicalIndex = Remap[m_Resources[ResourceIndex].PhysicalIndex];
+
+		m_Stats.AliasedBytes = 0;
+		for (const auto& Physical : m_PhysicalResources)
+			m_Stats.AliasedBytes += Physical.SizeInBytes;
+
+		m_Stats.PassCount = static_cast<uint32_t>(m_Passes.size());
+		m_Stats.CulledPassCount = static_cast<uint32_t>(std::count_if(m_Passes.begin(), m_Passes.end(), [](const PassNode& pass) { return pass.Culled; }));
+		m_Stats.TransientResourceCount = static_cast<uint32_t>(TransientResources.size());
+		m_Stats.PhysicalResourceCount = static_cast<uint32_t>(m_PhysicalResources.size());
+
+		if (PoolChanged)
+		{
+			constexpr double BytesPerMB = 1024.0 * 1024.0;
+			OHM_CORE_INFO("Render Graph: {} transient resources in {} allocations, {:.1f} MB unaliased -> {:.1f} MB aliased.",
+				m_Stats.TransientResourceCount, m_Stats.PhysicalResourceCount, m_Stats.UnaliasedBytes / BytesPerMB, m_Stats.AliasedBytes / BytesPerMB);
+		}
+	}
+
+	void RenderGraph::ComputeBarriers()
+	{
+		// Hazards are tracked on storage, not on resources: aliased resources share one history.
+		const uint32_t PhysicalCount = static_cast<uint32_t>(m_PhysicalResources.size());
+		std::vector<RenderGraphAccess> LastAccess(PhysicalCount + m_Resources.size(), RenderGraphAccess::None);
+
+		const auto StorageIndex = [this, PhysicalCount](uint32_t resourceIndex)
+		{
+			const ResourceNode& Resource = m_Resources[resourceIndex];
+			return Resource.Imported ? PhysicalCount + resourceIndex : Resource.PhysicalIndex;
+		};
+
+		m_Stats.BarrierCount = 0;
+		for (auto& Pass : m_Passes)
+		{
+			Pass.BarrierBits = 0;
+			if (Pass.Culled) continue;
+
+			for (const auto& Read : Pass.Reads)
+				Pass.BarrierBits |= BarrierBitsForAccess(LastAccess[StorageIndex(Read.Resource)], Read.Access);
+			for (const auto& Write : Pass.Writes)
+				Pass.BarrierBits |= BarrierBitsForAccess(LastAccess[StorageIndex(Write.Resource)], Write.Access);
+
+			for (const auto& Write : Pass.Writes)
+				LastAccess[StorageIndex(Write.Resource)] = Write.Access;
+
+			if (Pass.BarrierBits != 0)
+				m_Stats.BarrierCount++;
+		}
+	}
+
+	void RenderGraph::Execute()
+	{
+		ASSERT(m_Compiled, "Render Graph: Compile() must be called before Execute().");
+
+		const uint32_t QuerySlot = static_cast<uint32_t>(m_FrameIndex++ % TimerQueryLatency);
+		m_Stats.GPUMilliseconds = 0.0f;
+
+		for (auto& Pass : m_Passes)
+		{
+			if (Pass.Culled) continue;
+
+			PassTimer& Timer = m_PassTimers[Pass.Name];
+			if (Timer.Queries[0] == 0)
+				glCreateQueries(GL_TIME_ELAPSED, TimerQueryLatency, Timer.Queries);
+
+			// This slot was issued TimerQueryLatency frames ago; its result is almost always ready by now.
+			if (Timer.InFlight[QuerySlot])
+			{
+				GLint Available = GL_FALSE;
+				glGetQueryObjectiv(Timer.Queries[QuerySlot], GL_QUERY_RESULT_AVAILABLE, &Available);
+				if (Available)
+				{
+					GLuint64 Nanoseconds = 0;
+					glGetQueryObjectui64v(Timer.Queries[QuerySlot], GL_QUERY_RESULT, &Nanoseconds);
+					Timer.Milliseconds = static_cast<float>(Nanoseconds) / 1.0e6f;
+				}
+				Timer.InFlight[QuerySlot] = false;
+			}
+
+			if (Pass.BarrierBits != 0)
+				glMemoryBarrier(Pass.BarrierBits);
+
+			glBeginQuery(GL_TIME_ELAPSED, Timer.Queries[QuerySlot]);
+			Pass.ExecuteFn(*this);
+			glEndQuery(GL_TIME_ELAPSED);
+			Timer.InFlight[QuerySlot] = true;
+
+			Pass.GPUMilliseconds = Timer.Milliseconds;
+			m_Stats.GPUMilliseconds += Timer.Milliseconds;
+		}
+
+		PublishReport();
+	}
+
+	void RenderGraph::PublishReport()
+	{
+		std::lock_guard<std::mutex> Lock(m_ReportMutex);
+		m_Report.Stats = m_Stats;
+
+		m_Report.Passes.clear();
+		for (const auto& Pass : m_Passes)
+			m_Report.Passes.push_back({ Pass.Name, Pass.Culled, Pass.GPUMilliseconds });
+
+		m_Report.Resources.clear();
+		for (const auto& Resource : m_Resources)
+		{
+			if (Resource.Imported || Resource.PhysicalIndex == UINT32_MAX) continue;
+			m_Report.Resources.push_back({ Resource.Name, Resource.PhysicalIndex, Resource.FirstUse, glm::min(Resource.LastUse, m_Stats.PassCount - 1) });
+		}
+	}
+
+	RenderGraph::Statistics RenderGraph::GetStatistics() const
+	{
+		std::lock_guard<std::mutex> Lock(m_ReportMutex);
+		return m_Report.Stats;
+	}
+
+	const Ref<Framebuffer>& RenderGraph::GetFramebuffer(RenderGraphResource resource) const
+	{
+		ASSERT(resource.IsValid() && resource.Index < m_Resources.size(), "Render Graph: Invalid framebuffer resource.");
+		const ResourceNode& Resource = m_Resources[resource.Index];
+		ASSERT(Resource.Type == RenderGraphResourceType::Framebuffer, "Render Graph: Resource '{}' is not a framebuffer.", Resource.Name);
+
+		if (Resource.Imported)
+			return Resource.ImportedFramebuffer;
+
+		ASSERT(Resource.PhysicalIndex != UINT32_MAX, "Render Graph: Framebuffer '{}' has no storage; it is unused this frame.", Resource.Name);
+		return m_PhysicalResources[Resource.PhysicalIndex].FramebufferTarget;
+	}
+
+	const Ref<Texture2D>& RenderGraph::GetTexture(RenderGraphResource resource) const
+	{
+		ASSERT(resource.IsValid() && resource.Index < m_Resources.size(), "Render Graph: Invalid texture resource.");
+		const ResourceNode& Resource = m_Resources[resource.Index];
+		ASSERT(Resource.Type == RenderGraphResourceType::Texture && !Resource.Imported, "Render Graph: Resource '{}' is not a transient texture.", Resource.Name);
+		ASSERT(Resource.PhysicalIndex != UINT32_MAX, "Render Graph: Texture '{}' has no storage; it is unused this frame.", Resource.Name);
+		return m_PhysicalResources[Resource.PhysicalIndex].TextureTarget;
+	}
+
+	uint64_t RenderGraph::CalculateSize(const ResourceNode& resource)
+	{
+		if (resource.Type == RenderGraphResourceType::Texture)
+		{
+			const Texture2DSpecification& Spec = resource.TextureSpec;
+			const uint32_t MipCount = TextureUtils::CalculateMipLevelCount(Spec.Width, Spec.Height);
+			return CalculateMipChainSize(Spec.Width, Spec.Height, MipCount, TextureUtils::GetBytesPerPixel(Spec.InternalFormat));
+		}
+
+		if (resource.Type != RenderGraphResourceType::Framebuffer)
+			return 0;
+
+		// Mirrors Framebuffer::Invalidate: color attachments carry a full mip chain, depth a single level.
+		const FramebufferSpecification& Spec = resource.FramebufferSpec;
+		const uint32_t Layers = Spec.IsLayered ? glm::max(Spec.Layers, 1u) : 1u;
+		uint64_t Size = 0;
+		for (const auto& Attachment : Spec.AttachmentSpecification.FBOTextureSpecifications)
+		{
+			const uint32_t BytesPerPixel = Framebuffer::GetBytesPerPixel(Attachment.TextureFormat);
+			const bool IsDepth = Attachment.TextureFormat == FramebufferTextureFormat::DEPTH24STENCIL8 || Attachment.TextureFormat == FramebufferTextureFormat::DEPTH32F;
+			const uint32_t MipCount = IsDepth ? 1 : TextureUtils::CalculateMipLevelCount(Spec.Width, Spec.Height);
+			Size += CalculateMipChainSize(Spec.Width, Spec.Height, MipCount, BytesPerPixel) * (IsDepth ? Layers : 1u);
+		}
+		return Size;
+	}
+
+	void RenderGraph::DrawUI() const
+	{
+		std::lock_guard<std::mutex> Lock(m_ReportMutex);
+		const Statistics& Stats = m_Report.Stats;
+
+		constexpr double BytesPerMB = 1024.0 * 1024.0;
+		ImGui::Text("Passes: %u (Culled: %u)", Stats.PassCount, Stats.CulledPassCount);
+		ImGui::Text("Transient Resources: %u in %u Allocations", Stats.TransientResourceCount, Stats.PhysicalResourceCount);
+		ImGui::Text("Peak Transient VRAM: %.1f MB (Unaliased: %.1f MB)", Stats.AliasedBytes / BytesPerMB, Stats.UnaliasedBytes / BytesPerMB);
+		ImGui::Text("Memory Barriers: %u", Stats.BarrierCount);
+		ImGui::Text("GPU Time: %.3f ms", Stats.GPUMilliseconds);
+
+		for (const auto& Pass : m_Report.Passes)
+		{
+			if (Pass.Culled)
+				ImGui::TextDisabled("  %s (culled)", Pass.Name.c_str());
+			else
+				ImGui::Text("  %s: %.3f ms", Pass.Name.c_str(), Pass.GPUMilliseconds);
+		}
+
+		for (const auto& Resource : m_Report.Resources)
+			ImGui::Text("  %s -> Allocation %u [%u, %u]", Resource.Name.c_str(), Resource.PhysicalIndex, Resource.FirstUse, Resource.LastUse);
+	}
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include "Ohm/Rendering/Framebuffer.h"
+#include "Ohm/Rendering/Texture2D.h"
+
+namespace Ohm
+{
+	class RenderGraph;
+	class RenderGraphBuilder;
+
+	using RenderGraphSetupFn = std::function<void(RenderGraphBuilder&)>;
+	using RenderGraphExecuteFn = std::function<void(const RenderGraph&)>;
+
+	// Framebuffers are the targets of raster passes, textures the targets of compute passes.  External resources
+	// have no storage the graph knows about (e.g. the environment cube maps) and only exist to order passes.
+	enum class RenderGraphResourceType { None = 0, Framebuffer, Texture, External };
+
+	// How a pass touches a resource.  The previous access decides the memory barrier issued before the next pass.
+	enum class RenderGraphAccess { None = 0, Sampled, ImageLoad, ImageStore, RenderTarget };
+
+	struct RenderGraphResource
+	{
+		uint32_t Index = UINT32_MAX;
+		bool IsValid() const { return Index != UINT32_MAX; }
+	};
+
+	class RenderGraphBuilder
+	{
+	public:
+		RenderGraphBuilder(RenderGraph& graph, uint32_t passIndex)
+			:m_Graph(graph), m_PassIndex(passIndex) { }
+
+		// Transient resources are owned by the graph, only live between their first and last use and may share
+		// storage with other transient resources of the same description.
+		RenderGraphResource CreateFramebuffer(const std::string& name, const FramebufferSpecification& specification);
+		RenderGraphResource CreateTexture(const std::string& name, const Texture2DSpecification& specification);
+
+		RenderGraphResource Read(RenderGraphResource resource, RenderGraphAccess access = RenderGraphAccess::Sampled);
+		RenderGraphResource Write(RenderGraphResource resource, RenderGraphAccess access = RenderGraphAccess::RenderTarget);
+
+		// The pass does work outside the graph and must never be culled.
+		void SetSideEffects();
+
+	private:
+		RenderGraph& m_Graph;
+		uint32_t m_PassIndex;
+	};
+
+	/*
+	 * A frame is described by adding passes; each pass's setup function runs immediately and declares what the
+	 * pass creates, reads and writes.  Compile() then:
+	 *	- culls every pass that doesn't contribute to an output resource or have side effects,
+	 *	- computes the lifetime of each transient resource over the surviving passes,
+	 *	- assigns transient resources with matching descriptions and disjoint lifetimes to the same physical
+	 *	  framebuffer or texture, which is kept in a pool between frames,
+	 *	- records the memory barrier each pass needs from the accesses that came before it.
+	 *
+	 * A pass can only read a resource an earlier pass created, so declaration order is always a valid execution
+	 * order and passes run in the order they were added.
+	 */
+	class RenderGraph
+	{
+	public:
+		struct Statistics
+		{
+			uint32_t PassCount = 0;
+			uint32_t CulledPassCount = 0;
+			uint32_t TransientResourceCount = 0;
+			uint32_t PhysicalResourceCount = 0;
+			uint32_t BarrierCount = 0;
+			// Peak transient memory if every resource had its own allocation, and what the aliased allocations use.
+			uint64_t UnaliasedBytes = 0;
+			uint64_t AliasedBytes = 0;
+			// GPU time of the executed passes, as measured a few frames ago by timer queries.
+			float GPUMilliseconds = 0.0f;
+		};
+
+		// Frames a timer query is left in flight before its result is read, so reading back never stalls.
+		static constexpr uint32_t TimerQueryLatency = 4;
+
+		RenderGraph() = default;
+		~RenderGraph();
+
+		void Begin();
+		void AddPass(const std::string& name, const RenderGraphSetupFn& setupFn, const RenderGraphExecuteFn& executeFn);
+
+		RenderGraphResource ImportFramebuffer(const std::string& name, const Ref<Framebuffer>& framebuffer);
+		RenderGraphResource ImportExternal(const std::string& name);
+		// Outputs are kept alive to the end of the frame and make the passes producing them survive culling.
+		void MarkOutput(RenderGraphResource resource);
+
+		void Compile();
+		void Execute();
+
+		const Ref<Framebuffer>& GetFramebuffer(RenderGraphResource resource) const;
+		const Ref<Texture2D>& GetTexture(RenderGraphResource resource) const;
+
+		// Both read what the last executed frame published, so they can be called while another thread renders.
+		Statistics GetStatistics() const;
+		void DrawUI() const;
+
+	private:
+		friend class RenderGraphBuilder;
+
+		struct ResourceAccess
+		{
+			uint32_t Resource;
+			RenderGraphAccess Access;
+		};
+
+		struct PassNode
+		{
+			std::string Name;
+			RenderGraphExecuteFn ExecuteFn;
+			std::vector<ResourceAccess> Reads;
+			std::vector<ResourceAccess> Writes;
+			bool HasSideEffects = false;
+			bool Culled = false;
+			uint32_t BarrierBits = 0;
+			float GPUMilliseconds = 0.0f;
+		};
+
+		struct ResourceNode
+		{
+			std::string Name;
+			RenderGraphResourceType Type = RenderGraphResourceType::None;
+			FramebufferSpecification FramebufferSpec;
+			Texture2DSpecification TextureSpec{};
+			bool Imported = false;
+			bool IsOutput = false;
+			uint32_t Producer = UINT32_MAX;
+			uint32_t FirstUse = UINT32_MAX;
+			uint32_t LastUse = 0;
+			uint32_t PhysicalIndex = UINT32_MAX;
+			Ref<Framebuffer> ImportedFramebuffer;
+		};
+
+		// Storage that survives between frames.  Entries not claimed by a compile are released.
+		struct PhysicalResource
+		{
+			RenderGraphResourceType Type = RenderGraphResourceType::None;
+			FramebufferSpecification FramebufferSpec;
+			Texture2DSpecification TextureSpec{};
+			Ref<Framebuffer> FramebufferTarget;
+			Ref<Texture2D> TextureTarget;
+			uint64_t SizeInBytes = 0;
+			uint32_t LastUse = 0;
+			bool Claimed = false;
+		};
+
+		struct PassTimer
+		{
+			uint32_t Queries[TimerQueryLatency]{};
+			bool InFlight[TimerQueryLatency]{};
+			float Milliseconds = 0.0f;
+		};
+
+		// Copy of a frame's passes and allocations for the UI, which may run while the next frame is compiled.
+		struct Report
+		{
+			struct PassEntry
+			{
+				std::string Name;
+				bool Culled = false;
+				float GPUMilliseconds = 0.0f;
+			};
+
+			struct ResourceEntry
+			{
+				std::string Name;
+				uint32_t PhysicalIndex = 0;
+				uint32_t FirstUse = 0;
+				uint32_t LastUse = 0;
+			};
+
+			Statistics Stats;
+			std::vector<PassEntry> Passes;
+			std::vector<ResourceEntry> Resources;
+		};
+
+		RenderGraphResource AddResource(ResourceNode&& node);
+		void CullPasses();
+		void ComputeLifetimes();
+		void AssignPhysicalResources();
+		void ComputeBarriers();
+		void PublishReport();
+
+		static uint64_t CalculateSize(const ResourceNode& resource);
+
+	private:
+		std::vector<PassNode> m_Passes;
+		std::vector<ResourceNode> m_Resources;
+		std::vector<PhysicalResource> m_PhysicalResources;
+		// Keyed by pass name since passes are rebuilt every frame.
+		std::unordered_map<std::string, PassTimer> m_PassTimers;
+		uint64_t m_FrameIndex = 0;
+		Statistics m_Stats;
+		Report m_Report;
+		mutable std::mutex m_ReportMutex;
+		bool m_Compiled = false;
+	};
+}
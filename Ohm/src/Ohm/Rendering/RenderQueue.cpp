@@ -0,0 +1,193 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/RenderQueue.h"
+#include "Ohm/Rendering/RenderCommandBuffer.h"
+#include "Ohm/Rendering/Renderer.h"
+
+namespace Ohm
+{
+	// Everything above the depth field; packets equal under this mask can share an instanced draw.
+	static constexpr uint64_t s_StateMask = ~((1ull << RenderQueue::DepthBits) - 1);
+
+	uint64_t RenderQueue::MakeSortKey(DrawPass pass, uint32_t shaderID, uint32_t materialID, uint32_t meshID, float normalizedDepth)
+	{
+		constexpr uint64_t DepthMax = (1ull << DepthBits) - 1;
+
+		const float ClampedDepth = glm::clamp(normalizedDepth, 0.0f, 1.0f);
+		uint64_t Depth = static_cast<uint64_t>(ClampedDepth * static_cast<float>(DepthMax));
+
+		// Transparent geometry has to blend back-to-front.
+		if (pass == DrawPass::Transparent)
+			Depth = DepthMax - Depth;
+
+		uint64_t Key = 0;
+		Key |= (static_cast<uint64_t>(pass)			& ((1ull << PassBits) - 1))		<< (ShaderBits + MaterialBits + MeshBits + DepthBits);
+		Key |= (static_cast<uint64_t>(shaderID)		& ((1ull << ShaderBits) - 1))	<< (MaterialBits + MeshBits + DepthBits);
+		Key |= (static_cast<uint64_t>(materialID)	& ((1ull << MaterialBits) - 1))	<< (MeshBits + DepthBits);
+		Key |= (static_cast<uint64_t>(meshID)		& ((1ull << MeshBits) - 1))		<< DepthBits;
+		Key |= Depth;
+		return Key;
+	}
+
+	RenderQueue::RenderQueue()
+		:m_DirectCommands(CreateScope<RenderCommandBuffer>())
+	{
+	}
+
+	RenderQueue::~RenderQueue() = default;
+
+	void RenderQueue::Begin(const EditorCamera& camera)
+	{
+		Clear();
+		m_DirectCommands->Begin(camera);
+	}
+
+	void RenderQueue::Submit(DrawPass pass, const Ref<Mesh>& mesh, const Ref<Material>& material, const glm::mat4& transform, uint32_t lod)
+	{
+		m_DirectCommands->RecordDraw(pass, mesh, material, transform, lod);
+	}
+
+	void RenderQueue::Submit(const RenderCommandBuffer& commandBuffer)
+	{
+		if (commandBuffer.GetDrawCount() == 0) return;
+		m_CommandBuffers.push_back(&commandBuffer);
+	}
+
+	uint32_t RenderQueue::GetPacketCount() const
+	{
+		uint32_t Count = m_DirectCommands->GetDrawCount();
+		for (const RenderCommandBuffer* CommandBuffer : m_CommandBuffers)
+			Count += CommandBuffer->GetDrawCount();
+		return Count;
+	}
+
+	void RenderQueue::Merge(const RenderCommandBuffer& commandBuffer)
+	{
+		// Map the buffer's mesh and material tables into the queue's once, rather than resolving every draw's.
+		const std::vector<Ref<Material>>& Materials = commandBuffer.GetMaterials();
+		m_MaterialRemap.resize(Materials.size());
+		for (size_t i = 0; i < Materials.size(); i++)
+		{
+			auto [It, Inserted] = m_MaterialIndices.try_emplace(Materials[i].get(), static_cast<uint32_t>(m_Materials.size()));
+			if (Inserted)
+				m_Materials.push_back(Materials[i]);
+			m_MaterialRemap[i] = It->second;
+		}
+
+		const std::vector<Ref<Mesh>>& Meshes = commandBuffer.GetMeshes();
+		m_MeshRemap.resize(Meshes.size());
+		for (size_t i = 0; i < Meshes.size(); i++)
+		{
+			auto [It, Inserted] = m_MeshIndices.try_emplace(Meshes[i].get(), static_cast<uint32_t>(m_Meshes.size()));
+			if (Inserted)
+				m_Meshes.push_back(Meshes[i]);
+			m_MeshRemap[i] = It->second;
+		}
+
+		for (const DrawCommand& Command : commandBuffer.GetDrawCommands())
+		{
+			m_SortEntries.push_back({ Command.SortKey, static_cast<uint32_t>(m_Packets.size()) });
+			m_Packets.push_back({ Command.SortKey, Command.LOD, m_MeshRemap[Command.MeshIndex], m_MaterialRemap[Command.MaterialIndex], &Command.Transform });
+		}
+	}
+
+	void RenderQueue::RadixSort()
+	{
+		const size_t Count = m_SortEntries.size();
+		if (Count < 2) return;
+
+		m_SortScratch.resize(Count);
+		SortEntry* Source = m_SortEntries.data();
+		SortEntry* Destination = m_SortScratch.data();
+
+		// LSD radix sort, one byte per pass.  Stable, so equal keys keep their submission order.
+		for (uint32_t Shift = 0; Shift < 64; Shift += 8)
+		{
+			uint32_t Histogram[256] = {};
+			for (size_t i = 0; i < Count; i++)
+				Histogram[(Source[i].Key >> Shift) & 0xFF]++;
+
+			// Every key shares this byte, so the pass would not reorder anything.
+			if (Histogram[(Source[0].Key >> Shift) & 0xFF] == Count)
+				continue;
+
+			uint32_t Offset = 0;
+			for (uint32_t& Bucket : Histogram)
+			{
+				const uint32_t BucketCount = Bucket;
+				Bucket = Offset;
+				Offset += BucketCount;
+			}
+
+			for (size_t i = 0; i < Count; i++)
+				Destination[Histogram[(Source[i].Key >> Shift) & 0xFF]++] = Source[i];
+
+			std::swap(Source, Destination);
+		}
+
+		if (Source != m_SortEntries.data())
+			m_SortEntries.swap(m_SortScratch);
+	}
+
+	void RenderQueue::Flush(const RenderQueuePreDrawFn& preDrawFn)
+	{
+		const uint32_t PacketCount = GetPacketCount();
+		if (PacketCount == 0)
+		{
+			Clear();
+			return;
+		}
+
+		m_Packets.reserve(PacketCount);
+		m_SortEntries.reserve(PacketCount);
+		Merge(*m_DirectCommands);
+		for (const RenderCommandBuffer* CommandBuffer : m_CommandBuffers)
+			Merge(*CommandBuffer);
+
+		RadixSort();
+
+		m_InstanceTransforms.clear();
+		for (const SortEntry& Entry : m_SortEntries)
+			m_InstanceTransforms.push_back(*m_Packets[Entry.PacketIndex].Transform);
+		Renderer::UploadInstanceData(m_InstanceTransforms);
+
+		// Key fields are truncated, so compare the real mesh and material before merging into one draw.
+		const auto CanInstance = [](const DrawPacket& A, const DrawPacket& B)
+		{
+			return (A.SortKey & s_StateMask) == (B.SortKey & s_StateMask) &&
+				A.MeshIndex == B.MeshIndex &&
+				A.LOD == B.LOD &&
+				A.MaterialIndex == B.MaterialIndex;
+		};
+
+		const uint32_t Count = static_cast<uint32_t>(m_SortEntries.size());
+		uint32_t BatchStart = 0;
+		for (uint32_t Index = 1; Index <= Count; Index++)
+		{
+			const DrawPacket& BatchPacket = m_Packets[m_SortEntries[BatchStart].PacketIndex];
+			if (Index < Count && CanInstance(m_Packets[m_SortEntries[Index].PacketIndex], BatchPacket)) continue;
+
+			{
+				const Ref<Material>& BatchMaterial = m_Materials[BatchPacket.MaterialIndex];
+				std::lock_guard<std::mutex> Lock(BatchMaterial->GetMutex());
+				if (preDrawFn)
+					preDrawFn(BatchMaterial);
+				Renderer::DrawMeshInstanced(*m_Meshes[BatchPacket.MeshIndex], BatchMaterial, Index - BatchStart, BatchStart, BatchPacket.LOD);
+			}
+			BatchStart = Index;
+		}
+
+		Clear();
+	}
+
+	void RenderQueue::Clear()
+	{
+		m_DirectCommands->Clear();
+		m_CommandBuffers.clear();
+		m_Packets.clear();
+		m_Materials.clear();
+		m_MaterialIndices.clear();
+		m_Meshes.clear();
+		m_MeshIndices.clear();
+		m_SortEntries.clear();
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Ohm/Rendering/Material.h"
+#include "Ohm/Rendering/Mesh.h"
+#include "Ohm/Rendering/EditorCamera.h"
+
+#include <glm/glm.hpp>
+
+namespace Ohm
+{
+	class RenderCommandBuffer;
+
+	// Called before each batch is drawn, with the material's lock held.
+	using RenderQueuePreDrawFn = std::function<void(const Ref<Material>&)>;
+
+	// Ordered from first to last submitted.  Opaque packets are sorted front-to-back, transparent back-to-front.
+	enum class DrawPass : uint8_t { Opaque = 0, Transparent };
+
+	struct DrawPacket
+	{
+		uint64_t SortKey = 0;
+		uint32_t LOD = 0;
+		// Indices into the queue's merged mesh and material tables.
+		uint32_t MeshIndex = 0;
+		uint32_t MaterialIndex = 0;
+		// Points into the command buffer the draw was recorded in.
+		const glm::mat4* Transform = nullptr;
+	};
+
+	/*
+	 * Sort key layout (most to least significant):
+	 *	[63..60] Pass		[59..48] Shader		[47..32] Material		[31..16] Mesh		[15..0] Quantized view depth
+	 *
+	 * The mesh field holds the mesh's runtime ID in its high 12 bits and the LOD in its low 4, so each mesh and LOD
+	 * is its own batch, whether it's a primitive or was imported.  Meshes share their vertex format's GeometryPool,
+	 * so a change of mesh is only a different range to draw.
+	 *
+	 * Sorting on the key keeps program and texture changes to a minimum, and within a state bucket draws
+	 * opaque geometry front-to-back for early-Z.  Consecutive packets that share pass, shader, material and mesh
+	 * are merged into a single instanced draw on flush.
+	 *
+	 * Draws arrive either one at a time through Submit, or as whole RenderCommandBuffers recorded elsewhere.  Submitted
+	 * buffers are referenced, not copied, and must not change until the queue has been flushed.
+	 */
+	class RenderQueue
+	{
+	public:
+		static constexpr uint32_t PassBits = 4;
+		static constexpr uint32_t ShaderBits = 12;
+		static constexpr uint32_t MaterialBits = 16;
+		static constexpr uint32_t MeshBits = 16;
+		static constexpr uint32_t DepthBits = 16;
+
+		static uint64_t MakeSortKey(DrawPass pass, uint32_t shaderID, uint32_t materialID, uint32_t meshID, float normalizedDepth);
+		static uint32_t MakeMeshID(const Mesh& mesh, uint32_t lod) { return mesh.GetRuntimeID() << 4 | (lod & 0xF); }
+
+		RenderQueue();
+		~RenderQueue();
+
+		void Begin(const EditorCamera& camera);
+		void Submit(DrawPass pass, const Ref<Mesh>& mesh, const Ref<Material>& material, const glm::mat4& transform, uint32_t lod = 0);
+		void Submit(const RenderCommandBuffer& commandBuffer);
+		void Flush(const RenderQueuePreDrawFn& preDrawFn = nullptr);
+		void Clear();
+
+		uint32_t GetPacketCount() const;
+
+	private:
+		struct SortEntry
+		{
+			uint64_t Key;
+			uint32_t PacketIndex;
+		};
+
+		void Merge(const RenderCommandBuffer& commandBuffer);
+		void RadixSort();
+
+	private:
+		// Records the draws submitted one at a time; merged with the other buffers on flush.
+		Scope<RenderCommandBuffer> m_DirectCommands;
+
+		// Storage is kept between frames so steady-state submission doesn't allocate.
+		std::vector<const RenderCommandBuffer*> m_CommandBuffers;
+		std::vector<DrawPacket> m_Packets;
+		std::vector<Ref<Material>> m_Materials;
+		std::unordered_map<const Material*, uint32_t> m_MaterialIndices;
+		std::vector<uint32_t> m_MaterialRemap;
+		std::vector<Ref<Mesh>> m_Meshes;
+		std::unordered_map<const Mesh*, uint32_t> m_MeshIndices;
+		std::vector<uint32_t> m_MeshRemap;
+		std::vector<SortEntry> m_SortEntries;
+		std::vector<SortEntry> m_SortScratch;
+		std::vector<glm::mat4> m_InstanceTransforms;
+	};
+}
@@ -0,0 +1,198 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/RenderThread.h"
+#include "Ohm/Rendering/RenderCommand.h"
+#include "Ohm/Core/Window.h"
+
+#include <GLFW/glfw3.h>
+#include <glad/glad.h>
+
+#include <imgui.h>
+#include <backends/imgui_impl_opengl3.h>
+
+namespace Ohm
+{
+	struct RenderThread::Frame
+	{
+		FramePacket Packet;
+		std::vector<RenderThreadCommandFn> Commands;
+
+		// ImGui reuses its draw lists as soon as the next frame begins, so the frame keeps its own copies.
+		ImDrawData DrawData;
+		std::vector<ImDrawList*> DrawLists;
+		bool HasDrawData = false;
+
+		GLsync Fence = nullptr;
+
+		~Frame() { ClearDrawData(); }
+
+		void ClearDrawData()
+		{
+			for (ImDrawList* DrawList : DrawLists)
+				IM_DELETE(DrawList);
+			DrawLists.clear();
+			HasDrawData = false;
+		}
+
+		void Reset()
+		{
+			Commands.clear();
+			ClearDrawData();
+		}
+	};
+
+	RenderThread::RenderThread(Window& window)
+		:m_Window(window)
+	{
+		for (auto& Frame : m_Frames)
+			Frame = CreateScope<RenderThread::Frame>();
+
+		// GLFW only creates windows on the main thread, so the main thread's context is made here up front.
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		m_SharedContext = glfwCreateWindow(1, 1, "Ohm Shared Context", nullptr, m_Window.GetWindowHandle());
+		glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+		ASSERT(m_SharedContext, "Render Thread: Failed to create a context sharing the window's.");
+	}
+
+	RenderThread::~RenderThread()
+	{
+		Stop();
+		glfwDestroyWindow(m_SharedContext);
+	}
+
+	void RenderThread::Start()
+	{
+		ASSERT(!m_Running, "Render Thread: Already running.");
+
+		// Device objects are created lazily by the first NewFrame, which now runs without the window's context.
+		ImGui_ImplOpenGL3_CreateDeviceObjects();
+
+		glfwMakeContextCurrent(m_SharedContext);
+		RenderCommand::Initialize();
+
+		m_StopRequested = false;
+		m_Running = true;
+		m_Thread = std::thread([this]() { RenderLoop(); });
+		OHM_CORE_INFO("Render Thread: Started.");
+	}
+
+	void RenderThread::Stop()
+	{
+		if (!m_Running) return;
+
+		{
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			m_StopRequested = true;
+		}
+		m_Condition.notify_all();
+		m_Thread.join();
+		m_Running = false;
+
+		// Shutdown deletes GL objects, some of which (framebuffers, vertex arrays) only exist in this context.
+		glfwMakeContextCurrent(m_Window.GetWindowHandle());
+		RenderCommand::InvalidateStateCache();
+		OHM_CORE_INFO("Render Thread: Stopped.");
+	}
+
+	void RenderThread::BeginFrame()
+	{
+		{
+			std::unique_lock<std::mutex> Lock(m_Mutex);
+			m_Condition.wait(Lock, [this]() { return m_RenderingFrame != m_BuildFrame && m_PendingFrame != m_BuildFrame; });
+		}
+
+		m_Frames[m_BuildFrame]->Reset();
+	}
+
+	void RenderThread::EndFrame()
+	{
+		Frame& BuildFrame = *m_Frames[m_BuildFrame];
+		BuildFrame.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		// The render thread's context can't see the fence until this context's commands reach the driver.
+		glFlush();
+
+		{
+			std::unique_lock<std::mutex> Lock(m_Mutex);
+			m_Condition.wait(Lock, [this]() { return m_PendingFrame == NoFrame; });
+			m_PendingFrame = m_BuildFrame;
+		}
+		m_Condition.notify_all();
+
+		m_BuildFrame = (m_BuildFrame + 1) % FrameCount;
+		m_FrameIndex++;
+	}
+
+	FramePacket& RenderThread::GetFramePacket()
+	{
+		return m_Frames[m_BuildFrame]->Packet;
+	}
+
+	void RenderThread::Enqueue(const RenderThreadCommandFn& commandFn)
+	{
+		m_Frames[m_BuildFrame]->Commands.push_back(commandFn);
+	}
+
+	void RenderThread::SubmitUI(const ImDrawData* drawData)
+	{
+		Frame& BuildFrame = *m_Frames[m_BuildFrame];
+		BuildFrame.ClearDrawData();
+		if (drawData == nullptr || !drawData->Valid) return;
+
+		BuildFrame.DrawData = *drawData;
+		BuildFrame.DrawLists.reserve(drawData->CmdListsCount);
+		for (int i = 0; i < drawData->CmdListsCount; i++)
+			BuildFrame.DrawLists.push_back(drawData->CmdLists[i]->CloneOutput());
+		BuildFrame.DrawData.CmdLists = BuildFrame.DrawLists.data();
+		BuildFrame.HasDrawData = true;
+	}
+
+	void RenderThread::RenderLoop()
+	{
+		glfwMakeContextCurrent(m_Window.GetWindowHandle());
+		// Swap interval belongs to the context that swaps.
+		glfwSwapInterval(m_Window.IsVSync() ? 1 : 0);
+		RenderCommand::Initialize();
+
+		while (true)
+		{
+			uint32_t FrameIndex = NoFrame;
+			{
+				std::unique_lock<std::mutex> Lock(m_Mutex);
+				m_Condition.wait(Lock, [this]() { return m_PendingFrame != NoFrame || m_StopRequested; });
+				if (m_PendingFrame == NoFrame) break;
+
+				FrameIndex = m_PendingFrame;
+				m_RenderingFrame = FrameIndex;
+				m_PendingFrame = NoFrame;
+			}
+			m_Condition.notify_all();
+
+			RenderFrame(*m_Frames[FrameIndex]);
+
+			{
+				std::lock_guard<std::mutex> Lock(m_Mutex);
+				m_RenderingFrame = NoFrame;
+			}
+			m_Condition.notify_all();
+		}
+
+		glfwMakeContextCurrent(nullptr);
+	}
+
+	void RenderThread::RenderFrame(Frame& frame)
+	{
+		if (frame.Fence != nullptr)
+		{
+			glWaitSync(frame.Fence, 0, GL_TIMEOUT_IGNORED);
+			glDeleteSync(frame.Fence);
+			frame.Fence = nullptr;
+		}
+
+		for (const auto& Command : frame.Commands)
+			Command();
+
+		if (frame.HasDrawData)
+			ImGui_ImplOpenGL3_RenderDrawData(&frame.DrawData);
+
+		glfwSwapBuffers(m_Window.GetWindowHandle());
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Ohm/Rendering/FramePacket.h"
+
+struct GLFWwindow;
+struct ImDrawData;
+
+namespace Ohm
+{
+	class Window;
+
+	using RenderThreadCommandFn = std::function<void()>;
+
+	/*
+	 * Owns the window's GL context on a thread of its own, so the main thread can update and build frame N+1
+	 * while frame N is submitted to the driver and presented.
+	 *
+	 * Frames are double buffered.  Between BeginFrame and EndFrame the main thread fills one frame slot with a
+	 * FramePacket, commands to run and the ImGui draw lists; the render thread replays the other slot.  BeginFrame
+	 * blocks while the slot it hands out is still being rendered, which keeps the main thread at most one frame
+	 * ahead.
+	 *
+	 * The main thread keeps a hidden context sharing objects with the window's, so textures, buffers and shaders
+	 * can still be created from it.  Framebuffers and vertex arrays aren't shared between contexts and must be
+	 * created by commands run on the render thread.  Each frame ends with a fence on the main thread's context that
+	 * the render thread waits on before replaying it, making every upload made while building the frame visible.
+	 */
+	class RenderThread
+	{
+	public:
+		RenderThread(Window& window);
+		~RenderThread();
+
+		// Hands the window's context to the render thread.  Called from the main thread with the context current.
+		void Start();
+		// Renders whatever was submitted, joins the thread and makes the window's context current again.
+		void Stop();
+
+		void BeginFrame();
+		void EndFrame();
+
+		// The packet of the frame being built.  It is only rendered by commands enqueued for the same frame.
+		FramePacket& GetFramePacket();
+		// Runs on the render thread, in submission order, after the frame's fence and before its UI.
+		void Enqueue(const RenderThreadCommandFn& commandFn);
+		void SubmitUI(const ImDrawData* drawData);
+
+		uint64_t GetFrameIndex() const { return m_FrameIndex; }
+
+	private:
+		struct Frame;
+
+		void RenderLoop();
+		void RenderFrame(Frame& frame);
+
+	private:
+		static constexpr uint32_t FrameCount = 2;
+		static constexpr uint32_t NoFrame = UINT32_MAX;
+
+		Window& m_Window;
+		GLFWwindow* m_SharedContext = nullptr;
+		std::thread m_Thread;
+
+		Scope<Frame> m_Frames[FrameCount];
+		uint32_t m_BuildFrame = 0;
+		uint64_t m_FrameIndex = 0;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_Condition;
+		// Guarded by m_Mutex.
+		uint32_t m_PendingFrame = NoFrame;
+		uint32_t m_RenderingFrame = NoFrame;
+		bool m_StopRequested = false;
+		bool m_Running = false;
+	};
+}
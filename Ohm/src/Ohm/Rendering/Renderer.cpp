@@ -4,6 +4,11 @@
 #include "Ohm/Rendering/RenderCommand.h"
 #include "Ohm/Rendering/Texture2D.h"
 #include "Ohm/Rendering/UniformBuffer.h"
+#include "Ohm/Rendering/StorageBuffer.h"
+#include "Ohm/Rendering/MeshLibrary.h"
+#include "Ohm/Rendering/GeometryPool.h"
+#include "Ohm/Rendering/TextureUploader.h"
+#include "Ohm/Rendering/TextureStreamer.h"
 #include "Ohm/Core/Time.h"
 
 
@@ -11,9 +16,15 @@
 #include "Ohm/Core/Application.h"
 #include "Ohm/Scene/Entity.h"
 
+#include <glad/glad.h>
+#include <stb_image.h>
+
 namespace Ohm
 {
 	Renderer::Statistics Renderer::s_Stats;
+	Renderer::Statistics Renderer::s_LastFrameStats;
+	// Stats are gathered by whichever thread renders and read by the UI.
+	static std::mutex s_StatsMutex;
 
 	struct RenderData
 	{
@@ -41,30 +52,37 @@ namespace Ohm
 			float ShadowAmount {1.0f};
 		};
 
-		struct EntityData
+		struct InstanceData
 		{
 			glm::mat4 ModelMatrix;
 		};
+
+		// Enough room for a few thousand instances before the buffer has to grow.
+		static constexpr uint32_t InitialInstanceCapacity = 4096;
 		
 		Ref<UniformBuffer> CameraBuffer;
 		Ref<UniformBuffer> GlobalBuffer;
 		Ref<UniformBuffer> SceneBuffer;
-		Ref<UniformBuffer> EntityBuffer;
+		Ref<StorageBuffer> InstanceBuffer;
 
 		std::unordered_map<std::string, uint32_t> s_UniformBufferBindingMap =
 		{
 			{TypeName<GlobalData>(),				0},
 			{TypeName<CameraData>(),				1},
 			{TypeName<SceneData>(),				2},
-			{TypeName<EntityData>(),				3},
+		};
+
+		std::unordered_map<std::string, uint32_t> s_StorageBufferBindingMap =
+		{
+			{TypeName<InstanceData>(),				0},
 		};
 	};
 
 	static RenderData* s_RenderData = nullptr;
 
-	void Renderer::UploadGlobalData()
+	void Renderer::UploadGlobalData(float elapsedTime, float deltaTime)
 	{
-		const float GlobalTimeValues[2] = { Time::Elapsed(), Time::DeltaTime() };
+		const float GlobalTimeValues[2] = { elapsedTime, deltaTime };
 		s_RenderData->GlobalBuffer->SetData(GlobalTimeValues, sizeof(RenderData::GlobalData));
 	}
 
@@ -84,35 +102,42 @@ namespace Ohm
 		s_RenderData->CameraBuffer->SetData(&CameraData, sizeof(RenderData::CameraData));
 	}
 
-	void Renderer::UploadSceneData(const Ref<Scene>& Scene)
+	void Renderer::UploadSceneData(const DirectionalLightData& directionalLight)
 	{
-		Entity dirLightEntity = Scene->GetDirectionalLight();
-		const DirectionalLightComponent& dirLight = dirLightEntity.GetComponent<DirectionalLightComponent>();
-
 		const RenderData::SceneData sceneData
 		{
-			dirLight.Radiance,
-			dirLight.Intensity,
-			dirLight.LightDirection,
-			dirLight.ShadowAmount,
+			directionalLight.Radiance,
+			directionalLight.Intensity,
+			directionalLight.Direction,
+			directionalLight.ShadowAmount,
 		};
 
 		s_RenderData->SceneBuffer->SetData(&sceneData, sizeof(RenderData::SceneData));
 	}
 
-	void Renderer::UploadPerEntityData(const TransformComponent& transform)
+	void Renderer::UploadInstanceData(const std::vector<glm::mat4>& modelMatrices)
 	{
-		const RenderData::EntityData data
-		{
-			transform.Transform()
-		};
-		s_RenderData->EntityBuffer->SetData(&data, sizeof(RenderData::EntityData));
+		if (modelMatrices.empty()) return;
+		s_RenderData->InstanceBuffer->SetData(modelMatrices.data(), (uint32_t)(modelMatrices.size() * sizeof(RenderData::InstanceData)));
+	}
+
+	void Renderer::ReserveInstanceData(uint32_t instanceCount)
+	{
+		const Ref<StorageBuffer>& InstanceBuffer = s_RenderData->InstanceBuffer;
+		const uint32_t Size = instanceCount * sizeof(RenderData::InstanceData);
+		if (InstanceBuffer->GetSize() < Size)
+			InstanceBuffer->Resize(Size);
+		RenderCommand::BindBufferBase(GL_SHADER_STORAGE_BUFFER, InstanceBuffer->GetBinding(), InstanceBuffer->GetID());
 	}
 
 	void Renderer::Initialize()
 	{
 		s_RenderData = new RenderData();
 
+		// The vendored stb_image keeps this in a plain global, and texture files are decoded on the job system as well
+		// as here.  Set it once, before the first decode, rather than racing a write in with every load.
+		stbi_set_flip_vertically_on_load(1);
+
 		uint32_t globalSlot = s_RenderData->s_UniformBufferBindingMap[TypeName<RenderData::GlobalData>()];
 		s_RenderData->GlobalBuffer = CreateRef<UniformBuffer>(sizeof(RenderData::GlobalData), globalSlot);
 		
@@ -122,29 +147,31 @@ namespace Ohm
 		uint32_t sceneSlot = s_RenderData->s_UniformBufferBindingMap[TypeName<RenderData::SceneData>()];
 		s_RenderData->SceneBuffer = CreateRef<UniformBuffer>(sizeof(RenderData::SceneData), sceneSlot);
 
-		uint32_t entitySlot = s_RenderData->s_UniformBufferBindingMap[TypeName<RenderData::EntityData>()];
-		s_RenderData->EntityBuffer = CreateRef<UniformBuffer>(sizeof(RenderData::EntityData), entitySlot);
+		uint32_t instanceSlot = s_RenderData->s_StorageBufferBindingMap[TypeName<RenderData::InstanceData>()];
+		s_RenderData->InstanceBuffer = CreateRef<StorageBuffer>(sizeof(RenderData::InstanceData) * RenderData::InitialInstanceCapacity, instanceSlot);
 
-		s_RenderData->Primitives[Primitive::Cube] = MeshFactory::Create(Primitive::Cube);
-		s_RenderData->Primitives[Primitive::Quad] = MeshFactory::Create(Primitive::Quad);
-		s_RenderData->Primitives[Primitive::FullScreenQuad] = MeshFactory::Create(Primitive::FullScreenQuad);
-		s_RenderData->Primitives[Primitive::Sphere] = MeshFactory::Create(Primitive::Sphere);
-		s_RenderData->Primitives[Primitive::Plane] = MeshFactory::Create(Primitive::Plane);
-		s_RenderData->Primitives[Primitive::Triangle] = MeshFactory::Create(Primitive::Triangle);
-		s_RenderData->Primitives[Primitive::TessellatedQuad] = MeshFactory::Create(Primitive::TessellatedQuad);
-		s_RenderData->Primitives[Primitive::Skybox] = MeshFactory::Create(Primitive::Skybox);
-		s_RenderData->Primitives[Primitive::Icosphere] = MeshFactory::Create(Primitive::Icosphere);
+		s_RenderData->Primitives[Primitive::Cube] = MeshLibrary::GetPrimitive(Primitive::Cube);
+		s_RenderData->Primitives[Primitive::Quad] = MeshLibrary::GetPrimitive(Primitive::Quad);
+		s_RenderData->Primitives[Primitive::FullScreenQuad] = MeshLibrary::GetPrimitive(Primitive::FullScreenQuad);
+		s_RenderData->Primitives[Primitive::Sphere] = MeshLibrary::GetPrimitive(Primitive::Sphere);
+		s_RenderData->Primitives[Primitive::Plane] = MeshLibrary::GetPrimitive(Primitive::Plane);
+		s_RenderData->Primitives[Primitive::Triangle] = MeshLibrary::GetPrimitive(Primitive::Triangle);
+		s_RenderData->Primitives[Primitive::TessellatedQuad] = MeshLibrary::GetPrimitive(Primitive::TessellatedQuad);
+		s_RenderData->Primitives[Primitive::Skybox] = MeshLibrary::GetPrimitive(Primitive::Skybox);
+		s_RenderData->Primitives[Primitive::Icosphere] = MeshLibrary::GetPrimitive(Primitive::Icosphere);
 
 		TextureLibrary::LoadWhiteTexture();
 		TextureLibrary::LoadBlackTexture();
 		TextureLibrary::LoadBlackTextureCube();
 
-		TextureLibrary::LoadTexture2D( "assets/textures/BRDF_LUT.png");
-		TextureLibrary::LoadTexture2D("assets/textures/lava.jpg");
-		TextureLibrary::LoadTexture2D("assets/textures/uv.png");
-		TextureLibrary::LoadTexture2D("assets/textures/space.jpg");
-		TextureLibrary::LoadTexture2D("assets/textures/map.jpg");
-		TextureLibrary::LoadTexture2D("assets/textures/ground-blue.jpg");
+		// Decoded on the job system while startup carries on; they sample as the White Texture until resident.  The
+		// lookup table needs its precision and stays uncompressed.
+		TextureLibrary::LoadTexture2DAsync("assets/textures/BRDF_LUT.png");
+		TextureLibrary::LoadTexture2DStreamed("assets/textures/lava.jpg", TextureUsage::Albedo);
+		TextureLibrary::LoadTexture2DStreamed("assets/textures/uv.png", TextureUsage::Albedo);
+		TextureLibrary::LoadTexture2DStreamed("assets/textures/space.jpg", TextureUsage::Albedo);
+		TextureLibrary::LoadTexture2DStreamed("assets/textures/map.jpg", TextureUsage::Albedo);
+		TextureLibrary::LoadTexture2DStreamed("assets/textures/ground-blue.jpg", TextureUsage::Albedo);
 
 		ShaderLibrary::Load("assets/shaders/Phong.shader");
 		ShaderLibrary::Load("assets/shaders/ShadowMap.shader");
@@ -162,15 +189,24 @@ namespace Ohm
 		ShaderLibrary::Load("assets/shaders/VertexDeformation.shader");
 		ShaderLibrary::Load("assets/shaders/SceneComposite.shader");
 		ShaderLibrary::Load("assets/shaders/Bloom.shader");
+		ShaderLibrary::Load("assets/shaders/VertexFormatBenchmark.shader");
+		ShaderLibrary::Load("assets/shaders/GPUCulling.shader");
+		ShaderLibrary::Load("assets/shaders/MeshletCulling.shader");
 	}
 
-	void Renderer::BeginScene(const Ref<Scene>& scene, const EditorCamera& camera)
+	void Renderer::BeginScene(const FramePacket& packet)
 	{
 		s_Stats.Clear();
+		// Editor UI and anything else outside RenderCommand may have touched GL since the last frame.
+		RenderCommand::InvalidateStateCache();
+		RenderCommand::ResetStateStatistics();
+
+		// Culling ran when the packet was built.
+		RecordCullingResults(packet.ObjectsTotal, packet.ObjectsVisible);
 
-		UploadGlobalData();
-		UploadCameraData(camera);
-		UploadSceneData(scene);
+		UploadGlobalData(packet.ElapsedTime, packet.DeltaTime);
+		UploadCameraData(packet.Camera);
+		UploadSceneData(packet.DirectionalLight);
 	}
 
 	void Renderer::BeginPass(const Ref<RenderPass>& renderPass)
@@ -188,50 +224,120 @@ namespace Ohm
 		RenderCommand::Clear(specification.ClearColorFlag, specification.ClearDepthFlag);
 	}
 
+	// Meshes of the same vertex format share one vertex array, so this only changes bindings when the format does.
+	static void DrawMeshLOD(const Mesh& mesh, uint32_t lod, uint32_t instanceCount = 1, uint32_t baseInstance = 0)
+	{
+		const MeshLOD& LOD = mesh.GetLOD(lod);
+		const GeometryAllocation& Geometry = mesh.GetGeometry();
+		mesh.Bind();
+		RenderCommand::DrawIndexedBaseVertex(LOD.IndexCount, Geometry.FirstIndex + LOD.IndexOffset, Geometry.BaseVertex, instanceCount, baseInstance);
+	}
+
 	void Renderer::DrawPrimitive(const PrimitiveRendererComponent& primitive)
 	{
 		const auto& primitiveMesh = s_RenderData->Primitives[primitive.PrimitiveType];
-		primitiveMesh->Bind();
-		primitive.MaterialInstance->UploadStagedUniforms();
-		RenderCommand::DrawIndexed(primitiveMesh->GetVAO());
-		primitiveMesh->Unbind();
-		s_Stats.TriangleCount += primitiveMesh->GetIndices().size() / 3;
-		s_Stats.VertexCount += primitiveMesh->GetVertices().size();
+		s_Stats.MaterialBytesUploaded += primitive.MaterialInstance->UploadStagedUniforms();
+		DrawMeshLOD(*primitiveMesh, 0);
+		s_Stats.DrawCalls++;
+		s_Stats.TriangleCount += primitiveMesh->GetTriangleCount();
+		s_Stats.TrianglesPerLOD[0] += primitiveMesh->GetTriangleCount();
+		s_Stats.VertexCount += primitiveMesh->GetVertexCount();
 	}
 
 	void Renderer::DrawPrimitive(const PrimitiveRendererComponent& primitive, const Ref<Material>& material)
 	{
 		const auto& primitiveMesh = s_RenderData->Primitives[primitive.PrimitiveType];
-		primitiveMesh->Bind();
-		material->UploadStagedUniforms();
-		RenderCommand::DrawIndexed(primitiveMesh->GetVAO());
-		primitiveMesh->Unbind();
-		s_Stats.TriangleCount += primitiveMesh->GetIndices().size() / 3;
-		s_Stats.VertexCount += primitiveMesh->GetVertices().size();
+		s_Stats.MaterialBytesUploaded += material->UploadStagedUniforms();
+		DrawMeshLOD(*primitiveMesh, 0);
+		s_Stats.DrawCalls++;
+		s_Stats.TriangleCount += primitiveMesh->GetTriangleCount();
+		s_Stats.TrianglesPerLOD[0] += primitiveMesh->GetTriangleCount();
+		s_Stats.VertexCount += primitiveMesh->GetVertexCount();
+	}
+
+	void Renderer::DrawMeshInstanced(const Mesh& mesh, const Ref<Material>& material, uint32_t instanceCount, uint32_t baseInstance, uint32_t lod)
+	{
+		const MeshLOD& LOD = mesh.GetLOD(lod);
+		s_Stats.MaterialBytesUploaded += material->UploadStagedUniforms();
+		DrawMeshLOD(mesh, lod, instanceCount, baseInstance);
+		s_Stats.DrawCalls++;
+		s_Stats.InstanceCount += instanceCount;
+		s_Stats.DrawCallsSaved += instanceCount - 1;
+		s_Stats.TriangleCount += LOD.IndexCount / 3 * instanceCount;
+		s_Stats.TrianglesPerLOD[lod] += LOD.IndexCount / 3 * instanceCount;
+		s_Stats.VertexCount += mesh.GetVertexCount() * instanceCount;
 	}
 
 	void Renderer::DrawFullScreenQuad(const Ref<Material>& Material)
 	{
-		s_RenderData->Primitives[Primitive::FullScreenQuad]->Bind();
-		Material->UploadStagedUniforms();
-		RenderCommand::DrawIndexed(s_RenderData->Primitives[Primitive::FullScreenQuad]->GetVAO());
-		s_RenderData->Primitives[Primitive::FullScreenQuad]->Unbind();
-		s_Stats.TriangleCount += s_RenderData->Primitives[Primitive::FullScreenQuad]->GetIndices().size() / 3;
-		s_Stats.VertexCount += s_RenderData->Primitives[Primitive::FullScreenQuad]->GetVertices().size();
+		s_Stats.MaterialBytesUploaded += Material->UploadStagedUniforms();
+		DrawMeshLOD(*s_RenderData->Primitives[Primitive::FullScreenQuad], 0);
+		s_Stats.DrawCalls++;
+		s_Stats.TriangleCount += s_RenderData->Primitives[Primitive::FullScreenQuad]->GetTriangleCount();
+		s_Stats.TrianglesPerLOD[0] += s_RenderData->Primitives[Primitive::FullScreenQuad]->GetTriangleCount();
+		s_Stats.VertexCount += s_RenderData->Primitives[Primitive::FullScreenQuad]->GetVertexCount();
 	}
 
 	void Renderer::DrawSkybox(const Ref<Material>& SkyboxMaterial)
 	{
-		s_RenderData->Primitives[Primitive::Skybox]->Bind();
-		SkyboxMaterial->UploadStagedUniforms();
+		s_Stats.MaterialBytesUploaded += SkyboxMaterial->UploadStagedUniforms();
 
 		RenderCommand::SetDepthFlag(DepthFlag::LEqual);
-		RenderCommand::DrawIndexed(s_RenderData->Primitives[Primitive::Skybox]->GetVAO());
+		DrawMeshLOD(*s_RenderData->Primitives[Primitive::Skybox], 0);
 		RenderCommand::SetDepthFlag(DepthFlag::Less);
 
-		s_RenderData->Primitives[Primitive::Skybox]->Unbind();
-		s_Stats.TriangleCount += s_RenderData->Primitives[Primitive::Skybox]->GetIndices().size() / 3;
-		s_Stats.VertexCount += s_RenderData->Primitives[Primitive::Skybox]->GetVertices().size();
+		s_Stats.DrawCalls++;
+		s_Stats.TriangleCount += s_RenderData->Primitives[Primitive::Skybox]->GetTriangleCount();
+		s_Stats.TrianglesPerLOD[0] += s_RenderData->Primitives[Primitive::Skybox]->GetTriangleCount();
+		s_Stats.VertexCount += s_RenderData->Primitives[Primitive::Skybox]->GetVertexCount();
+	}
+
+	void Renderer::DrawIndirect(VertexFormat vertexFormat, const Ref<Material>& material, uint32_t commandBufferID, uint32_t firstCommand, uint32_t commandCount)
+	{
+		s_Stats.MaterialBytesUploaded += material->UploadStagedUniforms();
+		GeometryPool::Get(vertexFormat).Bind();
+		RenderCommand::MultiDrawIndexedIndirect(commandBufferID, firstCommand, commandCount);
+		s_Stats.DrawCalls++;
+	}
+
+	void Renderer::RecordIndirectDrawResults(uint32_t instanceCount, const uint32_t* trianglesPerLOD)
+	{
+		s_Stats.InstanceCount += instanceCount;
+		for (uint32_t i = 0; i < MaxMeshLODs; i++)
+		{
+			s_Stats.TriangleCount += trianglesPerLOD[i];
+			s_Stats.TrianglesPerLOD[i] += trianglesPerLOD[i];
+		}
+	}
+
+	void Renderer::RecordMeshletResults(uint32_t meshletsTotal, uint32_t meshletsVisible, uint32_t trianglesTotal, uint32_t trianglesVisible)
+	{
+		s_Stats.MeshletsTotal += meshletsTotal;
+		s_Stats.MeshletsVisible += meshletsVisible;
+		s_Stats.MeshletsCulled += meshletsTotal - meshletsVisible;
+		s_Stats.MeshletTrianglesCulled += trianglesTotal - trianglesVisible;
+		// Meshlets are always cut from LOD 0.
+		s_Stats.TriangleCount += trianglesVisible;
+		s_Stats.TrianglesPerLOD[0] += trianglesVisible;
+	}
+
+	Renderer::Statistics Renderer::GetStats()
+	{
+		std::lock_guard<std::mutex> Lock(s_StatsMutex);
+		return s_LastFrameStats;
+	}
+
+	const Ref<Mesh>& Renderer::GetPrimitiveMesh(Primitive primitiveType)
+	{
+		// Looked up from worker threads while recording, so this must never insert.
+		return s_RenderData->Primitives.at(primitiveType);
+	}
+
+	void Renderer::RecordCullingResults(uint32_t totalCount, uint32_t visibleCount)
+	{
+		s_Stats.ObjectsTotal += totalCount;
+		s_Stats.ObjectsVisible += visibleCount;
+		s_Stats.ObjectsCulled += totalCount - visibleCount;
 	}
 
 	void Renderer::EndPass(const Ref<RenderPass>& renderPass)
@@ -242,11 +348,18 @@ namespace Ohm
 
 	void Renderer::EndScene()
 	{
+		// The state cache is per thread, so its count has to be read by the thread that rendered.
+		s_Stats.StateChangesSkipped = RenderCommand::GetSkippedStateChanges();
 
+		std::lock_guard<std::mutex> Lock(s_StatsMutex);
+		s_LastFrameStats = s_Stats;
 	}
 
 	void Renderer::Shutdown()
 	{
 		delete s_RenderData;
+		GeometryPool::Shutdown();
+		TextureUploader::Shutdown();
+		TextureStreamer::Shutdown();
 	}
 }
@@ -4,6 +4,7 @@
 #include "Ohm/Rendering/EditorCamera.h"
 #include "Ohm/Rendering/RenderPass.h"
 #include "Ohm/Rendering/Mesh.h"
+#include "Ohm/Rendering/FramePacket.h"
 #include "Ohm/Scene/Scene.h"
 
 namespace Ohm
@@ -13,12 +14,14 @@ namespace Ohm
 	public:
 		static void Initialize();
 
-		static void UploadGlobalData();
+		static void UploadGlobalData(float elapsedTime, float deltaTime);
 		static void UploadCameraData(const EditorCamera& Camera);
-		static void UploadSceneData(const Ref<Scene>& Scene);
-		static void UploadPerEntityData(const TransformComponent& transform);
+		static void UploadSceneData(const DirectionalLightData& directionalLight);
+		static void UploadInstanceData(const std::vector<glm::mat4>& modelMatrices);
+		// Makes room for instances written on the GPU, without uploading anything.
+		static void ReserveInstanceData(uint32_t instanceCount);
 
-		static void BeginScene(const Ref<Scene>& scene, const EditorCamera& camera);
+		static void BeginScene(const FramePacket& packet);
 		static void EndScene();
 
 		static void BeginPass(const Ref<RenderPass>& renderPass);
@@ -26,8 +29,18 @@ namespace Ohm
 
 		static void DrawPrimitive(const PrimitiveRendererComponent& primitive);
 		static void DrawPrimitive(const PrimitiveRendererComponent& primitive, const Ref<Material>& material);
+		static void DrawMeshInstanced(const Mesh& mesh, const Ref<Material>& material, uint32_t instanceCount, uint32_t baseInstance, uint32_t lod = 0);
 		static void DrawFullScreenQuad(const Ref<Material>& material);
 		static void DrawSkybox(const Ref<Material>& skyboxMaterial);
+		// One multi-draw of DrawElementsIndirectCommands over the vertex format's GeometryPool.
+		static void DrawIndirect(VertexFormat vertexFormat, const Ref<Material>& material, uint32_t commandBufferID, uint32_t firstCommand, uint32_t commandCount);
+
+		static const Ref<Mesh>& GetPrimitiveMesh(Primitive primitiveType);
+		static void RecordCullingResults(uint32_t totalCount, uint32_t visibleCount);
+		// Instances and triangles of indirect draws, which only the GPU knows; see GPUDrivenQueue.
+		static void RecordIndirectDrawResults(uint32_t instanceCount, const uint32_t* trianglesPerLOD);
+		// Meshlets and their triangles considered and kept by meshlet culling; see MeshletQueue.
+		static void RecordMeshletResults(uint32_t meshletsTotal, uint32_t meshletsVisible, uint32_t trianglesTotal, uint32_t trianglesVisible);
 
 		static void Shutdown();
 		
@@ -35,17 +48,51 @@ namespace Ohm
 		{
 			uint64_t TriangleCount;
 			uint64_t VertexCount;
+			uint64_t DrawCalls;
+			uint64_t InstanceCount;
+			// Draw calls that would have been issued without instancing (InstanceCount - instanced DrawCalls).
+			uint64_t DrawCallsSaved;
+			// Bytes written to material parameter blocks this frame; zero when no material changed.
+			uint64_t MaterialBytesUploaded;
+			// Objects considered by, kept by and rejected by frustum culling.
+			uint64_t ObjectsTotal;
+			uint64_t ObjectsVisible;
+			uint64_t ObjectsCulled;
+			// Binds and state changes the GL state cache dropped because they matched the current state.
+			uint64_t StateChangesSkipped;
+			// Triangles drawn from each level of detail; LOD 0 includes everything drawn without LOD selection.
+			uint64_t TrianglesPerLOD[MaxMeshLODs];
+			// Meshlets considered by, kept by and rejected by meshlet culling, and the triangles of those rejected.
+			uint64_t MeshletsTotal;
+			uint64_t MeshletsVisible;
+			uint64_t MeshletsCulled;
+			uint64_t MeshletTrianglesCulled;
 
 			void Clear()
 			{
 				TriangleCount = 0;
 				VertexCount = 0;
+				DrawCalls = 0;
+				InstanceCount = 0;
+				DrawCallsSaved = 0;
+				MaterialBytesUploaded = 0;
+				ObjectsTotal = 0;
+				ObjectsVisible = 0;
+				ObjectsCulled = 0;
+				StateChangesSkipped = 0;
+				std::fill(std::begin(TrianglesPerLOD), std::end(TrianglesPerLOD), 0);
+				MeshletsTotal = 0;
+				MeshletsVisible = 0;
+				MeshletsCulled = 0;
+				MeshletTrianglesCulled = 0;
 			}
 		};
 
-		static Statistics GetStats() { return s_Stats; }
+		// Statistics of the last frame to finish rendering; safe to call from any thread.
+		static Statistics GetStats();
 
 	private:
 		static Statistics s_Stats;
+		static Statistics s_LastFrameStats;
 	};
 }
@@ -3,17 +3,24 @@
 #include "Ohm/Rendering/Renderer.h"
 #include "Ohm/Rendering/Framebuffer.h"
 #include "Ohm/Core/Application.h"
+#include "Ohm/Rendering/RenderThread.h"
 #include "Ohm/Rendering/Shader.h"
 #include "Ohm/Rendering/RenderCommand.h"
+#include "Ohm/Rendering/MeshBenchmark.h"
+#include "Ohm/Rendering/TextureBenchmark.h"
+#include "Ohm/Rendering/TextureStreamer.h"
 #include "Ohm/Scene/Component.h"
 #include "Ohm/UI/PropertyDrawer.h"
 
 #include <glm/glm.hpp>
 #include <imgui.h>
+#include <limits>
 
 #include "EnvironmentMapPipeline.h"
 #include "TextureLibrary.h"
 #include "Ohm/Core/UUID.h"
+#include "Ohm/Core/Time.h"
+#include "Ohm/Core/JobSystem.h"
 
 namespace Ohm
 {
@@ -24,14 +31,77 @@ namespace Ohm
 	Ref<RenderPass> SceneRenderer::s_GeometryPass = nullptr;
 	Ref<RenderPass> SceneRenderer::s_SkyboxGeometryPass = nullptr;
 	Ref<RenderPass> SceneRenderer::s_DebugDepthPass = nullptr;
-	Ref<RenderPass> SceneRenderer::s_EnvironmentPass = nullptr;
 	Ref<RenderPass> SceneRenderer::s_BloomPass = nullptr;
 	Ref<RenderPass> SceneRenderer::s_SceneCompositePass = nullptr;
 
-	Ref<SceneRenderer::SceneRenderProperties> SceneRenderer::s_SceneRenderProperties;
+	SceneRenderSettings SceneRenderer::s_RenderSettings;
+	FramePacket SceneRenderer::s_FramePacket;
 	Ref<SceneRenderer::BloomProperties> SceneRenderer::s_BloomProperties;
+	Ref<RenderQueue> SceneRenderer::s_GeometryQueue;
+	Ref<GPUDrivenQueue> SceneRenderer::s_GPUDrivenQueue;
+	Ref<MeshletQueue> SceneRenderer::s_MeshletQueue;
+	MeshletCuller SceneRenderer::s_MeshletCuller;
+	Ref<FrustumCuller> SceneRenderer::s_GeometryCuller;
+	Ref<RenderGraph> SceneRenderer::s_RenderGraph;
 
 	float SceneRenderer::s_ImageViewerSizeFactor = .58f;
+	SceneRenderer::RenderTargetBenchmark SceneRenderer::s_RenderTargetBenchmark;
+	SceneRenderer::FrameResults SceneRenderer::s_FrameResults;
+	SceneRenderer::GeometryRecording SceneRenderer::s_GeometryRecording;
+	int32_t SceneRenderer::s_PendingSaveImageIndex = -1;
+	std::string SceneRenderer::s_PendingSaveImagePath;
+
+	// Frame results are written by the thread that renders and read by the UI.
+	static std::mutex s_FrameResultsMutex;
+
+	// Resolved once the Renderer has loaded it; UploadPBRSamplers runs for every material drawn.
+	static Texture2DHandle s_BRDFLUT;
+	static const std::string RadianceCubeSamplerName = "sampler_RadianceCube";
+	static const std::string IrradianceCubeSamplerName = "sampler_IrradianceCube";
+	static const std::string BRDFLUTSamplerName = "sampler_BRDFLUT";
+
+	// The sampler uniforms of the last shader UploadPBRSamplers saw.  Batches are sorted by shader, so they're looked
+	// up by name about once per shader per frame rather than three times per material.  Only the thread that renders
+	// uses them; shaders stay in the ShaderLibrary for good, so the pointer can't be reused by another.
+	struct PBRSamplerUniforms
+	{
+		const Shader* Source = nullptr;
+		const ShaderUniform* Radiance = nullptr;
+		const ShaderUniform* Irradiance = nullptr;
+		const ShaderUniform* BRDFLUT = nullptr;
+	};
+	static PBRSamplerUniforms s_PBRSamplerUniforms;
+
+	struct RenderTargetFormats
+	{
+		FramebufferTextureFormat SceneColor;
+		FramebufferTextureFormat LinearDepth;
+		FramebufferTextureFormat Composite;
+		TextureUtils::ImageInternalFormat Bloom;
+		TextureUtils::ImageDataLayout BloomLayout;
+		TextureUtils::TextureShaderDataFormat BloomImage;
+	};
+
+	static RenderTargetFormats GetRenderTargetFormats(RenderTargetPrecision precision)
+	{
+		if (precision == RenderTargetPrecision::Full)
+		{
+			return
+			{
+				FramebufferTextureFormat::RGBA32F, FramebufferTextureFormat::RGBA32F, FramebufferTextureFormat::RGBA32F,
+				TextureUtils::ImageInternalFormat::RGBA32F, TextureUtils::ImageDataLayout::RGBA, TextureUtils::TextureShaderDataFormat::RGBA32F
+			};
+		}
+
+		// Scene color is HDR and gets blended into, so it keeps half floats and alpha.  Linear depth and bloom are
+		// positive and three channel at most, which R11G11B10F covers at a quarter of the size.  The composite is
+		// tone mapped and gamma corrected by the time it's written, so 8 bits per channel are all it can use.
+		return
+		{
+			FramebufferTextureFormat::RGBA16F, FramebufferTextureFormat::R11G11B10F, FramebufferTextureFormat::RGBA8,
+			TextureUtils::ImageInternalFormat::R11FG11FB10F, TextureUtils::ImageDataLayout::RGB, TextureUtils::TextureShaderDataFormat::R11FG11FB10F
+		};
+	}
 	glm::vec2 SceneRenderer::s_ViewportSize;
 
 	void SceneRenderer::LoadScene(const Ref<Scene>& runtimeScene)
@@ -51,20 +121,19 @@ namespace Ohm
 
 	void SceneRenderer::InitializeGeometryPass()
 	{
-		FramebufferSpecification GeometryFBOSpec =
-		{
-			Application::GetApplication().GetWindow().GetWidth(), Application::GetApplication().GetWindow().GetHeight(),
-			{ FramebufferTextureFormat::Depth, FramebufferTextureFormat::RGBA32F }
-		};
+		s_GeometryQueue = CreateRef<RenderQueue>();
+		s_GPUDrivenQueue = CreateRef<GPUDrivenQueue>();
+		s_MeshletQueue = CreateRef<MeshletQueue>();
+		s_GeometryCuller = CreateRef<FrustumCuller>();
+		s_BRDFLUT = TextureLibrary::GetHandle2D("BRDF_LUT.png");
 
+		// The target framebuffer is a render graph resource, assigned each frame in SubmitPipeline.
 		RenderPassSpecification GeometryRenderPassSpec;
 		GeometryRenderPassSpec.Flags |= static_cast<uint32_t>(RenderFlag::DepthTest) | static_cast<uint32_t>(RenderFlag::Blend);
-		GeometryRenderPassSpec.TargetFramebuffer = CreateRef<Framebuffer>(GeometryFBOSpec);
 		s_GeometryPass = CreateRef<RenderPass>(GeometryRenderPassSpec);
 
 		RenderPassSpecification SkyboxGeometryRenderPassSpec;
 		SkyboxGeometryRenderPassSpec.Flags |= static_cast<uint32_t>(RenderFlag::DepthTest) | static_cast<uint32_t>(RenderFlag::Blend);
-		SkyboxGeometryRenderPassSpec.TargetFramebuffer = GeometryRenderPassSpec.TargetFramebuffer;
 		SkyboxGeometryRenderPassSpec.ClearColorFlag = SkyboxGeometryRenderPassSpec.ClearDepthFlag = false;
 		SkyboxGeometryRenderPassSpec.PassMaterial = CreateRef<Material>("Skybox Materials", ShaderLibrary::Get("Skybox"));
 		s_SkyboxGeometryPass = CreateRef<RenderPass>(SkyboxGeometryRenderPassSpec);
@@ -72,13 +141,7 @@ namespace Ohm
 
 	void SceneRenderer::InitializeDebugDepthPass()
 	{
-		FramebufferSpecification DebugDepthFBOSpec;
-		DebugDepthFBOSpec.AttachmentSpecification = { FramebufferTextureFormat::RGBA32F };
-		constexpr uint32_t ShadowMapResolution = 4096;
-		DebugDepthFBOSpec.Width = DebugDepthFBOSpec.Height = ShadowMapResolution;
-
 		RenderPassSpecification DebugDepthRenderPassSpec;
-		DebugDepthRenderPassSpec.TargetFramebuffer = CreateRef<Framebuffer>(DebugDepthFBOSpec);
 		DebugDepthRenderPassSpec.PassMaterial = CreateRef<Material>("Debug Depth Material", ShaderLibrary::Get("LinearDepthVisualizer"));
 		
 		s_DebugDepthPass = CreateRef<RenderPass>(DebugDepthRenderPassSpec);
@@ -86,16 +149,6 @@ namespace Ohm
 
 	void SceneRenderer::InitializeEnvironmentPass()
 	{
-		FramebufferSpecification fboSpec;
-		fboSpec.AttachmentSpecification =
-		{
-			FramebufferTextureFormat::RGBA32F,
-			FramebufferTextureFormat::RGBA32F,
-			FramebufferTextureFormat::RGBA32F
-		};
-		fboSpec.Width = Application::GetApplication().GetWindow().GetWidth();
-		fboSpec.Height = Application::GetApplication().GetWindow().GetHeight();
-
 		Entity EnvironmentLightEntity = s_ActiveScene->GetEnvironmentLight();
 		EnvironmentLightComponent& EnvironmentLight = EnvironmentLightEntity.GetComponent<EnvironmentLightComponent>();
 		
@@ -119,19 +172,17 @@ namespace Ohm
 		}
 		else if(EnvironmentLight.Pipeline->GetSpecification().PipelineType == EnvironmentPipelineType::FromFile)
 			EnvironmentLight.Pipeline->BuildFromEquirectangularImage(EnvironmentLight.Pipeline->GetSpecification().FromFileFilePath);
-		
-		RenderPassSpecification EnvironmentPassSpec;
-		EnvironmentPassSpec.TargetFramebuffer = CreateRef<Framebuffer>(fboSpec);
-		EnvironmentPassSpec.PassMaterial = CreateRef<Material>("Skybox Material", ShaderLibrary::Get("Skybox"));
-		EnvironmentPassSpec.Flags |= static_cast<uint32_t>(RenderFlag::DepthTest) | static_cast<uint32_t>(RenderFlag::Blend);
-		
-		s_EnvironmentPass = CreateRef<RenderPass>(EnvironmentPassSpec);
 	}
 	
 	void SceneRenderer::InitializeBloomPass()
 	{
 		s_BloomProperties = CreateRef<BloomProperties>();
 		s_BloomProperties->BloomShader = ShaderLibrary::Get("Bloom");
+		s_BloomProperties->Uniforms.Params = s_BloomProperties->BloomShader->GetUniformHandle("u_Params");
+		s_BloomProperties->Uniforms.LOD = s_BloomProperties->BloomShader->GetUniformHandle("u_LOD");
+		s_BloomProperties->Uniforms.Mode = s_BloomProperties->BloomShader->GetUniformHandle("u_Mode");
+		s_BloomProperties->Uniforms.Texture = s_BloomProperties->BloomShader->GetUniformHandle("u_Texture");
+		s_BloomProperties->Uniforms.BloomTexture = s_BloomProperties->BloomShader->GetUniformHandle("u_BloomTexture");
 		Texture2DSpecification FileTextureSpec =
 		{
 			TextureUtils::WrapMode::Repeat,
@@ -146,15 +197,10 @@ namespace Ohm
 		FileTextureSpec.Name = "Bloom Dirt Mask";
 		const std::string DirtMaskPath = "assets/textures/dirt-mask.png";
 
-		s_BloomProperties->BloomDirtTexture = TextureLibrary::LoadTexture2D(FileTextureSpec, DirtMaskPath);
+		s_BloomProperties->BloomDirtTexture = TextureLibrary::LoadTexture2DAsync(FileTextureSpec, DirtMaskPath);
 
-		const glm::vec2 WindowDimensions = { Application::GetApplication().GetWindow().GetWidth(), Application::GetApplication().GetWindow().GetHeight() };
-		uint32_t HalfWidth = WindowDimensions.x / 2;
-		uint32_t HalfHeight = WindowDimensions.y / 2;
-		HalfWidth += (s_BloomProperties->BloomWorkGroupSize - (HalfWidth % s_BloomProperties->BloomWorkGroupSize));
-		HalfHeight += (s_BloomProperties->BloomWorkGroupSize - (HalfHeight % s_BloomProperties->BloomWorkGroupSize));
-
-		Texture2DSpecification BloomTextureSpecification =
+		// Sized to half the viewport each frame; the textures themselves are render graph resources.
+		s_BloomProperties->BloomTextureSpecification =
 		{
 			TextureUtils::WrapMode::ClampToEdge,
 			TextureUtils::WrapMode::ClampToEdge,
@@ -163,25 +209,16 @@ namespace Ohm
 			TextureUtils::ImageInternalFormat::RGBA32F,
 			TextureUtils::ImageDataLayout::RGBA,
 			TextureUtils::ImageDataType::Float,
-			HalfWidth, HalfHeight
+			0, 0
 		};
-
 		s_BloomProperties->BloomComputeTextures.resize(3);
-		BloomTextureSpecification.Name = "Bloom 1";
-		s_BloomProperties->BloomComputeTextures[0] = CreateRef<Texture2D>(BloomTextureSpecification);
-		BloomTextureSpecification.Name = "Bloom 2";
-		s_BloomProperties->BloomComputeTextures[1] = CreateRef<Texture2D>(BloomTextureSpecification);
-		BloomTextureSpecification.Name = "Bloom 3";
-		s_BloomProperties->BloomComputeTextures[2] = CreateRef<Texture2D>(BloomTextureSpecification);
 	}
 	
 	void SceneRenderer::InitializeSceneCompositePass()
 	{
-		s_SceneRenderProperties = CreateRef<SceneRenderProperties>();
-		
 		FramebufferSpecification CompositeFBOSpec;
 		const auto& Window = Application::GetApplication().GetWindow();
-		CompositeFBOSpec.AttachmentSpecification = { FramebufferTextureFormat::RGBA32F };
+		CompositeFBOSpec.AttachmentSpecification = { GetRenderTargetFormats(s_RenderSettings.TargetPrecision).Composite };
 		CompositeFBOSpec.Width = Window.GetWidth();
 		CompositeFBOSpec.Height = Window.GetHeight();
 
@@ -193,48 +230,66 @@ namespace Ohm
 		s_SceneCompositePass = CreateRef<RenderPass>(CompositeRenderPassSpec);
 	}
 
-	void SceneRenderer::UploadPBRSamplers(const Ref<Material>& material)
+	void SceneRenderer::UploadPBRSamplers(const Ref<Material>& material, const EnvironmentLightData& environmentLight)
 	{
-		Entity envLightEntity = s_ActiveScene->GetEnvironmentLight();
-		const EnvironmentLightComponent& envLight = envLightEntity.GetComponent<EnvironmentLightComponent>();
-
-		const uint32_t FilteredRadianceRendererID = TextureLibrary::GetCube(envLight.Pipeline->GetSpecification().GetFilteredCubeName())->GetID();
-		const uint32_t IrradianceRendererID = TextureLibrary::GetCube(envLight.Pipeline->GetSpecification().GetIrradianceCubeName())->GetID();
-		const uint32_t brdfLutId = TextureLibrary::Get2D("BRDF_LUT.png")->GetID();
+		const uint32_t FilteredRadianceRendererID = environmentLight.Pipeline->GetFilteredRadianceCube()->GetID();
+		const uint32_t IrradianceRendererID = environmentLight.Pipeline->GetIrradianceCube()->GetID();
+		const uint32_t brdfLutId = TextureLibrary::Get2D(s_BRDFLUT)->GetID();
 		
 		const TextureUniform radiance { FilteredRadianceRendererID, 5, 1 };
 		const TextureUniform irradiance { IrradianceRendererID, 6, 1 };
 		const TextureUniform brdf { brdfLutId, 7, 1 };
-		material->Set<TextureUniform>("sampler_RadianceCube", radiance);
-		material->Set<TextureUniform>("sampler_IrradianceCube", irradiance);
-		material->Set<TextureUniform>("sampler_BRDFLUT", brdf);
+
+		PBRSamplerUniforms& Uniforms = s_PBRSamplerUniforms;
+		if (Uniforms.Source != material->GetShader().get())
+		{
+			Uniforms.Source = material->GetShader().get();
+			Uniforms.Radiance = material->FindBaseBlockShaderUniform(RadianceCubeSamplerName);
+			Uniforms.Irradiance = material->FindBaseBlockShaderUniform(IrradianceCubeSamplerName);
+			Uniforms.BRDFLUT = material->FindBaseBlockShaderUniform(BRDFLUTSamplerName);
+		}
+
+		if (Uniforms.Radiance)
+			material->SetLocked<TextureUniform>(*Uniforms.Radiance, radiance);
+		if (Uniforms.Irradiance)
+			material->SetLocked<TextureUniform>(*Uniforms.Irradiance, irradiance);
+		if (Uniforms.BRDFLUT)
+			material->SetLocked<TextureUniform>(*Uniforms.BRDFLUT, brdf);
 	}
 	
-	void SceneRenderer::GeometryPass()
+	void SceneRenderer::GeometryPass(const FramePacket& packet)
 	{
 		Renderer::BeginPass(s_GeometryPass);
 
-		const auto primMeshView = s_ActiveScene->m_Registry.view<TransformComponent, PrimitiveRendererComponent>();
-		for (const auto Entity : primMeshView)
+		const EnvironmentLightData& EnvironmentLight = packet.EnvironmentLight;
+		const RenderQueuePreDrawFn PreDraw = [&EnvironmentLight](const Ref<Material>& material) { UploadPBRSamplers(material, EnvironmentLight); };
+
+		if (packet.Settings.GPUDriven)
 		{
-			auto [transform, primitive] = primMeshView.get<TransformComponent, PrimitiveRendererComponent>(Entity);
-			
-			if(primitive.PrimitiveType == Primitive::None) continue;
-			
-			UploadPBRSamplers(primitive.MaterialInstance);
-			Renderer::UploadPerEntityData(transform);
-			Renderer::DrawPrimitive(primitive);
+			// Culling and LOD selection happen here, on the GPU, for everything recorded in the packet.
+			const bool SelectLODs = packet.Settings.LODEnabled && packet.Camera.GetProjectionType() == ProjectionType::Perspective;
+			s_GPUDrivenQueue->Flush(packet.IndirectGeometry, packet.Camera, SelectLODs, packet.Settings.LODBias, PreDraw);
 		}
-		EnvironmentLightComponent& EnvironmentLight = s_ActiveScene->GetEnvironmentLight().GetComponent<EnvironmentLightComponent>();
-		const EnvironmentMapSpecification PipelineSpec = EnvironmentLight.Pipeline->GetSpecification();
-		const uint32_t FilteredRadianceMapID = TextureLibrary::GetCube(PipelineSpec.GetFilteredCubeName())->GetID();
-		const uint32_t UnfilteredRadianceMapID = TextureLibrary::GetCube(PipelineSpec.GetUnfilteredCubeName())->GetID();
-		const uint32_t IrradianceMapID = TextureLibrary::GetCube(PipelineSpec.GetIrradianceCubeName())->GetID();
+		else
+		{
+			// Culling and recording already happened when the packet was built; this only merges and sorts.
+			s_GeometryQueue->Begin(packet.Camera);
+			for (const RenderCommandBuffer& Commands : packet.GeometryCommands)
+				s_GeometryQueue->Submit(Commands);
+			s_GeometryQueue->Flush(PreDraw);
+
+			// Also runs with nothing recorded, so culling counts still on the GPU are collected.
+			s_MeshletQueue->Flush(packet.MeshletGeometry, packet.Settings.MeshletCulling == MeshletCullingMode::GPU, PreDraw);
+		}
+
+		const uint32_t FilteredRadianceMapID = EnvironmentLight.Pipeline->GetFilteredRadianceCube()->GetID();
+		const uint32_t UnfilteredRadianceMapID = EnvironmentLight.Pipeline->GetUnfilteredRadianceCube()->GetID();
+		const uint32_t IrradianceMapID = EnvironmentLight.Pipeline->GetIrradianceCube()->GetID();
 
-		const glm::mat4 ViewProjection = s_Camera.GetViewProjection();
+		const glm::mat4 ViewProjection = packet.Camera.GetViewProjection();
 
-		s_SkyboxGeometryPass->GetRenderPassSpecification().PassMaterial->Set<glm::vec3>("u_LODs", EnvironmentLight.EnvironmentMapSampleLODs);
-		s_SkyboxGeometryPass->GetRenderPassSpecification().PassMaterial->Set<glm::vec3>("u_Intensities", EnvironmentLight.EnvironmentMapSampleIntensities);
+		s_SkyboxGeometryPass->GetRenderPassSpecification().PassMaterial->Set<glm::vec3>("u_LODs", EnvironmentLight.SampleLODs);
+		s_SkyboxGeometryPass->GetRenderPassSpecification().PassMaterial->Set<glm::vec3>("u_Intensities", EnvironmentLight.SampleIntensities);
 		s_SkyboxGeometryPass->GetRenderPassSpecification().PassMaterial->Set<TextureUniform>("u_FilteredRadianceMap", {FilteredRadianceMapID, 0, 1});
 		s_SkyboxGeometryPass->GetRenderPassSpecification().PassMaterial->Set<TextureUniform>("u_UnfilteredRadianceMap", {UnfilteredRadianceMapID, 1, 1});
 		s_SkyboxGeometryPass->GetRenderPassSpecification().PassMaterial->Set<TextureUniform>("u_IrradianceMap", {IrradianceMapID, 2, 1});
@@ -244,12 +299,12 @@ namespace Ohm
 		Renderer::EndPass(s_SkyboxGeometryPass);
 	}
 
-	void SceneRenderer::DebugVisualizeDepthPass()
+	void SceneRenderer::DebugVisualizeDepthPass(const FramePacket& packet)
 	{
 		Renderer::BeginPass(s_DebugDepthPass);
 		s_DebugDepthPass->GetRenderPassSpecification().TargetFramebuffer->Bind();
-		s_DebugDepthPass->GetRenderPassSpecification().PassMaterial->Set<float>("u_Near", s_Camera.GetNearClip());
-		s_DebugDepthPass->GetRenderPassSpecification().PassMaterial->Set<float>("u_Far", s_Camera.GetFarClip());
+		s_DebugDepthPass->GetRenderPassSpecification().PassMaterial->Set<float>("u_Near", packet.Camera.GetNearClip());
+		s_DebugDepthPass->GetRenderPassSpecification().PassMaterial->Set<float>("u_Far", packet.Camera.GetFarClip());
 		const TextureUniform DepthTextureUniform { s_GeometryPass->GetRenderPassSpecification().TargetFramebuffer->GetDepthAttachmentID(), 0, 1 };
 		s_DebugDepthPass->GetRenderPassSpecification().PassMaterial->Set<TextureUniform>("sampler_SceneDepth", DepthTextureUniform);
 		Renderer::DrawFullScreenQuad(s_DebugDepthPass->GetRenderPassSpecification().PassMaterial);
@@ -257,37 +312,29 @@ namespace Ohm
 		Renderer::EndPass(s_DebugDepthPass);
 	}
 
-	void SceneRenderer::EnvironmentPass()
+	void SceneRenderer::EnvironmentPass(const FramePacket& packet)
 	{
-		EnvironmentLightComponent& EnvironmentLight = s_ActiveScene->GetEnvironmentLight().GetComponent<EnvironmentLightComponent>();
-		if(EnvironmentLight.NeedsUpdate)
-		{
-			if(EnvironmentLight.Pipeline->GetSpecification().PipelineType == EnvironmentPipelineType::FromShader)
-			{
-				EnvironmentLight.Pipeline->GetSpecification().PreDispatchFn =
-					[&EnvironmentLight](auto&& Unfiltered, auto&& Filtered)
-					{
-						const glm::vec3 TAI
-						{
-							EnvironmentLight.EnvironmentMapParams.Turbidity,
-							EnvironmentLight.EnvironmentMapParams.Azimuth,
-							EnvironmentLight.EnvironmentMapParams.Inclination
-						};
-						ShaderLibrary::Get("Preetham")->Bind();
-						ShaderLibrary::Get("Preetham")->UploadUniformFloat3("u_TAI", TAI);
-					};
-				EnvironmentLight.Pipeline->GetSpecification().EnvironmentMapResolution = 1024;
-				EnvironmentLight.Pipeline->GetSpecification().EnvironmentMapName = "Preetham Sky Model";
-				EnvironmentLight.Pipeline->BuildFromShader("Preetham");
-			}
-			else if(EnvironmentLight.Pipeline->GetSpecification().PipelineType == EnvironmentPipelineType::FromFile)
-				EnvironmentLight.Pipeline->BuildFromEquirectangularImage(EnvironmentLight.Pipeline->GetSpecification().FromFileFilePath);
+		const EnvironmentLightData& EnvironmentLight = packet.EnvironmentLight;
+		if(!EnvironmentLight.NeedsUpdate) return;
 
-			EnvironmentLight.NeedsUpdate = false;
+		if(EnvironmentLight.PipelineType == EnvironmentPipelineType::FromShader)
+		{
+			// Captured by value: the packet is only guaranteed to live until this frame has rendered.
+			EnvironmentLight.Pipeline->GetSpecification().PreDispatchFn =
+				[TAI = EnvironmentLight.TAI](auto&& Unfiltered, auto&& Filtered)
+				{
+					ShaderLibrary::Get("Preetham")->Bind();
+					ShaderLibrary::Get("Preetham")->UploadUniformFloat3("u_TAI", TAI);
+				};
+			EnvironmentLight.Pipeline->GetSpecification().EnvironmentMapResolution = 1024;
+			EnvironmentLight.Pipeline->GetSpecification().EnvironmentMapName = "Preetham Sky Model";
+			EnvironmentLight.Pipeline->BuildFromShader("Preetham");
 		}
+		else if(EnvironmentLight.PipelineType == EnvironmentPipelineType::FromFile)
+			EnvironmentLight.Pipeline->BuildFromEquirectangularImage(EnvironmentLight.FromFileFilePath);
 	}
 	
-	void SceneRenderer::BloomPass()
+	void SceneRenderer::BloomDownsamplePass(const FramePacket& packet)
 	{
 		s_BloomProperties->BloomShader->Bind();
 
@@ -298,7 +345,8 @@ namespace Ohm
 			int Mode = 0;
 		} bloomConstants;
 
-		bloomConstants.Params = { s_BloomProperties->BloomThreshold, s_BloomProperties->BloomThreshold - s_BloomProperties->BloomKnee, s_BloomProperties->BloomKnee * 2.0f, 0.25f / s_BloomProperties->BloomKnee };
+		const SceneRenderSettings& Settings = packet.Settings;
+		bloomConstants.Params = { Settings.BloomThreshold, Settings.BloomThreshold - Settings.BloomKnee, Settings.BloomKnee * 2.0f, 0.25f / Settings.BloomKnee };
 
 		//------------------ PREFILTER -----------------//
 		uint32_t workGroupsX = s_BloomProperties->BloomComputeTextures[0]->GetWidth() / s_BloomProperties->BloomWorkGroupSize;
@@ -306,12 +354,12 @@ namespace Ohm
 
 		{
 			bloomConstants.Mode = 0;
-			s_BloomProperties->BloomShader->UploadUniformFloat4("u_Params", bloomConstants.Params);
-			s_BloomProperties->BloomShader->UploadUniformFloat("u_LOD", bloomConstants.LOD);
-			s_BloomProperties->BloomShader->UploadUniformInt("u_Mode", bloomConstants.Mode);
+			s_BloomProperties->BloomShader->UploadUniformFloat4(s_BloomProperties->Uniforms.Params, bloomConstants.Params);
+			s_BloomProperties->BloomShader->UploadUniformFloat(s_BloomProperties->Uniforms.LOD, bloomConstants.LOD);
+			s_BloomProperties->BloomShader->UploadUniformInt(s_BloomProperties->Uniforms.Mode, bloomConstants.Mode);
 			s_GeometryPass->GetRenderPassSpecification().TargetFramebuffer->BindColorAttachment(0, 0);
-			s_BloomProperties->BloomShader->UploadUniformInt("u_Texture", 0);
-			s_BloomProperties->BloomComputeTextures[0]->BindToImageSlot(0, 0, TextureUtils::TextureAccessLevel::WriteOnly, TextureUtils::TextureShaderDataFormat::RGBA32F);
+			s_BloomProperties->BloomShader->UploadUniformInt(s_BloomProperties->Uniforms.Texture, 0);
+			s_BloomProperties->BloomComputeTextures[0]->BindToImageSlot(0, 0, TextureUtils::TextureAccessLevel::WriteOnly, s_BloomProperties->BloomImageFormat);
 
 			s_BloomProperties->BloomShader->DispatchCompute(workGroupsX, workGroupsY, 1);
 			s_BloomProperties->BloomShader->EnableShaderImageAccessBarrierBit();
@@ -334,12 +382,12 @@ namespace Ohm
 
 				bloomConstants.LOD = mip - 1.0f;
 				// Write to 1
-				s_BloomProperties->BloomComputeTextures[1]->BindToImageSlot(0, mip, TextureUtils::TextureAccessLevel::WriteOnly, TextureUtils::TextureShaderDataFormat::RGBA32F);
+				s_BloomProperties->BloomComputeTextures[1]->BindToImageSlot(0, mip, TextureUtils::TextureAccessLevel::WriteOnly, s_BloomProperties->BloomImageFormat);
 				// Read from 0 (starts pre-filtered)
 				s_BloomProperties->BloomComputeTextures[0]->BindToSamplerSlot(0);
-				s_BloomProperties->BloomShader->UploadUniformInt("u_Texture", 0);
-				s_BloomProperties->BloomShader->UploadUniformInt("u_Mode", bloomConstants.Mode);
-				s_BloomProperties->BloomShader->UploadUniformFloat("u_LOD", bloomConstants.LOD);
+				s_BloomProperties->BloomShader->UploadUniformInt(s_BloomProperties->Uniforms.Texture, 0);
+				s_BloomProperties->BloomShader->UploadUniformInt(s_BloomProperties->Uniforms.Mode, bloomConstants.Mode);
+				s_BloomProperties->BloomShader->UploadUniformFloat(s_BloomProperties->Uniforms.LOD, bloomConstants.LOD);
 				s_BloomProperties->BloomShader->DispatchCompute(workGroupsX, workGroupsY, 1);
 				s_BloomProperties->BloomShader->EnableShaderImageAccessBarrierBit();
 			}
@@ -347,31 +395,50 @@ namespace Ohm
 			{
 				bloomConstants.LOD = mip;
 				// Write to 0
-				s_BloomProperties->BloomComputeTextures[0]->BindToImageSlot(0, mip, TextureUtils::TextureAccessLevel::WriteOnly, TextureUtils::TextureShaderDataFormat::RGBA32F);
+				s_BloomProperties->BloomComputeTextures[0]->BindToImageSlot(0, mip, TextureUtils::TextureAccessLevel::WriteOnly, s_BloomProperties->BloomImageFormat);
 				// Read from 1
 				s_BloomProperties->BloomComputeTextures[1]->BindToSamplerSlot(0);
 
-				s_BloomProperties->BloomShader->UploadUniformInt("u_Texture", 0);
-				s_BloomProperties->BloomShader->UploadUniformInt("u_Mode", bloomConstants.Mode);
-				s_BloomProperties->BloomShader->UploadUniformFloat("u_LOD", bloomConstants.LOD);
+				s_BloomProperties->BloomShader->UploadUniformInt(s_BloomProperties->Uniforms.Texture, 0);
+				s_BloomProperties->BloomShader->UploadUniformInt(s_BloomProperties->Uniforms.Mode, bloomConstants.Mode);
+				s_BloomProperties->BloomShader->UploadUniformFloat(s_BloomProperties->Uniforms.LOD, bloomConstants.LOD);
 				s_BloomProperties->BloomShader->DispatchCompute(workGroupsX, workGroupsY, 1);
 				s_BloomProperties->BloomShader->EnableShaderImageAccessBarrierBit();
 			}
 		}
 		//------------------ DOWNSAMPLE -----------------//
 
+		Texture2D::ClearBinding();
+		s_BloomProperties->BloomShader->Unbind();
+	}
+
+	void SceneRenderer::BloomUpsamplePass()
+	{
+		s_BloomProperties->BloomShader->Bind();
+
+		struct BloomConstants
+		{
+			float LOD = 0.0f;
+			int Mode = 0;
+		} bloomConstants;
+
+		// Same mip count the down-sample chain stopped at.
+		const uint32_t mips = s_BloomProperties->BloomComputeTextures[0]->GetMipLevelCount() - 2;
+		uint32_t workGroupsX = 0;
+		uint32_t workGroupsY = 0;
+
 		//------------------ UPSAMPLE_FIRST -----------------//
 		{
 			bloomConstants.Mode = 2;
-			bloomConstants.LOD--;
+			bloomConstants.LOD = static_cast<float>(mips) - 2.0f;
 			// Write to 2 at smallest image in up-sampling mip chain
-			s_BloomProperties->BloomComputeTextures[2]->BindToImageSlot(0, mips - 2, TextureUtils::TextureAccessLevel::WriteOnly, TextureUtils::TextureShaderDataFormat::RGBA32F);
+			s_BloomProperties->BloomComputeTextures[2]->BindToImageSlot(0, mips - 2, TextureUtils::TextureAccessLevel::WriteOnly, s_BloomProperties->BloomImageFormat);
 			// Read from 0 (fully down-sampled)
 			s_BloomProperties->BloomComputeTextures[0]->BindToSamplerSlot(0);
 
-			s_BloomProperties->BloomShader->UploadUniformInt("u_Texture", 0);
-			s_BloomProperties->BloomShader->UploadUniformInt("u_Mode", bloomConstants.Mode);
-			s_BloomProperties->BloomShader->UploadUniformFloat("u_LOD", bloomConstants.LOD);
+			s_BloomProperties->BloomShader->UploadUniformInt(s_BloomProperties->Uniforms.Texture, 0);
+			s_BloomProperties->BloomShader->UploadUniformInt(s_BloomProperties->Uniforms.Mode, bloomConstants.Mode);
+			s_BloomProperties->BloomShader->UploadUniformFloat(s_BloomProperties->Uniforms.LOD, bloomConstants.LOD);
 
 			auto [mipWidth, mipHeight] = s_BloomProperties->BloomComputeTextures[2]->GetMipSize(mips - 2);
 			workGroupsX = (uint32_t)glm::ceil((float)mipWidth / (float)s_BloomProperties->BloomWorkGroupSize);
@@ -395,14 +462,14 @@ namespace Ohm
 
 				// Write to 2
 				s_BloomProperties->BloomShader->EnableShaderImageAccessBarrierBit();
-				s_BloomProperties->BloomComputeTextures[2]->BindToImageSlot(0, mip, TextureUtils::TextureAccessLevel::WriteOnly, TextureUtils::TextureShaderDataFormat::RGBA32F);
+				s_BloomProperties->BloomComputeTextures[2]->BindToImageSlot(0, mip, TextureUtils::TextureAccessLevel::WriteOnly, s_BloomProperties->BloomImageFormat);
 				// Read from 0	
 				s_BloomProperties->BloomComputeTextures[0]->BindToSamplerSlot(0);
-				s_BloomProperties->BloomShader->UploadUniformInt("u_Texture", 0);
+				s_BloomProperties->BloomShader->UploadUniformInt(s_BloomProperties->Uniforms.Texture, 0);
 				s_BloomProperties->BloomComputeTextures[2]->BindToSamplerSlot(1);
-				s_BloomProperties->BloomShader->UploadUniformInt("u_BloomTexture", 1);
-				s_BloomProperties->BloomShader->UploadUniformInt("u_Mode", bloomConstants.Mode);
-				s_BloomProperties->BloomShader->UploadUniformFloat("u_LOD", bloomConstants.LOD);
+				s_BloomProperties->BloomShader->UploadUniformInt(s_BloomProperties->Uniforms.BloomTexture, 1);
+				s_BloomProperties->BloomShader->UploadUniformInt(s_BloomProperties->Uniforms.Mode, bloomConstants.Mode);
+				s_BloomProperties->BloomShader->UploadUniformFloat(s_BloomProperties->Uniforms.LOD, bloomConstants.LOD);
 				s_BloomProperties->BloomShader->DispatchCompute(workGroupsX, workGroupsY, 1);
 				s_BloomProperties->BloomShader->EnableShaderImageAccessBarrierBit();
 			}
@@ -413,27 +480,30 @@ namespace Ohm
 		s_BloomProperties->BloomShader->Unbind();
 	}
 
-	void SceneRenderer::SceneCompositePass()
+	void SceneRenderer::SceneCompositePass(const FramePacket& packet)
 	{
 		Renderer::BeginPass(s_SceneCompositePass);
 		const TextureUniform GeometryTexUniform {s_GeometryPass->GetRenderPassSpecification().TargetFramebuffer->GetColorAttachmentID(0), 0, 1};
-		const TextureUniform BloomTextureUniform {s_BloomProperties->BloomComputeTextures[2]->GetID(), 1, 1};
-		const TextureUniform BloomDirtTextureUniform {TextureLibrary::Get2D("Bloom Dirt Mask")->GetID(), 2, 1};
+		const uint32_t BloomTextureID = s_BloomProperties->BloomComputeTextures[2] ? s_BloomProperties->BloomComputeTextures[2]->GetID() : 0;
+		const TextureUniform BloomTextureUniform {BloomTextureID, 1, 1};
+		const TextureUniform BloomDirtTextureUniform {s_BloomProperties->BloomDirtTexture->GetID(), 2, 1};
 		
 		s_SceneCompositePass->GetRenderPassSpecification().PassMaterial->Set<TextureUniform>("u_SceneTexture", GeometryTexUniform);
 		s_SceneCompositePass->GetRenderPassSpecification().PassMaterial->Set<TextureUniform>("u_BloomTexture", BloomTextureUniform);
 		s_SceneCompositePass->GetRenderPassSpecification().PassMaterial->Set<TextureUniform>("u_BloomDirtTexture", BloomDirtTextureUniform);
 
-		s_SceneCompositePass->GetRenderPassSpecification().PassMaterial->Set<int>("u_BloomEnabled", s_BloomProperties->BloomEnabled ? 1 : 0);
-		s_SceneCompositePass->GetRenderPassSpecification().PassMaterial->Set<float>("u_Exposure", s_SceneRenderProperties->Exposure);
-		s_SceneCompositePass->GetRenderPassSpecification().PassMaterial->Set<float>("u_BloomIntensity", s_BloomProperties->BloomIntensity);
-		s_SceneCompositePass->GetRenderPassSpecification().PassMaterial->Set<float>("u_BloomDirtIntensity", s_BloomProperties->BloomDirtIntensity);
+		s_SceneCompositePass->GetRenderPassSpecification().PassMaterial->Set<int>("u_BloomEnabled", BloomTextureID != 0 ? 1 : 0);
+		s_SceneCompositePass->GetRenderPassSpecification().PassMaterial->Set<float>("u_Exposure", packet.Settings.Exposure);
+		s_SceneCompositePass->GetRenderPassSpecification().PassMaterial->Set<float>("u_BloomIntensity", packet.Settings.BloomIntensity);
+		s_SceneCompositePass->GetRenderPassSpecification().PassMaterial->Set<float>("u_BloomDirtIntensity", packet.Settings.BloomDirtIntensity);
 		Renderer::DrawFullScreenQuad(s_SceneCompositePass->GetRenderPassSpecification().PassMaterial);
 		Renderer::EndPass(s_SceneCompositePass);
 	}
 	
 	void SceneRenderer::InitializePipeline()
 	{
+		s_RenderGraph = CreateRef<RenderGraph>();
+
 		InitializeGeometryPass();
 		InitializeDebugDepthPass();
 		InitializeEnvironmentPass();
@@ -443,15 +513,504 @@ namespace Ohm
 
 	void SceneRenderer::SubmitPipeline()
 	{
+		Application& App = Application::GetApplication();
+		if (!App.IsRenderThreadEnabled())
+		{
+			BuildFramePacket(s_FramePacket);
+			RenderFramePacket(s_FramePacket);
+			return;
+		}
+
+		// The packet lives in the render thread's frame slot, which isn't reused until this frame has rendered.
+		FramePacket& Packet = App.GetRenderThread().GetFramePacket();
+		BuildFramePacket(Packet);
+		App.GetRenderThread().Enqueue([&Packet]() { RenderFramePacket(Packet); });
+	}
+
+	void SceneRenderer::BuildFramePacket(FramePacket& packet)
+	{
+		UpdateRenderTargetBenchmark();
 		s_ActiveScene->UpdateLightingEnvironment(s_Camera);
-		Renderer::BeginScene(s_ActiveScene, s_Camera);
-		DebugVisualizeDepthPass();
-		EnvironmentPass();
-		GeometryPass();
 
-		BloomPass();
-		SceneCompositePass();
+		packet.ElapsedTime = Time::Elapsed();
+		packet.DeltaTime = Time::DeltaTime();
+		packet.Camera = s_Camera;
+		packet.ViewportSize = s_ViewportSize;
+		packet.Settings = s_RenderSettings;
+
+		const DirectionalLightComponent& DirectionalLight = s_ActiveScene->GetDirectionalLight().GetComponent<DirectionalLightComponent>();
+		packet.DirectionalLight = { DirectionalLight.Radiance, DirectionalLight.Intensity, DirectionalLight.LightDirection, DirectionalLight.ShadowAmount };
+
+		EnvironmentLightComponent& EnvironmentLight = s_ActiveScene->GetEnvironmentLight().GetComponent<EnvironmentLightComponent>();
+		packet.EnvironmentLight.Pipeline = EnvironmentLight.Pipeline;
+		packet.EnvironmentLight.PipelineType = EnvironmentLight.Pipeline->GetSpecification().PipelineType;
+		packet.EnvironmentLight.FromFileFilePath = EnvironmentLight.Pipeline->GetSpecification().FromFileFilePath;
+		packet.EnvironmentLight.TAI = { EnvironmentLight.EnvironmentMapParams.Turbidity, EnvironmentLight.EnvironmentMapParams.Azimuth, EnvironmentLight.EnvironmentMapParams.Inclination };
+		packet.EnvironmentLight.SampleLODs = EnvironmentLight.EnvironmentMapSampleLODs;
+		packet.EnvironmentLight.SampleIntensities = EnvironmentLight.EnvironmentMapSampleIntensities;
+		packet.EnvironmentLight.NeedsUpdate = EnvironmentLight.NeedsUpdate;
+		EnvironmentLight.NeedsUpdate = false;
+
+		RecordGeometryCommands(packet);
+
+		packet.SaveImageIndex = s_PendingSaveImageIndex;
+		packet.SaveImagePath = s_PendingSaveImagePath;
+		s_PendingSaveImageIndex = -1;
+	}
+
+	// Radius of the mesh's bounding sphere in world space over the half height of the view at its distance.
+	static float ComputeScreenSize(const Mesh& mesh, const glm::mat4& transform, const glm::vec3& cameraPosition, float tanHalfFOV)
+	{
+		const AABB& Bounds = mesh.GetBounds();
+		const glm::vec3 Center = transform * glm::vec4((Bounds.Min + Bounds.Max) * 0.5f, 1.0f);
+		const float Scale = glm::max(glm::length(glm::vec3(transform[0])), glm::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+		const float Radius = glm::length(Bounds.Max - Bounds.Min) * 0.5f * Scale;
+
+		// From inside the sphere the mesh is never smaller than the whole view.
+		const float Distance = glm::max(glm::length(Center - cameraPosition), Radius);
+		return Distance > 0.0f ? Radius / (Distance * tanHalfFOV) : 1.0f / tanHalfFOV;
+	}
+
+	// Pixels one unit of the mesh's UVs covers at the point of its bounding sphere nearest the camera.  Orthographic
+	// views keep full detail.
+	static float ComputePixelsPerUV(const Mesh& mesh, const glm::mat4& transform, const EditorCamera& camera, float tanHalfFOV, float viewportHeight)
+	{
+		if (mesh.GetUVDensity() <= 0.0f) return 0.0f;
+		if (camera.GetProjectionType() != ProjectionType::Perspective) return std::numeric_limits<float>::max();
+
+		const AABB& Bounds = mesh.GetBounds();
+		const glm::vec3 Center = transform * glm::vec4((Bounds.Min + Bounds.Max) * 0.5f, 1.0f);
+		// The largest scale stretches a unit of UV over the most world units.
+		const float Scale = glm::max(glm::length(glm::vec3(transform[0])), glm::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+		const float Radius = glm::length(Bounds.Max - Bounds.Min) * 0.5f * Scale;
+
+		const float Distance = glm::max(glm::length(Center - camera.GetPosition()) - Radius, camera.GetNearClip());
+		const float PixelsPerUnit = viewportHeight / (2.0f * Distance * tanHalfFOV);
+		return PixelsPerUnit * Scale / mesh.GetUVDensity();
+	}
+
+	uint32_t SceneRenderer::GatherGeometry(FrustumCuller* culler)
+	{
+		const auto MeshView = s_ActiveScene->m_Registry.view<TransformComponent, MeshRendererComponent>();
+		const auto PrimitiveView = s_ActiveScene->m_Registry.view<TransformComponent, PrimitiveRendererComponent>();
+
+		// Entities are split between threads by index, so the views are flattened first.  One with both renderers is
+		// only taken once, for its MeshRendererComponent.
+		GeometryRecording& Recording = s_GeometryRecording;
+		Recording.Entities.assign(MeshView.begin(), MeshView.end());
+		for (const entt::entity Entity : PrimitiveView)
+		{
+			if (!MeshView.contains(Entity))
+				Recording.Entities.push_back(Entity);
+		}
+
+		const uint32_t EntityCount = static_cast<uint32_t>(Recording.Entities.size());
+		Recording.Transforms.resize(EntityCount);
+		Recording.Drawable.resize(EntityCount);
+		Recording.Meshes.resize(EntityCount);
+		Recording.Materials.resize(EntityCount);
+		Recording.TextureDemand.resize(JobSystem::GetThreadCount());
+		if (culler)
+			culler->Resize(EntityCount);
+
+		std::atomic<uint32_t> DrawableCount{ 0 };
+		JobSystem::ParallelFor(EntityCount, GeometryRecording::ChunkSize,
+			[&MeshView, &PrimitiveView, &Recording, &DrawableCount, culler](uint32_t begin, uint32_t end, uint32_t)
+			{
+				uint32_t ChunkDrawableCount = 0;
+				for (uint32_t i = begin; i < end; i++)
+				{
+					const entt::entity Entity = Recording.Entities[i];
+					const bool HasMeshRenderer = MeshView.contains(Entity);
+					if (HasMeshRenderer)
+					{
+						const MeshRendererComponent& MeshRenderer = MeshView.get<MeshRendererComponent>(Entity);
+						Recording.Drawable[i] = MeshRenderer.IsComplete();
+						Recording.Meshes[i] = &MeshRenderer.MeshData;
+						Recording.Materials[i] = &MeshRenderer.MaterialInstance;
+					}
+					else
+					{
+						const PrimitiveRendererComponent& PrimitiveRenderer = PrimitiveView.get<PrimitiveRendererComponent>(Entity);
+						Recording.Drawable[i] = PrimitiveRenderer.PrimitiveType != Primitive::None && PrimitiveRenderer.MaterialInstance != nullptr;
+						if (Recording.Drawable[i])
+							Recording.Meshes[i] = &Renderer::GetPrimitiveMesh(PrimitiveRenderer.PrimitiveType);
+						Recording.Materials[i] = &PrimitiveRenderer.MaterialInstance;
+					}
+					if (!Recording.Drawable[i]) continue;
+
+					const TransformComponent& Transform = HasMeshRenderer ? MeshView.get<TransformComponent>(Entity) : PrimitiveView.get<TransformComponent>(Entity);
+					Recording.Transforms[i] = Transform.Transform();
+					if (culler)
+						culler->Set(i, (*Recording.Meshes[i])->GetBounds(), Recording.Transforms[i]);
+					ChunkDrawableCount++;
+				}
+				DrawableCount += ChunkDrawableCount;
+			});
+
+		return DrawableCount;
+	}
+
+	void SceneRenderer::RecordGeometryCommands(FramePacket& packet)
+	{
+		if (packet.Settings.GPUDriven)
+		{
+			RecordIndirectGeometry(packet);
+			return;
+		}
+		packet.IndirectGeometry.Clear();
+
+		GeometryRecording& Recording = s_GeometryRecording;
+		s_GeometryCuller->Begin(s_Camera.GetViewProjection());
+		const uint32_t DrawableCount = GatherGeometry(s_GeometryCuller.get());
+		const uint32_t EntityCount = static_cast<uint32_t>(Recording.Entities.size());
+
+		// Slots of entities that aren't drawable hold stale bounds; they're skipped below, whatever the result.
+		s_GeometryCuller->Cull();
+
+		// Every thread records into the buffer of its own thread index, so no buffer is shared.
+		packet.GeometryCommands.resize(JobSystem::GetThreadCount());
+		for (RenderCommandBuffer& Commands : packet.GeometryCommands)
+			Commands.Begin(s_Camera);
+
+		// Orthographic views keep full detail; their screen size doesn't depend on distance.
+		const bool SelectLODs = packet.Settings.LODEnabled && s_Camera.GetProjectionType() == ProjectionType::Perspective;
+		const glm::vec3 CameraPosition = s_Camera.GetPosition();
+		const float TanHalfFOV = glm::tan(glm::radians(s_Camera.GetFOV()) * 0.5f);
+		const float LODBias = packet.Settings.LODBias;
+		const float ViewportHeight = packet.ViewportSize.y;
+
+		// Cones are tested against the eye position, which an orthographic view doesn't have.
+		const bool CullMeshlets = packet.Settings.MeshletCulling != MeshletCullingMode::Off;
+		const bool ConeCulling = packet.Settings.MeshletConeCulling && s_Camera.GetProjectionType() == ProjectionType::Perspective;
+		s_MeshletCuller.Begin(s_Camera.GetViewProjection(), CameraPosition, ConeCulling);
+		packet.MeshletGeometry.resize(JobSystem::GetThreadCount());
+		for (MeshletDrawList& Meshlets : packet.MeshletGeometry)
+			Meshlets.Begin(s_MeshletCuller, packet.Settings.MeshletCulling == MeshletCullingMode::CPU);
+
+		JobSystem::ParallelFor(EntityCount, GeometryRecording::ChunkSize,
+			[&Recording, &packet, SelectLODs, CameraPosition, TanHalfFOV, LODBias, ViewportHeight, CullMeshlets](uint32_t begin, uint32_t end, uint32_t threadIndex)
+			{
+				RenderCommandBuffer& Commands = packet.GeometryCommands[threadIndex];
+				MeshletDrawList& Meshlets = packet.MeshletGeometry[threadIndex];
+				std::unordered_map<const Material*, float>& TextureDemand = Recording.TextureDemand[threadIndex];
+				for (uint32_t i = begin; i < end; i++)
+				{
+					if (!Recording.Drawable[i] || !s_GeometryCuller->IsVisible(i)) continue;
+
+					const Ref<Mesh>& DrawMesh = *Recording.Meshes[i];
+					const Ref<Material>& DrawMaterial = *Recording.Materials[i];
+
+					uint32_t LOD = 0;
+					float& PixelsPerUV = TextureDemand[DrawMaterial.get()];
+					PixelsPerUV = glm::max(PixelsPerUV, ComputePixelsPerUV(*DrawMesh, Recording.Transforms[i], s_Camera, TanHalfFOV, ViewportHeight));
+					if (SelectLODs && DrawMesh->GetLODCount() > 1)
+						LOD = DrawMesh->SelectLOD(ComputeScreenSize(*DrawMesh, Recording.Transforms[i], CameraPosition, TanHalfFOV), LODBias);
+
+					// Meshlets are cut from LOD 0; coarser LODs are small on screen and drawn whole.
+					if (CullMeshlets && LOD == 0 && DrawMesh->HasMeshlets())
+					{
+						Meshlets.Record(DrawMesh, DrawMaterial, Recording.Transforms[i]);
+						continue;
+					}
+
+					Commands.RecordDraw(DrawPass::Opaque, DrawMesh, DrawMaterial, Recording.Transforms[i], LOD);
+				}
+			});
+
+		RequestStreamedTextures();
+
+		packet.ObjectsTotal = DrawableCount;
+		packet.ObjectsVisible = 0;
+		for (const RenderCommandBuffer& Commands : packet.GeometryCommands)
+			packet.ObjectsVisible += Commands.GetDrawCount();
+		// An object whose meshlets were all culled counts as culled.
+		for (const MeshletDrawList& Meshlets : packet.MeshletGeometry)
+			packet.ObjectsVisible += Meshlets.GetDrawCount();
+	}
+
+	void SceneRenderer::RecordIndirectGeometry(FramePacket& packet)
+	{
+		// Nothing is culled here; the counts are read back from the GPU a frame later instead.
+		for (RenderCommandBuffer& Commands : packet.GeometryCommands)
+			Commands.Begin(s_Camera);
+		for (MeshletDrawList& Meshlets : packet.MeshletGeometry)
+			Meshlets.Clear();
+		packet.ObjectsTotal = packet.ObjectsVisible = 0;
+
+		GatherGeometry(nullptr);
+		GeometryRecording& Recording = s_GeometryRecording;
+		const uint32_t EntityCount = static_cast<uint32_t>(Recording.Entities.size());
+
+		// Streamed textures are asked for on behalf of everything, since culling happens later on the GPU.
+		const float TanHalfFOV = glm::tan(glm::radians(s_Camera.GetFOV()) * 0.5f);
+		const float ViewportHeight = packet.ViewportSize.y;
+		JobSystem::ParallelFor(EntityCount, GeometryRecording::ChunkSize,
+			[&Recording, TanHalfFOV, ViewportHeight](uint32_t begin, uint32_t end, uint32_t threadIndex)
+			{
+				std::unordered_map<const Material*, float>& TextureDemand = Recording.TextureDemand[threadIndex];
+				for (uint32_t i = begin; i < end; i++)
+				{
+					if (!Recording.Drawable[i]) continue;
+
+					float& PixelsPerUV = TextureDemand[Recording.Materials[i]->get()];
+					PixelsPerUV = glm::max(PixelsPerUV, ComputePixelsPerUV(**Recording.Meshes[i], Recording.Transforms[i], s_Camera, TanHalfFOV, ViewportHeight));
+				}
+			});
+		RequestStreamedTextures();
+
+		// Groups are shared between objects, so the list itself is filled on one thread.
+		IndirectDrawList& DrawList = packet.IndirectGeometry;
+		DrawList.Clear();
+		for (uint32_t i = 0; i < EntityCount; i++)
+		{
+			if (Recording.Drawable[i])
+				DrawList.Record(*Recording.Meshes[i], *Recording.Materials[i], Recording.Transforms[i]);
+		}
+		DrawList.Finish();
+	}
+
+	void SceneRenderer::RequestStreamedTextures()
+	{
+		// Materials are shared between threads' maps, so their demand is merged before it's passed on.
+		std::vector<std::unordered_map<const Material*, float>>& TextureDemand = s_GeometryRecording.TextureDemand;
+		for (size_t i = 1; i < TextureDemand.size(); i++)
+		{
+			for (const auto& [MaterialInstance, PixelsPerUV] : TextureDemand[i])
+			{
+				float& Merged = TextureDemand[0][MaterialInstance];
+				Merged = glm::max(Merged, PixelsPerUV);
+			}
+			TextureDemand[i].clear();
+		}
+
+		for (const auto& [MaterialInstance, PixelsPerUV] : TextureDemand[0])
+		{
+			if (PixelsPerUV > 0.0f)
+				TextureStreamer::RequestMaterial(*MaterialInstance, PixelsPerUV);
+		}
+		TextureDemand[0].clear();
+	}
+
+	void SceneRenderer::RenderFramePacket(const FramePacket& packet)
+	{
+		Renderer::BeginScene(packet);
+
+		// Graph-owned targets are handed out again by whichever passes survive this frame.
+		s_GeometryPass->GetRenderPassSpecification().TargetFramebuffer = nullptr;
+		s_SkyboxGeometryPass->GetRenderPassSpecification().TargetFramebuffer = nullptr;
+		s_DebugDepthPass->GetRenderPassSpecification().TargetFramebuffer = nullptr;
+		std::fill(s_BloomProperties->BloomComputeTextures.begin(), s_BloomProperties->BloomComputeTextures.end(), nullptr);
+
+		const RenderTargetFormats Formats = GetRenderTargetFormats(packet.Settings.TargetPrecision);
+
+		const Ref<Framebuffer>& CompositeFramebuffer = s_SceneCompositePass->GetRenderPassSpecification().TargetFramebuffer;
+		if (CompositeFramebuffer->GetFramebufferSpecification().AttachmentSpecification.FBOTextureSpecifications[0].TextureFormat != Formats.Composite)
+			CompositeFramebuffer->SetAttachments({ Formats.Composite });
+
+		// Transient targets follow the composite target's size through the render graph.
+		const uint32_t ViewportWidth = static_cast<uint32_t>(packet.ViewportSize.x);
+		const uint32_t ViewportHeight = static_cast<uint32_t>(packet.ViewportSize.y);
+		const FramebufferSpecification& CompositeSpec = CompositeFramebuffer->GetFramebufferSpecification();
+		if (ViewportWidth > 0 && ViewportHeight > 0 && (CompositeSpec.Width != ViewportWidth || CompositeSpec.Height != ViewportHeight))
+			CompositeFramebuffer->Resize(ViewportWidth, ViewportHeight);
+
+		const uint32_t Width = glm::max(CompositeFramebuffer->GetFramebufferSpecification().Width, 1u);
+		const uint32_t Height = glm::max(CompositeFramebuffer->GetFramebufferSpecification().Height, 1u);
+
+		struct
+		{
+			RenderGraphResource EnvironmentMaps;
+			RenderGraphResource SceneTarget;
+			RenderGraphResource LinearDepthTarget;
+			RenderGraphResource BloomTextures[3];
+			RenderGraphResource CompositeTarget;
+		} Resources;
+
+		s_RenderGraph->Begin();
+		Resources.EnvironmentMaps = s_RenderGraph->ImportExternal("Environment Maps");
+		Resources.CompositeTarget = s_RenderGraph->ImportFramebuffer("Scene Composite", CompositeFramebuffer);
+
+		s_RenderGraph->AddPass("Environment",
+			[&Resources](RenderGraphBuilder& builder)
+			{
+				// The environment pipeline synchronizes its own dispatches.
+				builder.Write(Resources.EnvironmentMaps, RenderGraphAccess::None);
+			},
+			[&packet](const RenderGraph&) { EnvironmentPass(packet); });
+
+		s_RenderGraph->AddPass("Geometry",
+			[&Resources, &Formats, Width, Height](RenderGraphBuilder& builder)
+			{
+				builder.Read(Resources.EnvironmentMaps);
+				const FramebufferSpecification SceneSpec = { Width, Height, { FramebufferTextureFormat::Depth, Formats.SceneColor } };
+				Resources.SceneTarget = builder.Write(builder.CreateFramebuffer("Scene", SceneSpec));
+			},
+			[&Resources, &packet](const RenderGraph& graph)
+			{
+				s_GeometryPass->GetRenderPassSpecification().TargetFramebuffer = graph.GetFramebuffer(Resources.SceneTarget);
+				s_SkyboxGeometryPass->GetRenderPassSpecification().TargetFramebuffer = graph.GetFramebuffer(Resources.SceneTarget);
+				GeometryPass(packet);
+			});
+
+		s_RenderGraph->AddPass("Linear Depth",
+			[&Resources, &Formats](RenderGraphBuilder& builder)
+			{
+				constexpr uint32_t LinearDepthResolution = 4096;
+				builder.Read(Resources.SceneTarget);
+				FramebufferSpecification LinearDepthSpec;
+				LinearDepthSpec.AttachmentSpecification = { Formats.LinearDepth };
+				LinearDepthSpec.Width = LinearDepthSpec.Height = LinearDepthResolution;
+				Resources.LinearDepthTarget = builder.Write(builder.CreateFramebuffer("Linear Depth", LinearDepthSpec));
+			},
+			[&Resources, &packet](const RenderGraph& graph)
+			{
+				s_DebugDepthPass->GetRenderPassSpecification().TargetFramebuffer = graph.GetFramebuffer(Resources.LinearDepthTarget);
+				DebugVisualizeDepthPass(packet);
+			});
+
+		uint32_t BloomWidth = Width / 2;
+		uint32_t BloomHeight = Height / 2;
+		BloomWidth += (s_BloomProperties->BloomWorkGroupSize - (BloomWidth % s_BloomProperties->BloomWorkGroupSize));
+		BloomHeight += (s_BloomProperties->BloomWorkGroupSize - (BloomHeight % s_BloomProperties->BloomWorkGroupSize));
+		s_BloomProperties->BloomTextureSpecification.Width = BloomWidth;
+		s_BloomProperties->BloomTextureSpecification.Height = BloomHeight;
+		s_BloomProperties->BloomTextureSpecification.InternalFormat = Formats.Bloom;
+		s_BloomProperties->BloomTextureSpecification.PixelLayoutFormat = Formats.BloomLayout;
+		s_BloomProperties->BloomImageFormat = Formats.BloomImage;
+
+		// Bloom 2 is scratch for the down-sample chain and dead before Bloom 3 is first written, so the two alias.
+		s_RenderGraph->AddPass("Bloom Downsample",
+			[&Resources](RenderGraphBuilder& builder)
+			{
+				builder.Read(Resources.SceneTarget);
+				Resources.BloomTextures[0] = builder.Write(builder.CreateTexture("Bloom 1", s_BloomProperties->BloomTextureSpecification), RenderGraphAccess::ImageStore);
+				Resources.BloomTextures[1] = builder.Write(builder.CreateTexture("Bloom 2", s_BloomProperties->BloomTextureSpecification), RenderGraphAccess::ImageStore);
+			},
+			[&Resources, &packet](const RenderGraph& graph)
+			{
+				s_BloomProperties->BloomComputeTextures[0] = graph.GetTexture(Resources.BloomTextures[0]);
+				s_BloomProperties->BloomComputeTextures[1] = graph.GetTexture(Resources.BloomTextures[1]);
+				BloomDownsamplePass(packet);
+			});
+
+		s_RenderGraph->AddPass("Bloom Upsample",
+			[&Resources](RenderGraphBuilder& builder)
+			{
+				builder.Read(Resources.BloomTextures[0]);
+				Resources.BloomTextures[2] = builder.Write(builder.CreateTexture("Bloom 3", s_BloomProperties->BloomTextureSpecification), RenderGraphAccess::ImageStore);
+			},
+			[&Resources](const RenderGraph& graph)
+			{
+				s_BloomProperties->BloomComputeTextures[2] = graph.GetTexture(Resources.BloomTextures[2]);
+				BloomUpsamplePass();
+			});
+
+		s_RenderGraph->AddPass("Scene Composite",
+			[&Resources, &packet](RenderGraphBuilder& builder)
+			{
+				builder.Read(Resources.SceneTarget);
+				if (packet.Settings.BloomEnabled)
+					builder.Read(Resources.BloomTextures[2]);
+				builder.Write(Resources.CompositeTarget);
+			},
+			[&packet](const RenderGraph&) { SceneCompositePass(packet); });
+
+		s_RenderGraph->MarkOutput(Resources.CompositeTarget);
+
+		// Whatever the texture viewer shows has to outlive the graph; when it's collapsed those passes are culled.
+		if (packet.Settings.TextureViewerVisible)
+		{
+			s_RenderGraph->MarkOutput(Resources.SceneTarget);
+			s_RenderGraph->MarkOutput(Resources.LinearDepthTarget);
+			if (packet.Settings.BloomEnabled)
+				s_RenderGraph->MarkOutput(Resources.BloomTextures[2]);
+		}
+
+		s_RenderGraph->Compile();
+		s_RenderGraph->Execute();
+
+		SaveTextureViewerImage(packet);
+
 		Renderer::EndScene();
+
+		// After the frame, so the benchmark's draws don't land in its statistics.
+		MeshBenchmark::RunPending();
+
+		PublishFrameResults();
+	}
+
+	void SceneRenderer::SaveTextureViewerImage(const FramePacket& packet)
+	{
+		if (packet.SaveImageIndex < 0) return;
+
+		Ref<Framebuffer> SaveFBO = nullptr;
+		switch(packet.SaveImageIndex)
+		{
+			case 0: SaveFBO = s_GeometryPass->GetRenderPassSpecification().TargetFramebuffer;	break; // PBR Geometry Output
+			case 1: SaveFBO = s_DebugDepthPass->GetRenderPassSpecification().TargetFramebuffer;	break; // Depth
+			default: ;
+		}
+
+		const bool SaveSuccess = SaveFBO != nullptr && SaveFBO->SaveAttachmentAsEXR(packet.SaveImagePath, 0);
+		const std::string Message = SaveSuccess ? "Successfully saved EXR with name " + packet.SaveImagePath + "!" : "Failed to save EXR with name " + packet.SaveImagePath + "!";
+		OHM_CORE_INFO(Message);
+	}
+
+	void SceneRenderer::PublishFrameResults()
+	{
+		const Ref<Framebuffer>& SceneFBO = s_GeometryPass->GetRenderPassSpecification().TargetFramebuffer;
+		const Ref<Framebuffer>& DepthFBO = s_DebugDepthPass->GetRenderPassSpecification().TargetFramebuffer;
+
+		FrameResults Results;
+		Results.CompositeTextureID = s_SceneCompositePass->GetRenderPassSpecification().TargetFramebuffer->GetColorAttachmentID(0);
+		Results.SceneTextureID = SceneFBO ? SceneFBO->GetColorAttachmentID(0) : 0;
+		Results.DepthTextureID = DepthFBO ? DepthFBO->GetColorAttachmentID(0) : 0;
+		for (uint32_t i = 0; i < 3; i++)
+			Results.BloomTextureIDs[i] = s_BloomProperties->BloomComputeTextures[i] ? s_BloomProperties->BloomComputeTextures[i]->GetID() : 0;
+
+		std::lock_guard<std::mutex> Lock(s_FrameResultsMutex);
+		s_FrameResults = Results;
+	}
+
+	void SceneRenderer::UpdateRenderTargetBenchmark()
+	{
+		RenderTargetBenchmark& Benchmark = s_RenderTargetBenchmark;
+		if (!Benchmark.Running) return;
+
+		// Warm-up frames let the graph's pool settle on the new formats and flush timer queries issued with the old ones.
+		// Runs while building packets, so it sees the graph statistics of whichever frame rendered last.
+		if (Benchmark.Frame++ >= RenderTargetBenchmark::WarmupFrames)
+		{
+			const RenderGraph::Statistics GraphStats = s_RenderGraph->GetStatistics();
+			const uint32_t CompositeBytesPerPixel = Framebuffer::GetBytesPerPixel(GetRenderTargetFormats(s_RenderSettings.TargetPrecision).Composite);
+			const uint64_t CompositePixels = static_cast<uint64_t>(s_ViewportSize.x) * static_cast<uint64_t>(s_ViewportSize.y);
+
+			RenderTargetBenchmark::Result& Result = Benchmark.Results[Benchmark.Run];
+			Result.FrameMilliseconds += Time::DeltaTimeMilliseconds() / RenderTargetBenchmark::MeasuredFrames;
+			Result.GPUMilliseconds += GraphStats.GPUMilliseconds / RenderTargetBenchmark::MeasuredFrames;
+			Result.TargetBytes = GraphStats.AliasedBytes + CompositePixels * CompositeBytesPerPixel;
+		}
+
+		if (Benchmark.Frame < RenderTargetBenchmark::WarmupFrames + RenderTargetBenchmark::MeasuredFrames) return;
+
+		Benchmark.Frame = 0;
+		if (++Benchmark.Run < 2)
+		{
+			s_RenderSettings.TargetPrecision = static_cast<RenderTargetPrecision>(Benchmark.Run);
+			return;
+		}
+
+		Benchmark.Running = false;
+		Benchmark.HasResults = true;
+		s_RenderSettings.TargetPrecision = Benchmark.RestorePrecision;
+
+		constexpr double BytesPerMB = 1024.0 * 1024.0;
+		const auto& Full = Benchmark.Results[static_cast<uint32_t>(RenderTargetPrecision::Full)];
+		const auto& Reduced = Benchmark.Results[static_cast<uint32_t>(RenderTargetPrecision::Reduced)];
+		OHM_CORE_INFO("Render Target Benchmark ({}x{}, {} frames):", s_ViewportSize.x, s_ViewportSize.y, RenderTargetBenchmark::MeasuredFrames);
+		OHM_CORE_INFO("  Full:    {:.3f} ms/frame, {:.3f} ms GPU, {:.1f} MB targets", Full.FrameMilliseconds, Full.GPUMilliseconds, Full.TargetBytes / BytesPerMB);
+		OHM_CORE_INFO("  Reduced: {:.3f} ms/frame, {:.3f} ms GPU, {:.1f} MB targets", Reduced.FrameMilliseconds, Reduced.GPUMilliseconds, Reduced.TargetBytes / BytesPerMB);
 	}
 
 	void SceneRenderer::UpdateCamera(float deltaTime)
@@ -469,20 +1028,7 @@ namespace Ohm
 		if(s_ViewportSize == viewportSize) return;
 		s_ViewportSize = viewportSize;
 
-		s_GeometryPass->GetRenderPassSpecification().TargetFramebuffer->Resize((uint32_t)s_ViewportSize.x, (uint32_t)s_ViewportSize.y);
-		s_EnvironmentPass->GetRenderPassSpecification().TargetFramebuffer->Resize((uint32_t)s_ViewportSize.x, (uint32_t)s_ViewportSize.y);
-		s_SceneCompositePass->GetRenderPassSpecification().TargetFramebuffer->Resize((uint32_t)s_ViewportSize.x, (uint32_t)s_ViewportSize.y);
-		s_DebugDepthPass->GetRenderPassSpecification().TargetFramebuffer->Resize((uint32_t)s_ViewportSize.x, (uint32_t)s_ViewportSize.y);
-
-		uint32_t halfWidth = s_ViewportSize.x / 2;
-		uint32_t halfHeight = s_ViewportSize.y / 2;
-		halfWidth += (s_BloomProperties->BloomWorkGroupSize - (halfWidth % s_BloomProperties->BloomWorkGroupSize));
-		halfHeight += (s_BloomProperties->BloomWorkGroupSize - (halfHeight % s_BloomProperties->BloomWorkGroupSize));
-				
-		s_BloomProperties->BloomComputeTextures[0]->Resize(halfWidth, halfHeight);
-		s_BloomProperties->BloomComputeTextures[1]->Resize(halfWidth, halfHeight);
-		s_BloomProperties->BloomComputeTextures[2]->Resize(halfWidth, halfHeight);
-
+		// The composite target itself is resized by the frame that renders at the new size.
 		s_Camera.SetViewportSize(s_ViewportSize.x, s_ViewportSize.y);
 	}
 
@@ -494,11 +1040,12 @@ namespace Ohm
 	    constexpr float MinImageHeight = 67.5f;
 	    constexpr float MaxImageHeight = 270.0f;
 	    constexpr uint32_t ImagesPerAxis = 3;
+	    constexpr uint32_t ImageRows = 1;
 
 	    constexpr float MinWindowWidth = MinImageWidth * ImagesPerAxis;
 	    constexpr float MaxWindowWidth = MaxImageWidth * ImagesPerAxis;
-	    constexpr float MinWindowHeight = MinImageHeight * ImagesPerAxis + BaseGuessWindowHeight;
-	    constexpr float MaxWindowHeight = MaxImageHeight * ImagesPerAxis + BaseGuessWindowHeight;
+	    constexpr float MinWindowHeight = MinImageHeight * ImageRows + BaseGuessWindowHeight;
+	    constexpr float MaxWindowHeight = MaxImageHeight * ImageRows + BaseGuessWindowHeight;
 	    
 	    float ImageWidth = MinImageWidth * (1.0f - s_ImageViewerSizeFactor) + MaxImageWidth * s_ImageViewerSizeFactor;
 	    float ImageHeight = MinImageHeight * (1.0f - s_ImageViewerSizeFactor) + MaxImageHeight * s_ImageViewerSizeFactor;
@@ -506,22 +1053,32 @@ namespace Ohm
 	    float WindowHeight =  MinWindowHeight * (1.0f - s_ImageViewerSizeFactor) + MaxWindowHeight * s_ImageViewerSizeFactor;
 
 	    ImGui::SetNextWindowSize({WindowWidth, WindowHeight});
-	    ImGui::Begin("Texture Viewer", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoScrollbar);
+	    // A collapsed viewer lets the render graph cull the passes that only exist to feed it.
+	    s_RenderSettings.TextureViewerVisible = ImGui::Begin("Texture Viewer", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoScrollbar);
+	    if (!s_RenderSettings.TextureViewerVisible)
+	    {
+	    	ImGui::End();
+	    	return;
+	    }
+
 	    ImGui::DragFloat("Image Size Factor", &s_ImageViewerSizeFactor, 0.01f, 0.0, 1.0);
 
 	    std::vector<std::string> ImageToolTips =
 	    {
-	    	"Filtered Sky Radiance",
-	        "Unfiltered Sky Radiance",
-	        "Irradiance",
 	    	"Scene Geometry",
 	        "Depth",
 	    	"Bloom",
 	    };
 
+	    FrameResults Results;
+	    {
+	    	std::lock_guard<std::mutex> Lock(s_FrameResultsMutex);
+	    	Results = s_FrameResults;
+	    }
+
 	    if (ImGui::BeginTable("Texture Viewer", 3))
 	    {
-	        for (int row = 0; row < ImagesPerAxis + 1; row++)
+	        for (int row = 0; row < ImageRows; row++)
 	        {
 	            ImGui::TableNextRow();
 	            for (int column = 0; column < ImagesPerAxis; column++)
@@ -530,46 +1087,21 @@ namespace Ohm
 	                uint32_t ImageID = 0;
 	                switch(Index)
 	                {
-						case 0: ImageID = s_EnvironmentPass->GetRenderPassSpecification().TargetFramebuffer->GetColorAttachmentID(0);	break; // Filtered Sky Radiance
-	                	case 1: ImageID = s_EnvironmentPass->GetRenderPassSpecification().TargetFramebuffer->GetColorAttachmentID(1);	break; // Unfiltered Sky Radiance
-	                	case 2: ImageID = s_EnvironmentPass->GetRenderPassSpecification().TargetFramebuffer->GetColorAttachmentID(2);	break; // Irradiance 
-	                    case 3: ImageID = s_GeometryPass->GetRenderPassSpecification().TargetFramebuffer->GetColorAttachmentID(0);		break; // PBR Geometry Output
-	                    case 4: ImageID = s_DebugDepthPass->GetRenderPassSpecification().TargetFramebuffer->GetColorAttachmentID(0);	break; // Depth
-	                    case 6: ImageID = s_BloomProperties->BloomComputeTextures[2]->GetID();												break; // Bloom
+	                    case 0: ImageID = Results.SceneTextureID;		break; // PBR Geometry Output
+	                    case 1: ImageID = Results.DepthTextureID;		break; // Depth
+	                    case 2: ImageID = Results.BloomTextureIDs[2];	break; // Bloom
 	                    default: ;
 	                }
 	                ImGui::TableSetColumnIndex(column);
 	            	const std::string TextureName = Index <= ImageToolTips.size() - 1 ? ImageToolTips[Index] : "";
 	                ImGui::Text(TextureName.c_str());
 
-	            	bool SaveSuccess = false;
-	            	Ref<Framebuffer> SaveFBO = nullptr;
-
-	            	std::string FileSaveName;
-	                if(ImGui::ImageButton(reinterpret_cast<ImTextureID>(ImageID), {ImageWidth, ImageHeight}, {0, 1}, {1, 0}))
-	            	{
-		                uint32_t AttachmentIndex = 0;
-		                switch(Index)
-	            		{
-	            			case 0: SaveFBO = s_EnvironmentPass->GetRenderPassSpecification().TargetFramebuffer; AttachmentIndex = 0;			break; // Filtered Sky Radiance
-	            			case 1: SaveFBO = s_EnvironmentPass->GetRenderPassSpecification().TargetFramebuffer; AttachmentIndex = 1;			break; // Unfiltered Sky Radiance
-	            			case 2: SaveFBO = s_EnvironmentPass->GetRenderPassSpecification().TargetFramebuffer; AttachmentIndex = 2;			break; // Irradiance 
-	            			case 3: SaveFBO = s_GeometryPass->GetRenderPassSpecification().TargetFramebuffer; AttachmentIndex = 0;				break; // PBR Geometry Output
-	            			case 5: SaveFBO = s_DebugDepthPass->GetRenderPassSpecification().TargetFramebuffer;	AttachmentIndex = 0;			break; // Depth
-	            		}
-
-	            		if(SaveFBO != nullptr)
-	            		{
-	            			static std::string DirPath = "assets/image-saves/";
-	            			FileSaveName = TextureName + "-(" + std::to_string(UUID()) + ").exr";
-	            			SaveSuccess = SaveFBO->SaveAttachmentAsEXR(DirPath + FileSaveName, AttachmentIndex);
-	            		}
-	            	}
-
-	            	if(SaveFBO != nullptr)
+	            	// Only the geometry and depth targets can be saved.  The frame that renders next writes the file.
+	                if(ImGui::ImageButton(reinterpret_cast<ImTextureID>(ImageID), {ImageWidth, ImageHeight}, {0, 1}, {1, 0}) && Index < 2)
 	            	{
-	            		std::string Message = SaveSuccess ? "Successfully saved EXR with name " + FileSaveName + "!" :  "Failed to save EXR with name " + FileSaveName + "!";
-	            		OHM_CORE_INFO(Message);
+	            		static std::string DirPath = "assets/image-saves/";
+	            		s_PendingSaveImageIndex = Index;
+	            		s_PendingSaveImagePath = DirPath + TextureName + "-(" + std::to_string(UUID()) + ").exr";
 	            	}
 	            }
 	        }
@@ -583,38 +1115,188 @@ namespace Ohm
 	{
 		if (ImGui::CollapsingHeader("Scene Render Settings"))
 		{
-			UI::UIFloat::Draw("Exposure", &s_SceneRenderProperties->Exposure);
-			UI::UIBool::Draw("Apply Color Correction", &s_SceneRenderProperties->ApplyColorCorrection);
+			UI::UIFloat::Draw("Exposure", &s_RenderSettings.Exposure);
+			UI::UIBool::Draw("Apply Color Correction", &s_RenderSettings.ApplyColorCorrection);
+
+			const char* PrecisionNames[] = { "Full (RGBA32F)", "Reduced (RGBA16F / R11G11B10F)" };
+			int Precision = static_cast<int>(s_RenderSettings.TargetPrecision);
+			if (ImGui::Combo("Render Target Precision", &Precision, PrecisionNames, IM_ARRAYSIZE(PrecisionNames)) && !s_RenderTargetBenchmark.Running)
+				s_RenderSettings.TargetPrecision = static_cast<RenderTargetPrecision>(Precision);
+
+			if (s_RenderTargetBenchmark.Running)
+			{
+				ImGui::Text("Benchmarking %s... %u / %u", PrecisionNames[s_RenderTargetBenchmark.Run], s_RenderTargetBenchmark.Frame,
+					RenderTargetBenchmark::WarmupFrames + RenderTargetBenchmark::MeasuredFrames);
+			}
+			else if (ImGui::Button("Benchmark Render Target Precision"))
+			{
+				s_RenderTargetBenchmark = {};
+				s_RenderTargetBenchmark.Running = true;
+				s_RenderTargetBenchmark.RestorePrecision = s_RenderSettings.TargetPrecision;
+				s_RenderSettings.TargetPrecision = RenderTargetPrecision::Full;
+			}
+
+			if (s_RenderTargetBenchmark.HasResults)
+			{
+				constexpr double BytesPerMB = 1024.0 * 1024.0;
+				for (uint32_t i = 0; i < 2; i++)
+				{
+					const auto& Result = s_RenderTargetBenchmark.Results[i];
+					ImGui::Text("%s: %.3f ms/frame, %.3f ms GPU, %.1f MB", PrecisionNames[i], Result.FrameMilliseconds, Result.GPUMilliseconds, Result.TargetBytes / BytesPerMB);
+				}
+			}
+
+			if (MeshBenchmark::IsVertexFormatBenchmarkPending())
+				ImGui::Text("Benchmarking vertex formats...");
+			else if (ImGui::Button("Benchmark Vertex Formats"))
+				MeshBenchmark::RequestVertexFormatBenchmark();
+
+			VertexFormatBenchmarkResult VertexFormatResult;
+			if (MeshBenchmark::GetVertexFormatResult(VertexFormatResult))
+			{
+				constexpr double BytesPerMB = 1024.0 * 1024.0;
+				const char* FormatNames[] = { "Full", "Packed" };
+				ImGui::Text("%u vertices, %u triangles", VertexFormatResult.VertexCount, VertexFormatResult.TriangleCount);
+				for (uint32_t i = 0; i < 2; i++)
+				{
+					const auto& Format = VertexFormatResult.Formats[i];
+					ImGui::Text("%s: %u B/vertex, %.2f MB, %.3f ms GPU/draw", FormatNames[i], Format.Stride, Format.VertexBufferBytes / BytesPerMB, Format.GPUMillisecondsPerDraw);
+				}
+				ImGui::Text("Packed error: normal %.4f deg, tangent %.4f deg", VertexFormatResult.MaxNormalErrorDegrees, VertexFormatResult.MaxTangentErrorDegrees);
+			}
+
+			if (MeshBenchmark::IsTangentBenchmarkPending())
+				ImGui::Text("Benchmarking tangent generation...");
+			else if (ImGui::Button("Benchmark Tangent Generation"))
+				MeshBenchmark::RequestTangentBenchmark();
+
+			TangentBenchmarkResult TangentResult;
+			if (MeshBenchmark::GetTangentResult(TangentResult))
+			{
+				ImGui::Text("%u triangles on %u threads: %.3f ms, %.1f M triangles/s", TangentResult.TriangleCount, TangentResult.ThreadCount, TangentResult.Milliseconds, TangentResult.MillionTrianglesPerSecond);
+				ImGui::Text("Max tangent error %.4f deg, orthogonality error %.6f", TangentResult.MaxTangentErrorDegrees, TangentResult.MaxOrthogonalityError);
+			}
+
+			if (TextureBenchmark::IsCompressionBenchmarkPending())
+				ImGui::Text("Benchmarking texture compression...");
+			else if (ImGui::Button("Benchmark Texture Compression"))
+				TextureBenchmark::RequestCompressionBenchmark();
+
+			TextureCompressionBenchmarkResult CompressionResult;
+			if (TextureBenchmark::GetCompressionResult(CompressionResult))
+			{
+				constexpr double BytesPerMB = 1024.0 * 1024.0;
+				ImGui::Text("%ux%u on %u threads, %.2f MB as RGBA8", CompressionResult.Width, CompressionResult.Height, CompressionResult.ThreadCount, CompressionResult.SourceBytes / BytesPerMB);
+				for (const TextureCompressionBenchmarkResult::Format& Format : CompressionResult.Formats)
+				{
+					ImGui::Text("%s: %.2f MB, %.2f ms, %.1f Mpixels/s, PSNR %.2f dB", TextureCompressor::GetFormatName(Format.BlockFormat),
+						Format.CompressedBytes / BytesPerMB, Format.Milliseconds, Format.MegapixelsPerSecond, Format.PSNR);
+				}
+			}
+
+			if (TextureBenchmark::IsMipBenchmarkPending())
+				ImGui::Text("Benchmarking mip generation...");
+			else if (ImGui::Button("Benchmark Mip Generation"))
+				TextureBenchmark::RequestMipBenchmark();
+
+			MipBenchmarkResult MipResult;
+			if (TextureBenchmark::GetMipResult(MipResult))
+			{
+				ImGui::Text("sRGB mip chains on %u threads", MipResult.ThreadCount);
+				for (const MipBenchmarkResult::Size& Size : MipResult.Sizes)
+				{
+					ImGui::Text("%ux%u: 2x2 reference %.2f ms, box %.2f ms, Kaiser %.2f ms", Size.Width, Size.Height,
+						Size.ReferenceMilliseconds, Size.BoxMilliseconds, Size.KaiserMilliseconds);
+				}
+			}
+		}
+
+		if (ImGui::CollapsingHeader("Level of Detail"))
+		{
+			UI::UIBool::Draw("LOD Enabled", &s_RenderSettings.LODEnabled);
+			UI::UIFloat::Draw("LOD Bias", &s_RenderSettings.LODBias);
+			s_RenderSettings.LODBias = glm::max(s_RenderSettings.LODBias, 0.0f);
+			UI::UIBool::Draw("GPU Driven Geometry", &s_RenderSettings.GPUDriven);
+
+			const char* MeshletCullingNames[] = { "Off", "CPU", "GPU" };
+			int MeshletCulling = static_cast<int>(s_RenderSettings.MeshletCulling);
+			if (ImGui::Combo("Meshlet Culling", &MeshletCulling, MeshletCullingNames, IM_ARRAYSIZE(MeshletCullingNames)))
+				s_RenderSettings.MeshletCulling = static_cast<MeshletCullingMode>(MeshletCulling);
+			UI::UIBool::Draw("Meshlet Cone Culling", &s_RenderSettings.MeshletConeCulling);
+
+			for (const Primitive PrimitiveType : { Primitive::Sphere, Primitive::Icosphere })
+			{
+				const Ref<Mesh>& PrimitiveMesh = Renderer::GetPrimitiveMesh(PrimitiveType);
+				ImGui::Text("%s:", MeshFactory::MeshPrimitiveToString(PrimitiveType).c_str());
+				for (uint32_t i = 0; i < PrimitiveMesh->GetLODCount(); i++)
+				{
+					const MeshLOD& LOD = PrimitiveMesh->GetLOD(i);
+					ImGui::Text("  LOD %u: %u triangles, error %.4f, below screen size %.3f", i, LOD.IndexCount / 3, LOD.Error, LOD.ScreenSize);
+				}
+				ImGui::Text("  %u meshlets", static_cast<uint32_t>(PrimitiveMesh->GetMeshlets().size()));
+			}
+		}
+
+		if (ImGui::CollapsingHeader("Texture Streaming"))
+		{
+			constexpr uint64_t BytesPerMB = 1024 * 1024;
+			int BudgetMB = static_cast<int>(TextureStreamer::GetBudget() / BytesPerMB);
+			if (ImGui::SliderInt("Budget (MB)", &BudgetMB, 1, 4096))
+				TextureStreamer::SetBudget(static_cast<uint64_t>(BudgetMB) * BytesPerMB);
+		}
+
+		if (ImGui::CollapsingHeader("Mesh Optimization"))
+		{
+			ImGui::Text("ACMR / ATVR / overdraw, before -> after");
+			for (uint32_t i = static_cast<uint32_t>(Primitive::Triangle); i <= static_cast<uint32_t>(Primitive::Skybox); i++)
+			{
+				const Primitive PrimitiveType = static_cast<Primitive>(i);
+				const MeshOptimizationReport& Report = Renderer::GetPrimitiveMesh(PrimitiveType)->GetOptimizationReport();
+				ImGui::Text("%s: %.3f -> %.3f / %.3f -> %.3f / %.3f -> %.3f (%.1f ms)", MeshFactory::MeshPrimitiveToString(PrimitiveType).c_str(),
+					Report.Before.ACMR, Report.After.ACMR, Report.Before.ATVR, Report.After.ATVR, Report.Before.Overdraw, Report.After.Overdraw, Report.Milliseconds);
+			}
 		}
 		
 		if (ImGui::CollapsingHeader("Bloom Settings"))
 		{
-			UI::UIBool::Draw("Bloom Enabled", &s_BloomProperties->BloomEnabled);
+			UI::UIBool::Draw("Bloom Enabled", &s_RenderSettings.BloomEnabled);
 
-			if(s_BloomProperties->BloomEnabled)
+			if(s_RenderSettings.BloomEnabled)
 			{
-				UI::UIFloat::Draw("Bloom Intensity", &s_BloomProperties->BloomIntensity);
-				UI::UIFloat::Draw("Bloom Threshold", &s_BloomProperties->BloomThreshold);
-				UI::UIFloat::Draw("Bloom Knee", &s_BloomProperties->BloomKnee);
+				UI::UIFloat::Draw("Bloom Intensity", &s_RenderSettings.BloomIntensity);
+				UI::UIFloat::Draw("Bloom Threshold", &s_RenderSettings.BloomThreshold);
+				UI::UIFloat::Draw("Bloom Knee", &s_RenderSettings.BloomKnee);
 
-				UI::UIBool::Draw("Bloom Dirt Enabled", &s_BloomProperties->BloomDirtEnabled);
-				if (s_BloomProperties->BloomEnabled)
-					UI::UIFloat::Draw("Bloom Dirt Intensity", &s_BloomProperties->BloomDirtIntensity);
+				UI::UIBool::Draw("Bloom Dirt Enabled", &s_RenderSettings.BloomDirtEnabled);
+				if (s_RenderSettings.BloomEnabled)
+					UI::UIFloat::Draw("Bloom Dirt Intensity", &s_RenderSettings.BloomDirtIntensity);
 				else
-					s_BloomProperties->BloomDirtIntensity = 0.0f;
+					s_RenderSettings.BloomDirtIntensity = 0.0f;
 
 				UI::UIBool::Draw("Display Compute Textures", &s_BloomProperties->DisplayBloomDebug);
 
 				if (s_BloomProperties->DisplayBloomDebug)
 				{
 					float aspect = static_cast<float>(ViewportSize.x) / static_cast<float>(ViewportSize.y);
-					ImGui::Image(reinterpret_cast<ImTextureID>(s_BloomProperties->BloomComputeTextures[0]->GetID()), { 300 * aspect, 300 }, { 0, 1 }, { 1, 0 });
-					ImGui::Image(reinterpret_cast<ImTextureID>(s_BloomProperties->BloomComputeTextures[1]->GetID()), { 300 * aspect, 300 }, { 0, 1 }, { 1, 0 });
-					ImGui::Image(reinterpret_cast<ImTextureID>(s_BloomProperties->BloomComputeTextures[2]->GetID()), { 300 * aspect, 300 }, { 0, 1 }, { 1, 0 });
+					FrameResults Results;
+					{
+						std::lock_guard<std::mutex> Lock(s_FrameResultsMutex);
+						Results = s_FrameResults;
+					}
+
+					// Bloom 2 shares storage with Bloom 3, so by now it shows the up-sampled result.
+					for (const uint32_t BloomTextureID : Results.BloomTextureIDs)
+					{
+						if (BloomTextureID == 0) continue;
+						ImGui::Image(reinterpret_cast<ImTextureID>(BloomTextureID), { 300 * aspect, 300 }, { 0, 1 }, { 1, 0 });
+					}
 				}
 			}
 		}
 		
+		if (ImGui::CollapsingHeader("Render Graph"))
+			s_RenderGraph->DrawUI();
+
 		if(ImGui::CollapsingHeader("Scene Information"))
 		{
 			UI::UIVector3::Draw("Camera Position", &s_Camera.GetPosition());
@@ -628,8 +1310,9 @@ namespace Ohm
 		}
 	}
 
-	const Ref<Framebuffer>& SceneRenderer::GetSceneCompositeFBO()
+	uint32_t SceneRenderer::GetSceneCompositeTextureID()
 	{
-		return s_SceneCompositePass->GetRenderPassSpecification().TargetFramebuffer;
+		std::lock_guard<std::mutex> Lock(s_FrameResultsMutex);
+		return s_FrameResults.CompositeTextureID;
 	}
 }
@@ -3,12 +3,25 @@
 #include "Ohm/Scene/Scene.h"
 #include "Ohm/Scene/Entity.h"
 #include "Ohm/Rendering/RenderPass.h"
+#include "Ohm/Rendering/RenderGraph.h"
+#include "Ohm/Rendering/RenderQueue.h"
+#include "Ohm/Rendering/GPUDrivenQueue.h"
+#include "Ohm/Rendering/MeshletQueue.h"
+#include "Ohm/Rendering/FramePacket.h"
+#include "Ohm/Rendering/FrustumCuller.h"
+#include "Ohm/Rendering/Shader.h"
 #include "Ohm/Rendering/EditorCamera.h"
 #include "Ohm/Event/Event.h"
 #include "Ohm/Rendering/Texture2D.h"
 
 namespace Ohm
 {
+	/*
+	 * A frame is built and rendered in two steps.  BuildFramePacket runs on the main thread: it culls the scene and
+	 * copies the camera, lights and settings into a FramePacket.  RenderFramePacket only reads that packet and does
+	 * all of the GL work.  Single threaded, SubmitPipeline runs both back to back; with a render thread, the packet
+	 * is handed to the render thread and rendered while the main thread builds the next one.
+	 */
 	class SceneRenderer
 	{
 	public:
@@ -21,16 +34,20 @@ namespace Ohm
 		static void SubmitPipeline();
 		static void OnEvent(Event& e);
 
+		static void BuildFramePacket(FramePacket& packet);
+		static void RenderFramePacket(const FramePacket& packet);
+
 		static void ValidateResize(glm::vec2 viewportSize);
 		static void DrawTextureViewerUI();
 		static void DrawSceneRendererUI(const glm::vec2 ViewportSize);
-		static const Ref<Framebuffer>& GetSceneCompositeFBO();
+		// Color attachment of the composite target as of the last rendered frame.
+		static uint32_t GetSceneCompositeTextureID();
 		static EditorCamera& GetCamera() { return s_Camera;}
 
 	private:
 		static void InitializeUI();
 
-		static void UploadPBRSamplers(const Ref<Material>& material);
+		static void UploadPBRSamplers(const Ref<Material>& material, const EnvironmentLightData& environmentLight);
 		
 		static void InitializeGeometryPass();
 		static void InitializeDebugDepthPass();
@@ -38,11 +55,20 @@ namespace Ohm
 		static void InitializeBloomPass();
 		static void InitializeSceneCompositePass();
 
-		static void GeometryPass();
-		static void DebugVisualizeDepthPass();
-		static void EnvironmentPass();
-		static void BloomPass();
-		static void SceneCompositePass();
+		static void GeometryPass(const FramePacket& packet);
+		static void DebugVisualizeDepthPass(const FramePacket& packet);
+		static void EnvironmentPass(const FramePacket& packet);
+		static void BloomDownsamplePass(const FramePacket& packet);
+		static void BloomUpsamplePass();
+		static void SceneCompositePass(const FramePacket& packet);
+
+		static uint32_t GatherGeometry(FrustumCuller* culler);
+		static void RecordGeometryCommands(FramePacket& packet);
+		static void RecordIndirectGeometry(FramePacket& packet);
+		static void RequestStreamedTextures();
+		static void SaveTextureViewerImage(const FramePacket& packet);
+		static void PublishFrameResults();
+		static void UpdateRenderTargetBenchmark();
 
 	private:
 		static Ref<Scene> s_ActiveScene;
@@ -52,41 +78,103 @@ namespace Ohm
 		static Ref<RenderPass> s_GeometryPass;
 		static Ref<RenderPass> s_SkyboxGeometryPass;
 		static Ref<RenderPass> s_DebugDepthPass;
-		static Ref<RenderPass> s_EnvironmentPass;
 		static Ref<RenderPass> s_BloomPass;
 		static Ref<RenderPass> s_SceneCompositePass;
 
-		struct SceneRenderProperties
-		{
-			float Exposure = 1.0f;
-			bool ApplyColorCorrection = true;
-		};
-		static Ref<SceneRenderProperties> s_SceneRenderProperties;
+		// Edited by the UI and copied into every packet; the passes only ever read the packet's copy.
+		static SceneRenderSettings s_RenderSettings;
+		// Used to build and render in place when there is no render thread.
+		static FramePacket s_FramePacket;
 
 		struct BloomProperties
 		{
 			Ref<Shader> BloomShader{};
+			struct
+			{
+				UniformHandle Params;
+				UniformHandle LOD;
+				UniformHandle Mode;
+				UniformHandle Texture;
+				UniformHandle BloomTexture;
+			} Uniforms;
+			// Assigned from the render graph each frame; empty entries belong to passes culled this frame.
 			std::vector<Ref<Texture2D>> BloomComputeTextures{};
+			Texture2DSpecification BloomTextureSpecification{};
+			TextureUtils::TextureShaderDataFormat BloomImageFormat = TextureUtils::TextureShaderDataFormat::R11FG11FB10F;
 			Ref<Texture2D> BloomDirtTexture{};
 			const uint32_t BloomWorkGroupSize = 4;
 
 			bool DisplayBloomDebug = false;
-			bool BloomEnabled = true;
-			bool BloomDirtEnabled = true;
-			float BloomThreshold = 2.0f;
-			float BloomKnee = 0.220f;
-			float BloomIntensity = 0.2f;
-			float BloomDirtIntensity = 0.1f;
 		};
 		static Ref<BloomProperties> s_BloomProperties;
 
+		static Ref<RenderQueue> s_GeometryQueue;
+		static Ref<GPUDrivenQueue> s_GPUDrivenQueue;
+		static Ref<MeshletQueue> s_MeshletQueue;
+		static MeshletCuller s_MeshletCuller;
+		static Ref<FrustumCuller> s_GeometryCuller;
+		static Ref<RenderGraph> s_RenderGraph;
+
+		// Per-entity scratch for recording geometry, indexed like the flattened entity view.
+		struct GeometryRecording
+		{
+			static constexpr uint32_t ChunkSize = 1024;
+
+			std::vector<entt::entity> Entities;
+			std::vector<glm::mat4> Transforms;
+			std::vector<uint8_t> Drawable;
+			// What each entity draws, from its MeshRendererComponent or else its primitive.  They point into the
+			// components and the Renderer's primitives, neither of which change while a frame is recorded.
+			std::vector<const Ref<Mesh>*> Meshes;
+			std::vector<const Ref<Material>*> Materials;
+			// Per recording thread, the most pixels a unit of UV covered for each material drawn; see TextureStreamer.
+			std::vector<std::unordered_map<const Material*, float>> TextureDemand;
+		};
+		static GeometryRecording s_GeometryRecording;
+
 		struct Benchmarks
 		{
 			float LastEnvironmentMappingPassTime = 0.0f;
 			float LastPPTransmittancePassTime = 0.0;
 			float LastSkyCompositionPassTime = 0.0;
 		};
+		// Renders the scene with Full and then Reduced precision targets and averages the frame times of each.
+		struct RenderTargetBenchmark
+		{
+			static constexpr uint32_t WarmupFrames = 16;
+			static constexpr uint32_t MeasuredFrames = 240;
+
+			struct Result
+			{
+				float FrameMilliseconds = 0.0f;
+				float GPUMilliseconds = 0.0f;
+				uint64_t TargetBytes = 0;
+			};
+
+			bool Running = false;
+			bool HasResults = false;
+			// Index into Results and the precision currently being measured.
+			uint32_t Run = 0;
+			uint32_t Frame = 0;
+			RenderTargetPrecision RestorePrecision = RenderTargetPrecision::Reduced;
+			Result Results[2];
+		};
+		static RenderTargetBenchmark s_RenderTargetBenchmark;
+
+		// What the UI shows of the last rendered frame, published by the thread that rendered it.
+		struct FrameResults
+		{
+			uint32_t CompositeTextureID = 0;
+			uint32_t SceneTextureID = 0;
+			uint32_t DepthTextureID = 0;
+			uint32_t BloomTextureIDs[3]{};
+		};
+		static FrameResults s_FrameResults;
+
 		static glm::vec2 s_ViewportSize;
 		static float s_ImageViewerSizeFactor;
+		// Texture viewer image the UI asked to save, written out by the next frame rendered.
+		static int32_t s_PendingSaveImageIndex;
+		static std::string s_PendingSaveImagePath;
 	};
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "ohmpch.h"
 #include "Ohm/Rendering/Shader.h"
+#include "Ohm/Rendering/RenderCommand.h"
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 #include "Ohm/Rendering/Material.h"
@@ -50,6 +51,7 @@ namespace Ohm
 
 		std::string source = ReadFile(filePath);
 		AddIncludeFiles(source);
+		ExtractParameterBlockDefaults(source);
 		const auto shaderSources = PreProcess(source);
 		Compile(shaderSources);
 		Reflect();
@@ -62,12 +64,12 @@ namespace Ohm
 
 	void Shader::Bind() const
 	{
-		glUseProgram(m_ID);
+		RenderCommand::BindProgram(m_ID);
 	}
 
 	void Shader::Unbind() const
 	{
-		glUseProgram(0);
+		RenderCommand::BindProgram(0);
 	}
 
 	std::string Shader::ReadFile(const std::string& filePath)
@@ -160,7 +162,7 @@ namespace Ohm
 
 	void Shader::ClearBinding()
 	{
-		glUseProgram(0);
+		RenderCommand::BindProgram(0);
 	}
 
 	std::unordered_map<GLenum, std::string> Shader::PreProcess(const std::string& source)
@@ -211,6 +213,118 @@ namespace Ohm
 		}
 	}
 
+	void Shader::ExtractParameterBlockDefaults(std::string& outSource)
+	{
+		const size_t blockPosition = outSource.find(ParameterBlockName);
+		if (blockPosition == std::string::npos)
+			return;
+
+		const size_t blockBegin = outSource.find('{', blockPosition);
+		const size_t blockEnd = outSource.find('}', blockBegin);
+		if (blockBegin == std::string::npos || blockEnd == std::string::npos)
+			return;
+
+		std::string block = outSource.substr(blockBegin + 1, blockEnd - blockBegin - 1);
+		std::string strippedBlock;
+
+		size_t declarationBegin = 0;
+		size_t declarationEnd = block.find(';');
+		while (declarationEnd != std::string::npos)
+		{
+			std::string declaration = block.substr(declarationBegin, declarationEnd - declarationBegin);
+
+			const size_t assignment = declaration.find('=');
+			if (assignment != std::string::npos)
+			{
+				// "vec3 AlbedoColor = vec3(1.0)" -> name "AlbedoColor", values { 1.0 }
+				std::string lhs = declaration.substr(0, assignment);
+				lhs.erase(lhs.find_last_not_of(" \t\r\n") + 1);
+				const std::string name = lhs.substr(lhs.find_last_of(" \t\r\n") + 1);
+
+				// Only the constructor's arguments hold values; the digit in "vec3" is part of its name.
+				std::string arguments = declaration.substr(assignment + 1);
+				const size_t argumentsBegin = arguments.find('(');
+				if (argumentsBegin != std::string::npos)
+					arguments = arguments.substr(argumentsBegin + 1, arguments.rfind(')') - argumentsBegin - 1);
+
+				std::vector<float> values;
+				const char* cursor = arguments.c_str();
+				while (*cursor)
+				{
+					const bool tokenStart = cursor == arguments.c_str() || !(std::isalnum(static_cast<unsigned char>(cursor[-1])) || cursor[-1] == '_');
+					if (tokenStart && (std::isdigit(static_cast<unsigned char>(*cursor)) || *cursor == '-' || *cursor == '.'))
+					{
+						char* next = nullptr;
+						const float value = std::strtof(cursor, &next);
+						if (next == cursor)
+						{
+							cursor++;
+							continue;
+						}
+						values.push_back(value);
+						cursor = next;
+						// Skip float suffixes such as "1.0f".
+						if (*cursor == 'f' || *cursor == 'F')
+							cursor++;
+					}
+					else
+						cursor++;
+				}
+
+				m_ParameterDefaultValues[name] = values;
+				declaration = declaration.substr(0, assignment);
+			}
+
+			strippedBlock += declaration + ";";
+			declarationBegin = declarationEnd + 1;
+			declarationEnd = block.find(';', declarationBegin);
+		}
+
+		strippedBlock += block.substr(declarationBegin);
+		outSource.replace(blockBegin + 1, blockEnd - blockBegin - 1, strippedBlock);
+	}
+
+	void Shader::WriteParameterBlockDefaults()
+	{
+		if (m_ParameterBlockSize == 0)
+			return;
+
+		m_ParameterBlockDefaults.Allocate(m_ParameterBlockSize);
+		m_ParameterBlockDefaults.ZeroInitialize();
+
+		for (const auto& [name, values] : m_ParameterDefaultValues)
+		{
+			const auto it = m_BaseBlockUniforms.find(name);
+			if (it == m_BaseBlockUniforms.end() || !it->second.IsParameterBlockMember() || values.empty())
+				continue;
+
+			const ShaderUniform& uniform = it->second;
+			const uint32_t componentCount = ShaderDataTypeSize(uniform.GetType()) / 4;
+
+			// Matrices don't share the tightly packed layout in std140, they're left zeroed.
+			if (componentCount > 4)
+				continue;
+
+			for (uint32_t component = 0; component < componentCount; component++)
+			{
+				// A single value splats across every component, matching GLSL's vecN(x) constructor.
+				const float value = values[values.size() == 1 ? 0 : std::min<size_t>(component, values.size() - 1)];
+				const uint32_t offset = uniform.GetBufferOffset() + component * 4;
+
+				if (uniform.GetType() == ShaderDataType::Int)
+				{
+					int intValue = static_cast<int>(value);
+					m_ParameterBlockDefaults.Write<int>(&intValue, sizeof(int), offset);
+				}
+				else
+				{
+					float floatValue = value;
+					m_ParameterBlockDefaults.Write<float>(&floatValue, sizeof(float), offset);
+				}
+			}
+		}
+	}
+
 	void* Shader::GetUniformData(ShaderDataType type, GLint location)
 	{
 		switch (type)
@@ -428,11 +542,23 @@ namespace Ohm
 
 			std::string name(nameBuffer.data(), nameLength);
 
-			m_Blocks[name] = ShaderBlock(name, blockSize, activeCount, binding, blockIndices[i]);
-
 			registeredBlockIndices.push_back(blockIndices[i]);
+
+			// The parameter block is backed by each material's own buffer, so it doesn't get a shared ShaderBlock.
+			if (name == ParameterBlockName)
+			{
+				m_ParameterBlockIndex = blockIndices[i];
+				m_ParameterBlockSize = blockSize;
+				m_ParameterBlockBinding = binding;
+				continue;
+			}
+
+			m_Blocks[name] = ShaderBlock(name, blockSize, activeCount, binding, blockIndices[i]);
 		}
 
+		// Loose uniforms are staged after the parameter block.
+		currentOffset = m_ParameterBlockSize;
+
 		m_NamedBlockUniformCount = 0;
 		m_DefaultBlockUniformCount = 0;
 
@@ -454,7 +580,19 @@ namespace Ohm
 
 			ShaderUniform uniform(name, location, shaderDataType, size, count, blockOffset);
 
-			if (blockIndices[i] != -1)
+			const UniformHandle handle { static_cast<uint32_t>(m_UniformLocations.size()) };
+			m_UniformLocations.push_back(location);
+			m_UniformHandleIndices[name] = handle.Index;
+			uniform.SetHandle(handle);
+
+			if (blockIndices[i] != -1 && blockIndices[i] == m_ParameterBlockIndex)
+			{
+				uniform.SetBufferOffsetForParameterBlockUniform(blockOffset);
+
+				m_DefaultBlockUniformCount++;
+				m_BaseBlockUniforms[name] = uniform;
+			}
+			else if (blockIndices[i] != -1)
 			{
 				// Add the uniform to it's respective block.
 
@@ -480,6 +618,9 @@ namespace Ohm
 				m_BaseBlockUniforms[name] = uniform;
 			}
 		}
+
+		m_BaseBlockStorageSize = currentOffset;
+		WriteParameterBlockDefaults();
 	}
 
 	GLint Shader::UploadUniformBool(const std::string& name, bool value)
@@ -577,6 +718,53 @@ namespace Ohm
 		return location;
 	}
 
+	UniformHandle Shader::GetUniformHandle(const std::string& name) const
+	{
+		const auto it = m_UniformHandleIndices.find(name);
+		if (it == m_UniformHandleIndices.end())
+		{
+			OHM_CORE_WARN("Shader: '{}' has no active uniform named '{}'.", m_Name, name);
+			return {};
+		}
+
+		return { it->second };
+	}
+
+	void Shader::UploadUniformFloat(UniformHandle handle, float value) const
+	{
+		glUniform1f(GetUniformLocation(handle), value);
+	}
+
+	void Shader::UploadUniformFloat2(UniformHandle handle, const glm::vec2& value) const
+	{
+		glUniform2f(GetUniformLocation(handle), value.x, value.y);
+	}
+
+	void Shader::UploadUniformFloat3(UniformHandle handle, const glm::vec3& value) const
+	{
+		glUniform3f(GetUniformLocation(handle), value.x, value.y, value.z);
+	}
+
+	void Shader::UploadUniformFloat4(UniformHandle handle, const glm::vec4& value) const
+	{
+		glUniform4f(GetUniformLocation(handle), value.x, value.y, value.z, value.w);
+	}
+
+	void Shader::UploadUniformInt(UniformHandle handle, int value) const
+	{
+		glUniform1i(GetUniformLocation(handle), value);
+	}
+
+	void Shader::UploadUniformMat3(UniformHandle handle, const glm::mat3& matrix) const
+	{
+		glUniformMatrix3fv(GetUniformLocation(handle), 1, GL_FALSE, glm::value_ptr(matrix));
+	}
+
+	void Shader::UploadUniformMat4(UniformHandle handle, const glm::mat4& matrix) const
+	{
+		glUniformMatrix4fv(GetUniformLocation(handle), 1, GL_FALSE, glm::value_ptr(matrix));
+	}
+
 	void Shader::EnableAllBarriersBits()
 	{
 		glMemoryBarrier(GL_ALL_BARRIER_BITS);
@@ -606,6 +794,11 @@ namespace Ohm
 	{
 		glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
 	}
+
+	void Shader::EnableCommandBarrierBit()
+	{
+		glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+	}
 	
 	void Shader::DispatchCompute(uint32_t groupX, uint32_t groupY, uint32_t groupZ)
 	{
@@ -615,17 +808,17 @@ namespace Ohm
 			return;
 		}
 
-		glUseProgram(m_ID);
+		RenderCommand::BindProgram(m_ID);
 		glDispatchCompute(groupX, groupY, groupZ);
 	}
 
-	std::unordered_map<std::string, Ref<Shader>> ShaderLibrary::s_ShaderLibrary;
+	HandlePool<Shader> ShaderLibrary::s_ShaderLibrary;
 
 	void ShaderLibrary::Add(const Ref<Shader>& shader)
 	{
-		if (s_ShaderLibrary.find(shader->GetName()) == s_ShaderLibrary.end())
+		if (!s_ShaderLibrary.Contains(shader->GetName()))
 		{
-			s_ShaderLibrary[shader->GetName()] = shader;
+			s_ShaderLibrary.Add(shader, shader->GetName());
 		}
 		else
 		{
@@ -641,8 +834,18 @@ namespace Ohm
 
 	const Ref<Shader>& ShaderLibrary::Get(const std::string& name)
 	{
-		ASSERT(s_ShaderLibrary.find(name) != s_ShaderLibrary.end(), "No shader with name: '{}' found in Shader Library.", name);
-		return s_ShaderLibrary.at(name);
+		ASSERT(s_ShaderLibrary.Contains(name), "No shader with name: '{}' found in Shader Library.", name);
+		return s_ShaderLibrary.Get(s_ShaderLibrary.Find(name));
+	}
+
+	const Ref<Shader>& ShaderLibrary::Get(ShaderHandle handle)
+	{
+		return s_ShaderLibrary.Get(handle);
+	}
+
+	ShaderHandle ShaderLibrary::GetHandle(const std::string& name)
+	{
+		return s_ShaderLibrary.Find(name);
 	}
 }
 
@@ -2,6 +2,8 @@
 
 #include "glm/glm.hpp"
 #include "Ohm/Core/Memory.h"
+#include "Ohm/Core/Buffer.h"
+#include "Ohm/Core/Handle.h"
 #include "Ohm/Rendering/BufferLayout.h"
 #include "Ohm/Rendering/UniformBuffer.h"
 
@@ -24,6 +26,15 @@ namespace Ohm
 		Bool
 	};
 
+	// Index into a shader's resolved uniform location table.  Resolve once with Shader::GetUniformHandle and
+	// reuse it every frame; handles are only meaningful for the shader that produced them.
+	struct UniformHandle
+	{
+		uint32_t Index = UINT32_MAX;
+
+		bool IsValid() const { return Index != UINT32_MAX; }
+	};
+
 	class ShaderUniform
 	{
 	public:
@@ -37,7 +48,11 @@ namespace Ohm
 		uint32_t GetSize() const { return m_Size; }
 		int32_t GetBlockOffset() const { return m_BlockOffset; }
 		uint32_t GetBufferOffset() const { return m_BufferOffset; }
+		UniformHandle GetHandle() const { return m_Handle; }
+		bool IsParameterBlockMember() const { return m_IsParameterBlockMember; }
 		void SetBufferOffsetForDefaultBlockUniform(uint32_t offset) { m_BufferOffset = offset; }
+		void SetBufferOffsetForParameterBlockUniform(uint32_t offset) { m_BufferOffset = offset; m_IsParameterBlockMember = true; }
+		void SetHandle(UniformHandle handle) { m_Handle = handle; }
 
 	private:
 
@@ -48,6 +63,8 @@ namespace Ohm
 		uint32_t m_Size = 0;
 		int32_t m_BlockOffset = 0;
 		uint32_t m_BufferOffset = 0;
+		UniformHandle m_Handle{};
+		bool m_IsParameterBlockMember = false;
 	};
 
 	class ShaderBlock
@@ -103,6 +120,16 @@ namespace Ohm
 		const std::unordered_map<std::string, ShaderBlock> GetNamedBlocks() { return m_Blocks; }
 		std::vector<ShaderUniform> GetBaseBlockUniformsOfType(ShaderDataType Type);
 
+		// Material parameters declared inside a 'uniform MaterialParameters { ... }' block are exposed through the
+		// base block uniforms like any other uniform, but occupy the first GetParameterBlockSize() bytes of a
+		// material's storage in std140 layout so they can be uploaded as a single UBO range.
+		static constexpr const char* ParameterBlockName = "MaterialParameters";
+		bool HasParameterBlock() const { return m_ParameterBlockSize > 0; }
+		uint32_t GetParameterBlockSize() const { return m_ParameterBlockSize; }
+		uint32_t GetParameterBlockBinding() const { return m_ParameterBlockBinding; }
+		const Buffer& GetParameterBlockDefaults() const { return m_ParameterBlockDefaults; }
+		uint32_t GetBaseBlockStorageSize() const { return m_BaseBlockStorageSize; }
+
 		GLint UploadUniformFloat(const std::string& name, float value);
 		GLint UploadUniformFloat2(const std::string& name, const glm::vec2& value);
 		GLint UploadUniformFloat3(const std::string& name, const glm::vec3& value);
@@ -114,12 +141,25 @@ namespace Ohm
 		GLint UploadUniformMat4(const std::string& name, const glm::mat4& matrix);
 		GLint UploadUniformFloat2Array(const std::string& name, uint32_t count, glm::vec2* value);
 		GLint UploadUniformFloat3Array(const std::string& name, uint32_t count, glm::vec3* value);
+
+		UniformHandle GetUniformHandle(const std::string& name) const;
+		GLint GetUniformLocation(UniformHandle handle) const { return handle.Index < m_UniformLocations.size() ? m_UniformLocations[handle.Index] : -1; }
+
+		void UploadUniformFloat(UniformHandle handle, float value) const;
+		void UploadUniformFloat2(UniformHandle handle, const glm::vec2& value) const;
+		void UploadUniformFloat3(UniformHandle handle, const glm::vec3& value) const;
+		void UploadUniformFloat4(UniformHandle handle, const glm::vec4& value) const;
+		void UploadUniformInt(UniformHandle handle, int value) const;
+		void UploadUniformMat3(UniformHandle handle, const glm::mat3& matrix) const;
+		void UploadUniformMat4(UniformHandle handle, const glm::mat4& matrix) const;
 		void* GetUniformData(ShaderDataType type, GLint location);
 
 		void EnableTextureFetchBarrierBit();
 		void EnableShaderStorageBarrierBit();
 		void EnableAtomicCounterBarrierBit();
 		void EnableBufferUpdateBarrierBit();
+		// Indirect draw and dispatch parameters written by shaders.
+		void EnableCommandBarrierBit();
 		void LogShaderData();
 		static void ClearBinding();
 
@@ -133,10 +173,25 @@ namespace Ohm
 		void Compile(const std::unordered_map<GLenum, std::string>& shaderSources);
 		void Reflect();
 		void AddIncludeFiles(std::string& outSource);
+		void ExtractParameterBlockDefaults(std::string& outSource);
+		void WriteParameterBlockDefaults();
 
 	private:
 		std::unordered_map<std::string, ShaderUniform> m_BaseBlockUniforms;
 		std::unordered_map<std::string, ShaderBlock> m_Blocks;
+
+		// Built by Reflect().  Handles index m_UniformLocations directly, the name map is only used to resolve them.
+		std::vector<GLint> m_UniformLocations;
+		std::unordered_map<std::string, uint32_t> m_UniformHandleIndices;
+
+		// GLSL doesn't allow initializers on block members, so they're stripped from the source and kept here.
+		std::unordered_map<std::string, std::vector<float>> m_ParameterDefaultValues;
+		Buffer m_ParameterBlockDefaults;
+		GLint m_ParameterBlockIndex = -1;
+		uint32_t m_ParameterBlockSize = 0;
+		uint32_t m_ParameterBlockBinding = 0;
+		uint32_t m_BaseBlockStorageSize = 0;
+
 		uint32_t m_ActiveTotalUniformCount = 0;
 		uint32_t m_NamedBlockUniformCount = 0;
 		uint32_t m_DefaultBlockUniformCount = 0;
@@ -145,6 +200,10 @@ namespace Ohm
 		bool m_IsCompute = false;
 	};
 
+	using ShaderHandle = Handle<Shader>;
+
+	// Shaders are loaded once, on the main thread, before anything renders.  Keep a handle or the shader itself
+	// rather than looking one up by name every frame.
 	class ShaderLibrary
 	{
 	public:
@@ -152,9 +211,12 @@ namespace Ohm
 		static void Load(const std::string& filePath);
 
 		static const Ref<Shader>& Get(const std::string& name);
+		static const Ref<Shader>& Get(ShaderHandle handle);
+		// An invalid handle if no shader by that name has been added.
+		static ShaderHandle GetHandle(const std::string& name);
 
 	private:
-		static std::unordered_map<std::string, Ref<Shader>> s_ShaderLibrary;
+		static HandlePool<Shader> s_ShaderLibrary;
 	};
 }
 
@@ -0,0 +1,42 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/StorageBuffer.h"
+#include "Ohm/Rendering/RenderCommand.h"
+#include <glad/glad.h>
+
+namespace Ohm
+{
+	StorageBuffer::StorageBuffer(uint32_t size, uint32_t binding)
+		:m_Size(size), m_Binding(binding)
+	{
+		glCreateBuffers(1, &m_ID);
+		glNamedBufferData(m_ID, size, nullptr, GL_DYNAMIC_DRAW);
+		RenderCommand::BindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, m_ID);
+	}
+
+	StorageBuffer::~StorageBuffer()
+	{
+		glDeleteBuffers(1, &m_ID);
+		RenderCommand::InvalidateStateCache();
+	}
+
+	void StorageBuffer::SetData(const void* data, uint32_t size, uint32_t offset /*= 0*/)
+	{
+		if (offset + size > m_Size)
+			Resize(offset + size);
+
+		RenderCommand::BindBufferBase(GL_SHADER_STORAGE_BUFFER, m_Binding, m_ID);
+		glNamedBufferSubData(m_ID, offset, size, data);
+	}
+
+	void StorageBuffer::Resize(uint32_t size)
+	{
+		// Grow geometrically so a slowly increasing entity count doesn't reallocate every frame.
+		uint32_t newSize = m_Size ? m_Size : 1;
+		while (newSize < size)
+			newSize *= 2;
+
+		m_Size = newSize;
+		glNamedBufferData(m_ID, m_Size, nullptr, GL_DYNAMIC_DRAW);
+		RenderCommand::BindBufferBase(GL_SHADER_STORAGE_BUFFER, m_Binding, m_ID);
+	}
+}
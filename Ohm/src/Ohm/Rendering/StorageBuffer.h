@@ -0,0 +1,23 @@
+#pragma once
+
+namespace Ohm
+{
+	class StorageBuffer
+	{
+	public:
+		StorageBuffer(uint32_t size, uint32_t binding);
+		~StorageBuffer();
+
+		void SetData(const void* data, uint32_t size, uint32_t offset = 0);
+		void Resize(uint32_t size);
+
+		uint32_t GetSize() const { return m_Size; }
+		uint32_t GetBinding() const { return m_Binding; }
+		uint32_t GetID() const { return m_ID; }
+
+	private:
+		uint32_t m_Size;
+		uint32_t m_Binding;
+		uint32_t m_ID;
+	};
+}
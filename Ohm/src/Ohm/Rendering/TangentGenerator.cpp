@@ -0,0 +1,263 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/TangentGenerator.h"
+#include "Ohm/Core/JobSystem.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define OHM_TANGENT_SSE
+#endif
+
+namespace Ohm
+{
+	static constexpr uint32_t TriangleChunkSize = 4096;
+	static constexpr uint32_t VertexChunkSize = 4096;
+	static constexpr float Epsilon = 1e-20f;
+	static constexpr float Pi = 3.14159265359f;
+
+	// What each triangle leaves at each of its corners.  Corner k of triangle t is at k * TriangleCount + t, so the
+	// SIMD path writes four triangles' corners with one store.
+	struct CornerTangents
+	{
+		// Tangent projected onto the corner's normal plane, scaled by the corner's angle.  Zero when the triangle
+		// has no usable texture coordinates.
+		std::vector<float> X, Y, Z;
+		std::vector<uint8_t> Mirrored;
+	};
+
+	// Abramowitz and Stegun 4.4.45, within 7e-5 radians; plenty for a weight.  The SIMD path uses the same formula, so
+	// a triangle's result doesn't depend on which path it took.
+	static float FastAcos(float x)
+	{
+		const float Magnitude = glm::abs(x);
+		const float Result = glm::sqrt(1.0f - Magnitude) * (1.5707288f + Magnitude * (-0.2121144f + Magnitude * (0.0742610f + Magnitude * -0.0187293f)));
+		return x < 0.0f ? Pi - Result : Result;
+	}
+
+	static void ProcessTrianglesScalar(const std::vector<Vertex>& vertices, const uint32_t* indices, uint32_t triangleCount, uint32_t begin, uint32_t end, CornerTangents& corners)
+	{
+		for (uint32_t Triangle = begin; Triangle < end; Triangle++)
+		{
+			const Vertex* Corners[3] = { &vertices[indices[Triangle * 3 + 0]], &vertices[indices[Triangle * 3 + 1]], &vertices[indices[Triangle * 3 + 2]] };
+
+			const glm::vec3 Edge1 = Corners[1]->Position - Corners[0]->Position;
+			const glm::vec3 Edge2 = Corners[2]->Position - Corners[0]->Position;
+			const glm::vec2 DeltaUV1 = Corners[1]->TexCoord - Corners[0]->TexCoord;
+			const glm::vec2 DeltaUV2 = Corners[2]->TexCoord - Corners[0]->TexCoord;
+			const float Determinant = DeltaUV1.x * DeltaUV2.y - DeltaUV2.x * DeltaUV1.y;
+
+			// Only the directions matter; the determinant's sign keeps them pointing along +U and +V.
+			const float Sign = Determinant < 0.0f ? -1.0f : 1.0f;
+			const glm::vec3 Tangent = Sign * (DeltaUV2.y * Edge1 - DeltaUV1.y * Edge2);
+			const glm::vec3 Binormal = Sign * (DeltaUV1.x * Edge2 - DeltaUV2.x * Edge1);
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				const glm::vec3& Normal = Corners[k]->Normal;
+				const glm::vec3 Projected = Tangent - Normal * glm::dot(Normal, Tangent);
+				const float ProjectedLength2 = glm::dot(Projected, Projected);
+
+				glm::vec3 ToNext = Corners[(k + 1) % 3]->Position - Corners[k]->Position;
+				glm::vec3 ToPrevious = Corners[(k + 2) % 3]->Position - Corners[k]->Position;
+				ToNext -= Normal * glm::dot(Normal, ToNext);
+				ToPrevious -= Normal * glm::dot(Normal, ToPrevious);
+				const float Cosine = glm::dot(ToNext, ToPrevious) / glm::sqrt(glm::max(glm::dot(ToNext, ToNext) * glm::dot(ToPrevious, ToPrevious), Epsilon));
+				const float Angle = FastAcos(glm::clamp(Cosine, -1.0f, 1.0f));
+
+				const bool Usable = Determinant != 0.0f && ProjectedLength2 > Epsilon;
+				const glm::vec3 Weighted = Usable ? Projected * (Angle / glm::sqrt(ProjectedLength2)) : glm::vec3(0.0f);
+
+				const uint32_t Corner = k * triangleCount + Triangle;
+				corners.X[Corner] = Weighted.x;
+				corners.Y[Corner] = Weighted.y;
+				corners.Z[Corner] = Weighted.z;
+				corners.Mirrored[Corner] = glm::dot(glm::cross(Normal, Projected), Binormal) < 0.0f ? 1 : 0;
+			}
+		}
+	}
+
+#if defined(OHM_TANGENT_SSE)
+	struct Vec3x4
+	{
+		__m128 X, Y, Z;
+	};
+
+	static inline Vec3x4 Sub(const Vec3x4& a, const Vec3x4& b) { return { _mm_sub_ps(a.X, b.X), _mm_sub_ps(a.Y, b.Y), _mm_sub_ps(a.Z, b.Z) }; }
+	static inline Vec3x4 Scale(const Vec3x4& a, __m128 s) { return { _mm_mul_ps(a.X, s), _mm_mul_ps(a.Y, s), _mm_mul_ps(a.Z, s) }; }
+	static inline Vec3x4 FlipSign(const Vec3x4& a, __m128 signBits) { return { _mm_xor_ps(a.X, signBits), _mm_xor_ps(a.Y, signBits), _mm_xor_ps(a.Z, signBits) }; }
+
+	static inline __m128 Dot(const Vec3x4& a, const Vec3x4& b)
+	{
+		return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.X, b.X), _mm_mul_ps(a.Y, b.Y)), _mm_mul_ps(a.Z, b.Z));
+	}
+
+	static inline Vec3x4 Cross(const Vec3x4& a, const Vec3x4& b)
+	{
+		return
+		{
+			_mm_sub_ps(_mm_mul_ps(a.Y, b.Z), _mm_mul_ps(a.Z, b.Y)),
+			_mm_sub_ps(_mm_mul_ps(a.Z, b.X), _mm_mul_ps(a.X, b.Z)),
+			_mm_sub_ps(_mm_mul_ps(a.X, b.Y), _mm_mul_ps(a.Y, b.X))
+		};
+	}
+
+	// Removes the component along the unit vector n.
+	static inline Vec3x4 Reject(const Vec3x4& a, const Vec3x4& n) { return Sub(a, Scale(n, Dot(n, a))); }
+
+	static inline __m128 FastAcos(__m128 x)
+	{
+		const __m128 SignBit = _mm_set1_ps(-0.0f);
+		const __m128 Magnitude = _mm_andnot_ps(SignBit, x);
+		__m128 Polynomial = _mm_add_ps(_mm_set1_ps(0.0742610f), _mm_mul_ps(Magnitude, _mm_set1_ps(-0.0187293f)));
+		Polynomial = _mm_add_ps(_mm_set1_ps(-0.2121144f), _mm_mul_ps(Magnitude, Polynomial));
+		Polynomial = _mm_add_ps(_mm_set1_ps(1.5707288f), _mm_mul_ps(Magnitude, Polynomial));
+		const __m128 Result = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), Magnitude)), Polynomial);
+
+		const __m128 Negative = _mm_cmplt_ps(x, _mm_setzero_ps());
+		const __m128 Mirrored = _mm_sub_ps(_mm_set1_ps(Pi), Result);
+		return _mm_or_ps(_mm_and_ps(Negative, Mirrored), _mm_andnot_ps(Negative, Result));
+	}
+
+	static inline Vec3x4 Gather(const glm::vec3* (&v)[4]) { return { _mm_setr_ps(v[0]->x, v[1]->x, v[2]->x, v[3]->x), _mm_setr_ps(v[0]->y, v[1]->y, v[2]->y, v[3]->y), _mm_setr_ps(v[0]->z, v[1]->z, v[2]->z, v[3]->z) }; }
+
+	// Same as ProcessTrianglesScalar, four triangles at a time.  Returns where the scalar tail has to pick up.
+	static uint32_t ProcessTrianglesSSE(const std::vector<Vertex>& vertices, const uint32_t* indices, uint32_t triangleCount, uint32_t begin, uint32_t end, CornerTangents& corners)
+	{
+		const __m128 Zero = _mm_setzero_ps();
+		const __m128 SignBit = _mm_set1_ps(-0.0f);
+		const __m128 EpsilonSplat = _mm_set1_ps(Epsilon);
+		const __m128 One = _mm_set1_ps(1.0f);
+
+		uint32_t Triangle = begin;
+		for (; Triangle + 4 <= end; Triangle += 4)
+		{
+			Vec3x4 Positions[3];
+			Vec3x4 Normals[3];
+			__m128 U[3], V[3];
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				const Vertex* Lanes[4];
+				for (uint32_t Lane = 0; Lane < 4; Lane++)
+					Lanes[Lane] = &vertices[indices[(Triangle + Lane) * 3 + k]];
+
+				const glm::vec3* LanePositions[4] = { &Lanes[0]->Position, &Lanes[1]->Position, &Lanes[2]->Position, &Lanes[3]->Position };
+				const glm::vec3* LaneNormals[4] = { &Lanes[0]->Normal, &Lanes[1]->Normal, &Lanes[2]->Normal, &Lanes[3]->Normal };
+				Positions[k] = Gather(LanePositions);
+				Normals[k] = Gather(LaneNormals);
+				U[k] = _mm_setr_ps(Lanes[0]->TexCoord.x, Lanes[1]->TexCoord.x, Lanes[2]->TexCoord.x, Lanes[3]->TexCoord.x);
+				V[k] = _mm_setr_ps(Lanes[0]->TexCoord.y, Lanes[1]->TexCoord.y, Lanes[2]->TexCoord.y, Lanes[3]->TexCoord.y);
+			}
+
+			const Vec3x4 Edge1 = Sub(Positions[1], Positions[0]);
+			const Vec3x4 Edge2 = Sub(Positions[2], Positions[0]);
+			const __m128 DeltaU1 = _mm_sub_ps(U[1], U[0]);
+			const __m128 DeltaV1 = _mm_sub_ps(V[1], V[0]);
+			const __m128 DeltaU2 = _mm_sub_ps(U[2], U[0]);
+			const __m128 DeltaV2 = _mm_sub_ps(V[2], V[0]);
+			const __m128 Determinant = _mm_sub_ps(_mm_mul_ps(DeltaU1, DeltaV2), _mm_mul_ps(DeltaU2, DeltaV1));
+
+			const __m128 DeterminantSign = _mm_and_ps(Determinant, SignBit);
+			const Vec3x4 Tangent = FlipSign(Sub(Scale(Edge1, DeltaV2), Scale(Edge2, DeltaV1)), DeterminantSign);
+			const Vec3x4 Binormal = FlipSign(Sub(Scale(Edge2, DeltaU1), Scale(Edge1, DeltaU2)), DeterminantSign);
+			const __m128 HasUVs = _mm_cmpneq_ps(Determinant, Zero);
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				const Vec3x4& Normal = Normals[k];
+				const Vec3x4 Projected = Reject(Tangent, Normal);
+				const __m128 ProjectedLength2 = Dot(Projected, Projected);
+
+				const Vec3x4 ToNext = Reject(Sub(Positions[(k + 1) % 3], Positions[k]), Normal);
+				const Vec3x4 ToPrevious = Reject(Sub(Positions[(k + 2) % 3], Positions[k]), Normal);
+				const __m128 LengthProduct = _mm_sqrt_ps(_mm_max_ps(_mm_mul_ps(Dot(ToNext, ToNext), Dot(ToPrevious, ToPrevious)), EpsilonSplat));
+				__m128 Cosine = _mm_div_ps(Dot(ToNext, ToPrevious), LengthProduct);
+				Cosine = _mm_min_ps(_mm_max_ps(Cosine, _mm_sub_ps(Zero, One)), One);
+				const __m128 Angle = FastAcos(Cosine);
+
+				const __m128 Usable = _mm_and_ps(HasUVs, _mm_cmpgt_ps(ProjectedLength2, EpsilonSplat));
+				const __m128 Weight = _mm_and_ps(Usable, _mm_div_ps(Angle, _mm_sqrt_ps(_mm_max_ps(ProjectedLength2, EpsilonSplat))));
+				const Vec3x4 Weighted = Scale(Projected, Weight);
+
+				const uint32_t Corner = k * triangleCount + Triangle;
+				_mm_storeu_ps(&corners.X[Corner], Weighted.X);
+				_mm_storeu_ps(&corners.Y[Corner], Weighted.Y);
+				_mm_storeu_ps(&corners.Z[Corner], Weighted.Z);
+
+				const int MirroredMask = _mm_movemask_ps(_mm_cmplt_ps(Dot(Cross(Normal, Projected), Binormal), Zero));
+				for (uint32_t Lane = 0; Lane < 4; Lane++)
+					corners.Mirrored[Corner + Lane] = (MirroredMask >> Lane) & 1;
+			}
+		}
+
+		return Triangle;
+	}
+#endif
+
+	void TangentGenerator::Generate(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+	{
+		Generate(vertices, indices, 0, static_cast<uint32_t>(vertices.size()), 0, indices.size());
+	}
+
+	void TangentGenerator::Generate(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t vertexBegin, uint32_t vertexEnd, size_t indexBegin, size_t indexEnd)
+	{
+		if (vertexEnd <= vertexBegin) return;
+
+		const uint32_t TriangleCount = static_cast<uint32_t>((indexEnd - indexBegin) / 3);
+		const uint32_t* TriangleIndices = indices.data() + indexBegin;
+		const uint32_t VertexCount = vertexEnd - vertexBegin;
+
+		CornerTangents Corners;
+		Corners.X.resize(TriangleCount * 3);
+		Corners.Y.resize(TriangleCount * 3);
+		Corners.Z.resize(TriangleCount * 3);
+		Corners.Mirrored.resize(TriangleCount * 3);
+
+		JobSystem::ParallelFor(TriangleCount, TriangleChunkSize, [&](uint32_t begin, uint32_t end, uint32_t)
+		{
+#if defined(OHM_TANGENT_SSE)
+			begin = ProcessTrianglesSSE(vertices, TriangleIndices, TriangleCount, begin, end, Corners);
+#endif
+			ProcessTrianglesScalar(vertices, TriangleIndices, TriangleCount, begin, end, Corners);
+		});
+
+		// Corners of each vertex, in index order.  Counting and filling are a single pass over the indices each;
+		// splitting them between threads would cost more in merging than it saves.
+		std::vector<uint32_t> FirstCorner(VertexCount + 1, 0);
+		for (uint32_t i = 0; i < TriangleCount * 3; i++)
+			FirstCorner[TriangleIndices[i] - vertexBegin + 1]++;
+		for (uint32_t i = 0; i < VertexCount; i++)
+			FirstCorner[i + 1] += FirstCorner[i];
+
+		std::vector<uint32_t> VertexCorners(TriangleCount * 3);
+		std::vector<uint32_t> Cursor(FirstCorner.begin(), FirstCorner.end() - 1);
+		for (uint32_t i = 0; i < TriangleCount * 3; i++)
+			VertexCorners[Cursor[TriangleIndices[i] - vertexBegin]++] = (i % 3) * TriangleCount + i / 3;
+
+		JobSystem::ParallelFor(VertexCount, VertexChunkSize, [&](uint32_t begin, uint32_t end, uint32_t)
+		{
+			for (uint32_t i = begin; i < end; i++)
+			{
+				// Unmirrored corners sum into the first, mirrored ones into the second.
+				glm::vec3 Sums[2] = { glm::vec3(0.0f), glm::vec3(0.0f) };
+				for (uint32_t c = FirstCorner[i]; c < FirstCorner[i + 1]; c++)
+				{
+					const uint32_t Corner = VertexCorners[c];
+					Sums[Corners.Mirrored[Corner]] += glm::vec3(Corners.X[Corner], Corners.Y[Corner], Corners.Z[Corner]);
+				}
+
+				Vertex& Current = vertices[vertexBegin + i];
+				uint32_t Side = glm::dot(Sums[1], Sums[1]) > glm::dot(Sums[0], Sums[0]) ? 1 : 0;
+				glm::vec3 Tangent = Sums[Side] - Current.Normal * glm::dot(Current.Normal, Sums[Side]);
+
+				// No usable texture coordinates: any tangent perpendicular to the normal will do.
+				if (glm::dot(Tangent, Tangent) < 1e-12f)
+				{
+					Tangent = glm::cross(Current.Normal, glm::abs(Current.Normal.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f));
+					Side = 0;
+				}
+
+				Current.Tangent = glm::normalize(Tangent);
+				Current.Binormal = glm::cross(Current.Normal, Current.Tangent) * (Side == 1 ? -1.0f : 1.0f);
+			}
+		});
+	}
+}
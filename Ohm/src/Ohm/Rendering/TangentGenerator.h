@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Ohm/Rendering/Vertex.h"
+
+#include <vector>
+
+namespace Ohm
+{
+	/*
+	 * Per-vertex tangent frames from texture coordinates, built the way MikkTSpace builds them:
+	 *	1. Each triangle's tangent is projected onto the plane of each corner's normal and weighted by the angle at
+	 *	   that corner, measured in the same plane.
+	 *	2. A vertex sums the tangents of all of its corners, and the sum is orthonormalized against its normal.
+	 *	3. The binormal is cross(normal, tangent), negated where the UV mapping is mirrored, so it follows +V.
+	 * Vertices split along a UV seam already get a frame per side.  A vertex shared between mirrored and unmirrored
+	 * triangles can only hold one frame; the side that contributes more wins.
+	 *
+	 * Triangles are processed in parallel chunks on the job system, four at a time with SSE where available.  Every
+	 * vertex then gathers its corners in index order, so the result doesn't depend on the thread count.
+	 */
+	class TangentGenerator
+	{
+	public:
+		// Normals must already be unit length.
+		static void Generate(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
+		// Only the vertices in [vertexBegin, vertexEnd), from the triangles in [indexBegin, indexEnd), which must only
+		// reference those vertices.
+		static void Generate(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t vertexBegin, uint32_t vertexEnd, size_t indexBegin, size_t indexEnd);
+	};
+}
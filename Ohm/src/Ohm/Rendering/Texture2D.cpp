@@ -1,26 +1,72 @@
 #include "ohmpch.h"
 #include "Ohm/Rendering/Texture2D.h"
+#include "Ohm/Rendering/RenderCommand.h"
+#include "Ohm/Rendering/MipGenerator.h"
 
 #include <glad/glad.h>
 #include <stb_image.h>
 
 namespace Ohm
 {
+	// Files are named after themselves unless the specification names them.
+	static std::string GetFileTextureName(const std::string& filePath, const Texture2DSpecification& specification)
+	{
+		if (specification.Name != "Texture2D")
+			return specification.Name;
+
+		const size_t pos = filePath.find_last_of("/") + 1;
+		return filePath.substr(pos, filePath.size() - pos);
+	}
+
+	// Fills in formats left to the image with the ones matching its channel count.
+	static void SetFormatsFromImage(Texture2DSpecification& specification, int channels)
+	{
+		if (specification.InternalFormat != TextureUtils::ImageInternalFormat::FromImage || specification.PixelLayoutFormat != TextureUtils::ImageDataLayout::FromImage)
+			return;
+
+		switch (channels)
+		{
+			case 1:
+			{
+				specification.InternalFormat = TextureUtils::ImageInternalFormat::R8;
+				specification.PixelLayoutFormat = TextureUtils::ImageDataLayout::Red;
+				break;
+			}
+			case 2:
+			{
+				specification.InternalFormat = TextureUtils::ImageInternalFormat::RG8;
+				specification.PixelLayoutFormat = TextureUtils::ImageDataLayout::RG;
+				break;
+			}
+			case 3:
+			{
+				specification.InternalFormat = TextureUtils::ImageInternalFormat::RGB8;
+				specification.PixelLayoutFormat = TextureUtils::ImageDataLayout::RGB;
+				break;
+			}
+			case 4:
+			{
+				specification.InternalFormat = TextureUtils::ImageInternalFormat::RGBA8;
+				specification.PixelLayoutFormat = TextureUtils::ImageDataLayout::RGBA;
+				break;
+			}
+		}
+	}
+
+	// Textures are set up through their names, so nothing depends on which texture unit happens to be active.
+	static void SetSamplerParameters(uint32_t id, const Texture2DSpecification& specification)
+	{
+		glTextureParameteri(id, GL_TEXTURE_WRAP_S, ConvertWrapMode(specification.WrapModeS));
+		glTextureParameteri(id, GL_TEXTURE_WRAP_T, ConvertWrapMode(specification.WrapModeT));
+		glTextureParameteri(id, GL_TEXTURE_MIN_FILTER, ConvertMinMagFilterMode(specification.MinFilterMode));
+		glTextureParameteri(id, GL_TEXTURE_MAG_FILTER, ConvertMinMagFilterMode(specification.MagFilterMode));
+	}
+
 	Texture2D::Texture2D(const Texture2DSpecification& specification)
 		:m_Specification(specification), m_Name(specification.Name)
 	{
 		glCreateTextures(GL_TEXTURE_2D, 1, &m_ID);
-		glBindTexture(GL_TEXTURE_2D, m_ID);
-
-		GLenum wrapS = ConvertWrapMode(specification.WrapModeS);
-		GLenum wrapT = ConvertWrapMode(specification.WrapModeT);
-		GLenum minFilter = ConvertMinMagFilterMode(specification.MinFilterMode);
-		GLenum magFilter = ConvertMinMagFilterMode(specification.MagFilterMode);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapS);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
+		SetSamplerParameters(m_ID, specification);
 
 		// Immutable-format Texture
 		// Contents of the image can be modified, but it's storage requirements may not change.
@@ -34,93 +80,52 @@ namespace Ohm
 		:m_Specification(specification), m_Name(specification.Name)
 	{
 		glCreateTextures(GL_TEXTURE_2D, 1, &m_ID);
-		glBindTexture(GL_TEXTURE_2D, m_ID);
-
-		const GLenum wrapS = ConvertWrapMode(specification.WrapModeS);
-		const GLenum wrapT = ConvertWrapMode(specification.WrapModeT);
-		const GLenum minFilter = ConvertMinMagFilterMode(specification.MinFilterMode);
-		const GLenum magFilter = ConvertMinMagFilterMode(specification.MagFilterMode);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapS);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
+		SetSamplerParameters(m_ID, specification);
 
 		const GLenum internalFormat = ConvertInternalFormatMode(m_Specification.InternalFormat);
 		const GLenum dataFormat = ConverDataLayoutMode(m_Specification.PixelLayoutFormat);
 		const GLenum dataType = ConvertImageDataType(m_Specification.DataType);
 
-		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_Specification.Width, m_Specification.Height, 0, dataFormat, dataType, data);
-		glGenerateMipmap(GL_TEXTURE_2D);
+		glTextureStorage2D(m_ID, GetMipLevelCount(), internalFormat, m_Specification.Width, m_Specification.Height);
+		glTextureSubImage2D(m_ID, 0, 0, 0, m_Specification.Width, m_Specification.Height, dataFormat, dataType, data);
+		glGenerateTextureMipmap(m_ID);
 	}
 
-	Texture2D::Texture2D(const std::string& filePath, const Texture2DSpecification& specification)
-		:m_Specification(specification), m_FilePath(filePath)
+	Texture2D::Texture2D(const std::string& filePath, const Texture2DSpecification& specification, TextureUsage usage)
+		:m_Specification(specification), m_FilePath(filePath), m_Name(GetFileTextureName(filePath, specification))
 	{
-		if(specification.Name == "Texture2D")
-		{
-			size_t pos = m_FilePath.find_last_of("/") + 1;
-			size_t size = m_FilePath.size() - pos;
-			m_Name = m_FilePath.substr(pos, size);
-		}
-		else
-		{
-			m_Name = specification.Name;
-		}
-
 		glCreateTextures(GL_TEXTURE_2D, 1, &m_ID);
-		glBindTexture(GL_TEXTURE_2D, m_ID);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, ConvertWrapMode(specification.WrapModeS));
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, ConvertWrapMode(specification.WrapModeT));
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, ConvertMinMagFilterMode(specification.MinFilterMode));
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, ConvertMinMagFilterMode(specification.MagFilterMode));
-
-		stbi_set_flip_vertically_on_load(1);
+		SetSamplerParameters(m_ID, specification);
 
 		int channels, width, height;
 		unsigned char* data = stbi_load(filePath.c_str(), &width, &height, &channels, 0);
 
 		m_Specification.Width = width;
 		m_Specification.Height = height;
-
-		if (m_Specification.InternalFormat == TextureUtils::ImageInternalFormat::FromImage && m_Specification.PixelLayoutFormat == TextureUtils::ImageDataLayout::FromImage)
-		{
-			switch (channels)
-			{
-				case 1:
-				{
-					m_Specification.InternalFormat = TextureUtils::ImageInternalFormat::R8;
-					m_Specification.PixelLayoutFormat = TextureUtils::ImageDataLayout::Red;
-					break;
-				}
-				case 2:
-				{
-					m_Specification.InternalFormat = TextureUtils::ImageInternalFormat::RG8;
-					m_Specification.PixelLayoutFormat = TextureUtils::ImageDataLayout::RG;
-					break;
-				}
-				case 3:
-				{
-					m_Specification.InternalFormat = TextureUtils::ImageInternalFormat::RGB8;
-					m_Specification.PixelLayoutFormat = TextureUtils::ImageDataLayout::RGB;
-					break;
-				}
-				case 4:
-				{
-					m_Specification.InternalFormat = TextureUtils::ImageInternalFormat::RGBA8;
-					m_Specification.PixelLayoutFormat = TextureUtils::ImageDataLayout::RGBA;
-					break;
-				}
-			}
-		}
+		SetFormatsFromImage(m_Specification, channels);
 
 		if (data)
 		{
 			GLenum internalFormat = ConvertInternalFormatMode(m_Specification.InternalFormat);
 			GLenum dataFormat = ConverDataLayoutMode(m_Specification.PixelLayoutFormat);
 			GLenum dataType = ConvertImageDataType(m_Specification.DataType);
-			glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_Specification.Width, m_Specification.Height, 0, dataFormat, dataType, data);
+
+			// Mips are filtered on the CPU rather than by the driver.
+			std::vector<MipLevel> Mips;
+			std::vector<uint8_t> MipData;
+			if (SamplesMips())
+				MipData = MipGenerator::GenerateChain(data, width, height, channels, GetMipLevelCount(), TextureCompressor::GetMipSettings(usage), Mips);
+			glTextureStorage2D(m_ID, static_cast<GLsizei>(Mips.size() + 1), internalFormat, m_Specification.Width, m_Specification.Height);
+
+			// Rows of RGB and single channel images aren't 4 byte aligned.
+			RenderCommand::SetUnpackAlignment(1);
+			glTextureSubImage2D(m_ID, 0, 0, 0, m_Specification.Width, m_Specification.Height, dataFormat, dataType, data);
+			for (uint32_t Level = 1; Level <= Mips.size(); Level++)
+			{
+				const MipLevel& Mip = Mips[Level - 1];
+				glTextureSubImage2D(m_ID, static_cast<GLint>(Level), 0, 0, Mip.Width, Mip.Height, dataFormat, dataType, MipData.data() + Mip.Offset);
+			}
+			RenderCommand::SetUnpackAlignment(4);
 			stbi_image_free(data);
 		}
 		else
@@ -129,28 +134,77 @@ namespace Ohm
 		}
 	}
 
+	Texture2D::Texture2D(const std::string& filePath, const Texture2DSpecification& specification, DeferredLoad)
+		:m_Specification(specification), m_FilePath(filePath), m_Name(GetFileTextureName(filePath, specification)), m_Resident(false)
+	{
+		m_Specification.Width = 0;
+		m_Specification.Height = 0;
+
+		// The name exists from the start, so the texture can be registered and referenced before it has any storage.
+		glCreateTextures(GL_TEXTURE_2D, 1, &m_ID);
+		SetSamplerParameters(m_ID, specification);
+	}
+
+	Texture2D::Texture2D(const std::string& filePath, const CompressedImage& image, const Texture2DSpecification& specification)
+		:m_Specification(specification), m_FilePath(filePath), m_Name(GetFileTextureName(filePath, specification))
+	{
+		glCreateTextures(GL_TEXTURE_2D, 1, &m_ID);
+		SetSamplerParameters(m_ID, specification);
+
+		const uint32_t Levels = AllocateStorage(image);
+		const GLenum internalFormat = ConvertInternalFormatMode(image.Format);
+		for (uint32_t Level = 0; Level < Levels; Level++)
+		{
+			const CompressedMip& Mip = image.Mips[Level];
+			glCompressedTextureSubImage2D(m_ID, static_cast<GLint>(Level), 0, 0, Mip.Width, Mip.Height, internalFormat, static_cast<GLsizei>(Mip.Size), image.GetMipData(Level));
+		}
+	}
+
+	uint32_t Texture2D::AllocateStorage(uint32_t width, uint32_t height, uint32_t channels)
+	{
+		m_Specification.Width = width;
+		m_Specification.Height = height;
+		SetFormatsFromImage(m_Specification, static_cast<int>(channels));
+
+		const uint32_t Levels = SamplesMips() ? GetMipLevelCount() : 1;
+		glTextureStorage2D(m_ID, Levels, ConvertInternalFormatMode(m_Specification.InternalFormat), width, height);
+		return Levels;
+	}
+
+	uint32_t Texture2D::AllocateStorage(const CompressedImage& image)
+	{
+		m_Specification.Width = image.Width;
+		m_Specification.Height = image.Height;
+		m_Specification.InternalFormat = image.Format;
+		m_Specification.PixelLayoutFormat = TextureUtils::ImageDataLayout::RGBA;
+
+		const uint32_t Levels = SamplesMips() ? static_cast<uint32_t>(image.Mips.size()) : 1;
+		glTextureStorage2D(m_ID, Levels, ConvertInternalFormatMode(image.Format), image.Width, image.Height);
+		return Levels;
+	}
+
+	bool Texture2D::SamplesMips() const
+	{
+		const TextureUtils::FilterMode MinFilter = m_Specification.MinFilterMode;
+		return MinFilter != TextureUtils::FilterMode::Linear && MinFilter != TextureUtils::FilterMode::Nearest && MinFilter != TextureUtils::FilterMode::None;
+	}
+
 	Texture2D::~Texture2D()
 	{
 		glDeleteTextures(1, &m_ID);
+		RenderCommand::InvalidateStateCache();
 	}
 
 	void Texture2D::Invalidate()
 	{
 		if (m_ID)
+		{
 			glDeleteTextures(1, &m_ID);
+			RenderCommand::InvalidateStateCache();
+		}
 
 		glCreateTextures(GL_TEXTURE_2D, 1, &m_ID);
-		glBindTexture(GL_TEXTURE_2D, m_ID);
-
-		GLenum wrapS = ConvertWrapMode(m_Specification.WrapModeS);
-		GLenum wrapT = ConvertWrapMode(m_Specification.WrapModeT);
-		GLenum minFilter = ConvertMinMagFilterMode(m_Specification.MinFilterMode);
-		GLenum magFilter = ConvertMinMagFilterMode(m_Specification.MagFilterMode);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapS);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
+		SetSamplerParameters(m_ID, m_Specification);
 
 		// Immutable-format Texture
 		// Contents of the image can be modified, but it's storage requirements may not change.
@@ -193,25 +247,20 @@ namespace Ohm
 
 	void Texture2D::BindTextureIDToSamplerSlot(uint32_t slot, uint32_t id)
 	{
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTextureUnit(slot, id);
+		RenderCommand::BindTextureUnit(slot, id);
 	}
 
 	void Texture2D::BindToSamplerSlot(uint32_t slot) const
 	{
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTextureUnit(slot, m_ID);
+		RenderCommand::BindTextureUnit(slot, m_ID);
 	}
 
 	void Texture2D::Unbind(uint32_t slot) const
 	{
-		glBindTexture(GL_TEXTURE_2D, 0);
+		RenderCommand::BindTextureUnit(0, 0);
 
 		if(slot != UINT32_MAX)
-		{
-			glActiveTexture(GL_TEXTURE0 + slot);
-			glBindTextureUnit(slot, m_ID);
-		}
+			RenderCommand::BindTextureUnit(slot, m_ID);
 	}
 
 	void Texture2D::BindToImageSlot(uint32_t unit, uint32_t level, TextureUtils::TextureAccessLevel access, TextureUtils::TextureShaderDataFormat shaderDataFormat)
@@ -225,7 +274,7 @@ namespace Ohm
 			return;
 		}
 
-		glBindImageTexture(unit, m_ID, level, GL_FALSE, 0, ConvertTextureAccessLevel(access), ConvertShaderFormatType(shaderDataFormat));
+		RenderCommand::BindImageTexture(unit, m_ID, level, false, 0, ConvertTextureAccessLevel(access), glShaderDataFormat);
 	}
 
 	void Texture2D::SetData(void* data, uint32_t size) const
@@ -244,7 +293,7 @@ namespace Ohm
 
 	void Texture2D::ClearBinding()
 	{
-		glBindTexture(GL_TEXTURE_2D, 0);
+		RenderCommand::BindTextureUnit(0, 0);
 	}
 
 	Ref<Texture2D> Texture2D::CreateWhiteTexture()
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Ohm/Rendering/Utility/TextureUtils.h"
+#include "Ohm/Rendering/TextureCompressor.h"
 
 namespace Ohm
 {
@@ -20,9 +21,18 @@ namespace Ohm
 	class Texture2D
 	{
 	public:
+		// Tag for a file texture whose image is decoded and uploaded later by TextureUploader.
+		struct DeferredLoad {};
+
 		Texture2D(const Texture2DSpecification& specification);
 		Texture2D(const Texture2DSpecification& specification, void* data);
-		Texture2D(const std::string& filePath, const Texture2DSpecification& specification);
+		// Uploaded uncompressed; usage only picks how the mips are filtered, as TextureCompressor::GetMipSettings does.
+		Texture2D(const std::string& filePath, const Texture2DSpecification& specification, TextureUsage usage = TextureUsage::None);
+		// Has no storage and isn't resident until TextureUploader has uploaded the file; its size is zero until then.
+		Texture2D(const std::string& filePath, const Texture2DSpecification& specification, DeferredLoad);
+		// Uploads every mip of a block compressed image, or just the first when the filter doesn't sample mips.  The
+		// image's format and size replace the specification's.
+		Texture2D(const std::string& filePath, const CompressedImage& image, const Texture2DSpecification& specification);
 		~Texture2D();
 
 		void Invalidate();
@@ -30,6 +40,8 @@ namespace Ohm
 		void Resize(uint32_t width, uint32_t height);
 
 		uint32_t GetID() const { return m_ID; }
+		// False while a deferred load is in flight.  TextureLibrary binds its placeholder in the texture's place until then.
+		bool IsResident() const { return m_Resident.load(std::memory_order_acquire); }
 		const Texture2DSpecification& GetSpecification() const { return m_Specification; }
 
 		std::pair<uint32_t, uint32_t> GetMipSize(uint32_t mip) const;
@@ -50,10 +62,22 @@ namespace Ohm
 		static Ref<Texture2D> CreateWhiteTexture();
 		static Ref<Texture2D> CreateBlackTexture();
 
+	private:
+		// Sizes the texture for a decoded image and allocates its storage, mips included when its filter samples them.
+		// Returns the number of levels allocated.
+		uint32_t AllocateStorage(uint32_t width, uint32_t height, uint32_t channels);
+		// The same for a block compressed image, in its format.
+		uint32_t AllocateStorage(const CompressedImage& image);
+		bool SamplesMips() const;
+
 	private:
 		Texture2DSpecification m_Specification;
 		uint32_t m_ID;
 		std::string m_FilePath;
 		std::string m_Name;
+		std::atomic<bool> m_Resident{ true };
+
+		friend class TextureUploader;
+		friend class TextureStreamer;
 	};
 }
\ No newline at end of file
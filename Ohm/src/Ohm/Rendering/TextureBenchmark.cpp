@@ -0,0 +1,253 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/TextureBenchmark.h"
+#include "Ohm/Rendering/BlockCompressor.h"
+#include "Ohm/Rendering/TextureCompressor.h"
+#include "Ohm/Rendering/MipGenerator.h"
+#include "Ohm/Core/JobSystem.h"
+
+#include <stb_image.h>
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace Ohm
+{
+	using TextureUtils::ImageInternalFormat;
+
+	static constexpr const char* BenchmarkImagePath = "assets/textures/lava.jpg";
+	// The image is tiled up to this size, so a run is long enough to time and every thread has rows to take.
+	static constexpr uint32_t BenchmarkSize = 2048;
+	static constexpr uint32_t MipBenchmarkSizes[2] = { 4096, 8192 };
+	static constexpr uint32_t MeasuredRuns = 3;
+
+	static std::mutex s_BenchmarkMutex;
+	static std::atomic<bool> s_CompressionBenchmarkRequested{ false };
+	static bool s_HasCompressionResult = false;
+	static TextureCompressionBenchmarkResult s_CompressionResult;
+	static std::atomic<bool> s_MipBenchmarkRequested{ false };
+	static bool s_HasMipResult = false;
+	static MipBenchmarkResult s_MipResult;
+
+	// The benchmark image repeated over a size x size RGBA8 image; empty if it couldn't be loaded.
+	static std::vector<uint8_t> LoadTiledImage(uint32_t size)
+	{
+		int SourceWidth, SourceHeight, SourceChannels;
+		stbi_uc* Source = stbi_load(BenchmarkImagePath, &SourceWidth, &SourceHeight, &SourceChannels, 4);
+		if (Source == nullptr)
+		{
+			OHM_CORE_ERROR("Texture Benchmark: Failed to load '{}'.", BenchmarkImagePath);
+			return {};
+		}
+
+		std::vector<uint8_t> Image(static_cast<size_t>(size) * size * 4);
+		for (uint32_t Y = 0; Y < size; Y++)
+		{
+			for (uint32_t X = 0; X < size; X++)
+			{
+				const stbi_uc* Texel = Source + ((Y % SourceHeight) * static_cast<size_t>(SourceWidth) + X % SourceWidth) * 4;
+				std::copy(Texel, Texel + 4, Image.begin() + (static_cast<size_t>(Y) * size + X) * 4);
+			}
+		}
+		stbi_image_free(Source);
+		return Image;
+	}
+
+	// Best of MeasuredRuns after a warmup that isn't counted.
+	template<typename Fn>
+	static float MeasureMilliseconds(const Fn& fn)
+	{
+		float Best = std::numeric_limits<float>::max();
+		for (uint32_t Run = 0; Run <= MeasuredRuns; Run++)
+		{
+			const auto Start = std::chrono::high_resolution_clock::now();
+			fn();
+			const float Milliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - Start).count();
+			if (Run > 0)
+				Best = glm::min(Best, Milliseconds);
+		}
+		return Best;
+	}
+
+	// The 2x2 average of encoded values, one level after the other on one thread, that MipGenerator replaced.
+	static void GenerateReferenceChain(const std::vector<uint8_t>& rgba, uint32_t size)
+	{
+		std::vector<uint8_t> Level = rgba;
+		for (uint32_t Width = size, Height = size; Width > 1 || Height > 1;)
+		{
+			const uint32_t MipWidth = glm::max(Width / 2, 1u);
+			const uint32_t MipHeight = glm::max(Height / 2, 1u);
+			std::vector<uint8_t> Mip(static_cast<size_t>(MipWidth) * MipHeight * 4);
+			for (uint32_t Y = 0; Y < MipHeight; Y++)
+			{
+				const uint32_t Y0 = glm::min(Y * 2, Height - 1), Y1 = glm::min(Y * 2 + 1, Height - 1);
+				for (uint32_t X = 0; X < MipWidth; X++)
+				{
+					const uint32_t X0 = glm::min(X * 2, Width - 1), X1 = glm::min(X * 2 + 1, Width - 1);
+					for (uint32_t Channel = 0; Channel < 4; Channel++)
+					{
+						const uint32_t Sum = Level[(static_cast<size_t>(Y0) * Width + X0) * 4 + Channel] + Level[(static_cast<size_t>(Y0) * Width + X1) * 4 + Channel] +
+							Level[(static_cast<size_t>(Y1) * Width + X0) * 4 + Channel] + Level[(static_cast<size_t>(Y1) * Width + X1) * 4 + Channel];
+						Mip[(static_cast<size_t>(Y) * MipWidth + X) * 4 + Channel] = static_cast<uint8_t>((Sum + 2) / 4);
+					}
+				}
+			}
+			Level = std::move(Mip);
+			Width = MipWidth;
+			Height = MipHeight;
+		}
+	}
+
+	void TextureBenchmark::RequestCompressionBenchmark()
+	{
+		if (s_CompressionBenchmarkRequested.exchange(true)) return;
+
+		JobSystem::Submit([]()
+			{
+				const TextureCompressionBenchmarkResult Result = RunCompressionBenchmark();
+				{
+					std::lock_guard<std::mutex> Lock(s_BenchmarkMutex);
+					s_CompressionResult = Result;
+					s_HasCompressionResult = Result.Width > 0;
+				}
+				s_CompressionBenchmarkRequested = false;
+
+				if (Result.Width == 0) return;
+
+				constexpr double BytesPerMB = 1024.0 * 1024.0;
+				OHM_CORE_INFO("Texture Compression Benchmark ({}x{}, {} threads, {:.2f} MB as RGBA8):", Result.Width, Result.Height, Result.ThreadCount, Result.SourceBytes / BytesPerMB);
+				for (const TextureCompressionBenchmarkResult::Format& Format : Result.Formats)
+				{
+					OHM_CORE_INFO("  {}: {:.2f} MB, {:.2f} ms, {:.1f} Mpixels/s, PSNR {:.2f} dB", TextureCompressor::GetFormatName(Format.BlockFormat),
+						Format.CompressedBytes / BytesPerMB, Format.Milliseconds, Format.MegapixelsPerSecond, Format.PSNR);
+				}
+			});
+	}
+
+	bool TextureBenchmark::IsCompressionBenchmarkPending()
+	{
+		return s_CompressionBenchmarkRequested;
+	}
+
+	bool TextureBenchmark::GetCompressionResult(TextureCompressionBenchmarkResult& outResult)
+	{
+		std::lock_guard<std::mutex> Lock(s_BenchmarkMutex);
+		if (!s_HasCompressionResult) return false;
+
+		outResult = s_CompressionResult;
+		return true;
+	}
+
+	void TextureBenchmark::RequestMipBenchmark()
+	{
+		if (s_MipBenchmarkRequested.exchange(true)) return;
+
+		JobSystem::Submit([]()
+			{
+				const MipBenchmarkResult Result = RunMipBenchmark();
+				{
+					std::lock_guard<std::mutex> Lock(s_BenchmarkMutex);
+					s_MipResult = Result;
+					s_HasMipResult = Result.ThreadCount > 0;
+				}
+				s_MipBenchmarkRequested = false;
+
+				if (Result.ThreadCount == 0) return;
+
+				OHM_CORE_INFO("Mip Generation Benchmark ({} threads, sRGB):", Result.ThreadCount);
+				for (const MipBenchmarkResult::Size& Size : Result.Sizes)
+				{
+					OHM_CORE_INFO("  {}x{}: 2x2 reference {:.2f} ms, box {:.2f} ms, Kaiser {:.2f} ms", Size.Width, Size.Height,
+						Size.ReferenceMilliseconds, Size.BoxMilliseconds, Size.KaiserMilliseconds);
+				}
+			});
+	}
+
+	bool TextureBenchmark::IsMipBenchmarkPending()
+	{
+		return s_MipBenchmarkRequested;
+	}
+
+	bool TextureBenchmark::GetMipResult(MipBenchmarkResult& outResult)
+	{
+		std::lock_guard<std::mutex> Lock(s_BenchmarkMutex);
+		if (!s_HasMipResult) return false;
+
+		outResult = s_MipResult;
+		return true;
+	}
+
+	TextureCompressionBenchmarkResult TextureBenchmark::RunCompressionBenchmark()
+	{
+		TextureCompressionBenchmarkResult Result;
+
+		const std::vector<uint8_t> Image = LoadTiledImage(BenchmarkSize);
+		if (Image.empty())
+			return Result;
+
+		Result.Width = BenchmarkSize;
+		Result.Height = BenchmarkSize;
+		Result.ThreadCount = JobSystem::GetThreadCount();
+		Result.SourceBytes = Image.size();
+
+		const ImageInternalFormat Formats[] = { ImageInternalFormat::BC1, ImageInternalFormat::BC3, ImageInternalFormat::BC4, ImageInternalFormat::BC5, ImageInternalFormat::BC7 };
+		const uint32_t StoredChannels[] = { 3, 4, 1, 2, 4 };
+		std::vector<uint8_t> Decompressed(Image.size());
+		for (uint32_t i = 0; i < 5; i++)
+		{
+			TextureCompressionBenchmarkResult::Format& Measured = Result.Formats[i];
+			Measured.BlockFormat = Formats[i];
+			Measured.CompressedBytes = TextureUtils::GetCompressedImageSize(Formats[i], BenchmarkSize, BenchmarkSize);
+			std::vector<uint8_t> Compressed(Measured.CompressedBytes);
+
+			Measured.Milliseconds = MeasureMilliseconds([&]() { BlockCompressor::Compress(Formats[i], Image.data(), BenchmarkSize, BenchmarkSize, Compressed.data()); });
+			Measured.MegapixelsPerSecond = static_cast<float>(BenchmarkSize) * BenchmarkSize / (Measured.Milliseconds * 1000.0f);
+
+			BlockCompressor::Decompress(Formats[i], Compressed.data(), BenchmarkSize, BenchmarkSize, Decompressed.data());
+			double SquaredError = 0.0;
+			for (size_t Texel = 0; Texel < Image.size(); Texel += 4)
+			{
+				for (uint32_t Channel = 0; Channel < StoredChannels[i]; Channel++)
+				{
+					const double Difference = static_cast<double>(Image[Texel + Channel]) - Decompressed[Texel + Channel];
+					SquaredError += Difference * Difference;
+				}
+			}
+
+			const double MeanSquaredError = SquaredError / (static_cast<double>(BenchmarkSize) * BenchmarkSize * StoredChannels[i]);
+			Measured.PSNR = MeanSquaredError > 0.0 ? static_cast<float>(10.0 * std::log10(255.0 * 255.0 / MeanSquaredError)) : std::numeric_limits<float>::infinity();
+		}
+
+		return Result;
+	}
+
+	MipBenchmarkResult TextureBenchmark::RunMipBenchmark()
+	{
+		MipBenchmarkResult Result;
+		for (uint32_t i = 0; i < 2; i++)
+		{
+			const uint32_t Size = MipBenchmarkSizes[i];
+			const std::vector<uint8_t> Image = LoadTiledImage(Size);
+			if (Image.empty())
+				return {};
+
+			MipBenchmarkResult::Size& Measured = Result.Sizes[i];
+			Measured.Width = Size;
+			Measured.Height = Size;
+
+			const uint32_t LevelCount = TextureUtils::CalculateMipLevelCount(Size, Size);
+			std::vector<MipLevel> Levels;
+			MipSettings Settings;
+			Settings.SRGB = true;
+
+			Measured.ReferenceMilliseconds = MeasureMilliseconds([&]() { GenerateReferenceChain(Image, Size); });
+			Settings.Filter = MipFilter::Box;
+			Measured.BoxMilliseconds = MeasureMilliseconds([&]() { MipGenerator::GenerateChain(Image.data(), Size, Size, 4, LevelCount, Settings, Levels); });
+			Settings.Filter = MipFilter::Kaiser;
+			Measured.KaiserMilliseconds = MeasureMilliseconds([&]() { MipGenerator::GenerateChain(Image.data(), Size, Size, 4, LevelCount, Settings, Levels); });
+		}
+
+		Result.ThreadCount = JobSystem::GetThreadCount();
+		return Result;
+	}
+}
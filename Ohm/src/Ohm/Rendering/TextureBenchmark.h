@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Ohm/Rendering/Utility/TextureUtils.h"
+
+namespace Ohm
+{
+	struct TextureCompressionBenchmarkResult
+	{
+		struct Format
+		{
+			TextureUtils::ImageInternalFormat BlockFormat = TextureUtils::ImageInternalFormat::None;
+			uint64_t CompressedBytes = 0;
+			// Best of the measured runs.
+			float Milliseconds = 0.0f;
+			float MegapixelsPerSecond = 0.0f;
+			// Over the channels the format stores, against the source image.
+			float PSNR = 0.0f;
+		};
+
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		uint32_t ThreadCount = 0;
+		uint64_t SourceBytes = 0;
+		Format Formats[5];
+	};
+
+	struct MipBenchmarkResult
+	{
+		struct Size
+		{
+			uint32_t Width = 0;
+			uint32_t Height = 0;
+			// Best of the measured runs for the whole chain of an sRGB image.  The reference is a single threaded
+			// 2x2 average of the encoded values, which is what texture compression used before MipGenerator.
+			float ReferenceMilliseconds = 0.0f;
+			float BoxMilliseconds = 0.0f;
+			float KaiserMilliseconds = 0.0f;
+		};
+
+		uint32_t ThreadCount = 0;
+		Size Sizes[2];
+	};
+
+	/*
+	 * Throughput and quality of BlockCompressor in every format, and the time MipGenerator takes over a 4K and an 8K
+	 * image, on a real image tiled up.  Each run is a job of its own, so requesting it doesn't stall the UI, which
+	 * reads the last result back from any thread.  The Get functions return false until a run has finished.
+	 */
+	class TextureBenchmark
+	{
+	public:
+		static void RequestCompressionBenchmark();
+		static bool IsCompressionBenchmarkPending();
+		static bool GetCompressionResult(TextureCompressionBenchmarkResult& outResult);
+
+		static void RequestMipBenchmark();
+		static bool IsMipBenchmarkPending();
+		static bool GetMipResult(MipBenchmarkResult& outResult);
+
+	private:
+		static TextureCompressionBenchmarkResult RunCompressionBenchmark();
+		static MipBenchmarkResult RunMipBenchmark();
+	};
+}
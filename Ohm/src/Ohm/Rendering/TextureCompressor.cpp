@@ -0,0 +1,228 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/TextureCompressor.h"
+#include "Ohm/Rendering/BlockCompressor.h"
+#include "Ohm/Core/AssetCache.h"
+
+#include <stb_image.h>
+
+#include <chrono>
+#include <cstring>
+
+namespace Ohm
+{
+	using TextureUtils::ImageInternalFormat;
+
+	static constexpr char CacheMagic[4] = { 'O', 'H', 'M', 'T' };
+	static constexpr const char* CacheExtension = ".ohmtex";
+
+	// The cache file is this header, the mip table and then the blocks of every mip back to back, largest first.
+	struct TextureCacheHeader
+	{
+		char Magic[4];
+		uint32_t Version;
+		// The SourceStamp of the image the cache was built from.
+		uint64_t SourceSize;
+		int64_t SourceWriteTime;
+		uint32_t Usage;
+		uint32_t Format;
+		uint32_t Width;
+		uint32_t Height;
+		uint32_t MipCount;
+		uint32_t Padding;
+	};
+	static_assert(sizeof(TextureCacheHeader) % 8 == 0, "The texture cache header must not have implicit padding.");
+	static_assert(sizeof(CompressedMip) == 24 && std::is_trivially_copyable_v<CompressedMip>, "Mips are written and read as raw bytes.");
+
+	static float MillisecondsSince(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	static Scope<CompressedImage> LoadCache(const std::string& cachePath, const SourceStamp& stamp, TextureUsage usage)
+	{
+		Scope<MappedFile> Cache = CreateScope<MappedFile>(cachePath);
+		if (!Cache->IsValid() || Cache->GetSize() < sizeof(TextureCacheHeader))
+			return nullptr;
+
+		TextureCacheHeader Header;
+		std::memcpy(&Header, Cache->GetData(), sizeof(Header));
+		if (std::memcmp(Header.Magic, CacheMagic, sizeof(CacheMagic)) != 0 || Header.Version != TextureCompressor::CacheVersion ||
+			Header.Usage != static_cast<uint32_t>(usage) || Header.SourceSize != stamp.Size || Header.SourceWriteTime != stamp.WriteTime)
+		{
+			OHM_CORE_TRACE("Texture Compressor: '{}' is out of date.", cachePath);
+			return nullptr;
+		}
+
+		Scope<CompressedImage> Image = CreateScope<CompressedImage>();
+		Image->Format = static_cast<ImageInternalFormat>(Header.Format);
+		Image->Width = Header.Width;
+		Image->Height = Header.Height;
+
+		const uint64_t TableBytes = static_cast<uint64_t>(Header.MipCount) * sizeof(CompressedMip);
+		bool Valid = TextureUtils::IsBlockCompressed(Image->Format) && Header.MipCount > 0 && sizeof(TextureCacheHeader) + TableBytes <= Cache->GetSize();
+		if (Valid)
+		{
+			Image->Mips.resize(Header.MipCount);
+			std::memcpy(Image->Mips.data(), Cache->GetData() + sizeof(TextureCacheHeader), TableBytes);
+		}
+
+		for (uint32_t i = 0; Valid && i < Header.MipCount; i++)
+		{
+			const CompressedMip& Mip = Image->Mips[i];
+			Valid = Mip.Width == glm::max(Header.Width >> i, 1u) && Mip.Height == glm::max(Header.Height >> i, 1u) &&
+				Mip.Size == TextureUtils::GetCompressedImageSize(Image->Format, Mip.Width, Mip.Height) && Mip.Offset + Mip.Size <= Cache->GetSize();
+		}
+
+		if (!Valid)
+		{
+			OHM_CORE_WARN("Texture Compressor: '{}' is corrupt and will be rebuilt.", cachePath);
+			return nullptr;
+		}
+
+		Image->Data = Cache->GetData();
+		Image->File = std::move(Cache);
+		return Image;
+	}
+
+	static void WriteCache(const std::string& cachePath, const SourceStamp& stamp, TextureUsage usage, const CompressedImage& image)
+	{
+		TextureCacheHeader Header = {};
+		std::memcpy(Header.Magic, CacheMagic, sizeof(CacheMagic));
+		Header.Version = TextureCompressor::CacheVersion;
+		Header.SourceSize = stamp.Size;
+		Header.SourceWriteTime = stamp.WriteTime;
+		Header.Usage = static_cast<uint32_t>(usage);
+		Header.Format = static_cast<uint32_t>(image.Format);
+		Header.Width = image.Width;
+		Header.Height = image.Height;
+		Header.MipCount = static_cast<uint32_t>(image.Mips.size());
+
+		// Offsets in the file are past the header and the table; in memory they start at zero.
+		const uint64_t DataOffset = sizeof(TextureCacheHeader) + image.Mips.size() * sizeof(CompressedMip);
+		std::vector<CompressedMip> Mips = image.Mips;
+		for (CompressedMip& Mip : Mips)
+			Mip.Offset += DataOffset;
+
+		AssetCache::Write(cachePath, {
+			{ &Header, sizeof(Header) },
+			{ Mips.data(), Mips.size() * sizeof(CompressedMip) },
+			{ image.Encoded.data(), image.Encoded.size() } });
+	}
+
+	static Scope<CompressedImage> Compress(const std::string& filePath, TextureUsage usage)
+	{
+		int Width, Height, Channels;
+		stbi_uc* Pixels = stbi_load(filePath.c_str(), &Width, &Height, &Channels, 4);
+		if (Pixels == nullptr)
+		{
+			OHM_CORE_ERROR("Texture Compressor: Failed to load '{}'.", filePath);
+			return nullptr;
+		}
+
+		bool HasAlpha = false;
+		for (size_t i = 3; Channels == 4 && !HasAlpha && i < static_cast<size_t>(Width) * Height * 4; i += 4)
+			HasAlpha = Pixels[i] != 255;
+
+		Scope<CompressedImage> Image = CreateScope<CompressedImage>();
+		Image->Format = TextureCompressor::GetFormat(usage, HasAlpha);
+		Image->Width = static_cast<uint32_t>(Width);
+		Image->Height = static_cast<uint32_t>(Height);
+
+		const uint32_t MipCount = TextureUtils::CalculateMipLevelCount(Image->Width, Image->Height);
+		uint64_t TotalSize = 0;
+		for (uint32_t i = 0; i < MipCount; i++)
+		{
+			CompressedMip& Mip = Image->Mips.emplace_back();
+			Mip.Width = glm::max(Image->Width >> i, 1u);
+			Mip.Height = glm::max(Image->Height >> i, 1u);
+			Mip.Offset = TotalSize;
+			Mip.Size = TextureUtils::GetCompressedImageSize(Image->Format, Mip.Width, Mip.Height);
+			TotalSize += Mip.Size;
+		}
+
+		std::vector<MipLevel> Levels;
+		const std::vector<uint8_t> MipData = MipGenerator::GenerateChain(Pixels, Image->Width, Image->Height, 4, MipCount, TextureCompressor::GetMipSettings(usage), Levels);
+
+		Image->Encoded.resize(TotalSize);
+		for (uint32_t i = 0; i < MipCount; i++)
+		{
+			const CompressedMip& Mip = Image->Mips[i];
+			const uint8_t* Texels = i == 0 ? Pixels : MipData.data() + Levels[i - 1].Offset;
+			BlockCompressor::Compress(Image->Format, Texels, Mip.Width, Mip.Height, Image->Encoded.data() + Mip.Offset);
+		}
+		stbi_image_free(Pixels);
+
+		Image->Data = Image->Encoded.data();
+		return Image;
+	}
+
+	Scope<CompressedImage> TextureCompressor::Load(const std::string& filePath, TextureUsage usage)
+	{
+		ASSERT(usage != TextureUsage::None, "Texture Compressor: '{}' has no usage to pick a format by.", filePath);
+		const auto Start = std::chrono::steady_clock::now();
+
+		SourceStamp Stamp;
+		const bool HasStamp = AssetCache::GetSourceStamp(filePath, Stamp);
+		const std::string CachePath = GetCachePath(filePath);
+		if (HasStamp)
+		{
+			if (Scope<CompressedImage> Cached = LoadCache(CachePath, Stamp, usage))
+			{
+				OHM_CORE_TRACE("Texture Compressor: Loaded '{}' ({}) from its cache in {:.2f} ms.", filePath, GetFormatName(Cached->Format), MillisecondsSince(Start));
+				return Cached;
+			}
+		}
+
+		Scope<CompressedImage> Image = Compress(filePath, usage);
+		if (!Image)
+			return nullptr;
+
+		if (HasStamp)
+			WriteCache(CachePath, Stamp, usage, *Image);
+
+		constexpr double BytesPerMB = 1024.0 * 1024.0;
+		OHM_CORE_INFO("Texture Compressor: Compressed '{}' ({}x{}, {} mips) to {} in {:.2f} ms, {:.2f} MB as RGBA8 to {:.2f} MB.",
+			filePath, Image->Width, Image->Height, Image->Mips.size(), GetFormatName(Image->Format), MillisecondsSince(Start),
+			static_cast<double>(Image->Width) * Image->Height * 4 * 4 / 3 / BytesPerMB, Image->Encoded.size() / BytesPerMB);
+		return Image;
+	}
+
+	ImageInternalFormat TextureCompressor::GetFormat(TextureUsage usage, bool hasAlpha)
+	{
+		switch (usage)
+		{
+			case TextureUsage::Albedo:				return hasAlpha ? ImageInternalFormat::BC3 : ImageInternalFormat::BC1;
+			case TextureUsage::AlbedoHighQuality:	return ImageInternalFormat::BC7;
+			case TextureUsage::Normal:				return ImageInternalFormat::BC5;
+			case TextureUsage::Mask:				return ImageInternalFormat::BC4;
+			default:								return ImageInternalFormat::None;
+		}
+	}
+
+	MipSettings TextureCompressor::GetMipSettings(TextureUsage usage)
+	{
+		MipSettings Settings;
+		Settings.Filter = MipFilter::Kaiser;
+		Settings.SRGB = usage == TextureUsage::Albedo || usage == TextureUsage::AlbedoHighQuality;
+		Settings.NormalMap = usage == TextureUsage::Normal;
+		return Settings;
+	}
+
+	std::string TextureCompressor::GetCachePath(const std::string& filePath)
+	{
+		return filePath + CacheExtension;
+	}
+
+	const char* TextureCompressor::GetFormatName(ImageInternalFormat format)
+	{
+		switch (format)
+		{
+			case ImageInternalFormat::BC1:	return "BC1";
+			case ImageInternalFormat::BC3:	return "BC3";
+			case ImageInternalFormat::BC4:	return "BC4";
+			case ImageInternalFormat::BC5:	return "BC5";
+			case ImageInternalFormat::BC7:	return "BC7";
+			default:						return "Uncompressed";
+		}
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Ohm/Rendering/Utility/TextureUtils.h"
+#include "Ohm/Rendering/MipGenerator.h"
+#include "Ohm/Core/MappedFile.h"
+
+namespace Ohm
+{
+	// What a file texture is sampled for, which decides the block compressed format it's stored in.
+	enum class TextureUsage
+	{
+		// Uploaded uncompressed.
+		None = 0,
+		// BC1, or BC3 when the image has alpha.
+		Albedo,
+		// BC7: twice the size of BC1, but without its banding on gradients.
+		AlbedoHighQuality,
+		// BC5 of the X and Y of a tangent space normal map; shaders rebuild Z.
+		Normal,
+		// BC4 of the red channel: roughness, metalness, occlusion and other single channel masks.
+		Mask,
+	};
+
+	struct CompressedMip
+	{
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		// Into CompressedImage::Data.
+		uint64_t Offset = 0;
+		uint64_t Size = 0;
+	};
+
+	// Every mip of an image in one block compressed format, largest first.
+	struct CompressedImage
+	{
+		TextureUtils::ImageInternalFormat Format = TextureUtils::ImageInternalFormat::None;
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		std::vector<CompressedMip> Mips;
+
+		// The mapped cache file, or the encoder's output when the cache couldn't be written.
+		const uint8_t* Data = nullptr;
+		Scope<MappedFile> File;
+		std::vector<uint8_t> Encoded;
+
+		const uint8_t* GetMipData(uint32_t mip) const { return Data + Mips[mip].Offset; }
+	};
+
+	/*
+	 * The asset step between a source image and a block compressed texture.
+	 *
+	 * The image is decoded, flipped like every 2D texture, and filtered down to a full mip chain by MipGenerator, in
+	 * linear light for albedo and renormalized for normal maps.  Each mip is compressed by BlockCompressor into the
+	 * format its usage calls for and the whole chain is written to a cache next to the source file, "<file>.ohmtex".
+	 * The next load of an unchanged file maps the cache and uploads from it as it is.  A cache is rebuilt when the
+	 * source's size or modification time, the usage, or CacheVersion no longer match.
+	 *
+	 * Loading makes no GL calls, so it can run on any thread, including a job.
+	 */
+	class TextureCompressor
+	{
+	public:
+		// Bump whenever the cache layout, the encoder or the mip filter changes.
+		static constexpr uint32_t CacheVersion = 2;
+
+		// Returns nullptr, with an error logged, if the source can't be decoded.
+		static Scope<CompressedImage> Load(const std::string& filePath, TextureUsage usage);
+		static TextureUtils::ImageInternalFormat GetFormat(TextureUsage usage, bool hasAlpha);
+		// How the mips of a texture with this usage are filtered, compressed or not.
+		static MipSettings GetMipSettings(TextureUsage usage);
+		static std::string GetCachePath(const std::string& filePath);
+		static const char* GetFormatName(TextureUtils::ImageInternalFormat format);
+	};
+}
@@ -1,5 +1,6 @@
 #include "ohmpch.h"
 #include "Ohm/Rendering/TextureCube.h"
+#include "Ohm/Rendering/RenderCommand.h"
 
 #include <glad/glad.h>
 #include <stb_image.h>
@@ -7,28 +8,40 @@
 namespace Ohm
 {
 
+	static void SetSamplerParameters(uint32_t id, const TextureCubeSpecification& specification)
+	{
+		glTextureParameteri(id, GL_TEXTURE_WRAP_S, ConvertWrapMode(specification.SamplerWrapS));
+		glTextureParameteri(id, GL_TEXTURE_WRAP_T, ConvertWrapMode(specification.SamplerWrapT));
+		glTextureParameteri(id, GL_TEXTURE_WRAP_R, ConvertWrapMode(specification.SamplerWrapR));
+		glTextureParameteri(id, GL_TEXTURE_MIN_FILTER, ConvertMinMagFilterMode(specification.MinFilter));
+		glTextureParameteri(id, GL_TEXTURE_MAG_FILTER, ConvertMinMagFilterMode(specification.MagFilter));
+	}
+
 	TextureCube::TextureCube(const TextureCubeSpecification& specification, const std::vector<std::string>& cubeFaceFiles)
 		:m_Specification(specification), m_Name(specification.Name)
 	{
 		glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &m_ID);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, m_ID);
 
 		int Width, Height, Channels;
+		bool HasStorage = false;
 
 		for (uint32_t i = 0; i < cubeFaceFiles.size(); i++)
 		{
 			if (unsigned char* Data = stbi_load(cubeFaceFiles[i].c_str(), &Width, &Height, &Channels, 0))
 			{
-				m_Specification.InternalFormat = Channels == 4 ? TextureUtils::ImageInternalFormat::RGBA8 : TextureUtils::ImageInternalFormat::RGB8;
-				m_Specification.DataLayout = Channels == 4 ? TextureUtils::ImageDataLayout::RGBA : TextureUtils::ImageDataLayout::RGB;
-
-				const GLenum InternalFormat = ConvertInternalFormatMode(m_Specification.InternalFormat);
-				const GLenum DataFormat = ConverDataLayoutMode(m_Specification.DataLayout);
+				// Immutable storage needs the size and format up front, so the first face that loads decides them.
+				if (!HasStorage)
+				{
+					m_Specification.InternalFormat = Channels == 4 ? TextureUtils::ImageInternalFormat::RGBA8 : TextureUtils::ImageInternalFormat::RGB8;
+					m_Specification.DataLayout = Channels == 4 ? TextureUtils::ImageDataLayout::RGBA : TextureUtils::ImageDataLayout::RGB;
+					m_Specification.Dimension = Height;
+					glTextureStorage2D(m_ID, GetMipLevelCount(), ConvertInternalFormatMode(m_Specification.InternalFormat), Width, Height);
+					HasStorage = true;
+				}
+
+				const GLenum DataFormat = Channels == 4 ? GL_RGBA : GL_RGB;
 				const GLenum DataType = ConvertImageDataType(m_Specification.DataType);
-				m_Specification.Dimension = Height;
-
-				const auto MipCount = GetMipLevelCount();
-				glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, MipCount, InternalFormat, Width, Height, 0, DataFormat, DataType, Data);
+				glTextureSubImage3D(m_ID, 0, 0, 0, static_cast<GLint>(i), Width, Height, 1, DataFormat, DataType, Data);
 				stbi_image_free(Data);
 			}
 			else
@@ -37,19 +50,11 @@ namespace Ohm
 				stbi_image_free(Data);
 			}
 		}
-		const GLenum WrapModeS = ConvertWrapMode(m_Specification.SamplerWrapS);
-		const GLenum WrapModeT = ConvertWrapMode(m_Specification.SamplerWrapT);
-		const GLenum WrapModeR = ConvertWrapMode(m_Specification.SamplerWrapR);
-		const GLenum MinFilter = ConvertMinMagFilterMode(m_Specification.MinFilter);
-		const GLenum MagFilter = ConvertMinMagFilterMode(m_Specification.MagFilter);
 
-		glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+		if (HasStorage)
+			glGenerateTextureMipmap(m_ID);
 		glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, WrapModeS);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, WrapModeT);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, WrapModeR);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, MinFilter);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, MagFilter);
+		SetSamplerParameters(m_ID, m_Specification);
 	}
 
 	/**
@@ -60,22 +65,10 @@ namespace Ohm
 		:m_Specification(Specification), m_ID(0), m_Name(Specification.Name)
 	{
 		glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &m_ID);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, m_ID);
+		SetSamplerParameters(m_ID, m_Specification);
 
-		const GLenum WrapModeS = ConvertWrapMode(m_Specification.SamplerWrapS);
-		const GLenum WrapModeT = ConvertWrapMode(m_Specification.SamplerWrapT);
-		const GLenum WrapModeR = ConvertWrapMode(m_Specification.SamplerWrapR);
-		const GLenum MinFilter = ConvertMinMagFilterMode(m_Specification.MinFilter);
-		const GLenum MagFilter = ConvertMinMagFilterMode(m_Specification.MagFilter);
 		const GLenum InternalFormat = ConvertInternalFormatMode(m_Specification.InternalFormat);
-
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, WrapModeS);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, WrapModeT);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, WrapModeR);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, MinFilter);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, MagFilter);
-		const auto MipCount = GetMipLevelCount();
-		glTexStorage2D(GL_TEXTURE_CUBE_MAP, MipCount, InternalFormat, Specification.Dimension, Specification.Dimension);
+		glTextureStorage2D(m_ID, GetMipLevelCount(), InternalFormat, Specification.Dimension, Specification.Dimension);
 	}
 
 	void TextureCube::Invalidate(const TextureCubeSpecification& Specification)
@@ -85,38 +78,26 @@ namespace Ohm
 			OHM_TRACE("\t New name for Invalidated Cubemap: {}", m_Specification.Name);
 		m_Specification = Specification;
 		glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &m_ID);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, m_ID);
+		SetSamplerParameters(m_ID, m_Specification);
 
-		const GLenum WrapModeS = ConvertWrapMode(m_Specification.SamplerWrapS);
-		const GLenum WrapModeT = ConvertWrapMode(m_Specification.SamplerWrapT);
-		const GLenum WrapModeR = ConvertWrapMode(m_Specification.SamplerWrapR);
-		const GLenum MinFilter = ConvertMinMagFilterMode(m_Specification.MinFilter);
-		const GLenum MagFilter = ConvertMinMagFilterMode(m_Specification.MagFilter);
 		const GLenum InternalFormat = ConvertInternalFormatMode(m_Specification.InternalFormat);
-
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, WrapModeS);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, WrapModeT);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, WrapModeR);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, MinFilter);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, MagFilter);
-		const auto MipCount = GetMipLevelCount();
-		glTexStorage2D(GL_TEXTURE_CUBE_MAP, MipCount, InternalFormat, Specification.Dimension, Specification.Dimension);
+		glTextureStorage2D(m_ID, GetMipLevelCount(), InternalFormat, Specification.Dimension, Specification.Dimension);
 	}
 
 	TextureCube::~TextureCube()
 	{
 		glDeleteTextures(1, &m_ID);
+		RenderCommand::InvalidateStateCache();
 	}
 
 	void TextureCube::BindToSamplerSlot(uint32_t slot) const
 	{
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTextureUnit(slot, m_ID);
+		RenderCommand::BindTextureUnit(slot, m_ID);
 	}
 
 	void TextureCube::Unbind()
 	{
-		glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+		RenderCommand::BindTextureUnit(0, 0);
 	}
 
 	void TextureCube::BindToImageSlot(uint32_t Binding, uint32_t MipLevel, TextureUtils::TextureAccessLevel AccessLevel, TextureUtils::TextureShaderDataFormat ShaderDataFormat) const
@@ -130,7 +111,7 @@ namespace Ohm
 			return;
 		}
 
-		glBindImageTexture(Binding, m_ID, MipLevel, GL_TRUE, 0, ConvertTextureAccessLevel(AccessLevel), ConvertShaderFormatType(ShaderDataFormat));
+		RenderCommand::BindImageTexture(Binding, m_ID, MipLevel, true, 0, ConvertTextureAccessLevel(AccessLevel), GLShaderDataFormat);
 	}
 
 	void TextureCube::SetData(const void* data, size_t size) const
@@ -141,18 +122,9 @@ namespace Ohm
 		const GLenum PixelLayout = ConverDataLayoutMode(m_Specification.DataLayout);
 		const GLenum DataType = ConvertImageDataType(m_Specification.DataType);
 
-		const std::vector Faces =
-		{
-			GL_TEXTURE_CUBE_MAP_POSITIVE_X,
-			GL_TEXTURE_CUBE_MAP_NEGATIVE_X,
-			GL_TEXTURE_CUBE_MAP_POSITIVE_Y,
-			GL_TEXTURE_CUBE_MAP_NEGATIVE_Y,
-			GL_TEXTURE_CUBE_MAP_POSITIVE_Z,
-			GL_TEXTURE_CUBE_MAP_NEGATIVE_Z,
-		};
-
-		for (const auto Face : Faces)
-			glTexSubImage2D(Face, 0, 0, 0, m_Specification.Dimension, m_Specification.Dimension, PixelLayout, DataType, data);
+		// Faces are layers 0-5 of the cubemap, in +X, -X, +Y, -Y, +Z, -Z order.
+		for (GLint Face = 0; Face < 6; Face++)
+			glTextureSubImage3D(m_ID, 0, 0, 0, Face, m_Specification.Dimension, m_Specification.Dimension, 1, PixelLayout, DataType, data);
 	}
 
 	std::pair<glm::uint32_t, glm::uint32_t> TextureCube::GetMipSize(uint32_t Mip) const
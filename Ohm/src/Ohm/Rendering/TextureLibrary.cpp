@@ -1,34 +1,40 @@
 #include "ohmpch.h"
 #include "Ohm/Rendering/TextureLibrary.h"
+#include "Ohm/Rendering/RenderCommand.h"
+#include "Ohm/Rendering/TextureUploader.h"
+#include "Ohm/Rendering/TextureStreamer.h"
 
 #include <glad/glad.h>
 
 namespace Ohm
 {
+	static std::recursive_mutex s_LibraryMutex;
+
     bool TextureLibrary::Has2D(const std::string& Name)
 	{
-		return s_NameToTexture2DLibrary.find(Name) != s_NameToTexture2DLibrary.end();
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
+		return s_Texture2Ds.Contains(Name);
 	}
 
 	void TextureLibrary::AddTexture2D(const Ref<Texture2D>& texture)
 	{
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
 		if (Has2D(texture->GetName()))
 		{
 			OHM_WARN("Texture2D with name '{}' already contained in Texture Library.", texture->GetName());
 			return;
 		}
 		
-		s_NameToTexture2DLibrary[texture->GetName()] = texture;
-		s_IdToNameLibrary[texture->GetID()] = texture->GetName();
-    	s_TextureLibraryIDs[texture->GetID()] = texture;
+		s_IDToTexture2D[texture->GetID()] = s_Texture2Ds.Add(texture, texture->GetName());
 		OHM_TRACE("Added Texture2D with name: '{}' to the Texture Library.", texture->GetName());
 	}
 
-	Ref<Texture2D> TextureLibrary::LoadTexture2D(const Texture2DSpecification& spec, const std::string& filePath)
+	Ref<Texture2D> TextureLibrary::LoadTexture2D(const Texture2DSpecification& spec, const std::string& filePath, TextureUsage usage)
 	{
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
 		if (!filePath.empty())
 		{
-			Ref<Texture2D> texture = CreateRef<Texture2D>(filePath, spec);
+			Ref<Texture2D> texture = CreateRef<Texture2D>(filePath, spec, usage);
 			AddTexture2D(texture);
 			return texture;
 		}
@@ -40,30 +46,32 @@ namespace Ohm
 
 	bool TextureLibrary::HasCube(const std::string& Name)
 	{
-		return s_NameToTextureCubeLibrary.find(Name) != s_NameToTextureCubeLibrary.end();
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
+		return s_TextureCubes.Contains(Name);
 	}
 
 	void TextureLibrary::AddTextureCube(const Ref<TextureCube>& texture)
 	{
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
 		if (HasCube(texture->GetName()))
 		{
 			OHM_TRACE("TextureCube with name '{}' already contained in Texture Library.", texture->GetName());
 			return;
 		}
 		
-		s_NameToTextureCubeLibrary[texture->GetName()] = texture;
-		s_IdToNameLibrary[texture->GetID()] = texture->GetName();
+		s_IDToTextureCube[texture->GetID()] = s_TextureCubes.Add(texture, texture->GetName());
 		OHM_TRACE("Added TextureCube with name: '{}' to the Texture Library.", texture->GetName());
 	}
 
 	Ref<TextureCube> TextureLibrary::LoadTextureCube(const TextureCubeSpecification& Spec, bool InvalidateIfExists)
 	{
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
 		if(HasCube(Spec.Name))
 		{
 			if(InvalidateIfExists)
-				s_NameToTextureCubeLibrary[Spec.Name]->Invalidate(Spec);
+				InvalidateCube(Spec);
 
-			return s_NameToTextureCubeLibrary[Spec.Name];
+			return GetCube(Spec.Name);
 		}
 		Ref<TextureCube> texture = CreateRef<TextureCube>(Spec);
 		AddTextureCube(texture);
@@ -72,29 +80,35 @@ namespace Ohm
 
 	void TextureLibrary::InvalidateCube(const TextureCubeSpecification& spec)
 	{
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
 		ASSERT(HasCube(spec.Name), "Unable to Invalidate TextureCube with name '{}' - does not exist", spec.Name);
-		const Ref<TextureCube> TextureCube = s_NameToTextureCubeLibrary[spec.Name];
+		// Invalidating creates the texture again under a new renderer ID; the handle stays the same.
+		const TextureCubeHandle CubeHandle = s_TextureCubes.Find(spec.Name);
+		const Ref<TextureCube>& TextureCube = s_TextureCubes.Get(CubeHandle);
+		s_IDToTextureCube.erase(TextureCube->GetID());
 		TextureCube->Invalidate(spec);
+		s_IDToTextureCube[TextureCube->GetID()] = CubeHandle;
 	}
 
 	Ref<Texture2D> TextureLibrary::Get2DFromID(uint32_t ID)
 	{
-		ASSERT(s_IdToNameLibrary.find(ID) != s_IdToNameLibrary.end(), "Unable to find Texture2D with ID: {}", ID);
-		const auto TextureName = s_IdToNameLibrary[ID];
-		ASSERT(s_NameToTexture2DLibrary.find(TextureName) != s_NameToTexture2DLibrary.end(), "Unable to find Texture2D with Name: {}", TextureName);
-		return s_NameToTexture2DLibrary[TextureName];
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
+		const auto It = s_IDToTexture2D.find(ID);
+		ASSERT(It != s_IDToTexture2D.end(), "Unable to find Texture2D with ID: {}", ID);
+		return s_Texture2Ds.Get(It->second);
 	}
 
 	Ref<TextureCube> TextureLibrary::GetCubeFromID(uint32_t ID)
 	{
-		ASSERT(s_IdToNameLibrary.find(ID) != s_IdToNameLibrary.end(), "Unable to find TextureCube with ID: {}", ID);
-		const auto TextureName = s_IdToNameLibrary[ID];
-		ASSERT(s_NameToTexture2DLibrary.find(TextureName) != s_NameToTexture2DLibrary.end(), "Unable to find TextureCube with Name: {}", TextureName);
-		return s_NameToTextureCubeLibrary[TextureName];
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
+		const auto It = s_IDToTextureCube.find(ID);
+		ASSERT(It != s_IDToTextureCube.end(), "Unable to find TextureCube with ID: {}", ID);
+		return s_TextureCubes.Get(It->second);
 	}
 
 	Ref<Texture2D> TextureLibrary::LoadTexture2D(const std::string& filePath)
 	{
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
 		Texture2DSpecification defaultFromFileSpec =
 		{
 			TextureUtils::WrapMode::Repeat,
@@ -112,10 +126,105 @@ namespace Ohm
 		return texture;
 	}
 
+	Ref<Texture2D> TextureLibrary::LoadTexture2D(const std::string& filePath, TextureUsage usage)
+	{
+		const Scope<CompressedImage> Image = TextureCompressor::Load(filePath, usage);
+		// Fails the same way uncompressed, which reports it.
+		if (!Image)
+			return LoadTexture2D(filePath);
+
+		const Texture2DSpecification defaultFromFileSpec =
+		{
+			TextureUtils::WrapMode::Repeat,
+			TextureUtils::WrapMode::Repeat,
+			TextureUtils::FilterMode::LinearMipLinear,
+			TextureUtils::FilterMode::Linear,
+			TextureUtils::ImageInternalFormat::FromImage,
+			TextureUtils::ImageDataLayout::FromImage,
+			TextureUtils::ImageDataType::UByte,
+		};
+
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
+		Ref<Texture2D> texture = CreateRef<Texture2D>(filePath, *Image, defaultFromFileSpec);
+		AddTexture2D(texture);
+		return texture;
+	}
+
+	Ref<Texture2D> TextureLibrary::LoadTexture2DAsync(const std::string& filePath, TextureUsage usage)
+	{
+		const Texture2DSpecification defaultFromFileSpec =
+		{
+			TextureUtils::WrapMode::Repeat,
+			TextureUtils::WrapMode::Repeat,
+			TextureUtils::FilterMode::LinearMipLinear,
+			TextureUtils::FilterMode::Linear,
+			TextureUtils::ImageInternalFormat::FromImage,
+			TextureUtils::ImageDataLayout::FromImage,
+			TextureUtils::ImageDataType::UByte,
+		};
+
+		return LoadTexture2DAsync(defaultFromFileSpec, filePath, usage);
+	}
+
+	Ref<Texture2D> TextureLibrary::LoadTexture2DAsync(const Texture2DSpecification& spec, const std::string& filePath, TextureUsage usage)
+	{
+		ASSERT(spec.DataType == TextureUtils::ImageDataType::UByte, "TextureLibrary: Only 8 bit images can be loaded asynchronously ('{}').", filePath);
+
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
+		Ref<Texture2D> texture = CreateRef<Texture2D>(filePath, spec, Texture2D::DeferredLoad());
+		AddTexture2D(texture);
+		TextureUploader::Enqueue(texture, usage);
+		return texture;
+	}
+
+	Ref<Texture2D> TextureLibrary::LoadTexture2DStreamed(const std::string& filePath, TextureUsage usage)
+	{
+		const Texture2DSpecification defaultFromFileSpec =
+		{
+			TextureUtils::WrapMode::Repeat,
+			TextureUtils::WrapMode::Repeat,
+			TextureUtils::FilterMode::LinearMipLinear,
+			TextureUtils::FilterMode::Linear,
+			TextureUtils::ImageInternalFormat::FromImage,
+			TextureUtils::ImageDataLayout::FromImage,
+			TextureUtils::ImageDataType::UByte,
+		};
+
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
+		Ref<Texture2D> texture = CreateRef<Texture2D>(filePath, defaultFromFileSpec, Texture2D::DeferredLoad());
+		AddTexture2D(texture);
+		TextureStreamer::Register(texture, usage);
+		return texture;
+	}
+
+	void TextureLibrary::UpdateAsyncLoads()
+	{
+		TextureUploader::Update();
+		TextureStreamer::Update();
+	}
+
+	uint32_t TextureLibrary::GetPendingAsyncLoadCount()
+	{
+		return TextureUploader::GetPendingCount() + TextureStreamer::GetPendingCount();
+	}
+
+	uint32_t TextureLibrary::GetResidentID(uint32_t TexID)
+	{
+		// Nothing to look up for the usual case of no loads in flight.
+		if (GetPendingAsyncLoadCount() == 0) return TexID;
+
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
+		const auto It = s_IDToTexture2D.find(TexID);
+		if (It == s_IDToTexture2D.end() || s_Texture2Ds.Get(It->second)->IsResident())
+			return TexID;
+		return GetWhiteTexture()->GetID();
+	}
+
 	Ref<Texture2D> TextureLibrary::LoadTexture2D(const Texture2DSpecification& Spec, void* Data)
 	{
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
 		if(Has2D(Spec.Name))
-			return s_NameToTexture2DLibrary[Spec.Name];
+			return Get2D(Spec.Name);
 
 		Texture2DSpecification defaultFromFileSpec =
 		{
@@ -136,48 +245,82 @@ namespace Ohm
 
 	const Ref<Texture2D>& TextureLibrary::Get2D(const std::string& name)
 	{
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
 		ASSERT(Has2D(name), "No Texture2D with name '{}' found in Texture Library.", name)
-		return s_NameToTexture2DLibrary.at(name);
+		return s_Texture2Ds.Get(s_Texture2Ds.Find(name));
+	}
+
+	const Ref<Texture2D>& TextureLibrary::Get2D(Texture2DHandle handle)
+	{
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
+		return s_Texture2Ds.Get(handle);
+	}
+
+	Texture2DHandle TextureLibrary::GetHandle2D(const std::string& name)
+	{
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
+		return s_Texture2Ds.Find(name);
 	}
 
 	const Ref<TextureCube>& TextureLibrary::GetCube(const std::string& name)
 	{
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
 		ASSERT(HasCube(name), "No TextureCube with name '{}' found in Texture Library.", name)
-		return s_NameToTextureCubeLibrary.at(name);
+		return s_TextureCubes.Get(s_TextureCubes.Find(name));
+	}
+
+	const Ref<TextureCube>& TextureLibrary::GetCube(TextureCubeHandle handle)
+	{
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
+		return s_TextureCubes.Get(handle);
+	}
+
+	TextureCubeHandle TextureLibrary::GetCubeHandle(const std::string& name)
+	{
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
+		return s_TextureCubes.Find(name);
 	}
 
 	void TextureLibrary::BindTexture2DToSlot(const std::string& TwoDimensionTextureName, uint32_t Slot)
 	{
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
 		ASSERT(Has2D(TwoDimensionTextureName), "TextureLibrary: Unable to bind Texture2D with name '{}' to slot '{}'.  This texture has not been registered.", TwoDimensionTextureName, Slot);
-		const auto& Texture2D = s_NameToTexture2DLibrary[TwoDimensionTextureName];
-		glBindTextureUnit(Slot, Texture2D->GetID());
+		const auto& Texture2D = Get2D(TwoDimensionTextureName);
+		RenderCommand::BindTextureUnit(Slot, GetResidentID(Texture2D->GetID()));
 	}
 
 	void TextureLibrary::BindTextureCubeToSlot(const std::string& CubeTextureName, uint32_t Slot)
 	{
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
 		ASSERT(HasCube(CubeTextureName), "TextureLibrary: Unable to bind TextureCube with name '{}' to slot '{}'.  This texture has not been registered.", CubeTextureName, Slot);
-		const auto& TextureCube = s_NameToTextureCubeLibrary[CubeTextureName];
-		glBindTextureUnit(Slot, TextureCube->GetID());
+		const auto& TextureCube = GetCube(CubeTextureName);
+		RenderCommand::BindTextureUnit(Slot, TextureCube->GetID());
 	}
 
 	void TextureLibrary::BindTextureToSlot(uint32_t TexID, uint32_t Slot)
 	{
-		glBindTextureUnit(Slot, TexID);
+		RenderCommand::BindTextureUnit(Slot, GetResidentID(TexID));
 	}
 
 	std::string TextureLibrary::GetNameFromID(uint32_t TextureID)
 	{
-		ASSERT(s_IdToNameLibrary.find(TextureID) != s_IdToNameLibrary.end(), "TextureLibrary: Unable to find texture with ID '{}'.", TextureID);
-		return s_IdToNameLibrary[TextureID];
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
+		if (const auto It = s_IDToTexture2D.find(TextureID); It != s_IDToTexture2D.end())
+			return s_Texture2Ds.GetName(It->second);
+
+		const auto It = s_IDToTextureCube.find(TextureID);
+		ASSERT(It != s_IDToTextureCube.end(), "TextureLibrary: Unable to find texture with ID '{}'.", TextureID);
+		return s_TextureCubes.GetName(It->second);
 	}
 
 	std::unordered_map<std::string, int32_t> TextureLibrary::BindAndGetMaterialTextureSlots(const std::unordered_map<std::string, uint32_t>& textureIDs)
     {
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
     	std::unordered_map<std::string, int32_t> nameToSlotMap;
     	uint32_t currentSlot = 1;
     	for (auto [name, id] : textureIDs)
     	{
-    		if (s_TextureLibraryIDs.find(id) == s_TextureLibraryIDs.end())
+    		if (s_IDToTexture2D.find(id) == s_IDToTexture2D.end())
     		{
     			// THIS NEEDS TO BE UPDATED TO HANDLE TEXTURES THAT HAVEN'T BEEN REGISTERED!
     			//OHM_WARN("Texture with name: '{}' and id: '{}' could not be found in the Texture Library.  Could not bind this texture.  Check that it has been added to the Texture Library.", name, id);
@@ -187,12 +330,12 @@ namespace Ohm
     		if (name == "sampler_ShadowMap")
     		{
     			nameToSlotMap[name] = 0;
-    			glBindTextureUnit(0, id);
+    			RenderCommand::BindTextureUnit(0, id);
     		}
     		else
     		{
     			nameToSlotMap[name] = currentSlot;
-    			glBindTextureUnit(currentSlot++, s_TextureLibraryIDs[id]->GetID());
+    			RenderCommand::BindTextureUnit(currentSlot++, GetResidentID(id));
     		}
     	}
 
@@ -202,6 +345,7 @@ namespace Ohm
 	
 	void TextureLibrary::LoadWhiteTexture()
 	{
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
 		Texture2DSpecification whiteTextureSpec =
 		{	
 			TextureUtils::WrapMode::Repeat,
@@ -219,10 +363,12 @@ namespace Ohm
 		uint32_t whiteTextureData = 0xffffffff;
 		WhiteTexture->SetData(&whiteTextureData, sizeof(uint32_t));
 		AddTexture2D(WhiteTexture);
+		s_WhiteTexture = s_Texture2Ds.Find(WhiteTexture->GetName());
 	}
 
 	void TextureLibrary::LoadBlackTexture()
 	{
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
 		Texture2DSpecification whiteTextureSpec =
 		{	
 			TextureUtils::WrapMode::Repeat,
@@ -244,6 +390,7 @@ namespace Ohm
 
 	void TextureLibrary::LoadBlackTextureCube()
 	{
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
 		const TextureCubeSpecification BlackCubeTextureSpec =
 		{
 			TextureUtils::WrapMode::ClampToEdge,
@@ -262,10 +409,31 @@ namespace Ohm
 		uint32_t blackTextureData = 0xff000000;
 		BlackTextureCube->SetData(&blackTextureData, sizeof(uint32_t));
 		AddTextureCube(BlackTextureCube);
+		s_BlackTextureCube = s_TextureCubes.Find(BlackTextureCube->GetName());
+	}
+
+	const Ref<Texture2D>& TextureLibrary::GetWhiteTexture()
+	{
+		return Get2D(s_WhiteTexture);
+	}
+
+	const Ref<TextureCube>& TextureLibrary::GetBlackTextureCube()
+	{
+		return GetCube(s_BlackTextureCube);
+	}
+
+	std::unordered_map<std::string, Ref<Texture2D>> TextureLibrary::Get2DLibrary()
+	{
+		std::lock_guard<std::recursive_mutex> Lock(s_LibraryMutex);
+		std::unordered_map<std::string, Ref<Texture2D>> Library;
+		s_Texture2Ds.ForEach([&Library](Texture2DHandle, const Ref<Texture2D>& texture, const std::string& name) { Library[name] = texture; });
+		return Library;
 	}
 
-	std::unordered_map<std::string, Ref<Texture2D>> TextureLibrary::s_NameToTexture2DLibrary;
-	std::unordered_map<std::string, Ref<TextureCube>> TextureLibrary::s_NameToTextureCubeLibrary;
-	std::unordered_map<uint32_t, Ref<Texture2D>> TextureLibrary::s_TextureLibraryIDs;
-	std::unordered_map<uint32_t, std::string> TextureLibrary::s_IdToNameLibrary;
+	HandlePool<Texture2D> TextureLibrary::s_Texture2Ds;
+	HandlePool<TextureCube> TextureLibrary::s_TextureCubes;
+	std::unordered_map<uint32_t, Texture2DHandle> TextureLibrary::s_IDToTexture2D;
+	std::unordered_map<uint32_t, TextureCubeHandle> TextureLibrary::s_IDToTextureCube;
+	Texture2DHandle TextureLibrary::s_WhiteTexture;
+	TextureCubeHandle TextureLibrary::s_BlackTextureCube;
 }
@@ -1,10 +1,28 @@
 #pragma once
 #include "Texture2D.h"
 #include "TextureCube.h"
+#include "Ohm/Core/Handle.h"
 
 
 namespace Ohm
 {
+    using Texture2DHandle = Handle<Texture2D>;
+    using TextureCubeHandle = Handle<TextureCube>;
+
+    // Every function may be called from the main thread and the render thread.  Entries are never removed, so
+    // references returned by Get2D and GetCube stay valid.
+    //
+    // Textures loaded with LoadTexture2DAsync are registered at once and decoded and uploaded by TextureUploader.
+    // Until they are resident every bind made through the library binds the White Texture in their place.
+    //
+    // A TextureUsage other than None loads a file block compressed through TextureCompressor, in the format the usage
+    // calls for, in place of the specification's.
+    //
+    // Textures loaded with LoadTexture2DStreamed are managed by TextureStreamer: once their smallest mips are in,
+    // only the levels the scene needs are resident, within the streaming budget.
+    //
+    // Names are for loading and the editor.  Code that runs every frame resolves a handle once, with GetHandle2D or
+    // GetCubeHandle, and looks the texture up by it: an index into the library rather than a string hash.
     class TextureLibrary
     {
     public:
@@ -12,10 +30,23 @@ namespace Ohm
         static Ref<TextureCube> GetCubeFromID(uint32_t ID);
 		
         static Ref<Texture2D> LoadTexture2D(const std::string& filePath = "");
-        static Ref<Texture2D> LoadTexture2D(const Texture2DSpecification& spec, const std::string& filePath = "");
+        // usage only picks the mip filter of the file's uncompressed image.
+        static Ref<Texture2D> LoadTexture2D(const Texture2DSpecification& spec, const std::string& filePath = "", TextureUsage usage = TextureUsage::None);
         static Ref<Texture2D> LoadTexture2D(const Texture2DSpecification& Spec, void* Data);
+        // Compresses the file first if its cache is out of date, which takes a while for a large image.
+        static Ref<Texture2D> LoadTexture2D(const std::string& filePath, TextureUsage usage);
+        // 8 bit images only.  Call from the main thread, which has to call UpdateAsyncLoads every frame.
+        static Ref<Texture2D> LoadTexture2DAsync(const std::string& filePath, TextureUsage usage = TextureUsage::None);
+        static Ref<Texture2D> LoadTexture2DAsync(const Texture2DSpecification& spec, const std::string& filePath, TextureUsage usage = TextureUsage::None);
+        // Call from the main thread.  usage can't be None.
+        static Ref<Texture2D> LoadTexture2DStreamed(const std::string& filePath, TextureUsage usage);
+        static void UpdateAsyncLoads();
+        static uint32_t GetPendingAsyncLoadCount();
         static void AddTexture2D(const Ref<Texture2D>& texture);
         static const Ref<Texture2D>& Get2D(const std::string& name);
+        static const Ref<Texture2D>& Get2D(Texture2DHandle handle);
+        // An invalid handle if no texture by that name has been added.
+        static Texture2DHandle GetHandle2D(const std::string& name);
         static void BindTexture2DToSlot(const std::string& TwoDimensionTextureName, uint32_t Slot);
         static bool Has2D(const std::string& Name);
 
@@ -25,22 +56,31 @@ namespace Ohm
         static void InvalidateCube(const TextureCubeSpecification& spec);
         static void AddTextureCube(const Ref<TextureCube>& texture);
         static const Ref<TextureCube>& GetCube(const std::string& name);
+        static const Ref<TextureCube>& GetCube(TextureCubeHandle handle);
+        static TextureCubeHandle GetCubeHandle(const std::string& name);
         static void BindTextureCubeToSlot(const std::string& CubeTextureName, uint32_t Slot);
         static bool HasCube(const std::string& Name);
 
-        static std::unordered_map<std::string, Ref<Texture2D>> Get2DLibrary() { return s_NameToTexture2DLibrary; }
+        static std::unordered_map<std::string, Ref<Texture2D>> Get2DLibrary();
 
         static void BindTextureToSlot(uint32_t TexID, uint32_t Slot);
+        // The ID to bind for a texture: its own, or the White Texture's while it isn't resident yet.
+        static uint32_t GetResidentID(uint32_t TexID);
         static std::string GetNameFromID(uint32_t TextureID);
 
         static void LoadWhiteTexture();
         static void LoadBlackTexture();
         static void LoadBlackTextureCube();
+        static const Ref<Texture2D>& GetWhiteTexture();
+        static const Ref<TextureCube>& GetBlackTextureCube();
 
     private:
-        static std::unordered_map<std::string, Ref<Texture2D>> s_NameToTexture2DLibrary;
-        static std::unordered_map<std::string, Ref<TextureCube>> s_NameToTextureCubeLibrary;
-		static std::unordered_map<uint32_t, Ref<Texture2D>> s_TextureLibraryIDs;
-        static std::unordered_map<uint32_t, std::string> s_IdToNameLibrary;
+        static HandlePool<Texture2D> s_Texture2Ds;
+        static HandlePool<TextureCube> s_TextureCubes;
+        // Renderer IDs, for the materials and editor panels that only hold those.
+        static std::unordered_map<uint32_t, Texture2DHandle> s_IDToTexture2D;
+        static std::unordered_map<uint32_t, TextureCubeHandle> s_IDToTextureCube;
+        static Texture2DHandle s_WhiteTexture;
+        static TextureCubeHandle s_BlackTextureCube;
     };
 }
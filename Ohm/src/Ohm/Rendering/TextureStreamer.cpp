@@ -0,0 +1,420 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/TextureStreamer.h"
+#include "Ohm/Rendering/Material.h"
+#include "Ohm/Rendering/RenderCommand.h"
+#include "Ohm/Core/JobSystem.h"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <cmath>
+#include <cstring>
+
+// ARB_sparse_texture isn't in the loader; its one entry point is looked up by hand.
+#ifndef GL_TEXTURE_SPARSE_ARB
+#define GL_TEXTURE_SPARSE_ARB 0x91A6
+#define GL_VIRTUAL_PAGE_SIZE_INDEX_ARB 0x91A7
+#define GL_NUM_VIRTUAL_PAGE_SIZES_ARB 0x91A8
+#define GL_NUM_SPARSE_LEVELS_ARB 0x91AA
+#endif
+
+namespace Ohm
+{
+	typedef void (APIENTRYP PFNGLTEXPAGECOMMITMENTARBPROC)(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset,
+		GLsizei width, GLsizei height, GLsizei depth, GLboolean commit);
+
+	// Every implementation of ARB_sparse_texture pages memory in 64 KB.
+	static constexpr uint64_t SparsePageBytes = 64 * 1024;
+
+	struct StreamedTexture
+	{
+		Ref<Texture2D> Texture;
+		Scope<CompressedImage> Image;
+		uint32_t LevelCount = 0;
+		// Levels from here on are always resident.
+		uint32_t TailLevel = 0;
+		// The finest level sampled, which GL_TEXTURE_BASE_LEVEL is set to.
+		uint32_t ResidentLevel = 0;
+		// The finest level holding data.  Finer than ResidentLevel while evicted levels wait to be decommitted, and
+		// for good when the storage isn't sparse.
+		uint32_t ValidLevel = 0;
+		uint32_t WantedLevel = 0;
+		uint32_t TargetLevel = 0;
+		uint64_t LastRequestedFrame = 0;
+		uint64_t DecommitFrame = 0;
+		// The most of this frame's requests.
+		float PixelsPerUV = 0.0f;
+		bool Sparse = false;
+		// Levels from here on make up the sparse mip tail, which is committed as a whole.
+		uint32_t SparseLevelCount = 0;
+
+		uint64_t GetBytes(uint32_t firstLevel) const
+		{
+			uint64_t Bytes = 0;
+			for (uint32_t Level = firstLevel; Level < LevelCount; Level++)
+				Bytes += Image->Mips[Level].Size;
+			return Bytes;
+		}
+
+		uint64_t GetCommittedBytes() const
+		{
+			if (!Sparse)
+				return GetBytes(0);
+
+			uint64_t Bytes = 0, TailBytes = 0;
+			for (uint32_t Level = ValidLevel; Level < LevelCount; Level++)
+			{
+				if (Level < SparseLevelCount)
+					Bytes += (Image->Mips[Level].Size + SparsePageBytes - 1) / SparsePageBytes * SparsePageBytes;
+				else
+					TailBytes += Image->Mips[Level].Size;
+			}
+			return Bytes + (TailBytes + SparsePageBytes - 1) / SparsePageBytes * SparsePageBytes;
+		}
+	};
+
+	struct LoadedImage
+	{
+		Ref<Texture2D> Texture;
+		// Null when the file couldn't be loaded.
+		Scope<CompressedImage> Image;
+	};
+
+	struct TextureStreamerData
+	{
+		// Filled by the jobs loading caches.
+		std::mutex LoadedMutex;
+		std::vector<LoadedImage> Loaded;
+
+		// Main thread only.  Entries are never removed, like the library's.
+		std::vector<StreamedTexture> Textures;
+		std::unordered_map<uint32_t, uint32_t> TextureIndices;
+		uint64_t Budget = TextureStreamer::DefaultBudgetBytes;
+		uint64_t Frame = 0;
+		TextureStreamingStats Stats;
+
+		bool Initialized = false;
+		PFNGLTEXPAGECOMMITMENTARBPROC TexPageCommitment = nullptr;
+
+		std::atomic<uint32_t> PendingCount{ 0 };
+	};
+
+	// Outlives the job system, so loads still running at shutdown have somewhere to go.
+	static TextureStreamerData s_Data;
+
+	static void Initialize()
+	{
+		s_Data.Initialized = true;
+
+		GLint ExtensionCount = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &ExtensionCount);
+		for (GLint i = 0; i < ExtensionCount; i++)
+		{
+			const char* Extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+			if (Extension != nullptr && std::strcmp(Extension, "GL_ARB_sparse_texture") == 0)
+			{
+				s_Data.TexPageCommitment = reinterpret_cast<PFNGLTEXPAGECOMMITMENTARBPROC>(glfwGetProcAddress("glTexPageCommitmentARB"));
+				break;
+			}
+		}
+
+		OHM_CORE_INFO("Texture Streamer: {}", s_Data.TexPageCommitment != nullptr ?
+			"Sparse textures are supported; only resident mips are committed." : "Sparse textures aren't supported; streamed textures are allocated in full.");
+	}
+
+	// Commits or decommits whole levels.  Any level of the mip tail stands for all of it.
+	static void SetCommitment(const StreamedTexture& texture, uint32_t firstLevel, uint32_t endLevel, bool commit)
+	{
+		if (!texture.Sparse || firstLevel >= endLevel) return;
+
+		// The ARB entry point works on the active unit's binding.
+		RenderCommand::SetActiveTextureUnit(0);
+		RenderCommand::BindTextureUnit(0, texture.Texture->GetID());
+		for (uint32_t Level = firstLevel; Level < endLevel; Level++)
+		{
+			const uint32_t CommittedLevel = glm::min(Level, texture.SparseLevelCount);
+			const CompressedMip& Mip = texture.Image->Mips[CommittedLevel];
+			s_Data.TexPageCommitment(GL_TEXTURE_2D, static_cast<GLint>(CommittedLevel), 0, 0, 0, Mip.Width, Mip.Height, 1, commit ? GL_TRUE : GL_FALSE);
+			if (CommittedLevel == texture.SparseLevelCount) break;
+		}
+	}
+
+	static void UploadLevel(const StreamedTexture& texture, uint32_t level)
+	{
+		const CompressedMip& Mip = texture.Image->Mips[level];
+		glCompressedTextureSubImage2D(texture.Texture->GetID(), static_cast<GLint>(level), 0, 0, Mip.Width, Mip.Height,
+			TextureUtils::ConvertInternalFormatMode(texture.Image->Format), static_cast<GLsizei>(Mip.Size), texture.Image->GetMipData(level));
+	}
+
+	static void SetResidentLevel(StreamedTexture& texture, uint32_t level)
+	{
+		texture.ResidentLevel = level;
+		glTextureParameteri(texture.Texture->GetID(), GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(level));
+	}
+
+	void TextureStreamer::Register(const Ref<Texture2D>& texture, TextureUsage usage)
+	{
+		ASSERT(!texture->IsResident(), "Texture Streamer: '{}' wasn't created for a deferred load.", texture->GetName());
+		ASSERT(usage != TextureUsage::None, "Texture Streamer: Only block compressed textures are streamed ('{}').", texture->GetName());
+		s_Data.PendingCount++;
+
+		JobSystem::Submit([texture, usage]()
+			{
+				LoadedImage Loaded;
+				Loaded.Texture = texture;
+				Loaded.Image = TextureCompressor::Load(texture->GetFilePath(), usage);
+
+				std::lock_guard<std::mutex> Lock(s_Data.LoadedMutex);
+				s_Data.Loaded.push_back(std::move(Loaded));
+			});
+	}
+
+	void TextureStreamer::RequestMaterial(const Material& material, float pixelsPerUV)
+	{
+		material.ForEachTexture2DID([pixelsPerUV](uint32_t textureID)
+			{
+				const auto It = s_Data.TextureIndices.find(textureID);
+				if (It == s_Data.TextureIndices.end()) return;
+
+				StreamedTexture& Texture = s_Data.Textures[It->second];
+				Texture.PixelsPerUV = glm::max(Texture.PixelsPerUV, pixelsPerUV);
+			});
+	}
+
+	void TextureStreamer::AddTexture(const Ref<Texture2D>& texture, Scope<CompressedImage> image)
+	{
+		StreamedTexture Texture;
+		Texture.Texture = texture;
+		Texture.Image = std::move(image);
+
+		const uint32_t TextureID = Texture.Texture->GetID();
+		if (s_Data.TexPageCommitment != nullptr)
+		{
+			GLint PageSizeCount = 0;
+			glGetInternalformativ(GL_TEXTURE_2D, TextureUtils::ConvertInternalFormatMode(Texture.Image->Format), GL_NUM_VIRTUAL_PAGE_SIZES_ARB, 1, &PageSizeCount);
+			Texture.Sparse = PageSizeCount > 0;
+		}
+
+		if (Texture.Sparse)
+		{
+			glTextureParameteri(TextureID, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
+			glTextureParameteri(TextureID, GL_VIRTUAL_PAGE_SIZE_INDEX_ARB, 0);
+		}
+		Texture.LevelCount = Texture.Texture->AllocateStorage(*Texture.Image);
+
+		Texture.TailLevel = Texture.LevelCount - 1;
+		for (uint32_t Level = 0; Level < Texture.LevelCount; Level++)
+		{
+			const CompressedMip& Mip = Texture.Image->Mips[Level];
+			if (glm::max(Mip.Width, Mip.Height) <= MinStreamedSize)
+			{
+				Texture.TailLevel = Level;
+				break;
+			}
+		}
+
+		if (Texture.Sparse)
+		{
+			GLint SparseLevelCount = 0;
+			glGetTextureParameteriv(TextureID, GL_NUM_SPARSE_LEVELS_ARB, &SparseLevelCount);
+			Texture.SparseLevelCount = static_cast<uint32_t>(SparseLevelCount);
+			Texture.TailLevel = glm::min(Texture.TailLevel, Texture.SparseLevelCount);
+		}
+
+		SetCommitment(Texture, Texture.TailLevel, Texture.LevelCount, true);
+		for (uint32_t Level = Texture.TailLevel; Level < Texture.LevelCount; Level++)
+			UploadLevel(Texture, Level);
+		Texture.ValidLevel = Texture.WantedLevel = Texture.TargetLevel = Texture.TailLevel;
+		SetResidentLevel(Texture, Texture.TailLevel);
+
+		// Streamed in from the next frame on, like any other level.
+		Texture.LastRequestedFrame = s_Data.Frame;
+		Texture.Texture->m_Resident.store(true, std::memory_order_release);
+		OHM_CORE_TRACE("Texture Streamer: '{}' is resident from level {} of {}{}.", Texture.Texture->GetName(), Texture.TailLevel, Texture.LevelCount,
+			Texture.Sparse ? ", sparse" : "");
+
+		s_Data.TextureIndices[TextureID] = static_cast<uint32_t>(s_Data.Textures.size());
+		s_Data.Textures.push_back(std::move(Texture));
+	}
+
+	// The level whose texels are no smaller on screen than a pixel, or the finest one if none are.
+	static uint32_t CalculateWantedLevel(const StreamedTexture& texture, float pixelsPerUV)
+	{
+		const float TexelsPerUV = static_cast<float>(glm::max(texture.Image->Width, texture.Image->Height));
+		const float Level = std::floor(std::log2(TexelsPerUV / pixelsPerUV));
+		if (!(Level > 0.0f))
+			return 0;
+		return glm::min(static_cast<uint32_t>(Level), texture.TailLevel);
+	}
+
+	// The texture to give up its finest target level for the budget: one holding a level nothing asked for, then the
+	// least recently requested, then the one whose finest level is largest.
+	static StreamedTexture* FindEvictionCandidate()
+	{
+		StreamedTexture* Candidate = nullptr;
+		for (StreamedTexture& Texture : s_Data.Textures)
+		{
+			if (Texture.TargetLevel >= Texture.TailLevel) continue;
+			if (Candidate == nullptr)
+			{
+				Candidate = &Texture;
+				continue;
+			}
+
+			const bool Surplus = Texture.TargetLevel < Texture.WantedLevel;
+			const bool CandidateSurplus = Candidate->TargetLevel < Candidate->WantedLevel;
+			if (Surplus != CandidateSurplus)
+			{
+				if (Surplus) Candidate = &Texture;
+				continue;
+			}
+
+			if (Texture.LastRequestedFrame != Candidate->LastRequestedFrame)
+			{
+				if (Texture.LastRequestedFrame < Candidate->LastRequestedFrame) Candidate = &Texture;
+				continue;
+			}
+
+			if (Texture.Image->Mips[Texture.TargetLevel].Size > Candidate->Image->Mips[Candidate->TargetLevel].Size)
+				Candidate = &Texture;
+		}
+		return Candidate;
+	}
+
+	void TextureStreamer::Update()
+	{
+		if (!s_Data.Initialized)
+			Initialize();
+		s_Data.Frame++;
+
+		std::vector<LoadedImage> Loaded;
+		{
+			std::lock_guard<std::mutex> Lock(s_Data.LoadedMutex);
+			std::swap(Loaded, s_Data.Loaded);
+		}
+
+		for (LoadedImage& Image : Loaded)
+		{
+			s_Data.PendingCount--;
+			if (!Image.Image)
+			{
+				// Left on the placeholder, like a failed TextureUploader load.
+				OHM_CORE_ERROR("Texture Streamer: Failed to load '{}'.", Image.Texture->GetFilePath());
+				continue;
+			}
+			AddTexture(Image.Texture, std::move(Image.Image));
+		}
+
+		// What was asked for, and what the budget leaves of it.  Levels already resident are kept while they fit.
+		uint64_t RequestedBytes = 0, TargetBytes = 0;
+		for (StreamedTexture& Texture : s_Data.Textures)
+		{
+			if (Texture.PixelsPerUV > 0.0f)
+			{
+				Texture.WantedLevel = CalculateWantedLevel(Texture, Texture.PixelsPerUV);
+				Texture.LastRequestedFrame = s_Data.Frame;
+			}
+			else
+				Texture.WantedLevel = Texture.TailLevel;
+			Texture.PixelsPerUV = 0.0f;
+
+			Texture.TargetLevel = glm::min(Texture.WantedLevel, Texture.ResidentLevel);
+			RequestedBytes += Texture.GetBytes(Texture.WantedLevel);
+			TargetBytes += Texture.GetBytes(Texture.TargetLevel);
+		}
+
+		while (TargetBytes > s_Data.Budget)
+		{
+			StreamedTexture* Candidate = FindEvictionCandidate();
+			if (Candidate == nullptr) break;
+
+			TargetBytes -= Candidate->Image->Mips[Candidate->TargetLevel].Size;
+			Candidate->TargetLevel++;
+		}
+
+		for (StreamedTexture& Texture : s_Data.Textures)
+		{
+			if (Texture.TargetLevel <= Texture.ResidentLevel) continue;
+
+			// Sampling stops straight away; the memory goes once no frame in flight can still be sampling it.
+			SetResidentLevel(Texture, Texture.TargetLevel);
+			Texture.DecommitFrame = s_Data.Frame + DecommitDelayFrames;
+		}
+
+		// A level at a time for each texture per pass, so every texture sharpens evenly.  The first upload always goes
+		// out, however large.
+		uint64_t UploadedBytes = 0;
+		for (bool Streaming = true; Streaming && UploadedBytes < UploadBytesPerFrame;)
+		{
+			Streaming = false;
+			for (StreamedTexture& Texture : s_Data.Textures)
+			{
+				if (Texture.TargetLevel >= Texture.ResidentLevel) continue;
+				if (UploadedBytes >= UploadBytesPerFrame) break;
+
+				const uint32_t Level = Texture.ResidentLevel - 1;
+				if (Level < Texture.ValidLevel)
+				{
+					SetCommitment(Texture, Level, Level + 1, true);
+					UploadLevel(Texture, Level);
+					UploadedBytes += Texture.Image->Mips[Level].Size;
+					Texture.ValidLevel = Level;
+				}
+				SetResidentLevel(Texture, Level);
+				Streaming = true;
+			}
+		}
+
+		for (StreamedTexture& Texture : s_Data.Textures)
+		{
+			if (!Texture.Sparse || Texture.ValidLevel >= Texture.ResidentLevel || s_Data.Frame < Texture.DecommitFrame) continue;
+
+			SetCommitment(Texture, Texture.ValidLevel, Texture.ResidentLevel, false);
+			Texture.ValidLevel = Texture.ResidentLevel;
+		}
+
+		TextureStreamingStats& Stats = s_Data.Stats;
+		Stats = {};
+		Stats.BudgetBytes = s_Data.Budget;
+		Stats.RequestedBytes = RequestedBytes;
+		Stats.TextureCount = static_cast<uint32_t>(s_Data.Textures.size());
+		Stats.Sparse = s_Data.TexPageCommitment != nullptr;
+		for (const StreamedTexture& Texture : s_Data.Textures)
+		{
+			Stats.ResidentBytes += Texture.GetBytes(Texture.ResidentLevel);
+			Stats.FullBytes += Texture.GetBytes(0);
+			Stats.AllocatedBytes += Texture.GetCommittedBytes();
+			if (Texture.ResidentLevel > Texture.WantedLevel)
+				Stats.StreamingCount++;
+		}
+	}
+
+	void TextureStreamer::Shutdown()
+	{
+		s_Data.Textures.clear();
+		s_Data.TextureIndices.clear();
+
+		std::lock_guard<std::mutex> Lock(s_Data.LoadedMutex);
+		s_Data.Loaded.clear();
+	}
+
+	void TextureStreamer::SetBudget(uint64_t bytes)
+	{
+		s_Data.Budget = bytes;
+	}
+
+	uint64_t TextureStreamer::GetBudget()
+	{
+		return s_Data.Budget;
+	}
+
+	TextureStreamingStats TextureStreamer::GetStats()
+	{
+		return s_Data.Stats;
+	}
+
+	uint32_t TextureStreamer::GetPendingCount()
+	{
+		return s_Data.PendingCount.load();
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Ohm/Rendering/Texture2D.h"
+#include "Ohm/Rendering/TextureCompressor.h"
+
+namespace Ohm
+{
+	class Material;
+
+	struct TextureStreamingStats
+	{
+		uint64_t BudgetBytes = 0;
+		// Mips holding data and sampled from, the always resident ones included.
+		uint64_t ResidentBytes = 0;
+		// What the last frame asked for, before the budget.
+		uint64_t RequestedBytes = 0;
+		// Every mip of every streamed texture.
+		uint64_t FullBytes = 0;
+		// Storage the driver holds: the committed pages of sparse textures, the whole chain of the others.
+		uint64_t AllocatedBytes = 0;
+		uint32_t TextureCount = 0;
+		// Resident at a coarser level than they were asked for, whether held back by the budget or still loading.
+		uint32_t StreamingCount = 0;
+		bool Sparse = false;
+	};
+
+	/*
+	 * Keeps block compressed file textures resident only down to the mip level the scene needs from them, within a
+	 * budget of video memory.
+	 *
+	 * A streamed texture's compressed cache stays mapped, so any of its mips can be uploaded again without decoding
+	 * anything.  Its smallest mips, up to MinStreamedSize, are uploaded with the texture and never leave.  Every
+	 * frame the renderer passes in how many pixels a unit of UV covers on screen for each material it draws, and
+	 * Update works out the level each texture needs from it.  Levels that are needed are streamed in, largest last, a
+	 * few megabytes a frame; levels that aren't are kept as long as the budget allows and evicted least recently used
+	 * first.  When what's needed doesn't fit either, the largest levels of the least recently used textures go first.
+	 *
+	 * With ARB_sparse_texture, storage is sparse and only the pages of resident levels are committed.  Evicted
+	 * levels are decommitted a few frames after they stopped being sampled, since the render thread may still be
+	 * drawing with them.  Without it the whole chain is allocated, and streaming only limits what's uploaded and
+	 * sampled.  Either way the sampled range is set with GL_TEXTURE_BASE_LEVEL, so the texture's name never changes.
+	 *
+	 * Everything but the job that maps the cache runs on the main thread, on its context.
+	 */
+	class TextureStreamer
+	{
+	public:
+		static constexpr uint64_t DefaultBudgetBytes = 256ull * 1024 * 1024;
+		static constexpr uint32_t UploadBytesPerFrame = 8 * 1024 * 1024;
+		// Mips no larger than this on either axis are always resident.
+		static constexpr uint32_t MinStreamedSize = 64;
+		// Frames an evicted level stays committed for, so a frame in flight on the render thread can finish with it.
+		static constexpr uint32_t DecommitDelayFrames = 3;
+
+		// The texture must have been created with Texture2D::DeferredLoad.  usage can't be None.
+		static void Register(const Ref<Texture2D>& texture, TextureUsage usage);
+		// pixelsPerUV is the most pixels one unit of UV covers, along either axis, wherever the material was drawn.
+		static void RequestMaterial(const Material& material, float pixelsPerUV);
+		static void Update();
+		static void Shutdown();
+
+		static void SetBudget(uint64_t bytes);
+		static uint64_t GetBudget();
+		static TextureStreamingStats GetStats();
+		// Registered textures whose smallest mips aren't resident yet, failed loads excluded.
+		static uint32_t GetPendingCount();
+
+	private:
+		// Allocates the storage of a texture whose cache has been mapped and uploads the mips that are always resident.
+		static void AddTexture(const Ref<Texture2D>& texture, Scope<CompressedImage> image);
+	};
+}
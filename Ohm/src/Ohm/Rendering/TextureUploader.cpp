@@ -0,0 +1,259 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/TextureUploader.h"
+#include "Ohm/Rendering/MipGenerator.h"
+#include "Ohm/Rendering/RenderCommand.h"
+#include "Ohm/Core/JobSystem.h"
+
+#include <glad/glad.h>
+#include <stb_image.h>
+#include <cstring>
+
+namespace Ohm
+{
+	struct DecodedImage
+	{
+		Ref<Texture2D> Texture;
+		// Both null when the file couldn't be decoded.
+		unsigned char* Pixels = nullptr;
+		Scope<CompressedImage> Compressed;
+		int Width = 0, Height = 0, Channels = 0;
+		// Mips 1 and up of Pixels, generated on the worker when the texture samples mips.
+		std::vector<MipLevel> Mips;
+		std::vector<uint8_t> MipData;
+	};
+
+	// A texture whose storage exists and whose rows are being copied in, one level after the other: rows of texels,
+	// or of blocks for a compressed image.
+	struct PendingUpload
+	{
+		DecodedImage Image;
+		uint32_t MipLevels = 1;
+		uint32_t Level = 0;
+		uint32_t NextRow = 0;
+
+		uint32_t GetRowBytes() const
+		{
+			if (Image.Compressed)
+				return TextureUtils::GetCompressedImageSize(Image.Compressed->Format, Image.Compressed->Mips[Level].Width, 1);
+			const uint32_t Width = Level == 0 ? static_cast<uint32_t>(Image.Width) : Image.Mips[Level - 1].Width;
+			return Width * static_cast<uint32_t>(Image.Channels);
+		}
+
+		uint32_t GetRowCount() const
+		{
+			if (Image.Compressed)
+				return (Image.Compressed->Mips[Level].Height + 3) / 4;
+			return Level == 0 ? static_cast<uint32_t>(Image.Height) : Image.Mips[Level - 1].Height;
+		}
+
+		const uint8_t* GetRow(uint32_t row) const
+		{
+			const uint8_t* Base = Image.Compressed ? Image.Compressed->GetMipData(Level) :
+				Level == 0 ? Image.Pixels : Image.MipData.data() + Image.Mips[Level - 1].Offset;
+			return Base + static_cast<size_t>(row) * GetRowBytes();
+		}
+	};
+
+	// Rows of one level of a texture copied into the current segment, at Offset bytes into it.
+	struct UploadSlice
+	{
+		Texture2D* Texture = nullptr;
+		uint32_t Level = 0;
+		uint32_t FirstRow = 0;
+		uint32_t RowCount = 0;
+		uint32_t Offset = 0;
+		uint32_t Size = 0;
+	};
+
+	struct TextureUploaderData
+	{
+		// Filled by the workers decoding.
+		std::mutex DecodedMutex;
+		std::vector<DecodedImage> Decoded;
+
+		// Main thread only.
+		std::deque<PendingUpload> Uploads;
+		std::vector<UploadSlice> Slices;
+		// Textures whose last rows went out on the previous Update.
+		std::vector<Ref<Texture2D>> Uploaded;
+		std::vector<Ref<Texture2D>> Completed;
+
+		uint32_t PixelBuffer = 0;
+		GLsync SegmentFences[TextureUploader::SegmentCount]{};
+		uint32_t Segment = 0;
+
+		std::atomic<uint32_t> PendingCount{ 0 };
+	};
+
+	// Outlives the job system, so decodes still running at shutdown have somewhere to go.
+	static TextureUploaderData s_Data;
+
+	void TextureUploader::Enqueue(const Ref<Texture2D>& texture, TextureUsage usage)
+	{
+		ASSERT(!texture->IsResident(), "Texture Uploader: '{}' wasn't created for a deferred load.", texture->GetName());
+		s_Data.PendingCount++;
+
+		const bool GenerateMips = texture->SamplesMips();
+		JobSystem::Submit([texture, usage, GenerateMips]()
+			{
+				DecodedImage Image;
+				Image.Texture = texture;
+				if (usage != TextureUsage::None)
+					Image.Compressed = TextureCompressor::Load(texture->GetFilePath(), usage);
+				else
+					Image.Pixels = stbi_load(texture->GetFilePath().c_str(), &Image.Width, &Image.Height, &Image.Channels, 0);
+
+				if (Image.Pixels != nullptr && GenerateMips)
+				{
+					const uint32_t Width = static_cast<uint32_t>(Image.Width), Height = static_cast<uint32_t>(Image.Height);
+					Image.MipData = MipGenerator::GenerateChain(Image.Pixels, Width, Height, static_cast<uint32_t>(Image.Channels),
+						TextureUtils::CalculateMipLevelCount(Width, Height), TextureCompressor::GetMipSettings(usage), Image.Mips);
+				}
+
+				std::lock_guard<std::mutex> Lock(s_Data.DecodedMutex);
+				s_Data.Decoded.push_back(std::move(Image));
+			});
+	}
+
+	void TextureUploader::Update()
+	{
+		for (const Ref<Texture2D>& Texture : s_Data.Uploaded)
+		{
+			Texture->m_Resident.store(true, std::memory_order_release);
+			OHM_CORE_TRACE("Texture Uploader: '{}' is resident.", Texture->GetName());
+		}
+		s_Data.PendingCount -= static_cast<uint32_t>(s_Data.Uploaded.size());
+		s_Data.Uploaded.clear();
+		std::swap(s_Data.Uploaded, s_Data.Completed);
+
+		std::vector<DecodedImage> Decoded;
+		{
+			std::lock_guard<std::mutex> Lock(s_Data.DecodedMutex);
+			std::swap(Decoded, s_Data.Decoded);
+		}
+
+		for (DecodedImage& Image : Decoded)
+		{
+			if (Image.Pixels == nullptr && !Image.Compressed)
+			{
+				// It keeps sampling as the placeholder.
+				OHM_CORE_ERROR("Texture Uploader: Failed to load '{}'.", Image.Texture->GetFilePath());
+				s_Data.PendingCount--;
+				continue;
+			}
+
+			const uint32_t MipLevels = Image.Compressed ? Image.Texture->AllocateStorage(*Image.Compressed) :
+				Image.Texture->AllocateStorage(Image.Width, Image.Height, Image.Channels);
+			s_Data.Uploads.push_back({ std::move(Image), MipLevels });
+		}
+
+		if (s_Data.Uploads.empty()) return;
+
+		if (s_Data.PixelBuffer == 0)
+		{
+			glCreateBuffers(1, &s_Data.PixelBuffer);
+			glNamedBufferStorage(s_Data.PixelBuffer, static_cast<GLsizeiptr>(UploadBytesPerFrame) * SegmentCount, nullptr, GL_MAP_WRITE_BIT);
+		}
+
+		// Normally signalled long ago: the segment was last used SegmentCount frames back.
+		GLsync& Fence = s_Data.SegmentFences[s_Data.Segment];
+		if (Fence != nullptr)
+		{
+			glClientWaitSync(Fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+			glDeleteSync(Fence);
+			Fence = nullptr;
+		}
+
+		const GLintptr SegmentOffset = static_cast<GLintptr>(s_Data.Segment) * UploadBytesPerFrame;
+		auto* Mapped = static_cast<unsigned char*>(glMapNamedBufferRange(s_Data.PixelBuffer, SegmentOffset, UploadBytesPerFrame,
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+
+		// Whole rows only; a row never outgrows a segment, which would take an image over two million pixels wide.
+		s_Data.Slices.clear();
+		uint32_t Used = 0;
+		while (!s_Data.Uploads.empty())
+		{
+			PendingUpload& Upload = s_Data.Uploads.front();
+			const uint32_t RowBytes = Upload.GetRowBytes();
+			const uint32_t RowCount = std::min(Upload.GetRowCount() - Upload.NextRow, (UploadBytesPerFrame - Used) / RowBytes);
+			if (RowCount == 0) break;
+
+			std::memcpy(Mapped + Used, Upload.GetRow(Upload.NextRow), static_cast<size_t>(RowCount) * RowBytes);
+			s_Data.Slices.push_back({ Upload.Image.Texture.get(), Upload.Level, Upload.NextRow, RowCount, Used, RowCount * RowBytes });
+			Upload.NextRow += RowCount;
+			Used += RowCount * RowBytes;
+
+			if (Upload.NextRow < Upload.GetRowCount())
+				continue;
+
+			if (Upload.Level + 1 < Upload.MipLevels)
+			{
+				Upload.Level++;
+				Upload.NextRow = 0;
+				continue;
+			}
+
+			stbi_image_free(Upload.Image.Pixels);
+			s_Data.Completed.push_back(Upload.Image.Texture);
+			s_Data.Uploads.pop_front();
+		}
+		glUnmapNamedBuffer(s_Data.PixelBuffer);
+
+		// Tightly packed rows, as in Texture2D's file constructor.
+		RenderCommand::BindPixelUnpackBuffer(s_Data.PixelBuffer);
+		RenderCommand::SetUnpackAlignment(1);
+		for (const UploadSlice& Slice : s_Data.Slices)
+		{
+			const Texture2DSpecification& Specification = Slice.Texture->GetSpecification();
+			const void* Offset = reinterpret_cast<const void*>(static_cast<uintptr_t>(SegmentOffset + Slice.Offset));
+			const auto [MipWidth, MipHeight] = Slice.Texture->GetMipSize(Slice.Level);
+			if (TextureUtils::IsBlockCompressed(Specification.InternalFormat))
+			{
+				// A block row is four texel rows, fewer only where it reaches the bottom of the level.
+				const uint32_t FirstY = Slice.FirstRow * 4;
+				const uint32_t Height = std::min(Slice.RowCount * 4, MipHeight - FirstY);
+				glCompressedTextureSubImage2D(Slice.Texture->GetID(), Slice.Level, 0, FirstY, MipWidth, Height,
+					TextureUtils::ConvertInternalFormatMode(Specification.InternalFormat), Slice.Size, Offset);
+				continue;
+			}
+
+			glTextureSubImage2D(Slice.Texture->GetID(), Slice.Level, 0, Slice.FirstRow, MipWidth, Slice.RowCount,
+				TextureUtils::ConverDataLayoutMode(Specification.PixelLayoutFormat), GL_UNSIGNED_BYTE, Offset);
+		}
+		RenderCommand::SetUnpackAlignment(4);
+		RenderCommand::BindPixelUnpackBuffer(0);
+
+		Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		s_Data.Segment = (s_Data.Segment + 1) % SegmentCount;
+	}
+
+	void TextureUploader::Shutdown()
+	{
+		for (GLsync& Fence : s_Data.SegmentFences)
+		{
+			if (Fence != nullptr)
+				glDeleteSync(Fence);
+			Fence = nullptr;
+		}
+
+		if (s_Data.PixelBuffer != 0)
+			glDeleteBuffers(1, &s_Data.PixelBuffer);
+		s_Data.PixelBuffer = 0;
+
+		for (PendingUpload& Upload : s_Data.Uploads)
+			stbi_image_free(Upload.Image.Pixels);
+		s_Data.Uploads.clear();
+
+		std::lock_guard<std::mutex> Lock(s_Data.DecodedMutex);
+		for (DecodedImage& Image : s_Data.Decoded)
+			stbi_image_free(Image.Pixels);
+		s_Data.Decoded.clear();
+		s_Data.Uploaded.clear();
+		s_Data.Completed.clear();
+	}
+
+	uint32_t TextureUploader::GetPendingCount()
+	{
+		return s_Data.PendingCount.load();
+	}
+}
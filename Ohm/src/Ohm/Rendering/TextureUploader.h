@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Ohm/Rendering/Texture2D.h"
+#include "Ohm/Rendering/TextureCompressor.h"
+
+namespace Ohm
+{
+	/*
+	 * Loads the images of deferred textures without stalling the thread that asked for them.
+	 *
+	 * Files are decoded by stb_image on the job system, or, for a texture with a usage, loaded block compressed by
+	 * TextureCompressor, which compresses them there first if their cache is out of date.  Update, called once a
+	 * frame on the main thread, allocates each decoded texture's storage and copies its rows through a ring of pixel
+	 * buffer segments, at most UploadBytesPerFrame a frame, so a large image is spread over several frames rather
+	 * than blocking one.  Each segment is fenced and only rewritten once the GPU has read it.  Images are copied a
+	 * level at a time: compressed ones bring their mips from the cache, and the others have theirs generated by
+	 * MipGenerator on the worker that decoded them, so the render thread never filters.
+	 *
+	 * A texture is marked resident on the Update after its last rows were issued.  By then the frame that
+	 * issued them has been fenced for the render thread, which therefore never samples a half-uploaded texture.
+	 */
+	class TextureUploader
+	{
+	public:
+		static constexpr uint32_t UploadBytesPerFrame = 8 * 1024 * 1024;
+		// Frames a segment may still be in flight for, plus the one being written.
+		static constexpr uint32_t SegmentCount = 3;
+
+		// The texture must have been created with Texture2D::DeferredLoad.
+		static void Enqueue(const Ref<Texture2D>& texture, TextureUsage usage = TextureUsage::None);
+		static void Update();
+		static void Shutdown();
+
+		// Textures enqueued and not yet resident, failed loads excluded.
+		static uint32_t GetPendingCount();
+	};
+}
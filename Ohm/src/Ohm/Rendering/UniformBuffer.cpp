@@ -1,5 +1,6 @@
 #include "ohmpch.h"
 #include "Ohm/Rendering/UniformBuffer.h"
+#include "Ohm/Rendering/RenderCommand.h"
 #include <glad/glad.h>
 
 namespace Ohm
@@ -9,17 +10,28 @@ namespace Ohm
 	{
 		glCreateBuffers(1, &m_ID);
 		glNamedBufferData(m_ID, size, nullptr, GL_DYNAMIC_DRAW);
-		glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_ID);
+		RenderCommand::BindBufferBase(GL_UNIFORM_BUFFER, binding, m_ID);
 	}
 
 	UniformBuffer::~UniformBuffer()
 	{
 		glDeleteBuffers(1, &m_ID);
+		RenderCommand::InvalidateStateCache();
 	}
 
 	void UniformBuffer::SetData(const void* data, uint32_t size, uint32_t offset /*= 0*/)
 	{
-		glBindBufferBase(GL_UNIFORM_BUFFER, m_Binding, m_ID);
+		RenderCommand::BindBufferBase(GL_UNIFORM_BUFFER, m_Binding, m_ID);
 		glNamedBufferSubData(m_ID, offset, size, data);
 	}
+
+	void UniformBuffer::Update(const void* data, uint32_t size, uint32_t offset) const
+	{
+		glNamedBufferSubData(m_ID, offset, size, data);
+	}
+
+	void UniformBuffer::BindRange(uint32_t offset, uint32_t size) const
+	{
+		RenderCommand::BindBufferRange(GL_UNIFORM_BUFFER, m_Binding, m_ID, offset, size);
+	}
 }
\ No newline at end of file
@@ -9,6 +9,12 @@ namespace Ohm
 		~UniformBuffer();
 
 		void SetData(const void* data, uint32_t size, uint32_t offset = 0);
+		// Writes a sub-range without touching the binding point.
+		void Update(const void* data, uint32_t size, uint32_t offset) const;
+		void BindRange(uint32_t offset, uint32_t size) const;
+
+		uint32_t GetBinding() const { return m_Binding; }
+		uint32_t GetID() const { return m_ID; }
 
 	private:
 		uint32_t m_Binding;
@@ -2,6 +2,14 @@
 #include "Ohm/Rendering/Utility/TextureUtils.h"
 #include <glad/glad.h>
 
+// S3TC isn't core, but every desktop driver has it; glad wasn't generated with the extension.
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
 namespace Ohm
 {
 	namespace TextureUtils
@@ -11,6 +19,60 @@ namespace Ohm
 			return (uint32_t)std::floor(std::log2(glm::min(width, height))) + 1;
 		}
 
+		uint32_t GetBytesPerPixel(ImageInternalFormat internalFormat)
+		{
+			switch (internalFormat)
+			{
+			case ImageInternalFormat::R8:			return 1;
+			case ImageInternalFormat::R16:			return 2;
+			case ImageInternalFormat::RG8:			return 2;
+			case ImageInternalFormat::RG16:			return 4;
+			case ImageInternalFormat::RGB4:			return 2;
+			case ImageInternalFormat::RGB5:			return 2;
+			case ImageInternalFormat::RGB8:			return 3;
+			case ImageInternalFormat::RGB10:		return 4;
+			case ImageInternalFormat::RGB12:		return 5;
+			case ImageInternalFormat::RGBA2:		return 1;
+			case ImageInternalFormat::RGBA4:		return 2;
+			case ImageInternalFormat::RGBA8:		return 4;
+			case ImageInternalFormat::RGBA12:		return 6;
+			case ImageInternalFormat::RGBA16:		return 8;
+			case ImageInternalFormat::R16F:			return 2;
+			case ImageInternalFormat::RG16F:		return 4;
+			case ImageInternalFormat::RGB16F:		return 6;
+			case ImageInternalFormat::RGBA16F:		return 8;
+			case ImageInternalFormat::R32F:			return 4;
+			case ImageInternalFormat::RG32F:		return 8;
+			case ImageInternalFormat::RGB32F:		return 12;
+			case ImageInternalFormat::RGBA32F:		return 16;
+			case ImageInternalFormat::R11FG11FB10F:	return 4;
+			default:								return 0;
+			}
+		}
+
+		bool IsBlockCompressed(ImageInternalFormat internalFormat)
+		{
+			return GetBytesPerBlock(internalFormat) != 0;
+		}
+
+		uint32_t GetBytesPerBlock(ImageInternalFormat internalFormat)
+		{
+			switch (internalFormat)
+			{
+			case ImageInternalFormat::BC1:			return 8;
+			case ImageInternalFormat::BC3:			return 16;
+			case ImageInternalFormat::BC4:			return 8;
+			case ImageInternalFormat::BC5:			return 16;
+			case ImageInternalFormat::BC7:			return 16;
+			default:								return 0;
+			}
+		}
+
+		uint32_t GetCompressedImageSize(ImageInternalFormat internalFormat, uint32_t width, uint32_t height)
+		{
+			return ((width + 3) / 4) * ((height + 3) / 4) * GetBytesPerBlock(internalFormat);
+		}
+
 		GLenum ConvertWrapMode(WrapMode wrapMode)
 		{
 			switch (wrapMode)
@@ -72,6 +134,12 @@ namespace Ohm
 			case ImageInternalFormat::RG32F:		return GL_RG32F;
 			case ImageInternalFormat::RGB32F:		return GL_RGB32F;
 			case ImageInternalFormat::RGBA32F:		return GL_RGBA32F;
+			case ImageInternalFormat::R11FG11FB10F:	return GL_R11F_G11F_B10F;
+			case ImageInternalFormat::BC1:			return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+			case ImageInternalFormat::BC3:			return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			case ImageInternalFormat::BC4:			return GL_COMPRESSED_RED_RGTC1;
+			case ImageInternalFormat::BC5:			return GL_COMPRESSED_RG_RGTC2;
+			case ImageInternalFormat::BC7:			return GL_COMPRESSED_RGBA_BPTC_UNORM;
 			}
 
 			return 0;
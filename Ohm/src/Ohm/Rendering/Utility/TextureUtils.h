@@ -16,6 +16,9 @@ namespace Ohm
 			RGBA, RGB, RG, Red, DepthStencil, Depth,
 			R8, R16, RG8, RG16, RGB4, RGB5, RGB8, RGB10, RGB12, RGBA2, RGBA4, RGBA8, RGBA12, RGBA16,
 			R16F, RG16F, RGB16F, RGBA16F, R32F, RG32F, RGB32F, RGBA32F,
+			R11FG11FB10F,
+			// Block compressed, 4x4 texels a block: BC1 and BC4 in 8 bytes, the rest in 16.
+			BC1, BC3, BC4, BC5, BC7,
 		};
 		enum class ImageDataLayout { None = 0, FromImage, RGBA, RGB, RG, Red, RGBAInt, RGBInt, RGInt, RedInt, Stencil, Depth, DepthStencil };
 		enum class ImageDataType { None = 0, UByte, Byte, UShort, Short, UInt, Int, HalfFloat, Float };
@@ -23,6 +26,11 @@ namespace Ohm
 		enum class TextureShaderDataFormat { None = 0, RGBA32F, RGBA16F, RG32F, RG16F, R11FG11FB10F, R32F, R16F, RGBA8 };
 
 		uint32_t CalculateMipLevelCount(uint32_t width, uint32_t height);
+		uint32_t GetBytesPerPixel(ImageInternalFormat internalFormat);
+		bool IsBlockCompressed(ImageInternalFormat internalFormat);
+		uint32_t GetBytesPerBlock(ImageInternalFormat internalFormat);
+		// Bytes of a width x height image in a block compressed format, partial blocks at the edges included.
+		uint32_t GetCompressedImageSize(ImageInternalFormat internalFormat, uint32_t width, uint32_t height);
 
 		GLenum ConvertWrapMode(WrapMode wrapMode);
 		GLenum ConvertMinMagFilterMode(FilterMode filterMode);
@@ -0,0 +1,65 @@
+#include "ohmpch.h"
+#include "Ohm/Rendering/Vertex.h"
+
+#include <glm/gtc/packing.hpp>
+
+namespace Ohm
+{
+	static glm::vec2 SignNotZero(const glm::vec2& value)
+	{
+		return { value.x >= 0.0f ? 1.0f : -1.0f, value.y >= 0.0f ? 1.0f : -1.0f };
+	}
+
+	// Projects the unit sphere onto an octahedron and unfolds it into [-1, 1]^2.
+	static glm::vec2 OctahedralEncode(const glm::vec3& direction)
+	{
+		const glm::vec3 Projected = direction / (glm::abs(direction.x) + glm::abs(direction.y) + glm::abs(direction.z));
+		const glm::vec2 Upper = { Projected.x, Projected.y };
+		if (Projected.z >= 0.0f)
+			return Upper;
+
+		return (1.0f - glm::abs(glm::vec2(Upper.y, Upper.x))) * SignNotZero(Upper);
+	}
+
+	static glm::vec3 OctahedralDecode(const glm::vec2& encoded)
+	{
+		glm::vec3 Direction = { encoded.x, encoded.y, 1.0f - glm::abs(encoded.x) - glm::abs(encoded.y) };
+		const float Fold = glm::max(-Direction.z, 0.0f);
+		Direction.x += Direction.x >= 0.0f ? -Fold : Fold;
+		Direction.y += Direction.y >= 0.0f ? -Fold : Fold;
+		return glm::normalize(Direction);
+	}
+
+	PackedVertex PackedVertex::Pack(const Vertex& vertex)
+	{
+		const glm::vec3 Normal = glm::length(vertex.Normal) > 0.0f ? glm::normalize(vertex.Normal) : glm::vec3(0.0f, 1.0f, 0.0f);
+
+		// Only the part of the tangent perpendicular to the normal survives; meshes without one get any perpendicular.
+		glm::vec3 Tangent = vertex.Tangent - Normal * glm::dot(Normal, vertex.Tangent);
+		if (glm::dot(Tangent, Tangent) < 1e-12f)
+			Tangent = glm::abs(Normal.x) < 0.9f ? glm::cross(Normal, glm::vec3(1.0f, 0.0f, 0.0f)) : glm::cross(Normal, glm::vec3(0.0f, 1.0f, 0.0f));
+		Tangent = glm::normalize(Tangent);
+
+		const float Handedness = glm::dot(glm::cross(Normal, Tangent), vertex.Binormal) < 0.0f ? -1.0f : 1.0f;
+
+		PackedVertex Packed;
+		Packed.Position = vertex.Position;
+		Packed.Normal = glm::packSnorm2x16(OctahedralEncode(Normal));
+		Packed.Tangent = glm::packSnorm3x10_1x2(glm::vec4(OctahedralEncode(Tangent), 1.0f, Handedness));
+		Packed.TexCoord = glm::packHalf2x16(vertex.TexCoord);
+		return Packed;
+	}
+
+	Vertex PackedVertex::Unpack() const
+	{
+		const glm::vec4 TangentAndSign = glm::unpackSnorm3x10_1x2(Tangent);
+
+		Vertex Unpacked;
+		Unpacked.Position = Position;
+		Unpacked.Normal = OctahedralDecode(glm::unpackSnorm2x16(Normal));
+		Unpacked.Tangent = OctahedralDecode(glm::vec2(TangentAndSign));
+		Unpacked.Binormal = glm::cross(Unpacked.Normal, Unpacked.Tangent) * (TangentAndSign.w < 0.0f ? -1.0f : 1.0f);
+		Unpacked.TexCoord = glm::unpackHalf2x16(TexCoord);
+		return Unpacked;
+	}
+}
@@ -11,4 +11,28 @@ namespace Ohm
 		glm::vec3 Binormal {0.0f};
 		glm::vec2 TexCoord {0.0f};
 	};
-}
\ No newline at end of file
+
+	// How a mesh's vertices are laid out on the GPU.  Meshes always keep their CPU-side vertices as Vertex.
+	enum class VertexFormat { Full = 0, Packed };
+
+	/*
+	 * Vertex squeezed into 24 bytes instead of 56.  Normal and tangent are octahedral-encoded unit vectors, the
+	 * binormal is rebuilt in the shader from their cross product and a handedness sign, and texture coordinates
+	 * are half floats.  The shader side lives in assets/shaders/VertexInput.glsl.
+	 */
+	struct PackedVertex
+	{
+		glm::vec3 Position {0.0f};
+		// Two snorm16.
+		uint32_t Normal = 0;
+		// Tangent in x and y (snorm10), always 1 in z so shaders can tell the formats apart, handedness in w (snorm2).
+		uint32_t Tangent = 0;
+		// Two half floats.
+		uint32_t TexCoord = 0;
+
+		static PackedVertex Pack(const Vertex& vertex);
+		// The vertex the shader decodes, binormal included.
+		Vertex Unpack() const;
+	};
+	static_assert(sizeof(PackedVertex) == 24, "PackedVertex must match the packed buffer layout.");
+}
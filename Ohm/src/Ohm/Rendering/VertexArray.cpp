@@ -1,5 +1,6 @@
 #include "ohmpch.h"
 #include "Ohm/Rendering/VertexArray.h"
+#include "Ohm/Rendering/RenderCommand.h"
 
 #include <glad/glad.h>
 
@@ -16,6 +17,9 @@ namespace Ohm
 			case ShaderDataType::Float3:	
 			case ShaderDataType::Float4:	return GL_FLOAT;
 			case ShaderDataType::Int:		return GL_INT;
+			case ShaderDataType::Short2:	return GL_SHORT;
+			case ShaderDataType::Half2:		return GL_HALF_FLOAT;
+			case ShaderDataType::Int10_10_10_2: return GL_INT_2_10_10_10_REV;
 			default:						return GL_FLOAT;
 		}
 	}
@@ -23,27 +27,28 @@ namespace Ohm
 	VertexArray::VertexArray()
 	{
 		glCreateVertexArrays(1, &m_ID);
-		glBindVertexArray(m_ID);
+		RenderCommand::BindVertexArray(m_ID);
 	}
 
 	VertexArray::~VertexArray()
 	{
 		glDeleteVertexArrays(1, &m_ID);
+		RenderCommand::InvalidateStateCache();
 	}
 
 	void VertexArray::Bind() const
 	{
-		glBindVertexArray(m_ID);
+		RenderCommand::BindVertexArray(m_ID);
 	}
 
 	void VertexArray::Unbind() const
 	{
-		glBindVertexArray(0);
+		RenderCommand::BindVertexArray(0);
 	}
 
 	void VertexArray::EnableVertexAttributes(const Ref<VertexBuffer>& vertexBuffer)
 	{
-		glBindVertexArray(m_ID);
+		RenderCommand::BindVertexArray(m_ID);
 		vertexBuffer->Bind();
 
 		const auto& layout = vertexBuffer->GetLayout();
@@ -51,6 +56,9 @@ namespace Ohm
 		uint32_t index = 0;
 		for (const auto& element : layout)
 		{
+			if (element.Location != UINT32_MAX)
+				index = element.Location;
+
 			glEnableVertexAttribArray(index);
 			glVertexAttribPointer(
 				index,
@@ -66,7 +74,7 @@ namespace Ohm
 
 	void VertexArray::SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer)
 	{
-		glBindVertexArray(m_ID);
+		RenderCommand::BindVertexArray(m_ID);
 		indexBuffer->Bind();
 		m_IndexBuffer = indexBuffer;
 	}
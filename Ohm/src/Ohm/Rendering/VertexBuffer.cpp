@@ -1,5 +1,6 @@
 #include "ohmpch.h"
 #include "Ohm/Rendering/VertexBuffer.h"
+#include "Ohm/Rendering/RenderCommand.h"
 
 #include <glad/glad.h>
 
@@ -8,47 +9,48 @@ namespace Ohm
 	VertexBuffer::VertexBuffer(uint32_t size)
 	{
 		glCreateBuffers(1, &m_ID);
-		glBindBuffer(GL_ARRAY_BUFFER, m_ID);
-		glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+		glNamedBufferData(m_ID, size, nullptr, GL_DYNAMIC_DRAW);
 	}
 
-	VertexBuffer::VertexBuffer(float* vertices, uint32_t size)
+	VertexBuffer::VertexBuffer(const float* vertices, uint32_t size)
 	{
 		glCreateBuffers(1, &m_ID);
-		glBindBuffer(GL_ARRAY_BUFFER, m_ID);
-		glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+		glNamedBufferData(m_ID, size, vertices, GL_STATIC_DRAW);
 	}
 
 	VertexBuffer::~VertexBuffer()
 	{
 		glDeleteBuffers(1, &m_ID);
+		RenderCommand::InvalidateStateCache();
 	}
 
-	void VertexBuffer::SetData(const void* data, uint32_t size)
+	void VertexBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_ID);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+		glNamedBufferSubData(m_ID, offset, size, data);
 	}
 
 	void VertexBuffer::Resize(uint32_t size)
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_ID);
-		glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+		glNamedBufferData(m_ID, size, nullptr, GL_DYNAMIC_DRAW);
 	}
 
 	void VertexBuffer::ResizeAndSetData(const void* data, uint32_t size)
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_ID);
-		glBufferData(GL_ARRAY_BUFFER, size, data, GL_DYNAMIC_DRAW);
+		glNamedBufferData(m_ID, size, data, GL_DYNAMIC_DRAW);
+	}
+
+	void VertexBuffer::GetData(void* data, uint32_t size, uint32_t offset) const
+	{
+		glGetNamedBufferSubData(m_ID, offset, size, data);
 	}
 
 	void VertexBuffer::Bind() const
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_ID);
+		RenderCommand::BindVertexBuffer(m_ID);
 	}
 
 	void VertexBuffer::Unbind() const
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		RenderCommand::BindVertexBuffer(0);
 	}
 }
\ No newline at end of file
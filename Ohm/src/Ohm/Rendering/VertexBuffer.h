@@ -8,12 +8,14 @@ namespace Ohm
 	{
 	public:
 		VertexBuffer(uint32_t size);
-		VertexBuffer(float* vertices, uint32_t size);
+		VertexBuffer(const float* vertices, uint32_t size);
 		~VertexBuffer();
 
-		void SetData(const void* data, uint32_t size);
+		void SetData(const void* data, uint32_t size, uint32_t offset = 0);
 		void Resize(uint32_t size);
 		void ResizeAndSetData(const void* data, uint32_t size);
+		// Reads the buffer back; stalls until the GPU is done with it.
+		void GetData(void* data, uint32_t size, uint32_t offset = 0) const;
 
 		void Bind() const;
 		void Unbind() const;
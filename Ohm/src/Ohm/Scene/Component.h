@@ -106,7 +106,7 @@ namespace Ohm
 		{
 			if(ShaderName == "PBR")
 			{
-				uint32_t whiteTextureId = TextureLibrary::Get2D("White Texture")->GetID();
+				uint32_t whiteTextureId = TextureLibrary::GetWhiteTexture()->GetID();
 				MaterialInstance->Set<TextureUniform>("sampler_AlbedoTexture", {whiteTextureId, 0, 0 });
 				MaterialInstance->Set<TextureUniform>("sampler_NormalTexture", {whiteTextureId, 1, 0 });
 				MaterialInstance->Set<TextureUniform>("sampler_MetalnessTexture", {whiteTextureId, 2, 0 });
@@ -2,6 +2,7 @@
 #include "Ohm/Scene/SceneSerializer.h"
 #include "Ohm/Scene/Entity.h"
 #include "Ohm/Rendering/Mesh.h"
+#include "Ohm/Rendering/MeshLibrary.h"
 #include "Ohm/Rendering/Material.h"
 
 #include <glm/glm.hpp>
@@ -195,6 +196,8 @@ namespace Ohm
 			auto& meshRenderer = entity.GetComponent<MeshRendererComponent>();
 			const uint32_t primitiveType = (uint32_t)meshRenderer.MeshData->GetPrimitiveType();
 			out << YAML::Key << "PrimitiveType" << YAML::Value << primitiveType;
+			if (!meshRenderer.MeshData->GetSourcePath().empty())
+				out << YAML::Key << "Source" << YAML::Value << meshRenderer.MeshData->GetSourcePath();
 
 			MaterialUniformData materialData = meshRenderer.MaterialInstance->GetMaterialUniformData();
 
@@ -329,7 +332,10 @@ namespace Ohm
 					auto& meshRendererComponent = deserializedEntity.AddComponent<MeshRendererComponent>();
 					uint32_t primitiveType = meshRendererData["PrimitiveType"].as<uint32_t>();
 
-					meshRendererComponent.MeshData = MeshFactory::Create(static_cast<Primitive>(primitiveType));
+					if (auto source = meshRendererData["Source"])
+						meshRendererComponent.MeshData = MeshLibrary::GetImported(source.as<std::string>());
+					else
+						meshRendererComponent.MeshData = MeshLibrary::GetPrimitive(static_cast<Primitive>(primitiveType));
 
 					if (auto materialUniformData = meshRendererData["Material Uniforms"])
 					{
@@ -379,7 +379,7 @@ namespace Ohm
 				ImGui::LabelText(ss.str().c_str(), m_Label.c_str());
 
 				ImGui::TableSetColumnIndex(1);
-				if (ImGui::ImageButton((ImTextureID)CurrentTexture->GetID(), { 50, 50 }, { 0, 1 }, { 1, 0 }))
+				if (ImGui::ImageButton((ImTextureID)TextureLibrary::GetResidentID(CurrentTexture->GetID()), { 50, 50 }, { 0, 1 }, { 1, 0 }))
 					ImGui::OpenPopup("Texture Selection");
 
 				if (ImGui::BeginPopup("Texture Selection"))
@@ -12,6 +12,11 @@
 #include <utility>
 #include <functional>
 #include <array>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
 
 #include "Ohm/Core/Memory.h"
 #include "Ohm/Core/Utility.h"
@@ -1,7 +1,8 @@
 #type compute
 #version 450 core
 
-layout(binding = 0, rgba32f) restrict writeonly uniform image2D o_Image;
+// No format qualifier: write-only images take whatever format the bound level has (RGBA32F, RGBA16F or R11G11B10F).
+layout(binding = 0) restrict writeonly uniform image2D o_Image;
 
 const float Epsilon = 1.0e-4;
 
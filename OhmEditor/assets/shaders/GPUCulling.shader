@@ -0,0 +1,176 @@
+#type compute
+#version 450 core
+
+// GPU-driven geometry, see GPUDrivenQueue.h.  Run three times a frame, one u_Stage after the other:
+//	0: frustum culls each object, picks its LOD and counts it into that LOD's draw command.
+//	1: gives every draw command its range of the instance buffer.
+//	2: writes the transform of each visible object into its command's range.
+layout(local_size_x = 64) in;
+
+const uint MaxLODs = 8;
+const uint Culled = 0xFFFFFFFFu;
+
+struct DrawCommand
+{
+	uint Count;
+	uint InstanceCount;
+	uint FirstIndex;
+	int BaseVertex;
+	uint BaseInstance;
+};
+
+struct DrawGroup
+{
+	vec4 BoundsCenter;
+	vec4 BoundsExtent;
+	uint FirstCommand;
+	uint LODCount;
+	uint Padding0;
+	uint Padding1;
+	float LODScreenSizes[MaxLODs];
+};
+
+struct DrawObject
+{
+	mat4 Transform;
+	uint GroupIndex;
+	uint Padding0;
+	uint Padding1;
+	uint Padding2;
+};
+
+layout(std430, binding = 0) writeonly buffer InstanceData
+{
+	mat4 ModelMatrices[];
+};
+
+layout(std430, binding = 1) readonly buffer ObjectData
+{
+	DrawObject Objects[];
+};
+
+layout(std430, binding = 2) readonly buffer GroupData
+{
+	DrawGroup Groups[];
+};
+
+layout(std430, binding = 3) buffer CommandData
+{
+	DrawCommand Commands[];
+};
+
+// Draw command of each object and its instance within the command; x is Culled when the object isn't drawn.
+layout(std430, binding = 4) buffer SlotData
+{
+	uvec2 Slots[];
+};
+
+layout(std430, binding = 5) buffer ResultData
+{
+	uint VisibleObjects;
+	uint TrianglesPerLOD[MaxLODs];
+};
+
+uniform int u_Stage;
+uniform int u_ObjectCount;
+uniform int u_CommandCount;
+uniform mat4 u_ViewProjection;
+uniform vec3 u_CameraPosition;
+uniform float u_TanHalfFOV;
+uniform float u_LODBias;
+uniform int u_SelectLODs;
+
+// Same test as FrustumCuller: a box is out once it's entirely behind one of the planes.
+bool IsInFrustum(vec3 center, vec3 extent)
+{
+	// Gribb/Hartmann planes, from the rows of the view-projection matrix.
+	mat4 rows = transpose(u_ViewProjection);
+	vec4 planes[6] = vec4[6](rows[3] + rows[0], rows[3] - rows[0], rows[3] + rows[1], rows[3] - rows[1], rows[3] + rows[2], rows[3] - rows[2]);
+
+	for (int i = 0; i < 6; i++)
+	{
+		if (dot(planes[i].xyz, center) + planes[i].w + dot(extent, abs(planes[i].xyz)) < 0.0)
+			return false;
+	}
+	return true;
+}
+
+// Mirrors ComputeScreenSize in SceneRenderer.cpp and Mesh::SelectLOD.
+uint SelectLOD(uint groupIndex, vec3 center, float radius)
+{
+	if (u_SelectLODs == 0)
+		return 0;
+
+	float distance = max(length(center - u_CameraPosition), radius);
+	float screenSize = distance > 0.0 ? radius / (distance * u_TanHalfFOV) : 1.0 / u_TanHalfFOV;
+
+	uint lod = 0;
+	while (lod + 1 < Groups[groupIndex].LODCount && screenSize < Groups[groupIndex].LODScreenSizes[lod + 1] * u_LODBias)
+		lod++;
+	return lod;
+}
+
+void CullObject(uint index)
+{
+	mat4 transform = Objects[index].Transform;
+	uint groupIndex = Objects[index].GroupIndex;
+	vec3 localCenter = Groups[groupIndex].BoundsCenter.xyz;
+	vec3 localExtent = Groups[groupIndex].BoundsExtent.xyz;
+
+	// World-space box around the transformed local box.
+	mat3 axes = mat3(transform);
+	vec3 center = (transform * vec4(localCenter, 1.0)).xyz;
+	vec3 extent = abs(axes[0]) * localExtent.x + abs(axes[1]) * localExtent.y + abs(axes[2]) * localExtent.z;
+	if (!IsInFrustum(center, extent))
+	{
+		Slots[index] = uvec2(Culled, 0);
+		return;
+	}
+
+	float scale = max(length(axes[0]), max(length(axes[1]), length(axes[2])));
+	uint lod = SelectLOD(groupIndex, center, length(localExtent) * scale);
+	uint command = Groups[groupIndex].FirstCommand + lod;
+
+	Slots[index] = uvec2(command, atomicAdd(Commands[command].InstanceCount, 1u));
+	atomicAdd(VisibleObjects, 1u);
+	atomicAdd(TrianglesPerLOD[lod], Commands[command].Count / 3u);
+}
+
+void AssignInstances()
+{
+	uint baseInstance = 0;
+	for (int i = 0; i < u_CommandCount; i++)
+	{
+		Commands[i].BaseInstance = baseInstance;
+		baseInstance += Commands[i].InstanceCount;
+	}
+}
+
+void WriteInstance(uint index)
+{
+	uvec2 slot = Slots[index];
+	if (slot.x == Culled)
+		return;
+
+	ModelMatrices[Commands[slot.x].BaseInstance + slot.y] = Objects[index].Transform;
+}
+
+void main()
+{
+	uint index = gl_GlobalInvocationID.x;
+
+	if (u_Stage == 1)
+	{
+		if (index == 0)
+			AssignInstances();
+		return;
+	}
+
+	if (index >= uint(u_ObjectCount))
+		return;
+
+	if (u_Stage == 0)
+		CullObject(index);
+	else
+		WriteInstance(index);
+}
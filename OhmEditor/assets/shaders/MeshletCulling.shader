@@ -0,0 +1,114 @@
+#type compute
+#version 450 core
+
+// Meshlet culling on the GPU, see MeshletQueue.h.  One work group per object, each invocation testing one of its
+// meshlets at a time; a culled meshlet's draw command is left with no instances.  The tests match MeshletCuller.
+layout(local_size_x = 64) in;
+
+struct DrawCommand
+{
+	uint Count;
+	uint InstanceCount;
+	uint FirstIndex;
+	int BaseVertex;
+	uint BaseInstance;
+};
+
+struct Meshlet
+{
+	vec4 BoundingSphere;
+	vec4 ConeApex;
+	vec4 ConeAxisCutoff;
+	uint IndexOffset;
+	uint IndexCount;
+	uint VertexCount;
+	uint Padding;
+};
+
+// Planes and eye position are in the object's local space, like the meshlet bounds.
+struct MeshletObject
+{
+	vec4 Planes[6];
+	vec4 CameraPosition;
+	uint FirstMeshlet;
+	uint MeshletCount;
+	uint FirstCommand;
+	uint Padding;
+};
+
+layout(std430, binding = 1) readonly buffer MeshletData
+{
+	Meshlet Meshlets[];
+};
+
+layout(std430, binding = 2) readonly buffer ObjectData
+{
+	MeshletObject Objects[];
+};
+
+layout(std430, binding = 3) buffer CommandData
+{
+	DrawCommand Commands[];
+};
+
+layout(std430, binding = 4) buffer ResultData
+{
+	uint VisibleMeshlets;
+	uint VisibleTriangles;
+};
+
+uniform int u_ObjectCount;
+
+shared uint s_VisibleMeshlets;
+shared uint s_VisibleTriangles;
+
+bool IsVisible(Meshlet meshlet, MeshletObject object)
+{
+	for (int i = 0; i < 6; i++)
+	{
+		if (dot(object.Planes[i].xyz, meshlet.BoundingSphere.xyz) + object.Planes[i].w < -meshlet.BoundingSphere.w)
+			return false;
+	}
+
+	float Cutoff = meshlet.ConeAxisCutoff.w;
+	if (object.CameraPosition.w == 0.0 || Cutoff > 1.0)
+		return true;
+
+	vec3 ToApex = meshlet.ConeApex.xyz - object.CameraPosition.xyz;
+	return dot(ToApex, meshlet.ConeAxisCutoff.xyz) < Cutoff * length(ToApex);
+}
+
+void main()
+{
+	// Objects past 65535 continue on the next row of work groups.
+	uint ObjectIndex = gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+	if (ObjectIndex >= uint(u_ObjectCount))
+		return;
+
+	if (gl_LocalInvocationIndex == 0)
+	{
+		s_VisibleMeshlets = 0;
+		s_VisibleTriangles = 0;
+	}
+	barrier();
+
+	MeshletObject Object = Objects[ObjectIndex];
+	for (uint i = gl_LocalInvocationIndex; i < Object.MeshletCount; i += gl_WorkGroupSize.x)
+	{
+		Meshlet Current = Meshlets[Object.FirstMeshlet + i];
+		bool Visible = IsVisible(Current, Object);
+		Commands[Object.FirstCommand + i].InstanceCount = Visible ? 1u : 0u;
+		if (Visible)
+		{
+			atomicAdd(s_VisibleMeshlets, 1u);
+			atomicAdd(s_VisibleTriangles, Current.IndexCount / 3u);
+		}
+	}
+	barrier();
+
+	if (gl_LocalInvocationIndex == 0)
+	{
+		atomicAdd(VisibleMeshlets, s_VisibleMeshlets);
+		atomicAdd(VisibleTriangles, s_VisibleTriangles);
+	}
+}
@@ -1,11 +1,8 @@
 #type vertex
 #version 450 core
+#extension GL_ARB_shader_draw_parameters : require
 
-layout(location = 0) in vec3 a_Position;
-layout(location = 1) in vec3 a_Normal;
-layout(location = 2) in vec3 a_Tangent;
-layout(location = 3) in vec3 a_Binormal;
-layout(location = 4) in vec2 a_TexCoord;
+//include "VertexInput.glsl"
 
 layout(std140, binding = 1) uniform Camera
 {
@@ -15,9 +12,9 @@ layout(std140, binding = 1) uniform Camera
     mat4 ViewMatrix;
 };
 
-layout(std140, binding = 3) uniform Entity
+layout(std430, binding = 0) readonly buffer InstanceData
 {
-    mat4 ModelMatrix;
+    mat4 ModelMatrices[];
 };
 
 out Interpolators
@@ -34,18 +31,20 @@ out Interpolators
 
 void main()
 {
-	vec4 worldPosition = ModelMatrix * vec4(a_Position, 1.0);
+	VertexAttributes attributes = DecodeVertexAttributes();
+	mat4 ModelMatrix = ModelMatrices[gl_BaseInstanceARB + gl_InstanceID];
+	vec4 worldPosition = ModelMatrix * vec4(attributes.Position, 1.0);
 	VertexOutput.WorldPosition = worldPosition.xyz;
-	VertexOutput.Normal = mat3(ModelMatrix) * a_Normal;
-	VertexOutput.TexCoord = a_TexCoord;
-	VertexOutput.WorldNormals = mat3(ModelMatrix) * mat3(a_Tangent, a_Binormal, a_Normal);
+	VertexOutput.Normal = mat3(ModelMatrix) * attributes.Normal;
+	VertexOutput.TexCoord = attributes.TexCoord;
+	VertexOutput.WorldNormals = mat3(ModelMatrix) * mat3(attributes.Tangent, attributes.Binormal, attributes.Normal);
 	VertexOutput.WorldTransform = mat3(ModelMatrix);
-	VertexOutput.Binormal = a_Binormal;
+	VertexOutput.Binormal = attributes.Binormal;
 	VertexOutput.WorldSpaceViewDirection = normalize(VertexOutput.WorldPosition - CameraPosition.xyz);
 	VertexOutput.WorldSpaceViewDirection.z *= -1;
 
 	VertexOutput.ViewPosition = vec3(ViewMatrix * vec4(VertexOutput.WorldPosition, 1.0));
-	gl_Position = ViewProjectionMatrix * ModelMatrix * vec4(a_Position, 1.0);
+	gl_Position = ViewProjectionMatrix * worldPosition;
 }
 
 #type fragment
@@ -57,15 +56,19 @@ const vec3 FresnelDialectric = vec3(0.04);
 
 layout(location = 0) out vec4 o_Color;
 
-uniform vec3 AlbedoColor = vec3(1.0);
-uniform float Metalness = 0.0;
-uniform float Roughness = 1.0;
-uniform float Emission = 0.0;
-
-uniform float TextureTiling = 1.0f;
-uniform float EnvironmentIntensity = 1.0;
-uniform float EnvMapRotation = 0.0;
-uniform int UseNormalMap = 0;
+// Initializers are stripped by the engine and used as material defaults.
+layout(std140, binding = 4) uniform MaterialParameters
+{
+    vec3 AlbedoColor = vec3(1.0);
+    float Metalness = 0.0;
+    float Roughness = 1.0;
+    float Emission = 0.0;
+
+    float TextureTiling = 1.0f;
+    float EnvironmentIntensity = 1.0;
+    float EnvMapRotation = 0.0;
+    int UseNormalMap = 0;
+};
 
 uniform sampler2D sampler_AlbedoTexture;
 uniform sampler2D sampler_NormalTexture;
@@ -207,8 +210,11 @@ vec3 CalculateLighting()
 	PBRParams.Normal = normalize(VertexInput.Normal);
 	if (UseNormalMap == 1)
 	{
-		PBRParams.Normal = normalize(texture(sampler_NormalTexture, VertexInput.TexCoord).rgb * 2.0f - 1.0f);
-		PBRParams.Normal = normalize(VertexInput.WorldNormals * PBRParams.Normal);
+		// Z is rebuilt from X and Y, so BC5 normal maps, which only store those, sample like uncompressed ones.
+		vec3 tangentNormal;
+		tangentNormal.xy = texture(sampler_NormalTexture, VertexInput.TexCoord).rg * 2.0f - 1.0f;
+		tangentNormal.z = sqrt(max(1.0f - dot(tangentNormal.xy, tangentNormal.xy), 0.0f));
+		PBRParams.Normal = normalize(VertexInput.WorldNormals * tangentNormal);
 	}
 	
 	PBRParams.View = normalize(CameraPosition.xyz - VertexInput.WorldPosition);
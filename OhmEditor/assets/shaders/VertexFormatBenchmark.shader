@@ -0,0 +1,30 @@
+#type vertex
+#version 450 core
+
+//include "VertexInput.glsl"
+
+uniform mat4 u_ViewProjection;
+
+out vec3 v_Color;
+
+void main()
+{
+	VertexAttributes attributes = DecodeVertexAttributes();
+
+	// Every attribute feeds the output, so none of them can be dropped from the vertex fetch.
+	v_Color = attributes.Normal * 0.5 + 0.5;
+	v_Color += (attributes.Tangent + attributes.Binormal + vec3(attributes.TexCoord, 0.0)) * 0.01;
+	gl_Position = u_ViewProjection * vec4(attributes.Position, 1.0);
+}
+
+#type fragment
+#version 450 core
+
+layout(location = 0) out vec4 o_Color;
+
+in vec3 v_Color;
+
+void main()
+{
+	o_Color = vec4(v_Color, 1.0);
+}
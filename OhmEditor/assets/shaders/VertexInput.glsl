@@ -0,0 +1,52 @@
+// Vertex attributes of both vertex formats (see Vertex.h).  Full meshes feed locations 0-4 and packed meshes 0 and 5-7;
+// attributes a mesh doesn't feed read as (0, 0, 0, 1).
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec3 a_Normal;
+layout(location = 2) in vec3 a_Tangent;
+layout(location = 3) in vec3 a_Binormal;
+layout(location = 4) in vec2 a_TexCoord;
+layout(location = 5) in vec2 a_PackedNormal;
+layout(location = 6) in vec4 a_PackedTangent;
+layout(location = 7) in vec2 a_PackedTexCoord;
+
+struct VertexAttributes
+{
+	vec3 Position;
+	vec3 Normal;
+	vec3 Tangent;
+	vec3 Binormal;
+	vec2 TexCoord;
+};
+
+vec3 OctahedralDecode(vec2 encoded)
+{
+	vec3 direction = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float fold = max(-direction.z, 0.0);
+	direction.x += direction.x >= 0.0 ? -fold : fold;
+	direction.y += direction.y >= 0.0 ? -fold : fold;
+	return normalize(direction);
+}
+
+VertexAttributes DecodeVertexAttributes()
+{
+	VertexAttributes attributes;
+	attributes.Position = a_Position;
+
+	// Packed tangents always store 1 in z.
+	if (a_PackedTangent.z > 0.5)
+	{
+		attributes.Normal = OctahedralDecode(a_PackedNormal);
+		attributes.Tangent = OctahedralDecode(a_PackedTangent.xy);
+		attributes.Binormal = cross(attributes.Normal, attributes.Tangent) * (a_PackedTangent.w < 0.0 ? -1.0 : 1.0);
+		attributes.TexCoord = a_PackedTexCoord;
+	}
+	else
+	{
+		attributes.Normal = a_Normal;
+		attributes.Tangent = a_Tangent;
+		attributes.Binormal = a_Binormal;
+		attributes.TexCoord = a_TexCoord;
+	}
+
+	return attributes;
+}
@@ -1,12 +1,15 @@
 #include "EditorLayer.h"
 #include "Panels/Dockspace.h"
+#include "Panels/StatisticsPanel.h"
 #include "Ohm/Rendering/SceneRenderer.h"
 
 #include <imgui/imgui.h>
 #include <glm/glm.hpp>
 #include <cmath>
+#include <filesystem>
 
 #include "Ohm/Rendering/TextureLibrary.h"
+#include "Ohm/Rendering/MeshLibrary.h"
 
 namespace Ohm
 {
@@ -42,7 +45,6 @@ namespace Ohm
 		SceneRenderer::InitializePipeline();
 
 		m_SceneHierarchyPanel.SetContext(m_Scene);
-		m_ViewportPanel.SetFramebuffer(SceneRenderer::GetSceneCompositeFBO());
 	}
 
 	void EditorLayer::OnUpdate(float deltaTime)
@@ -86,7 +88,7 @@ namespace Ohm
 						if (ImGui::MenuItem("Cube"))
 						{
 							Entity cube = m_Scene->CreateEntity("Cube");
-							cube.AddComponent<MeshRendererComponent>(m_EngineGeometryMaterial->Clone("Cube Base Material"), MeshFactory::Create(Primitive::Cube));
+							cube.AddComponent<MeshRendererComponent>(m_EngineGeometryMaterial->Clone("Cube Base Material"), MeshLibrary::GetPrimitive(Primitive::Cube));
 							m_SceneHierarchyPanel.SetSelectedEntity(cube);
 						}
 						ImGui::Separator();
@@ -94,7 +96,7 @@ namespace Ohm
 						if (ImGui::MenuItem("Sphere"))
 						{
 							Entity sphere = m_Scene->CreateEntity("Sphere");
-							sphere.AddComponent<MeshRendererComponent>(m_EngineGeometryMaterial->Clone("Sphere Base Material"), MeshFactory::Create(Primitive::Sphere));
+							sphere.AddComponent<MeshRendererComponent>(m_EngineGeometryMaterial->Clone("Sphere Base Material"), MeshLibrary::GetPrimitive(Primitive::Sphere));
 							m_SceneHierarchyPanel.SetSelectedEntity(sphere);
 						}
 						ImGui::Separator();
@@ -102,7 +104,7 @@ namespace Ohm
 						if (ImGui::MenuItem("Quad"))
 						{
 							Entity quad = m_Scene->CreateEntity("Quad");
-							quad.AddComponent<MeshRendererComponent>(m_EngineGeometryMaterial->Clone("Quad Base Material"), MeshFactory::Create(Primitive::Quad));
+							quad.AddComponent<MeshRendererComponent>(m_EngineGeometryMaterial->Clone("Quad Base Material"), MeshLibrary::GetPrimitive(Primitive::Quad));
 							m_SceneHierarchyPanel.SetSelectedEntity(quad);
 						}
 						ImGui::Separator();
@@ -110,13 +112,30 @@ namespace Ohm
 						if (ImGui::MenuItem("Plane"))
 						{
 							Entity plane = m_Scene->CreateEntity("Plane");
-							plane.AddComponent<MeshRendererComponent>(m_EngineGeometryMaterial->Clone("Plane Base Material"), MeshFactory::Create(Primitive::Plane));
+							plane.AddComponent<MeshRendererComponent>(m_EngineGeometryMaterial->Clone("Plane Base Material"), MeshLibrary::GetPrimitive(Primitive::Plane));
 							m_SceneHierarchyPanel.SetSelectedEntity(plane);
 						}
 
 						ImGui::Separator();
 						ImGui::EndMenu();
 					}
+					ImGui::Separator();
+
+					if (ImGui::BeginMenu("Mesh From File"))
+					{
+						ImGui::InputText("Path", m_MeshImportPath, sizeof(m_MeshImportPath));
+						if (ImGui::MenuItem("Import (.obj, .gltf, .glb)"))
+						{
+							if (Ref<Mesh> importedMesh = MeshLibrary::GetImported(m_MeshImportPath))
+							{
+								const std::string name = std::filesystem::path(m_MeshImportPath).stem().string();
+								Entity imported = m_Scene->CreateEntity(name);
+								imported.AddComponent<MeshRendererComponent>(m_EngineGeometryMaterial->Clone(name + " Base Material"), importedMesh);
+								m_SceneHierarchyPanel.SetSelectedEntity(imported);
+							}
+						}
+						ImGui::EndMenu();
+					}
 
 					ImGui::Separator();
 					ImGui::EndMenu();
@@ -154,16 +173,7 @@ namespace Ohm
 		// Console
 		m_ConsolePanel.Draw("Console");
 		// Statistics
-		{
-			ImGui::Begin("Statistics");
-
-			Renderer::Statistics stats = Renderer::GetStats();
-
-			ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
-			ImGui::Text("Vertex Count: %d", stats.VertexCount);
-			ImGui::Text("Triangle Count: %d", stats.TriangleCount);
-			ImGui::End();
-		}
+		UI::StatisticsPanel::Draw();
 
 		// Scene Drawer 
 		{
@@ -173,6 +183,7 @@ namespace Ohm
 			SceneRenderer::DrawTextureViewerUI();
 		}
 
+		m_ViewportPanel.SetTextureID(SceneRenderer::GetSceneCompositeTextureID());
 		m_ViewportPanel.Draw();
 		Dockspace::End();
 	}
@@ -34,5 +34,6 @@ namespace Ohm
 		UI::SceneHierarchyPanel m_SceneHierarchyPanel;
 
 		Ref<Material> m_EngineGeometryMaterial;
+		char m_MeshImportPath[256] = "assets/meshes/";
 	};
 }
\ No newline at end of file
@@ -8,8 +8,8 @@ namespace Ohm
 	class OhmEditor : public Application
 	{
 	public:
-		OhmEditor()
-			:Application("Ohm Editor")
+		OhmEditor(ApplicationRenderMode renderMode)
+			:Application("Ohm Editor", renderMode)
 		{
 			PushLayer(new EditorLayer());
 		}
@@ -20,9 +20,17 @@ namespace Ohm
 		}
 	};
 
-	Application* CreateApplication()
+	Application* CreateApplication(int argc, char** argv)
 	{
-		return new OhmEditor;
+		// Rendering on its own thread is opt-in: OhmEditor --render-thread
+		ApplicationRenderMode RenderMode = ApplicationRenderMode::SingleThreaded;
+		for (int i = 1; i < argc; i++)
+		{
+			if (std::string(argv[i]) == "--render-thread")
+				RenderMode = ApplicationRenderMode::MultiThreaded;
+		}
+
+		return new OhmEditor(RenderMode);
 	}
 }
 
@@ -14,6 +14,14 @@ namespace Ohm
 
 	    void MaterialInspector::Draw() const
 	    {
+	    	// The render thread may be uploading this material's parameters while the drawers write them.
+	    	std::lock_guard<std::mutex> Lock(m_Material->GetMutex());
+
+	    	// Drawers edit the material's storage in place, so diff the parameter block to find what needs re-uploading.
+	    	const uint32_t ParameterBlockSize = m_Material->GetParameterBlockSize();
+	    	const auto* ParameterBlock = static_cast<const uint8_t*>(m_Material->GetParameterBlockData());
+	    	const std::vector<uint8_t> ParametersBefore(ParameterBlock, ParameterBlock + ParameterBlockSize);
+
 	    	for(const auto& [name, FloatDrawer] : m_FloatDrawers)
 	    		FloatDrawer->Draw();
 	    	for(const auto&  [name, IntDrawer] : m_IntDrawers)
@@ -29,6 +37,12 @@ namespace Ohm
 	    	for(const auto& [name, TextureDrawer] : m_TextureDrawers)
 	    		TextureDrawer->Draw();
 
+	    	for (uint32_t Offset = 0; Offset < ParameterBlockSize; Offset += 4)
+	    	{
+	    		if (memcmp(ParametersBefore.data() + Offset, ParameterBlock + Offset, 4) != 0)
+	    			m_Material->MarkParametersDirty(Offset, 4);
+	    	}
+
 	    	if (ImGui::Button("Log Shader Data"))
 	    		m_Material->GetShader()->LogShaderData();
 	    }
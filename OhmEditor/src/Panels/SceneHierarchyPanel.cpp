@@ -254,10 +254,10 @@ namespace Ohm
 					if (ImGui::Button("Add Default Material"))
 					{
 						Component.MaterialInstance = CreateRef<Material>("Default Engine Material", ShaderLibrary::Get("PBR"));
-						TextureUniform albedo{TextureLibrary::Get2D("White Texture")->GetID(), 0, 0 };
-						TextureUniform normal{TextureLibrary::Get2D("White Texture")->GetID(), 1, 0 };
-						TextureUniform metal{TextureLibrary::Get2D("White Texture")->GetID(), 2, 0 };
-						TextureUniform roughness{TextureLibrary::Get2D("White Texture")->GetID(), 3, 0 };
+						TextureUniform albedo{TextureLibrary::GetWhiteTexture()->GetID(), 0, 0 };
+						TextureUniform normal{TextureLibrary::GetWhiteTexture()->GetID(), 1, 0 };
+						TextureUniform metal{TextureLibrary::GetWhiteTexture()->GetID(), 2, 0 };
+						TextureUniform roughness{TextureLibrary::GetWhiteTexture()->GetID(), 3, 0 };
 
 						Component.MaterialInstance->Set("sampler_AlbedoTexture", 	albedo);
 						Component.MaterialInstance->Set("sampler_NormalTexture", 	normal);
@@ -1,5 +1,7 @@
 ﻿#include "StatisticsPanel.h"
 #include "Ohm/Rendering/Renderer.h"
+#include "Ohm/Rendering/MeshLibrary.h"
+#include "Ohm/Rendering/TextureStreamer.h"
 #include "imgui/imgui.h"
 
 namespace Ohm
@@ -12,9 +14,47 @@ namespace Ohm
 
             const Renderer::Statistics RenderStats = Renderer::GetStats();
 
-            ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
-            ImGui::Text("Vertex Count: %d", RenderStats.VertexCount);
-            ImGui::Text("Triangle Count: %d", RenderStats.TriangleCount);
+            ImGui::TextUnformatted(fmt::format("Application average {:.3f} ms/frame ({:.1f} FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate).c_str());
+            ImGui::TextUnformatted(fmt::format("Vertex Count: {}", RenderStats.VertexCount).c_str());
+            ImGui::TextUnformatted(fmt::format("Triangle Count: {}", RenderStats.TriangleCount).c_str());
+            ImGui::TextUnformatted(fmt::format("Draw Calls: {}", RenderStats.DrawCalls).c_str());
+            ImGui::TextUnformatted(fmt::format("Instances: {}", RenderStats.InstanceCount).c_str());
+            ImGui::TextUnformatted(fmt::format("Draw Calls Saved By Batching: {}", RenderStats.DrawCallsSaved).c_str());
+            ImGui::TextUnformatted(fmt::format("Material Bytes Uploaded: {}", RenderStats.MaterialBytesUploaded).c_str());
+            ImGui::TextUnformatted(fmt::format("Objects: {} (Visible: {}, Culled: {})", RenderStats.ObjectsTotal, RenderStats.ObjectsVisible, RenderStats.ObjectsCulled).c_str());
+            ImGui::TextUnformatted(fmt::format("Redundant State Changes Skipped: {}", RenderStats.StateChangesSkipped).c_str());
+            if (RenderStats.MeshletsTotal > 0)
+            {
+                ImGui::TextUnformatted(fmt::format("Meshlets: {} (Visible: {}, Culled: {})", RenderStats.MeshletsTotal, RenderStats.MeshletsVisible, RenderStats.MeshletsCulled).c_str());
+                ImGui::TextUnformatted(fmt::format("Meshlet Triangles Culled: {}", RenderStats.MeshletTrianglesCulled).c_str());
+            }
+            for (uint32_t i = 0; i < MaxMeshLODs; i++)
+                if (RenderStats.TrianglesPerLOD[i] > 0)
+                    ImGui::TextUnformatted(fmt::format("LOD {} Triangles: {}", i, RenderStats.TrianglesPerLOD[i]).c_str());
+
+            const MeshLibrary::Statistics MeshStats = MeshLibrary::GetStats();
+            ImGui::TextUnformatted(fmt::format("Meshes: {} (Handles: {}, Vertex Data: {:.2f} MB)", MeshStats.MeshCount, MeshStats.HandleCount, MeshStats.VertexBufferBytes / (1024.0 * 1024.0)).c_str());
+            const MeshMemoryStats MeshMemory = Mesh::GetMemoryStats();
+            ImGui::TextUnformatted(fmt::format("Mesh CPU Data: {:.2f} MB (Released: {:.2f} MB)", MeshMemory.ResidentBytes / (1024.0 * 1024.0), MeshMemory.ReleasedBytes / (1024.0 * 1024.0)).c_str());
+            for (VertexFormat Format : { VertexFormat::Full, VertexFormat::Packed })
+            {
+                const GeometryPool::Statistics PoolStats = GeometryPool::Get(Format).GetStats();
+                if (PoolStats.VertexBytesCapacity == 0) continue;
+                ImGui::TextUnformatted(fmt::format("Geometry Pool ({}): {} Meshes, Vertices {:.2f} / {:.2f} MB, Indices {:.2f} / {:.2f} MB, {} Free Blocks",
+                    Format == VertexFormat::Packed ? "Packed" : "Full", PoolStats.AllocationCount,
+                    PoolStats.VertexBytesUsed / (1024.0 * 1024.0), PoolStats.VertexBytesCapacity / (1024.0 * 1024.0),
+                    PoolStats.IndexBytesUsed / (1024.0 * 1024.0), PoolStats.IndexBytesCapacity / (1024.0 * 1024.0), PoolStats.FreeBlockCount).c_str());
+            }
+
+            const TextureStreamingStats StreamingStats = TextureStreamer::GetStats();
+            if (StreamingStats.TextureCount > 0)
+            {
+                ImGui::TextUnformatted(fmt::format("Streamed Textures: {} ({} Below Requested Detail)", StreamingStats.TextureCount, StreamingStats.StreamingCount).c_str());
+                ImGui::TextUnformatted(fmt::format("Texture Memory: Resident {:.2f} / Requested {:.2f} MB (Budget {:.2f} MB, Full Chains {:.2f} MB)",
+                    StreamingStats.ResidentBytes / (1024.0 * 1024.0), StreamingStats.RequestedBytes / (1024.0 * 1024.0),
+                    StreamingStats.BudgetBytes / (1024.0 * 1024.0), StreamingStats.FullBytes / (1024.0 * 1024.0)).c_str());
+                ImGui::TextUnformatted(fmt::format("Texture Storage Allocated: {:.2f} MB ({})", StreamingStats.AllocatedBytes / (1024.0 * 1024.0), StreamingStats.Sparse ? "Sparse" : "Not Sparse").c_str());
+            }
             ImGui::End();
         }
     }
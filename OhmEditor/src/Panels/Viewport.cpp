@@ -6,11 +6,6 @@ namespace Ohm
 {
 	namespace UI
 	{
-		Viewport::Viewport(const Ref<Framebuffer>& framebuffer)
-			:m_Framebuffer(framebuffer)
-		{
-		}
-
 		Viewport::Viewport()
 		{
 		}
@@ -32,8 +27,7 @@ namespace Ohm
 			ImVec2 viewportPanelSize = ImGui::GetContentRegionAvail();
 			m_ViewportSize = { viewportPanelSize.x, viewportPanelSize.y };
 
-			uint32_t textureID = m_Framebuffer->GetColorAttachmentID();
-			ImGui::Image((void*)textureID, ImVec2{ m_ViewportSize.x, m_ViewportSize.y }, ImVec2{ 0, 1 }, ImVec2{ 1, 0 });
+			ImGui::Image((void*)m_TextureID, ImVec2{ m_ViewportSize.x, m_ViewportSize.y }, ImVec2{ 0, 1 }, ImVec2{ 1, 0 });
 			ImGui::End();
 			ImGui::PopStyleVar();
 		}
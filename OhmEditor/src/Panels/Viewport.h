@@ -11,9 +11,9 @@ namespace Ohm
 		{
 		public:
 			Viewport();
-			Viewport(const Ref<Framebuffer>& framebuffer);
 
-			void SetFramebuffer(const Ref<Framebuffer>& framebuffer) { m_Framebuffer = framebuffer; }
+			// The image is read each frame rather than held, since the render thread may swap the target behind it.
+			void SetTextureID(uint32_t textureID) { m_TextureID = textureID; }
 
 			void Draw();
 
@@ -22,7 +22,7 @@ namespace Ohm
 			const glm::vec2& GetViewportBoundsMax() const { return m_ViewportBoundsMax; }
 
 		private:
-			Ref<Framebuffer> m_Framebuffer;
+			uint32_t m_TextureID = 0;
 			glm::vec2 m_ViewportSize{ 0.0f };
 			glm::vec2 m_ViewportBoundsMin{ 0.0f };
 			glm::vec2 m_ViewportBoundsMax{ 0.0f };